@@ -0,0 +1,815 @@
+/**
+*******************************************************************************
+* @file canApi_sim.c
+* @brief Host stand-in for the canApi of the basic firmware
+* @author FRIWO
+* @date 19.10.2026 - 14:02:11
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* See canApi_sim.h for the simulated behaviour and the build command.
+*/
+
+/**
+* @addtogroup canApi_sim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief maximum number of identifiers in one filter bank (four standard identifiers in list mode) */
+#define FILTER_ENTRIES 4u
+
+/** @brief number of canApi signals */
+#define SIGNALS_AVAILABLE ((uint32_t)(sizeof(signal_array) / sizeof(canApiSim_SignalTypeDef)))
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Index of every signal in signal_array */
+typedef enum
+{
+#define CANAPI_SIM_GET(type, name) SIGNAL_INDEX_##name,
+#define CANAPI_SIM_SET(type, name) SIGNAL_INDEX_##name,
+#include "canApi_sim_signals.h"
+#undef CANAPI_SIM_GET
+#undef CANAPI_SIM_SET
+	SIGNAL_INDEX_COUNT
+}simSignalIndex_TypeDef;
+
+/**
+ * @brief Typedef for the receive or the transmit buffer.
+ * RINGBUFFER uses Head/Count, the PRIORITYBUFFER modes search the slots marked in Used.
+ */
+typedef struct
+{
+	buffer_BufferType Type; /**< @brief buffer mode */
+	canApi_MessageTypedef Slot[CANAPI_SIM_BUFFER_SIZE]; /**< @brief message storage */
+	uint32_t Sequence[CANAPI_SIM_BUFFER_SIZE]; /**< @brief enqueue order, FIFO among equal priorities */
+	uint8_t Used[CANAPI_SIM_BUFFER_SIZE]; /**< @brief slot occupied, PRIORITYBUFFER modes only */
+	uint32_t Head; /**< @brief oldest message, RINGBUFFER only */
+	uint32_t Count; /**< @brief number of messages */
+	uint32_t NextSequence; /**< @brief sequence number of the next message */
+}simBuffer_TypeDef;
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief Typedef for the FD receive or the FD transmit buffer, always a ring buffer
+ */
+typedef struct
+{
+	CAN_Fd_MessageTypedef Slot[CANAPI_SIM_FD_BUFFER_SIZE]; /**< @brief message storage */
+	uint32_t Head; /**< @brief oldest message */
+	uint32_t Count; /**< @brief number of messages */
+}simFdBuffer_TypeDef;
+#endif
+
+/**
+ * @brief Typedef for one identifier of a filter bank
+ */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief identifier to compare */
+	uint32_t Mask; /**< @brief relevant identifier bits, all bits in list mode */
+	uint8_t IDE; /**< @brief 0x00u = standard frame identifier, 0x01u = extended frame identifier */
+	uint8_t RTR; /**< @brief remote transmission request to compare */
+	uint8_t RTRMask; /**< @brief 1 if RTR is relevant */
+}simFilterEntry_TypeDef;
+
+/**
+ * @brief Typedef for a filter bank
+ */
+typedef struct
+{
+	uint8_t Count; /**< @brief number of valid entries, 0 = filter bank deactivated */
+	simFilterEntry_TypeDef Entry[FILTER_ENTRIES]; /**< @brief identifiers of the filter bank */
+}simFilterBank_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* signal storage, see canApi_sim_signals.h */
+#define CANAPI_SIM_GET(type, name) CANAPI_SIM_LOCAL type canApiSim_##name = 0;
+#define CANAPI_SIM_SET(type, name) CANAPI_SIM_LOCAL type canApiSim_##name = 0;
+#include "canApi_sim_signals.h"
+#undef CANAPI_SIM_GET
+#undef CANAPI_SIM_SET
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief signal descriptions for generic access, in the order of canApi.h.
+ * The value pointers are set in canApiSim_Reset(), the address of a thread-local signal is not a constant.
+ */
+#define CANAPI_SIM_TYPE_Float32 CANAPI_SIM_FLOAT32
+#define CANAPI_SIM_TYPE_Int16 CANAPI_SIM_INT16
+#define CANAPI_SIM_TYPE_UInt32 CANAPI_SIM_UINT32
+#define CANAPI_SIM_TYPE_UInt8 CANAPI_SIM_UINT8
+static CANAPI_SIM_LOCAL canApiSim_SignalTypeDef signal_array[] =
+{
+#define CANAPI_SIM_GET(type, name) {#name, CANAPI_SIM_TYPE_##type, 0, 0},
+#define CANAPI_SIM_SET(type, name) {#name, CANAPI_SIM_TYPE_##type, 1, 0},
+#include "canApi_sim_signals.h"
+#undef CANAPI_SIM_GET
+#undef CANAPI_SIM_SET
+};
+
+static CANAPI_SIM_LOCAL simBuffer_TypeDef receiveBuffer;
+static CANAPI_SIM_LOCAL simBuffer_TypeDef transmitBuffer;
+static CANAPI_SIM_LOCAL simFilterBank_TypeDef filterBank_array[CANAPI_SIM_FILTER_BANKS];
+
+static CANAPI_SIM_LOCAL uint32_t simTimeUs = 0;
+static CANAPI_SIM_LOCAL uint32_t usToNextTick = 1000u;
+static CANAPI_SIM_LOCAL uint32_t txPerTick = 0;
+static CANAPI_SIM_LOCAL canApiSim_FptrOnTransmit transmitObserver = 0;
+static CANAPI_SIM_LOCAL canApiSim_FptrOnSet signalObserver = 0;
+#ifdef CAN_FD_ENABLE
+static CANAPI_SIM_LOCAL simFdBuffer_TypeDef fdReceiveBuffer;
+static CANAPI_SIM_LOCAL simFdBuffer_TypeDef fdTransmitBuffer;
+static CANAPI_SIM_LOCAL canApiSim_FptrOnFdTransmit fdTransmitObserver = 0;
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void BufferClear(simBuffer_TypeDef *buffer);
+static canApi_StatusTypeDef BufferPut(simBuffer_TypeDef *buffer, const canApi_MessageTypedef *message);
+static canApi_StatusTypeDef BufferGet(simBuffer_TypeDef *buffer, canApi_MessageTypedef *message);
+static void FilterSet(canApi_FilterBank_Type FilterBank, uint8_t index, uint32_t identifier, uint8_t ide,
+	uint8_t rtr, uint32_t mask, uint8_t rtrMask);
+static Float64 ReadSignal(const canApiSim_SignalTypeDef *signal);
+static void WriteSignal(const canApiSim_SignalTypeDef *signal, Float64 value);
+static void NotifySet(simSignalIndex_TypeDef index);
+#ifdef CAN_FD_ENABLE
+static canApi_StatusTypeDef FdBufferPut(simFdBuffer_TypeDef *buffer, const CAN_Fd_MessageTypedef *message);
+static canApi_StatusTypeDef FdBufferGet(simFdBuffer_TypeDef *buffer, CAN_Fd_MessageTypedef *message);
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Remove all messages from a buffer, the buffer mode is kept
+ * @param buffer: receive or transmit buffer
+ */
+static void BufferClear(simBuffer_TypeDef *buffer)
+{
+	memset(buffer->Used, 0, sizeof(buffer->Used));
+	buffer->Head = 0;
+	buffer->Count = 0;
+}
+
+/**
+ * @brief Put a message into a buffer according to its mode
+ * @param buffer: receive or transmit buffer
+ * @param message: message to store
+ * @return CAN_OK, CAN_BUFFER_FULL if no slot is free
+ */
+static canApi_StatusTypeDef BufferPut(simBuffer_TypeDef *buffer, const canApi_MessageTypedef *message)
+{
+	uint32_t i;
+
+	if (buffer->Type == RINGBUFFER)
+	{
+		if (buffer->Count >= CANAPI_SIM_BUFFER_SIZE)
+		{
+			return CAN_BUFFER_FULL;
+		}
+		buffer->Slot[(buffer->Head + buffer->Count) % CANAPI_SIM_BUFFER_SIZE] = *message;
+		buffer->Count++;
+		return CAN_OK;
+	}
+
+	if (buffer->Type == PRIORITYBUFFER_REPLACE)
+	{
+		/* replace a queued message with the same identifier, it keeps its place in the queue */
+		for (i = 0; i < CANAPI_SIM_BUFFER_SIZE; i++)
+		{
+			if (buffer->Used[i] != 0 && buffer->Slot[i].Identifier == message->Identifier
+				&& buffer->Slot[i].IDE == message->IDE)
+			{
+				buffer->Slot[i] = *message;
+				return CAN_OK;
+			}
+		}
+	}
+
+	for (i = 0; i < CANAPI_SIM_BUFFER_SIZE; i++)
+	{
+		if (buffer->Used[i] == 0)
+		{
+			buffer->Slot[i] = *message;
+			buffer->Sequence[i] = buffer->NextSequence++;
+			buffer->Used[i] = 1;
+			buffer->Count++;
+			return CAN_OK;
+		}
+	}
+	return CAN_BUFFER_FULL;
+}
+
+/**
+ * @brief Find the slot of the message which leaves a buffer next according to its mode
+ * @param buffer: receive or transmit buffer, must not be empty
+ * @return slot index
+ */
+static uint32_t BufferNextSlot(const simBuffer_TypeDef *buffer)
+{
+	uint32_t i;
+	uint32_t best = CANAPI_SIM_BUFFER_SIZE;
+
+	if (buffer->Type == RINGBUFFER)
+	{
+		return buffer->Head;
+	}
+
+	for (i = 0; i < CANAPI_SIM_BUFFER_SIZE; i++)
+	{
+		if (buffer->Used[i] != 0
+			&& (best == CANAPI_SIM_BUFFER_SIZE
+				|| buffer->Slot[i].Priority > buffer->Slot[best].Priority
+				|| (buffer->Slot[i].Priority == buffer->Slot[best].Priority
+					&& (int32_t)(buffer->Sequence[i] - buffer->Sequence[best]) < 0)))
+		{
+			best = i;
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief Take the next message from a buffer according to its mode
+ * @param buffer: receive or transmit buffer
+ * @param message: target pointer to store the message
+ * @return CAN_OK, CAN_BUFFER_EMPTY if no message is stored
+ */
+static canApi_StatusTypeDef BufferGet(simBuffer_TypeDef *buffer, canApi_MessageTypedef *message)
+{
+	uint32_t slot;
+
+	if (buffer->Count == 0)
+	{
+		return CAN_BUFFER_EMPTY;
+	}
+
+	slot = BufferNextSlot(buffer);
+	*message = buffer->Slot[slot];
+	if (buffer->Type == RINGBUFFER)
+	{
+		buffer->Head = (buffer->Head + 1u) % CANAPI_SIM_BUFFER_SIZE;
+	}
+	else
+	{
+		buffer->Used[slot] = 0;
+	}
+	buffer->Count--;
+	return CAN_OK;
+}
+
+/**
+ * @brief Store one identifier of a filter bank
+ * @param FilterBank: filter bank
+ * @param index: entry of the filter bank, 0...FILTER_ENTRIES-1
+ * @param identifier: identifier to compare
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @param rtr: remote transmission request to compare
+ * @param mask: relevant identifier bits
+ * @param rtrMask: 1 if rtr is relevant
+ */
+static void FilterSet(canApi_FilterBank_Type FilterBank, uint8_t index, uint32_t identifier, uint8_t ide,
+	uint8_t rtr, uint32_t mask, uint8_t rtrMask)
+{
+	simFilterBank_TypeDef *bank;
+
+	if (FilterBank < FilterBank01 || FilterBank > FilterBank26)
+	{
+		return;
+	}
+	bank = &filterBank_array[FilterBank - FilterBank01];
+	bank->Entry[index].Identifier = identifier;
+	bank->Entry[index].IDE = ide;
+	bank->Entry[index].RTR = rtr;
+	bank->Entry[index].Mask = mask;
+	bank->Entry[index].RTRMask = rtrMask;
+	bank->Count = (uint8_t)(index + 1u);
+}
+
+/**
+ * @brief Read a signal converted to Float64
+ * @param signal: signal description
+ * @return current value
+ */
+static Float64 ReadSignal(const canApiSim_SignalTypeDef *signal)
+{
+	switch (signal->Type)
+	{
+		case CANAPI_SIM_FLOAT32:
+			return *(const Float32*)signal->Value;
+		case CANAPI_SIM_INT16:
+			return *(const Int16*)signal->Value;
+		case CANAPI_SIM_UINT32:
+			return (Float64)*(const UInt32*)signal->Value;
+		case CANAPI_SIM_UINT8:
+			return *(const UInt8*)signal->Value;
+	}
+	return 0;
+}
+
+/**
+ * @brief Write a signal converted to its basetype
+ * @param signal: signal description
+ * @param value: new value
+ */
+static void WriteSignal(const canApiSim_SignalTypeDef *signal, Float64 value)
+{
+	switch (signal->Type)
+	{
+		case CANAPI_SIM_FLOAT32:
+			*(Float32*)signal->Value = (Float32)value;
+			break;
+		case CANAPI_SIM_INT16:
+			*(Int16*)signal->Value = (Int16)value;
+			break;
+		case CANAPI_SIM_UINT32:
+			*(UInt32*)signal->Value = (UInt32)value;
+			break;
+		case CANAPI_SIM_UINT8:
+			*(UInt8*)signal->Value = (UInt8)value;
+			break;
+	}
+}
+
+/**
+ * @brief Call the signal observer for a canApi_Set_ call
+ * @param index: index of the written signal
+ */
+static void NotifySet(simSignalIndex_TypeDef index)
+{
+	if (signalObserver != 0)
+	{
+		signalObserver(&signal_array[index], ReadSignal(&signal_array[index]), simTimeUs);
+	}
+}
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief Put an FD message into an FD buffer
+ * @return CAN_OK, CAN_BUFFER_FULL if the buffer is full
+ */
+static canApi_StatusTypeDef FdBufferPut(simFdBuffer_TypeDef *buffer, const CAN_Fd_MessageTypedef *message)
+{
+	if (buffer->Count >= CANAPI_SIM_FD_BUFFER_SIZE)
+	{
+		return CAN_BUFFER_FULL;
+	}
+	buffer->Slot[(buffer->Head + buffer->Count) % CANAPI_SIM_FD_BUFFER_SIZE] = *message;
+	buffer->Count++;
+	return CAN_OK;
+}
+
+/**
+ * @brief Take the oldest FD message from an FD buffer
+ * @return CAN_OK, CAN_BUFFER_EMPTY if the buffer is empty
+ */
+static canApi_StatusTypeDef FdBufferGet(simFdBuffer_TypeDef *buffer, CAN_Fd_MessageTypedef *message)
+{
+	if (buffer->Count == 0)
+	{
+		return CAN_BUFFER_EMPTY;
+	}
+	*message = buffer->Slot[buffer->Head];
+	buffer->Head = (buffer->Head + 1u) % CANAPI_SIM_FD_BUFFER_SIZE;
+	buffer->Count--;
+	return CAN_OK;
+}
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* canApi signal functions, see canApi_sim_signals.h */
+#define CANAPI_SIM_GET(type, name) type canApi_Get_##name(void) { return canApiSim_##name; }
+#define CANAPI_SIM_SET(type, name) void canApi_Set_##name(type value) { canApiSim_##name = value; NotifySet(SIGNAL_INDEX_##name); }
+#include "canApi_sim_signals.h"
+#undef CANAPI_SIM_GET
+#undef CANAPI_SIM_SET
+
+/* canApi buffer functions */
+
+void canApi_SetupBuffer(buffer_BufferType receiveBufferType, buffer_BufferType transmitBufferType)
+{
+	receiveBuffer.Type = receiveBufferType;
+	transmitBuffer.Type = transmitBufferType;
+	BufferClear(&receiveBuffer);
+	BufferClear(&transmitBuffer);
+}
+
+void canApi_ClearTransmitBuffer(void)
+{
+	BufferClear(&transmitBuffer);
+}
+
+void canApi_ClearReceiveBuffer(void)
+{
+	BufferClear(&receiveBuffer);
+}
+
+canApi_StatusTypeDef canApi_SendMessage(const canApi_MessageTypedef *message)
+{
+	if (message->DLC > 8u || (message->IDE == 0 && message->Identifier > 0x7FFu)
+		|| message->Identifier > 0x1FFFFFFFu)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	return BufferPut(&transmitBuffer, message);
+}
+
+canApi_StatusTypeDef canApi_ReceiveMessage(canApi_MessageTypedef *message)
+{
+	return BufferGet(&receiveBuffer, message);
+}
+
+/* canApi filter functions */
+
+void canApi_FilterDeactivateFilterBank(canApi_FilterBank_Type FilterBank)
+{
+	if (FilterBank >= FilterBank01 && FilterBank <= FilterBank26)
+	{
+		filterBank_array[FilterBank - FilterBank01].Count = 0;
+	}
+}
+
+void canApi_FilterSetOneStdIdMaskMode(canApi_FilterBank_Type FilterBank,uint16_t StdId_1,uint8_t RTR_StdId_1, uint16_t Mask_1, uint8_t RTR_Mask_1)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, Mask_1, RTR_Mask_1);
+}
+
+void canApi_FilterSetTwoStdIdMaskMode(canApi_FilterBank_Type FilterBank,uint16_t StdId_1,uint8_t RTR_StdId_1, uint16_t Mask_1, uint8_t RTR_Mask_1, uint16_t StdId_2, uint8_t RTR_StdId_2, uint16_t Mask_2, uint8_t RTR_Mask_2)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, Mask_1, RTR_Mask_1);
+	FilterSet(FilterBank, 1, StdId_2, 0, RTR_StdId_2, Mask_2, RTR_Mask_2);
+}
+
+void canApi_FilterSetOneStdIdListMode(canApi_FilterBank_Type FilterBank,uint16_t StdId_1,uint8_t RTR_StdId_1)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, 0x7FFu, 1);
+}
+
+void canApi_FilterSetTwoStdIdListMode(canApi_FilterBank_Type FilterBank,uint16_t StdId_1,uint8_t RTR_StdId_1,uint16_t StdId_2,uint8_t RTR_StdId_2)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, 0x7FFu, 1);
+	FilterSet(FilterBank, 1, StdId_2, 0, RTR_StdId_2, 0x7FFu, 1);
+}
+
+void canApi_FilterSetThreeStdIdListMode(canApi_FilterBank_Type FilterBank,uint16_t StdId_1,uint8_t RTR_StdId_1,uint16_t StdId_2,uint8_t RTR_StdId_2,uint16_t StdId_3,uint8_t RTR_StdId_3)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, 0x7FFu, 1);
+	FilterSet(FilterBank, 1, StdId_2, 0, RTR_StdId_2, 0x7FFu, 1);
+	FilterSet(FilterBank, 2, StdId_3, 0, RTR_StdId_3, 0x7FFu, 1);
+}
+
+void canApi_FilterSetFourStdIdListMode(canApi_FilterBank_Type FilterBank,uint16_t StdId_1,uint8_t RTR_StdId_1,uint16_t StdId_2,uint8_t RTR_StdId_2,uint16_t StdId_3,uint8_t RTR_StdId_3,uint16_t StdId_4,uint8_t RTR_StdId_4)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, 0x7FFu, 1);
+	FilterSet(FilterBank, 1, StdId_2, 0, RTR_StdId_2, 0x7FFu, 1);
+	FilterSet(FilterBank, 2, StdId_3, 0, RTR_StdId_3, 0x7FFu, 1);
+	FilterSet(FilterBank, 3, StdId_4, 0, RTR_StdId_4, 0x7FFu, 1);
+}
+
+void canApi_FilterSetOneExtIdMaskMode(canApi_FilterBank_Type FilterBank,uint32_t ExtId_1,uint8_t RTR_ExtId_1, uint32_t Mask_1,uint8_t RTR_Mask_1)
+{
+	FilterSet(FilterBank, 0, ExtId_1, 1, RTR_ExtId_1, Mask_1, RTR_Mask_1);
+}
+
+void canApi_FilterSetOneExtIdListMode(canApi_FilterBank_Type FilterBank, uint32_t ExtId_1,uint8_t RTR_ExtId_1)
+{
+	FilterSet(FilterBank, 0, ExtId_1, 1, RTR_ExtId_1, 0x1FFFFFFFu, 1);
+}
+
+void canApi_FilterSetTwoExtIdListMode(canApi_FilterBank_Type FilterBank, uint32_t ExtId_1,uint8_t RTR_ExtId_1, uint32_t ExtId_2,uint8_t RTR_ExtId_2)
+{
+	FilterSet(FilterBank, 0, ExtId_1, 1, RTR_ExtId_1, 0x1FFFFFFFu, 1);
+	FilterSet(FilterBank, 1, ExtId_2, 1, RTR_ExtId_2, 0x1FFFFFFFu, 1);
+}
+
+void canApi_FilterSetOneStdIdOneExtIdListMode(canApi_FilterBank_Type FilterBank, uint16_t StdId_1,uint8_t RTR_StdId_1,uint32_t ExtId_1,uint8_t RTR_ExtId_1)
+{
+	FilterSet(FilterBank, 0, StdId_1, 0, RTR_StdId_1, 0x7FFu, 1);
+	FilterSet(FilterBank, 1, ExtId_1, 1, RTR_ExtId_1, 0x1FFFFFFFu, 1);
+}
+
+#ifdef CAN_FD_ENABLE
+/* FD peripheral of CAN_fd.h */
+
+canApi_StatusTypeDef CAN_Fd_SendMessage(const CAN_Fd_MessageTypedef *message)
+{
+	if (message->DLC > 15u || (message->FDF == 0 && message->DLC > 8u))
+	{
+		return CAN_INVALID_VALUE;
+	}
+	return FdBufferPut(&fdTransmitBuffer, message);
+}
+
+canApi_StatusTypeDef CAN_Fd_ReceiveMessage(CAN_Fd_MessageTypedef *message)
+{
+	return FdBufferGet(&fdReceiveBuffer, message);
+}
+#endif
+
+/* simulated clock, overrides the weak definition in CAN_custom.c */
+
+uint32_t CAN_GetTimestampUs(void)
+{
+	return simTimeUs;
+}
+
+/* simulation control */
+
+void canApiSim_Reset(void)
+{
+	uint32_t i;
+
+#define CANAPI_SIM_GET(type, name) signal_array[SIGNAL_INDEX_##name].Value = (void*)&canApiSim_##name;
+#define CANAPI_SIM_SET(type, name) signal_array[SIGNAL_INDEX_##name].Value = (void*)&canApiSim_##name;
+#include "canApi_sim_signals.h"
+#undef CANAPI_SIM_GET
+#undef CANAPI_SIM_SET
+	for (i = 0; i < SIGNALS_AVAILABLE; i++)
+	{
+		WriteSignal(&signal_array[i], 0);
+	}
+	receiveBuffer.Type = RINGBUFFER;
+	transmitBuffer.Type = RINGBUFFER;
+	BufferClear(&receiveBuffer);
+	BufferClear(&transmitBuffer);
+#ifdef CAN_FD_ENABLE
+	memset(&fdReceiveBuffer, 0, sizeof(fdReceiveBuffer));
+	memset(&fdTransmitBuffer, 0, sizeof(fdTransmitBuffer));
+	fdTransmitObserver = 0;
+#endif
+	memset(filterBank_array, 0, sizeof(filterBank_array));
+	simTimeUs = 0;
+	usToNextTick = 1000u;
+	txPerTick = 0;
+	transmitObserver = 0;
+	signalObserver = 0;
+}
+
+void canApiSim_Init(void)
+{
+	canApiSim_Reset();
+	canApi_UserInitCallBack();
+}
+
+void canApiSim_Tick(uint32_t count)
+{
+	while (count > 0)
+	{
+		canApiSim_RunForUs(usToNextTick);
+		count--;
+	}
+}
+
+void canApiSim_RunForUs(uint32_t us)
+{
+	while (us >= usToNextTick)
+	{
+		us -= usToNextTick;
+		simTimeUs += usToNextTick;
+		usToNextTick = 1000u;
+		canApi_UserPeriodicCallBack();
+		if (txPerTick != CANAPI_SIM_TX_EXTERNAL)
+		{
+			(void)canApiSim_Transmit(txPerTick);
+		}
+	}
+	simTimeUs += us;
+	usToNextTick -= us;
+}
+
+uint32_t canApiSim_GetTimeUs(void)
+{
+	return simTimeUs;
+}
+
+/* simulated bus */
+
+canApi_StatusTypeDef canApiSim_Receive(const canApi_MessageTypedef *message)
+{
+	if (canApiSim_FilterAccepts(message) == 0)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	CAN_RxIsrHook(message);
+	return BufferPut(&receiveBuffer, message);
+}
+
+uint32_t canApiSim_Transmit(uint32_t maxCount)
+{
+	canApi_MessageTypedef message;
+	uint32_t sent = 0;
+#ifdef CAN_FD_ENABLE
+	CAN_Fd_MessageTypedef fdMessage;
+#endif
+
+	while ((maxCount == 0 || sent < maxCount) && canApiSim_TakeTransmit(&message) == CAN_OK)
+	{
+		canApiSim_CompleteTransmit(&message);
+		sent++;
+	}
+#ifdef CAN_FD_ENABLE
+	while ((maxCount == 0 || sent < maxCount) && canApiSim_BSW_IO_F_CAN_BSW_BusOff == 0
+		&& FdBufferGet(&fdTransmitBuffer, &fdMessage) == CAN_OK)
+	{
+		if (fdTransmitObserver != 0)
+		{
+			fdTransmitObserver(&fdMessage, simTimeUs);
+		}
+		sent++;
+	}
+#endif
+	return sent;
+}
+
+canApi_StatusTypeDef canApiSim_PeekTransmit(canApi_MessageTypedef *message)
+{
+	if (canApiSim_BSW_IO_F_CAN_BSW_BusOff != 0 || transmitBuffer.Count == 0)
+	{
+		return CAN_BUFFER_EMPTY;
+	}
+	*message = transmitBuffer.Slot[BufferNextSlot(&transmitBuffer)];
+	return CAN_OK;
+}
+
+canApi_StatusTypeDef canApiSim_TakeTransmit(canApi_MessageTypedef *message)
+{
+	if (canApiSim_BSW_IO_F_CAN_BSW_BusOff != 0)
+	{
+		return CAN_BUFFER_EMPTY;
+	}
+	return BufferGet(&transmitBuffer, message);
+}
+
+void canApiSim_CompleteTransmit(const canApi_MessageTypedef *message)
+{
+	if (transmitObserver != 0)
+	{
+		transmitObserver(message, simTimeUs);
+	}
+	CAN_TxCompleteHook(message);
+}
+
+#ifdef CAN_FD_ENABLE
+canApi_StatusTypeDef canApiSim_ReceiveFd(const CAN_Fd_MessageTypedef *message)
+{
+	canApi_MessageTypedef filterProbe;
+
+	filterProbe.Identifier = message->Identifier;
+	filterProbe.IDE = message->IDE;
+	filterProbe.RTR = 0;
+	if (canApiSim_FilterAccepts(&filterProbe) == 0)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	return FdBufferPut(&fdReceiveBuffer, message);
+}
+#endif
+
+void canApiSim_SetTxPerTick(uint32_t count)
+{
+	txPerTick = count;
+}
+
+void canApiSim_SetBusState(Int16 busOff, Int16 passive, Int16 warning)
+{
+	canApiSim_BSW_IO_F_CAN_BSW_BusOff = busOff;
+	canApiSim_BSW_IO_F_CAN_BSW_Passive = passive;
+	canApiSim_BSW_IO_F_CAN_BSW_Warning = warning;
+}
+
+uint8_t canApiSim_FilterAccepts(const canApi_MessageTypedef *message)
+{
+	uint32_t bank;
+	uint8_t i;
+
+	for (bank = 0; bank < CANAPI_SIM_FILTER_BANKS; bank++)
+	{
+		for (i = 0; i < filterBank_array[bank].Count; i++)
+		{
+			const simFilterEntry_TypeDef *entry = &filterBank_array[bank].Entry[i];
+
+			if (entry->IDE == message->IDE
+				&& ((entry->Identifier ^ message->Identifier) & entry->Mask) == 0
+				&& (entry->RTRMask == 0 || entry->RTR == message->RTR))
+			{
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+void canApiSim_GetBufferLevel(uint32_t *receive, uint32_t *transmit)
+{
+	if (receive != 0)
+	{
+		*receive = receiveBuffer.Count;
+	}
+	if (transmit != 0)
+	{
+		*transmit = transmitBuffer.Count;
+	}
+}
+
+/* observers */
+
+void canApiSim_SetTransmitObserver(canApiSim_FptrOnTransmit observer)
+{
+	transmitObserver = observer;
+}
+
+#ifdef CAN_FD_ENABLE
+void canApiSim_SetFdTransmitObserver(canApiSim_FptrOnFdTransmit observer)
+{
+	fdTransmitObserver = observer;
+}
+#endif
+
+void canApiSim_SetSignalObserver(canApiSim_FptrOnSet observer)
+{
+	signalObserver = observer;
+}
+
+/* generic signal access */
+
+uint32_t canApiSim_GetSignalCount(void)
+{
+	return SIGNALS_AVAILABLE;
+}
+
+const canApiSim_SignalTypeDef* canApiSim_GetSignalByIndex(uint32_t index)
+{
+	if (index >= SIGNALS_AVAILABLE)
+	{
+		return 0;
+	}
+	return &signal_array[index];
+}
+
+const canApiSim_SignalTypeDef* canApiSim_FindSignal(const char *name)
+{
+	uint32_t i;
+
+	for (i = 0; i < SIGNALS_AVAILABLE; i++)
+	{
+		if (strcmp(signal_array[i].Name, name) == 0)
+		{
+			return &signal_array[i];
+		}
+	}
+	return 0;
+}
+
+canApi_StatusTypeDef canApiSim_SetSignal(const char *name, Float64 value)
+{
+	const canApiSim_SignalTypeDef *signal = canApiSim_FindSignal(name);
+
+	if (signal == 0)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	WriteSignal(signal, value);
+	return CAN_OK;
+}
+
+canApi_StatusTypeDef canApiSim_GetSignal(const char *name, Float64 *value)
+{
+	const canApiSim_SignalTypeDef *signal = canApiSim_FindSignal(name);
+
+	if (signal == 0)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	*value = ReadSignal(signal);
+	return CAN_OK;
+}
+
+/** @} */
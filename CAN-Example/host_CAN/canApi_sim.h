@@ -0,0 +1,305 @@
+/**
+*******************************************************************************
+* @file canApi_sim.h
+* @brief Host stand-in for the canApi of the basic firmware
+* @author FRIWO
+* @date 19.10.2026 - 14:02:11
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Implements every function of canApi.h on a Linux host so that CAN_custom.c
+* runs unchanged outside the target:
+* - every canApi_Get_/canApi_Set_ signal is an ordinary variable canApiSim_<name>
+* - receive and transmit buffer in all three buffer_BufferType modes
+* - the 26 filter banks in list and mask mode
+* - with -DCAN_FD_ENABLE CAN_Fd_SendMessage() and CAN_Fd_ReceiveMessage() of
+*   CAN_fd.h with their own ring buffers, see canApiSim_ReceiveFd()
+* - a deterministic 1ms tick driver with a simulated microsecond clock,
+*   which also provides CAN_GetTimestampUs() and calls CAN_RxIsrHook() and
+*   CAN_TxCompleteHook() like the basic software does
+*
+* Built with -DCAN_MULTI_INSTANCE all simulation state is thread-local, so each
+* thread simulates its own controller, see CAN_SelectContext().
+*
+* Assumptions where the firmware behaviour is not documented:
+* - a full buffer rejects the new message with CAN_BUFFER_FULL
+* - in the PRIORITYBUFFER modes the message with the highest Priority value
+*   leaves first, messages of equal priority in FIFO order
+* - with no filter bank active no message is received, like the bxCAN peripheral
+*
+* Build together with the module and a driver, e.g.
+* gcc -std=c99 -O2 -I../module_CAN -o can_sim can_sim.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+*/
+
+#ifndef CANAPI_SIM_H_
+#define CANAPI_SIM_H_
+
+/**
+* @addtogroup canApi_sim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+#ifdef CAN_FD_ENABLE
+#include "CAN_fd.h"
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of messages in the receive and in the transmit buffer */
+#ifndef CANAPI_SIM_BUFFER_SIZE
+#define CANAPI_SIM_BUFFER_SIZE 64u
+#endif
+
+/** @brief number of FD messages in the receive and in the transmit buffer of the FD peripheral */
+#ifndef CANAPI_SIM_FD_BUFFER_SIZE
+#define CANAPI_SIM_FD_BUFFER_SIZE 16u
+#endif
+
+/** @brief number of filter banks, see canApi_FilterBank_Type */
+#define CANAPI_SIM_FILTER_BANKS 26u
+
+/** @brief canApiSim_SetTxPerTick() value: the ticks transmit nothing, a bus model drains the transmit buffer */
+#define CANAPI_SIM_TX_EXTERNAL 0xFFFFFFFFu
+
+/** @brief storage of the simulation state, one simulated controller per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CANAPI_SIM_LOCAL _Thread_local
+#else
+#define CANAPI_SIM_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Basetype of a canApi signal */
+typedef enum
+{
+	CANAPI_SIM_FLOAT32, /**< @brief Float32 */
+	CANAPI_SIM_INT16, /**< @brief Int16 */
+	CANAPI_SIM_UINT32, /**< @brief UInt32 */
+	CANAPI_SIM_UINT8 /**< @brief UInt8 */
+}canApiSim_SignalType;
+
+/** @brief Description of one canApi signal for generic access by name */
+typedef struct
+{
+	const char *Name; /**< @brief signal name without canApi_Get_/canApi_Set_ prefix */
+	canApiSim_SignalType Type; /**< @brief basetype of the signal */
+	uint8_t Direction; /**< @brief 0 = read by the module (Get), 1 = written by the module (Set) */
+	void *Value; /**< @brief pointer to the variable canApiSim_<name> */
+}canApiSim_SignalTypeDef;
+
+/** @brief Called for every message which leaves the transmit buffer onto the simulated bus */
+typedef void (*canApiSim_FptrOnTransmit)(const canApi_MessageTypedef *message, uint32_t timestamp);
+
+#ifdef CAN_FD_ENABLE
+/** @brief Called for every FD message which leaves the FD transmit buffer onto the simulated bus */
+typedef void (*canApiSim_FptrOnFdTransmit)(const CAN_Fd_MessageTypedef *message, uint32_t timestamp);
+#endif
+
+/** @brief Called for every canApi_Set_ call of the module */
+typedef void (*canApiSim_FptrOnSet)(const canApiSim_SignalTypeDef *signal, Float64 value, uint32_t timestamp);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* one variable canApiSim_<name> per signal, see canApi_sim_signals.h */
+#define CANAPI_SIM_GET(type, name) extern CANAPI_SIM_LOCAL type canApiSim_##name;
+#define CANAPI_SIM_SET(type, name) extern CANAPI_SIM_LOCAL type canApiSim_##name;
+#include "canApi_sim_signals.h"
+#undef CANAPI_SIM_GET
+#undef CANAPI_SIM_SET
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* simulation control */
+
+/**
+ * @brief Clear buffers, filters, signals, observers and the simulated clock
+ */
+void canApiSim_Reset(void);
+
+/**
+ * @brief Reset the simulation and call canApi_UserInitCallBack() like the CAN hardware init
+ */
+void canApiSim_Init(void);
+
+/**
+ * @brief Run the module for a number of 1ms ticks as fast as possible.
+ * Each tick advances the clock to the next millisecond, calls canApi_UserPeriodicCallBack() and
+ * moves messages from the transmit buffer onto the simulated bus.
+ * @param count: number of ticks
+ */
+void canApiSim_Tick(uint32_t count);
+
+/**
+ * @brief Advance the simulated clock, e.g. to the arrival time of the next received message.
+ * Every tick of the fixed 1ms grid within the time step is executed like in canApiSim_Tick().
+ * @param us: time step [us]
+ */
+void canApiSim_RunForUs(uint32_t us);
+
+/**
+ * @brief Get the simulated clock
+ * @return time since canApiSim_Reset() [us]
+ */
+uint32_t canApiSim_GetTimeUs(void);
+
+/* simulated bus */
+
+/**
+ * @brief Deliver a message from the bus like the receive interrupt does.
+ * The message passes the filter banks, then CAN_RxIsrHook() is called and the message is put into the receive buffer.
+ * @param message: received message
+ * @return CAN_OK, CAN_INVALID_VALUE if no filter bank accepts the message, CAN_BUFFER_FULL if the receive buffer dropped it
+ */
+canApi_StatusTypeDef canApiSim_Receive(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Move messages from the transmit buffer onto the bus and call CAN_TxCompleteHook() for each.
+ * Nothing is transmitted while the bus-off flag is set. In CAN FD builds the FD transmit buffer is
+ * emptied afterwards, each FD message counts against maxCount. A bus model which uses
+ * CANAPI_SIM_TX_EXTERNAL does not see FD messages.
+ * @param maxCount: maximum number of messages, 0 = all
+ * @return number of transmitted messages
+ */
+uint32_t canApiSim_Transmit(uint32_t maxCount);
+
+/**
+ * @brief Get the message which leaves the transmit buffer next without removing it,
+ * e.g. to let it take part in a bus arbitration model
+ * @param message: target pointer to store the message
+ * @return CAN_OK, CAN_BUFFER_EMPTY if the buffer is empty or the bus-off flag is set
+ */
+canApi_StatusTypeDef canApiSim_PeekTransmit(canApi_MessageTypedef *message);
+
+/**
+ * @brief Remove the next message from the transmit buffer like the peripheral loading a mailbox.
+ * No hook is called, see canApiSim_CompleteTransmit().
+ * @param message: target pointer to store the message
+ * @return CAN_OK, CAN_BUFFER_EMPTY if the buffer is empty or the bus-off flag is set
+ */
+canApi_StatusTypeDef canApiSim_TakeTransmit(canApi_MessageTypedef *message);
+
+/**
+ * @brief Report the end of transmission of a message taken with canApiSim_TakeTransmit():
+ * calls the transmit observer and CAN_TxCompleteHook() at the current simulated time
+ * @param message: transmitted message
+ */
+void canApiSim_CompleteTransmit(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Limit the number of messages transmitted at the end of each tick
+ * @param count: messages per tick, 0 = empty the transmit buffer in every tick (default),
+ * CANAPI_SIM_TX_EXTERNAL = no transmission by the ticks
+ */
+void canApiSim_SetTxPerTick(uint32_t count);
+
+/**
+ * @brief Set the error state flags returned by canApi_Get_BSW_IO_F_CAN_BSW_*()
+ * @param busOff: bus-off flag
+ * @param passive: error passive flag
+ * @param warning: error warning flag
+ */
+void canApiSim_SetBusState(Int16 busOff, Int16 passive, Int16 warning);
+
+/**
+ * @brief Check a message against the active filter banks
+ * @param message: message to check
+ * @return 1 if at least one filter bank accepts the message, else 0
+ */
+uint8_t canApiSim_FilterAccepts(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Get the number of messages in the buffers
+ * @param receive: target pointer for the receive buffer level, may be 0
+ * @param transmit: target pointer for the transmit buffer level, may be 0
+ */
+void canApiSim_GetBufferLevel(uint32_t *receive, uint32_t *transmit);
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief Deliver an FD message from the bus into the FD receive buffer.
+ * The identifier passes the filter banks, CAN_RxIsrHook() is not called.
+ * @param message: received message
+ * @return CAN_OK, CAN_INVALID_VALUE if no filter bank accepts the message, CAN_BUFFER_FULL if the buffer dropped it
+ */
+canApi_StatusTypeDef canApiSim_ReceiveFd(const CAN_Fd_MessageTypedef *message);
+#endif
+
+/* observers */
+
+/**
+ * @brief Register a function called for every transmitted message, 0 to remove
+ * @param observer: function pointer
+ */
+void canApiSim_SetTransmitObserver(canApiSim_FptrOnTransmit observer);
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief Register a function called for every transmitted FD message, 0 to remove
+ * @param observer: function pointer
+ */
+void canApiSim_SetFdTransmitObserver(canApiSim_FptrOnFdTransmit observer);
+#endif
+
+/**
+ * @brief Register a function called for every canApi_Set_ call, 0 to remove
+ * @param observer: function pointer
+ */
+void canApiSim_SetSignalObserver(canApiSim_FptrOnSet observer);
+
+/* generic signal access */
+
+/**
+ * @brief Get the number of canApi signals
+ * @return number of entries for canApiSim_GetSignalByIndex()
+ */
+uint32_t canApiSim_GetSignalCount(void);
+
+/**
+ * @brief Get a canApi signal by index, in the order of canApi.h.
+ * The value pointer is valid after canApiSim_Reset() in the calling thread.
+ * @param index: 0...canApiSim_GetSignalCount()-1
+ * @return signal description, 0 if index is out of range
+ */
+const canApiSim_SignalTypeDef* canApiSim_GetSignalByIndex(uint32_t index);
+
+/**
+ * @brief Find a canApi signal by name
+ * @param name: signal name without canApi_Get_/canApi_Set_ prefix
+ * @return signal description, 0 if unknown
+ */
+const canApiSim_SignalTypeDef* canApiSim_FindSignal(const char *name);
+
+/**
+ * @brief Write a canApi signal by name, converted to its basetype
+ * @param name: signal name without canApi_Get_/canApi_Set_ prefix
+ * @param value: new value
+ * @return CAN_OK, CAN_INVALID_VALUE if the signal is unknown
+ */
+canApi_StatusTypeDef canApiSim_SetSignal(const char *name, Float64 value);
+
+/**
+ * @brief Read a canApi signal by name
+ * @param name: signal name without canApi_Get_/canApi_Set_ prefix
+ * @param value: target pointer to store the value
+ * @return CAN_OK, CAN_INVALID_VALUE if the signal is unknown
+ */
+canApi_StatusTypeDef canApiSim_GetSignal(const char *name, Float64 *value);
+
+/** @} */
+
+#endif /* CANAPI_SIM_H_ */
@@ -0,0 +1,165 @@
+/**
+*******************************************************************************
+* @file canApi_sim_signals.h
+* @brief Host stand-in for canApi: list of all signals of canApi.h
+* @author FRIWO
+* @date 19.10.2026 - 14:02:11
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* X-macro list, included several times by canApi_sim.c and canApi_sim.h.
+* CANAPI_SIM_GET(type, name) is a signal read by the CAN module through
+* canApi_Get_<name>(), CANAPI_SIM_SET(type, name) a signal written through
+* canApi_Set_<name>(). Keep the order of canApi.h.
+*/
+
+/* no include guard, this file is included once per X-macro expansion */
+
+
+/* GET FUNCTIONS (TX Signals) */
+CANAPI_SIM_GET(Int16, BSW_IO_F_CAN_BSW_BusOff)
+CANAPI_SIM_GET(Int16, BSW_IO_F_CAN_BSW_Passive)
+CANAPI_SIM_GET(Int16, BSW_IO_F_CAN_BSW_Warning)
+CANAPI_SIM_GET(Float32, INFO_ODO_Total_Kilometers)
+CANAPI_SIM_GET(Float32, INFO_ODO_Trip_Kilometers)
+CANAPI_SIM_GET(Float32, INFO_Motor_Current_Iq)
+CANAPI_SIM_GET(Float32, INFO_Motor_Current_Id)
+CANAPI_SIM_GET(Float32, INFO_DC_Current)
+CANAPI_SIM_GET(Float32, INFO_Voltage_DC_Link)
+CANAPI_SIM_GET(Float32, INFO_Rotor_Speed)
+CANAPI_SIM_GET(Float32, INFO_Motor_Current)
+CANAPI_SIM_GET(Float32, INFO_Vehicle_Speed)
+CANAPI_SIM_GET(Float32, INFO_Remaining_Distance)
+CANAPI_SIM_GET(Float32, INFO_Consumption_Ave_Trip)
+CANAPI_SIM_GET(Float32, INFO_Ah_Pos)
+CANAPI_SIM_GET(Float32, INFO_Ah_Neg)
+CANAPI_SIM_GET(Float32, INFO_Rel_Torque_Setpoint)
+CANAPI_SIM_GET(Float32, INFO_Rel_Torque_Max)
+CANAPI_SIM_GET(Float32, INFO_Rel_Torque_Mapping)
+CANAPI_SIM_GET(Float32, TEMP_FET_Max)
+CANAPI_SIM_GET(Float32, TEMP_Motor)
+CANAPI_SIM_GET(Float32, TEMP_MCU)
+CANAPI_SIM_GET(Float32, TEMP_Combined_Max_Rel)
+CANAPI_SIM_GET(UInt32, ERR_Errorcode)
+CANAPI_SIM_GET(UInt32, ERR_MEM_Trace_0_Errorcode)
+CANAPI_SIM_GET(Float32, SM_OUT_SYS_Trq_Control)
+CANAPI_SIM_GET(Float32, SM_PE_Mode_Req_Int)
+CANAPI_SIM_GET(Float32, SM_BMS_Control_State)
+CANAPI_SIM_GET(Float32, ROC_Result)
+CANAPI_SIM_GET(Float32, APP_Disp_Ride_Mode)
+CANAPI_SIM_GET(UInt32, APP_Boost_Info)
+CANAPI_SIM_GET(Float32, APP_Boost_Avail_Rel)
+CANAPI_SIM_GET(Float32, APP_Boost_Avail_As)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Temp_MCU)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Max_Positive_Current)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Max_Negative_Current)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_DC_Link_Voltage_Max)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_DC_Link_Voltage_Min)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Rotor_Speed)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Temp_FET)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Temp_Motor)
+CANAPI_SIM_GET(Float32, TRQ_LIM_Derating_Active)
+CANAPI_SIM_GET(Float32, TRQ_DES_Driver_Reverse_Gear)
+CANAPI_SIM_GET(UInt32, PROD_M_BSW_Ver_Release)
+CANAPI_SIM_GET(UInt32, PROD_M_BSW_Ver_Revision)
+CANAPI_SIM_GET(UInt32, PROD_C_HW_Prod_Info_1)
+CANAPI_SIM_GET(UInt32, PROD_M_HW_ID1)
+CANAPI_SIM_GET(UInt32, PROD_M_HW_ID2)
+CANAPI_SIM_GET(UInt32, BSW_C_BSW_ET_Dataset_ID1)
+CANAPI_SIM_GET(UInt32, BSW_C_BSW_ET_Dataset_ID2)
+CANAPI_SIM_GET(UInt32, BSW_C_BSW_ET_Dataset_ID3)
+CANAPI_SIM_GET(UInt32, BSW_Immo_Challenge_Lower)
+CANAPI_SIM_GET(UInt32, BSW_Immo_Challenge_Higher)
+CANAPI_SIM_GET(UInt32, BSW_BMS_Unlock_Code_Higher)
+CANAPI_SIM_GET(UInt32, BSW_BMS_Unlock_Code_Lower)
+CANAPI_SIM_GET(Float32, SOC_State_of_Charge)
+
+/* SET FUNCTIONS (RX Signals) */
+CANAPI_SIM_SET(UInt8, CAN_EXT_Alive_Counter)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Alive_Counter_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_State_Request)
+CANAPI_SIM_SET(UInt8, CAN_EXT_State_Request_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_Ride_Mode)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Ride_Mode_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_ROC_Start)
+CANAPI_SIM_SET(UInt8, CAN_EXT_ROC_Start_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_Boost_Enable)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Boost_Enable_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_Reverse_Gear)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Reverse_Gear_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_Torque_Request)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Torque_Request_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_Rotor_Speed_Max)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Rotor_Speed_Max_Timeout)
+CANAPI_SIM_SET(Float32, CAN_EXT_Skip_Signal_Checks)
+CANAPI_SIM_SET(UInt8, CAN_EXT_Skip_Signal_Checks_Timeout)
+CANAPI_SIM_SET(UInt32, CAN_Immo_Unlock_Request_Lower)
+CANAPI_SIM_SET(UInt32, CAN_Immo_Unlock_Request_Higher)
+CANAPI_SIM_SET(UInt8, CAN_Immo_Unlock_Request_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Pack_Voltage)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Pack_Voltage_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Pack_Current)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Pack_Current_Timeout)
+CANAPI_SIM_SET(UInt32, CAN_BMS_Errorcode)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Errorcode_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Charge_Plug_Detection)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Charge_Plug_Detection_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_State)
+CANAPI_SIM_SET(UInt8, CAN_BMS_State_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_SOC)
+CANAPI_SIM_SET(UInt8, CAN_BMS_SOC_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_State_of_Health)
+CANAPI_SIM_SET(UInt8, CAN_BMS_State_of_Health_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Remaining_Capacity)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Remaining_Capacity_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Fullcharge_Capacity)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Fullcharge_Capacity_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_TEMP_Powerstage1)
+CANAPI_SIM_SET(UInt8, CAN_BMS_TEMP_Powerstage1_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_TEMP_Powerstage2)
+CANAPI_SIM_SET(UInt8, CAN_BMS_TEMP_Powerstage2_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_TEMP_MCU)
+CANAPI_SIM_SET(UInt8, CAN_BMS_TEMP_MCU_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_TEMP_Cell1)
+CANAPI_SIM_SET(UInt8, CAN_BMS_TEMP_Cell1_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_TEMP_Cell2)
+CANAPI_SIM_SET(UInt8, CAN_BMS_TEMP_Cell2_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Max_Charge)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Max_Charge_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Max_Discharge)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Max_Discharge_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Max_Voltage)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Max_Voltage_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Min_Voltage)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Min_Voltage_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Warning_Status)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Warning_Status_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Pending_HV_Shutdown)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Pending_HV_Shutdown_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_Pending_Bordnet_Shutdown)
+CANAPI_SIM_SET(UInt8, CAN_BMS_Pending_Bordnet_Shutdown_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_PushButton_ShortPress_Detected)
+CANAPI_SIM_SET(UInt8, CAN_BMS_PushButton_ShortPress_Detected_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_PushButton_LongPress_Detected)
+CANAPI_SIM_SET(UInt8, CAN_BMS_PushButton_LongPress_Detected_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_PushButton_SuperLongPress_Detected)
+CANAPI_SIM_SET(UInt8, CAN_BMS_PushButton_SuperLongPress_Detected_Timeout)
+CANAPI_SIM_SET(Float32, CAN_BMS_PushButton_SuperLongPress_Ongoing)
+CANAPI_SIM_SET(UInt8, CAN_BMS_PushButton_SuperLongPress_Ongoing_Timeout)
+CANAPI_SIM_SET(Float32, CAN_Disp_Reset_Trip)
+CANAPI_SIM_SET(UInt8, CAN_Disp_Reset_Trip_Timeout)
+CANAPI_SIM_SET(Float32, CAN_Dyno_Torque)
+CANAPI_SIM_SET(UInt8, CAN_Dyno_Torque_Timeout)
+CANAPI_SIM_SET(Float32, CAN_Dyno_DC_Current)
+CANAPI_SIM_SET(UInt8, CAN_Dyno_DC_Current_Timeout)
+CANAPI_SIM_SET(Float32, CAN_Dyno_DC_Voltage)
+CANAPI_SIM_SET(UInt8, CAN_Dyno_DC_Voltage_Timeout)
+CANAPI_SIM_SET(Float32, CAN_Dyno_Elec_Power_Input)
+CANAPI_SIM_SET(UInt8, CAN_Dyno_Elec_Power_Input_Timeout)
+CANAPI_SIM_SET(UInt8, CAN_Custom_Timeout_Bit27)
+CANAPI_SIM_SET(UInt8, CAN_Custom_Timeout_Bit28)
+CANAPI_SIM_SET(UInt8, CAN_Custom_Timeout_Bit29)
+CANAPI_SIM_SET(UInt8, CAN_Custom_Timeout_Bit30)
+CANAPI_SIM_SET(UInt8, CAN_Custom_Timeout_Bit31)
@@ -0,0 +1,153 @@
+/**
+*******************************************************************************
+* @file canDelta_decoder.c
+* @brief Host decoder of the delta telemetry frames of CAN_delta.c
+* @author FRIWO
+* @date 20.10.2026 - 12:03:30
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup canDelta_decoder
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "canDelta_decoder.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief payload of a classic frame */
+#define FRAME_LENGTH 8u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void CheckSequence(canDeltaDecoder_TypeDef *decoder, uint8_t sequence);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Count lost frames and mark all valid signals stale on a gap in the sequence counter
+ */
+static void CheckSequence(canDeltaDecoder_TypeDef *decoder, uint8_t sequence)
+{
+	uint8_t lost = (uint8_t)((sequence - decoder->Sequence) & CAN_DELTA_SEQUENCE_MASK);
+	uint32_t i;
+
+	if (decoder->SequenceValid != 0u && lost != 0u)
+	{
+		decoder->LostFrames += lost;
+		for (i = 0; i < CANDELTA_SIGNALS; i++)
+		{
+			if (decoder->State[i] == CANDELTA_VALID)
+			{
+				decoder->State[i] = CANDELTA_STALE;
+			}
+		}
+	}
+	decoder->Sequence = (uint8_t)((sequence + 1u) & CAN_DELTA_SEQUENCE_MASK);
+	decoder->SequenceValid = 1;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void canDeltaDecoder_Init(canDeltaDecoder_TypeDef *decoder, canDeltaDecoder_FptrOnUpdate onUpdate, void *context)
+{
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->OnUpdate = onUpdate;
+	decoder->Context = context;
+}
+
+int canDeltaDecoder_Feed(canDeltaDecoder_TypeDef *decoder, const uint8_t *data, uint8_t dlc, uint32_t timestamp)
+{
+	uint8_t position = 1;
+	int tuples = 0;
+
+	if (dlc == 0u || dlc > FRAME_LENGTH)
+	{
+		decoder->Malformed++;
+		return -1;
+	}
+
+	CheckSequence(decoder, (uint8_t)(data[0] & CAN_DELTA_SEQUENCE_MASK));
+	decoder->Frames++;
+	if ((data[0] & CAN_DELTA_FLAG_KEYFRAME) != 0u)
+	{
+		decoder->KeyframeFrames++;
+	}
+
+	while (position < dlc)
+	{
+		uint8_t index = (uint8_t)(data[position] & CAN_DELTA_INDEX_MASK);
+		uint8_t format = (uint8_t)(data[position] >> CAN_DELTA_FORMAT_SHIFT);
+		uint8_t size = (format == CAN_DELTA_FORMAT_INT16 || format == CAN_DELTA_FORMAT_UINT16) ? 2u : 4u;
+		uint32_t value = 0;
+		int64_t raw;
+		uint8_t i;
+
+		if (position + 1u + size > dlc)
+		{
+			decoder->Malformed++;
+			return -1;
+		}
+		for (i = 0; i < size; i++)
+		{
+			value |= (uint32_t)data[position + 1u + i] << (8u * i);
+		}
+		switch (format)
+		{
+			case CAN_DELTA_FORMAT_INT16:
+				raw = (int16_t)value;
+				break;
+
+			case CAN_DELTA_FORMAT_INT32:
+				raw = (int32_t)value;
+				break;
+
+			default:
+				raw = value;
+				break;
+		}
+
+		decoder->Raw[index] = raw;
+		decoder->Timestamp[index] = timestamp;
+		decoder->State[index] = CANDELTA_VALID;
+		decoder->Tuples++;
+		tuples++;
+		if (decoder->OnUpdate != 0)
+		{
+			decoder->OnUpdate(decoder->Context, index, raw, timestamp);
+		}
+		position = (uint8_t)(position + 1u + size);
+	}
+	return tuples;
+}
+
+canDelta_State_TypeDef canDeltaDecoder_Get(const canDeltaDecoder_TypeDef *decoder, uint8_t index, int64_t *raw)
+{
+	if (index >= CANDELTA_SIGNALS)
+	{
+		return CANDELTA_UNKNOWN;
+	}
+	if (raw != 0)
+	{
+		*raw = decoder->Raw[index];
+	}
+	return (canDelta_State_TypeDef)decoder->State[index];
+}
+
+/** @} */
@@ -0,0 +1,123 @@
+/**
+*******************************************************************************
+* @file canDelta_decoder.h
+* @brief Host decoder of the delta telemetry frames of CAN_delta.c
+* @author FRIWO
+* @date 20.10.2026 - 12:03:30
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Rebuilds the signal values of the controller from the frames of
+* Delta_Telemetry_01 (0x3F1), see CAN_delta.h for the frame layout. The
+* decoder only needs the frames, not the configuration of the controller:
+* every tuple names its signal index and raw format. Physical values are
+* raw * Factor of signal_array in CAN_signals.c.
+*
+* A gap in the sequence counter marks every known signal stale, a stale
+* signal becomes valid again with its next tuple, at the latest with the next
+* keyframe. The decoder has no dynamic memory and no global state, so a fleet
+* logger runs one decoder per vehicle.
+*
+* Build together with a tool, e.g.
+* gcc -std=c99 -O2 -I../module_CAN -c canDelta_decoder.c
+*/
+
+#ifndef CANDELTA_DECODER_H_
+#define CANDELTA_DECODER_H_
+
+/**
+* @addtogroup canDelta_decoder
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <stdint.h>
+#include "CAN_delta.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of signal indices a tuple can address */
+#define CANDELTA_SIGNALS (CAN_DELTA_MAX_INDEX + 1u)
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief State of one signal in the decoder
+ */
+typedef enum
+{
+	CANDELTA_UNKNOWN = 0, /**< @brief never received */
+	CANDELTA_VALID = 1, /**< @brief received and no frame lost since */
+	CANDELTA_STALE = 2 /**< @brief received, but a frame was lost since, the value may be outdated */
+}canDelta_State_TypeDef;
+
+/**
+ * @brief Called for every decoded tuple
+ * @param context: pointer given to canDeltaDecoder_Init()
+ * @param index: signal index
+ * @param raw: raw value, sign extended for the signed formats
+ * @param timestamp: timestamp given to canDeltaDecoder_Feed()
+ */
+typedef void (*canDeltaDecoder_FptrOnUpdate)(void *context, uint8_t index, int64_t raw, uint32_t timestamp);
+
+/**
+ * @brief Decoder of one controller
+ */
+typedef struct
+{
+	int64_t Raw[CANDELTA_SIGNALS]; /**< @brief last raw value per signal index */
+	uint32_t Timestamp[CANDELTA_SIGNALS]; /**< @brief timestamp of the last update per signal index */
+	uint8_t State[CANDELTA_SIGNALS]; /**< @brief canDelta_State_TypeDef per signal index */
+	uint8_t Sequence; /**< @brief expected sequence counter of the next frame */
+	uint8_t SequenceValid; /**< @brief 0 until the first frame */
+	canDeltaDecoder_FptrOnUpdate OnUpdate; /**< @brief update callback, may be 0 */
+	void *Context; /**< @brief passed to OnUpdate */
+	uint32_t Frames; /**< @brief decoded frames */
+	uint32_t Tuples; /**< @brief decoded tuples */
+	uint32_t KeyframeFrames; /**< @brief frames with the keyframe flag */
+	uint32_t LostFrames; /**< @brief frames missing according to the sequence counter */
+	uint32_t Malformed; /**< @brief frames with a truncated tuple, the tuples before it are used */
+}canDeltaDecoder_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Reset a decoder, all signals become unknown
+ * @param decoder: decoder to reset
+ * @param onUpdate: called for every decoded tuple, may be 0
+ * @param context: passed to onUpdate
+ */
+void canDeltaDecoder_Init(canDeltaDecoder_TypeDef *decoder, canDeltaDecoder_FptrOnUpdate onUpdate, void *context);
+
+/**
+ * @brief Decode one frame of Delta_Telemetry_01
+ * @param decoder: decoder of the sending controller
+ * @param data: payload
+ * @param dlc: payload length 1...8
+ * @param timestamp: reception time in any unit, stored with the values
+ * @return number of decoded tuples, -1 if the frame is malformed
+ */
+int canDeltaDecoder_Feed(canDeltaDecoder_TypeDef *decoder, const uint8_t *data, uint8_t dlc, uint32_t timestamp);
+
+/**
+ * @brief Get the last value of a signal
+ * @param decoder: decoder of the sending controller
+ * @param index: signal index
+ * @param raw: target pointer for the raw value, may be 0
+ * @return canDelta_State_TypeDef of the signal
+ */
+canDelta_State_TypeDef canDeltaDecoder_Get(const canDeltaDecoder_TypeDef *decoder, uint8_t index, int64_t *raw);
+
+/** @} */
+
+#endif /* CANDELTA_DECODER_H_ */
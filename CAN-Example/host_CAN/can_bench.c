@@ -0,0 +1,689 @@
+/**
+*******************************************************************************
+* @file can_bench.c
+* @brief Microbenchmarks of the CAN module hot paths
+* @author FRIWO
+* @date 19.10.2026 - 16:40:55
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Includes CAN_custom.c to reach its private functions and measures the time
+* per call of GetMessageManagement(), HandleMessageTimeouts(), every receive
+* decoder of msgManagment_array, every send function of txSchedule_array,
+* CAN_RxIsrHook() with and without fast path and a full
+* canApi_UserPeriodicCallBack() at the timeslots 0, 10, 100 and 1000.
+* Each case is the median of BENCH_SAMPLES batches minus the call overhead
+* of an empty function. On the host the reception latency of 0x111 via the
+* fast path and via the polled path is simulated as well.
+* The case "calibration" times a fixed workload outside the module. It
+* tells how fast the host runs compared to the one of the baseline.
+*
+* Host build (time in ns):
+*   gcc -std=c99 -O2 -I../module_CAN -o can_bench can_bench.c canApi_sim.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_bench [-o result.json] [-c baseline.json] [-t tolerance_percent]
+*   With -c every case is compared to the baseline; the exit code is 1 if a
+*   case is slower than baseline * speed * (1 + tolerance) + BENCH_SLACK,
+*   speed being calibration / baseline calibration, or if the cases of the
+*   result and of the baseline differ.
+*   can_bench_baseline.json was recorded with -O2 on an x86-64 build host.
+*   A change of a hot path records a new one with -o in the same commit.
+*
+* Target build (time in CPU cycles of the DWT cycle counter):
+*   compile with -DCAN_BENCH_TARGET instead of CAN_custom.c, link against the
+*   firmware and call CAN_Bench_Run() once after the CAN init; the JSON
+*   result is written with printf.
+*/
+
+/**
+* @addtogroup can_bench
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#ifndef CAN_BENCH_TARGET
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* module under test, including its private functions */
+#include "CAN_custom.c"
+
+#ifndef CAN_BENCH_TARGET
+#include <time.h>
+#include "canApi_sim.h"
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of timed batches per case, the median is reported */
+#define BENCH_SAMPLES 101u
+
+/** @brief maximum number of benchmark cases */
+#define BENCH_MAX_CASES 96u
+
+/** @brief calls per batch for functions without side effects on the buffers */
+#define BENCH_CALLS 64u
+
+/** @brief calls per batch for the send functions, must fit into the transmit buffer */
+#define BENCH_CALLS_SEND 8u
+
+/** @brief calls per batch for the receive hook, must fit into the timestamp ring */
+#define BENCH_CALLS_ISR 16u
+
+/** @brief absolute tolerance for the baseline comparison, hides timer noise of very short cases */
+#define BENCH_SLACK 5.0
+
+/** @brief name of the case with the fixed workload, scales the baseline to the speed of the host */
+#define BENCH_CALIBRATION "calibration"
+
+/** @brief entries of the lookup table of the calibration workload */
+#define BENCH_CALIBRATION_ENTRIES 32u
+
+/** @brief number of calibration measurements spread over the run, the median is reported */
+#define BENCH_CALIBRATION_POINTS 5u
+
+#ifdef CAN_BENCH_TARGET
+/* DWT cycle counter of the Cortex-M core */
+#define BENCH_DEMCR (*(volatile uint32_t*)0xE000EDFCu)
+#define BENCH_DWT_CTRL (*(volatile uint32_t*)0xE0001000u)
+#define BENCH_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004u)
+#define BENCH_UNIT "cycles"
+#else
+#define BENCH_UNIT "ns"
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Function under test, called BENCH_CALLS times per batch */
+typedef void (*FptrBench)(uint32_t arg);
+
+/** @brief Function to restore the module state before each batch */
+typedef void (*FptrBenchReset)(uint32_t arg);
+
+/** @brief Result of one benchmark case */
+typedef struct
+{
+	char Name[48]; /**< @brief case name */
+	const char *Unit; /**< @brief unit of Value */
+	double Value; /**< @brief time per call or simulated latency */
+}benchCase_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static benchCase_TypeDef benchCase_array[BENCH_MAX_CASES];
+static unsigned benchCaseCount = 0;
+static double benchOverhead = 0.0;
+static canApi_MessageTypedef benchMessage;
+static volatile uint32_t benchSink = 0;
+static uint32_t benchCalibration_array[BENCH_CALIBRATION_ENTRIES];
+static double benchCalibrationSample_array[BENCH_CALIBRATION_POINTS];
+static unsigned benchCalibrationCount = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* time base */
+
+#ifdef CAN_BENCH_TARGET
+static void TimerInit(void)
+{
+	BENCH_DEMCR |= 0x01000000u; /* TRCENA */
+	BENCH_DWT_CYCCNT = 0;
+	BENCH_DWT_CTRL |= 0x00000001u; /* CYCCNTENA */
+}
+
+static uint32_t TimerNow(void)
+{
+	return BENCH_DWT_CYCCNT;
+}
+#else
+static void TimerInit(void)
+{
+}
+
+static uint32_t TimerNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+static int CompareDouble(const void *a, const void *b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Time a function in BENCH_SAMPLES batches
+ * @param fn: function under test
+ * @param reset: called before every batch outside the timed section, may be 0
+ * @param arg: argument for fn and reset
+ * @param calls: calls per batch
+ * @return median time per call minus the call overhead
+ */
+static double Measure(FptrBench fn, FptrBenchReset reset, uint32_t arg, uint32_t calls)
+{
+	static double sample[BENCH_SAMPLES];
+	uint32_t s;
+	uint32_t i;
+	double median;
+
+	for (s = 0; s < BENCH_SAMPLES; s++)
+	{
+		uint32_t start;
+
+		if (reset != 0)
+		{
+			reset(arg);
+		}
+		start = TimerNow();
+		for (i = 0; i < calls; i++)
+		{
+			fn(arg);
+		}
+		sample[s] = (double)(uint32_t)(TimerNow() - start) / calls;
+	}
+	qsort(sample, BENCH_SAMPLES, sizeof(double), CompareDouble);
+	median = sample[BENCH_SAMPLES / 2u] - benchOverhead;
+	return (median > 0.0) ? median : 0.0;
+}
+
+static void AddCase(const char *name, const char *unit, double value)
+{
+	if (benchCaseCount < BENCH_MAX_CASES)
+	{
+		snprintf(benchCase_array[benchCaseCount].Name, sizeof(benchCase_array[benchCaseCount].Name), "%s", name);
+		benchCase_array[benchCaseCount].Unit = unit;
+		benchCase_array[benchCaseCount].Value = value;
+		benchCaseCount++;
+	}
+}
+
+/* functions under test and their reset functions */
+
+static void BenchEmpty(uint32_t arg)
+{
+	benchSink += arg;
+}
+
+/**
+ * @brief Fixed workload which does not depend on the module: a linear search over a table
+ * and some bit operations, similar to the work of the message lookup and the encoders
+ */
+static void BenchCalibration(uint32_t arg)
+{
+	uint32_t value = arg;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_CALIBRATION_ENTRIES; i++)
+	{
+		if (benchCalibration_array[i] == value)
+		{
+			break;
+		}
+		value = (value << 3) ^ (value >> 5) ^ benchCalibration_array[i];
+	}
+	benchSink += value;
+}
+
+/**
+ * @brief Time the calibration workload once more; measured between the groups of cases,
+ * so that the median follows the load of the host during the whole run
+ */
+static void Calibrate(void)
+{
+	if (benchCalibrationCount < BENCH_CALIBRATION_POINTS)
+	{
+		benchCalibrationSample_array[benchCalibrationCount] = Measure(BenchCalibration, 0, 0, BENCH_CALLS);
+		benchCalibrationCount++;
+	}
+}
+
+static void BenchGetMessageManagement(uint32_t arg)
+{
+	benchMessage.Identifier = arg;
+	benchSink += (GetMessageManagement(&benchMessage) != 0);
+}
+
+static void ResetTimeouts(uint32_t arg)
+{
+	uint8_t i;
+
+	(void)arg;
+	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	{
+		canContext->MsgManagement[i].TimeoutCounter = canContext->MsgManagement[i].TimeoutReloadValue;
+	}
+}
+
+static void BenchHandleMessageTimeouts(uint32_t arg)
+{
+	(void)arg;
+	HandleMessageTimeouts();
+}
+
+static void BenchReceive(uint32_t arg)
+{
+	canContext->MsgManagement[arg].ReceiveFunction(&benchMessage);
+}
+
+static void ResetTransmit(uint32_t arg)
+{
+	(void)arg;
+	canApi_ClearTransmitBuffer();
+	canContext->TxCurrentEntry = TX_ENTRY_NONE;
+}
+
+static void BenchSend(uint32_t arg)
+{
+	canContext->TxSchedule[arg].SendFunction();
+}
+
+static void ResetRxIsrHook(uint32_t arg)
+{
+	canContext->RxTimestampHead = 0;
+	canContext->RxTimestampTail = 0;
+	canContext->FastPathCount = (uint8_t)arg;
+}
+
+static void BenchRxIsrHook(uint32_t arg)
+{
+	(void)arg;
+	CAN_RxIsrHook(&benchMessage);
+}
+
+static void ResetPeriodicCallBack(uint32_t arg)
+{
+	uint8_t i;
+
+	canApi_ClearTransmitBuffer();
+	canApi_ClearReceiveBuffer();
+	ResetTimeouts(0);
+	canContext->BusState = BUS_STATE_ACTIVE;
+	canContext->TxTimeslot = arg;
+	/* due in this slot: the messages whose interval divides it */
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		canContext->TxSchedule[i].NextSlot = (arg % canContext->TxSchedule[i].Interval == 0u) ? arg : arg + 1u;
+	}
+}
+
+static void BenchPeriodicCallBack(uint32_t arg)
+{
+	(void)arg;
+	canApi_UserPeriodicCallBack();
+}
+
+/**
+ * @brief Payload length expected by the receive decoder of a message
+ */
+static uint8_t DecoderDLC(uint32_t identifier)
+{
+	switch (identifier)
+	{
+		case 0x50C:
+			return 1u;
+		case 0x600:
+			return 4u;
+		default:
+			return 8u;
+	}
+}
+
+#ifndef CAN_BENCH_TARGET
+/* simulated reception latency of 0x111, host only */
+
+static uint32_t latencyReceiveUs = 0;
+static uint32_t latencySum = 0;
+static uint32_t latencyMax = 0;
+static uint32_t latencyCount = 0;
+
+static void OnLatencySet(const canApiSim_SignalTypeDef *signal, Float64 value, uint32_t timestamp)
+{
+	(void)value;
+	if (latencyReceiveUs != 0xFFFFFFFFu && strcmp(signal->Name, "CAN_EXT_Torque_Request") == 0)
+	{
+		uint32_t latency = timestamp - latencyReceiveUs;
+
+		latencySum += latency;
+		if (latency > latencyMax)
+		{
+			latencyMax = latency;
+		}
+		latencyCount++;
+		latencyReceiveUs = 0xFFFFFFFFu;
+	}
+}
+
+/**
+ * @brief Simulate 0x111 arriving at every microsecond offset within the 1ms tick
+ * @param fastPath: 1 to decode in the receive interrupt, 0 for the polled path
+ */
+static void MeasureLatency(uint8_t fastPath)
+{
+	canApi_MessageTypedef message = {0x111, 1, 0, 0, 8, {0}};
+	uint32_t offset;
+
+	canApiSim_Init();
+	if (fastPath == 0)
+	{
+		canContext->FastPathCount = 0;
+	}
+	canApiSim_SetSignalObserver(OnLatencySet);
+	latencyReceiveUs = 0xFFFFFFFFu;
+	latencySum = 0;
+	latencyMax = 0;
+	latencyCount = 0;
+	for (offset = 0; offset < 1000u; offset += 7u)
+	{
+		canApiSim_RunForUs(offset);
+		latencyReceiveUs = canApiSim_GetTimeUs();
+		(void)canApiSim_Receive(&message);
+		canApiSim_RunForUs(1000u - offset);
+	}
+	AddCase(fastPath ? "latency_0x111_fastpath_mean" : "latency_0x111_polled_mean", "us",
+		latencyCount ? (double)latencySum / latencyCount : 0.0);
+	AddCase(fastPath ? "latency_0x111_fastpath_max" : "latency_0x111_polled_max", "us", latencyMax);
+}
+
+/**
+ * @brief Find a case of the result by name
+ * @return index in benchCase_array, benchCaseCount if not found
+ */
+static unsigned FindCase(const char *name)
+{
+	unsigned k;
+
+	for (k = 0; k < benchCaseCount; k++)
+	{
+		if (strcmp(benchCase_array[k].Name, name) == 0)
+		{
+			break;
+		}
+	}
+	return k;
+}
+
+/**
+ * @brief Compare the results to a baseline written by an earlier run.
+ * The timed cases of the baseline are scaled by the ratio of the calibration cases, the simulated
+ * latencies are compared as they are. A case missing on either side counts as a regression,
+ * the baseline must be recorded again when cases are added or renamed.
+ * @return number of regressions, negative if the baseline cannot be read
+ */
+static int CompareBaseline(const char *path, double tolerance)
+{
+	static char baseName_array[BENCH_MAX_CASES][48];
+	static double baseValue_array[BENCH_MAX_CASES];
+	FILE *f = fopen(path, "r");
+	char line[256];
+	unsigned baseCount = 0;
+	unsigned calibration = FindCase(BENCH_CALIBRATION);
+	double speed = 1.0;
+	int regressions = 0;
+	unsigned b;
+	unsigned k;
+
+	if (f == 0)
+	{
+		fprintf(stderr, "can_bench: cannot open %s\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f) != 0 && baseCount < BENCH_MAX_CASES)
+	{
+		const char *valueField = strstr(line, "\"value\":");
+
+		if (sscanf(line, " {\"name\": \"%47[^\"]\"", baseName_array[baseCount]) == 1 && valueField != 0
+			&& sscanf(valueField, "\"value\": %lf", &baseValue_array[baseCount]) == 1)
+		{
+			baseCount++;
+		}
+	}
+	fclose(f);
+
+	for (b = 0; b < baseCount; b++)
+	{
+		if (strcmp(baseName_array[b], BENCH_CALIBRATION) == 0 && calibration < benchCaseCount && baseValue_array[b] > 0.0)
+		{
+			speed = benchCase_array[calibration].Value / baseValue_array[b];
+			fprintf(stderr, "can_bench: host speed %.2f of the baseline host\n", 1.0 / speed);
+		}
+	}
+	for (b = 0; b < baseCount; b++)
+	{
+		double limit;
+
+		k = FindCase(baseName_array[b]);
+		if (k == benchCaseCount)
+		{
+			fprintf(stderr, "can_bench: %s missing in the result\n", baseName_array[b]);
+			regressions++;
+			continue;
+		}
+		limit = baseValue_array[b];
+		if (strcmp(benchCase_array[k].Unit, BENCH_UNIT) == 0)
+		{
+			limit *= speed;
+		}
+		if (benchCase_array[k].Value > limit * (1.0 + tolerance / 100.0) + BENCH_SLACK)
+		{
+			fprintf(stderr, "can_bench: %s %.1f %s, baseline %.1f, scaled %.1f\n", benchCase_array[k].Name,
+				benchCase_array[k].Value, benchCase_array[k].Unit, baseValue_array[b], limit);
+			regressions++;
+		}
+	}
+	for (k = 0; k < benchCaseCount; k++)
+	{
+		for (b = 0; b < baseCount && strcmp(baseName_array[b], benchCase_array[k].Name) != 0; b++)
+		{
+		}
+		if (b == baseCount)
+		{
+			fprintf(stderr, "can_bench: %s missing in the baseline\n", benchCase_array[k].Name);
+			regressions++;
+		}
+	}
+	return regressions;
+}
+#endif
+
+static void PrintJson(FILE *f)
+{
+	unsigned k;
+
+	fprintf(f, "{\n\"unit\": \"%s\",\n\"cases\": [\n", BENCH_UNIT);
+	for (k = 0; k < benchCaseCount; k++)
+	{
+		fprintf(f, "  {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %.1f}%s\n", benchCase_array[k].Name,
+			benchCase_array[k].Unit, benchCase_array[k].Value, (k + 1u < benchCaseCount) ? "," : "");
+	}
+	fprintf(f, "]\n}\n");
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Run all benchmark cases, the results are kept in benchCase_array.
+ * On the target the module must be initialized, on the host the simulated canApi is initialized here.
+ */
+void CAN_Bench_Run(void)
+{
+	static const uint16_t timeslot_array[] = {0, 10, 100, 1000};
+	char name[48];
+	uint8_t fastPathRegistered;
+	UInt32 deltaEnable;
+	UInt32 muxInterval;
+	uint32_t i;
+
+	TimerInit();
+#ifndef CAN_BENCH_TARGET
+	canApiSim_Init();
+#endif
+	fastPathRegistered = canContext->FastPathCount;
+	benchCaseCount = 0;
+	benchOverhead = 0.0;
+	benchOverhead = Measure(BenchEmpty, 0, 0, BENCH_CALLS);
+
+	/* host speed reference, the table never contains the searched value */
+	for (i = 0; i < BENCH_CALIBRATION_ENTRIES; i++)
+	{
+		benchCalibration_array[i] = (i + 1u) * 0x9E3779B9u;
+	}
+	benchCalibrationCount = 0;
+	Calibrate();
+
+	/* message lookup: first entry, last entry and unknown identifier */
+	AddCase("GetMessageManagement_first", BENCH_UNIT,
+		Measure(BenchGetMessageManagement, 0, canContext->MsgManagement[0].CanIdentifier, BENCH_CALLS));
+	AddCase("GetMessageManagement_last", BENCH_UNIT,
+		Measure(BenchGetMessageManagement, 0, canContext->MsgManagement[COMMANDS_AVAILABLE - 1u].CanIdentifier, BENCH_CALLS));
+	AddCase("GetMessageManagement_miss", BENCH_UNIT, Measure(BenchGetMessageManagement, 0, 0x7FFu, BENCH_CALLS));
+
+	AddCase("HandleMessageTimeouts", BENCH_UNIT, Measure(BenchHandleMessageTimeouts, ResetTimeouts, 0, BENCH_CALLS));
+
+	/* receive decoders with a payload of the expected length */
+	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	{
+		memset(&benchMessage, 0, sizeof(benchMessage));
+		benchMessage.Identifier = canContext->MsgManagement[i].CanIdentifier;
+		benchMessage.IDE = canContext->MsgManagement[i].IDE;
+		benchMessage.DLC = DecoderDLC(benchMessage.Identifier);
+		snprintf(name, sizeof(name), "MessageReceive0x%03lX", (unsigned long)benchMessage.Identifier);
+		AddCase(name, BENCH_UNIT, Measure(BenchReceive, 0, i, BENCH_CALLS));
+	}
+	Calibrate();
+
+	/* send functions, named by the identifier they send; the messages which are off by default
+	   are switched on, otherwise they send nothing and have no identifier */
+	deltaEnable = CAN_C_Delta_Enable;
+	muxInterval = CAN_C_Mux_Page0_Interval;
+	CAN_C_Delta_Enable = 1;
+	CAN_C_Mux_Page0_Interval = 10;
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		ResetTransmit(0);
+		canContext->TxLatency[i].InFlight = 0;
+		canContext->TxCurrentEntry = (uint8_t)i;
+		canContext->TxSchedule[i].SendFunction();
+		canContext->TxCurrentEntry = TX_ENTRY_NONE;
+		canContext->TxLatency[i].InFlight = 0;
+		snprintf(name, sizeof(name), "MessageSend0x%03lX", (unsigned long)canContext->TxLatency[i].Identifier);
+		AddCase(name, BENCH_UNIT, Measure(BenchSend, ResetTransmit, i, BENCH_CALLS_SEND));
+	}
+	CAN_C_Delta_Enable = deltaEnable;
+	CAN_C_Mux_Page0_Interval = muxInterval;
+	Calibrate();
+
+	/* receive interrupt hook, timestamp only and with the 0x111 decoder on the fast path */
+	memset(&benchMessage, 0, sizeof(benchMessage));
+	benchMessage.Identifier = 0x111;
+	benchMessage.DLC = 8u;
+	AddCase("CAN_RxIsrHook", BENCH_UNIT, Measure(BenchRxIsrHook, ResetRxIsrHook, 0, BENCH_CALLS_ISR));
+	if (fastPathRegistered > 0)
+	{
+		AddCase("CAN_RxIsrHook_fastpath", BENCH_UNIT,
+			Measure(BenchRxIsrHook, ResetRxIsrHook, fastPathRegistered, BENCH_CALLS_ISR));
+	}
+	ResetRxIsrHook(fastPathRegistered);
+	Calibrate();
+
+	/* full 1ms callback with an empty receive buffer */
+	for (i = 0; i < sizeof(timeslot_array) / sizeof(timeslot_array[0]); i++)
+	{
+		snprintf(name, sizeof(name), "canApi_UserPeriodicCallBack_slot%u", timeslot_array[i]);
+		AddCase(name, BENCH_UNIT, Measure(BenchPeriodicCallBack, ResetPeriodicCallBack, timeslot_array[i], 1));
+	}
+	ResetPeriodicCallBack(0);
+	Calibrate();
+	qsort(benchCalibrationSample_array, benchCalibrationCount, sizeof(double), CompareDouble);
+	AddCase(BENCH_CALIBRATION, BENCH_UNIT, benchCalibrationSample_array[benchCalibrationCount / 2u]);
+
+#ifndef CAN_BENCH_TARGET
+	MeasureLatency(0);
+	MeasureLatency(1);
+#else
+	PrintJson(stdout);
+#endif
+}
+
+#ifndef CAN_BENCH_TARGET
+int main(int argc, char **argv)
+{
+	const char *outPath = 0;
+	const char *basePath = 0;
+	double tolerance = 30.0;
+	int regressions = 0;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			outPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			basePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			tolerance = strtod(argv[++i], 0);
+		}
+		else
+		{
+			fprintf(stderr, "usage: can_bench [-o result.json] [-c baseline.json] [-t tolerance_percent]\n");
+			return 2;
+		}
+	}
+
+	CAN_Bench_Run();
+
+	if (outPath != 0)
+	{
+		FILE *f = fopen(outPath, "w");
+
+		if (f == 0)
+		{
+			fprintf(stderr, "can_bench: cannot write %s\n", outPath);
+			return 2;
+		}
+		PrintJson(f);
+		fclose(f);
+	}
+	else
+	{
+		PrintJson(stdout);
+	}
+	if (basePath != 0)
+	{
+		regressions = CompareBaseline(basePath, tolerance);
+		if (regressions < 0)
+		{
+			return 2;
+		}
+	}
+	return (regressions > 0) ? 1 : 0;
+}
+#endif
+
+/** @} */
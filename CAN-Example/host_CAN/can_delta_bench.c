@@ -0,0 +1,501 @@
+/**
+*******************************************************************************
+* @file can_delta_bench.c
+* @brief Host tool: bus load and decoder throughput of the delta telemetry 0x3F1
+* @author FRIWO
+* @date 20.10.2026 - 13:12:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Runs the CAN module with CAN_C_Delta_Enable = 1 and the default signal set
+* against a synthetic ride: stop and go with speed, currents and torque,
+* a DC link voltage with noise, slowly rising temperatures, counting ODO and
+* Ah and a falling SOC. Every frame of 0x3F1 is decoded live with
+* canDelta_decoder.c and after every tick each decoded signal is compared with
+* the raw value the module reads. A signal may be outside its deadband only
+* until the round robin of CAN_delta.c reached it, which takes at most
+* CAN_DELTA_SLOTS frames.
+*
+* Reported are the frames and tuples per second, the bus load of 0x3F1 at
+* 500 kbit/s and the bus load of the same signals sent in full every 10ms.
+* Then the captured frames are decoded again and again to measure the decoder
+* throughput. The bus time is counted without dynamic stuff bits.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_delta_bench can_delta_bench.c canDelta_decoder.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_delta_bench [-t duration_s] [-f frames_per_slot] [-n decode_repetitions]
+*
+* The exit code is 0 if every signal followed its source, 1 otherwise and 2 on
+* usage errors.
+*/
+
+/**
+* @addtogroup can_delta_bench
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+#include "CAN_signals.h"
+#include "canDelta_decoder.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief identifier of Delta_Telemetry_01 */
+#define DELTA_ID 0x3F1u
+
+/** @brief period of the 0x3F1 slot [ms] */
+#define DELTA_SLOT_MS 10u
+
+/** @brief bit rate for the bus load [bit/s] */
+#define BENCH_BITRATE 500000.0
+
+/** @brief length of one stop and go cycle of the ride [ms] */
+#define RIDE_CYCLE_MS 60000u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief One captured frame of 0x3F1
+ */
+typedef struct
+{
+	uint8_t DLC; /**< @brief payload length */
+	uint8_t Data[8]; /**< @brief payload */
+	uint32_t Timestamp; /**< @brief transmit time [us] */
+}benchFrame_TypeDef;
+
+/**
+ * @brief Comparison of one slot of the set with its source
+ */
+typedef struct
+{
+	uint8_t Index; /**< @brief signal index, 0xFF if the slot is empty */
+	uint8_t Deadband; /**< @brief deadband of the slot [raw LSB] */
+	uint32_t Tuples; /**< @brief decoded tuples of this signal */
+	uint32_t OutsideMs; /**< @brief time the decoded value is currently outside the deadband [ms] */
+	uint32_t MaxOutsideMs; /**< @brief longest time outside the deadband [ms] */
+}benchSlot_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static canDeltaDecoder_TypeDef decoder; /* live decoder */
+static benchSlot_TypeDef slot_array[CAN_DELTA_SLOTS];
+static benchFrame_TypeDef *frame_array = 0; /* captured frames for the replay */
+static uint32_t frameCount = 0;
+static uint32_t frameCapacity = 0;
+static double busBits = 0; /* bus bits of 0x3F1 */
+static uint8_t captureFailed = 0; /* 1 if a frame could not be stored */
+static uint32_t randomState = 12345u; /* noise of the DC link voltage */
+
+/* EnableTool variables of CAN_custom.c */
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Enable;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_FramesPerSlot;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals0;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals1;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals2;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals3;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband0;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband1;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband2;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband3;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static double WallSeconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_delta_bench [-t duration_s] [-f frames_per_slot] [-n decode_repetitions]\n");
+}
+
+/**
+ * @brief Bus bits of a classic frame without dynamic stuff bits
+ */
+static double FrameBits(uint8_t ide, uint8_t dlc)
+{
+	return (double)((ide != 0u) ? 67u : 47u) + 8.0 * dlc;
+}
+
+/**
+ * @brief Uniform noise in -1...1
+ */
+static double Noise(void)
+{
+	randomState = randomState * 1103515245u + 12345u;
+	return (double)((randomState >> 16) & 0x7FFFu) / 16383.5 - 1.0;
+}
+
+/**
+ * @brief Read the signal set of the NV variables like CAN_custom.c does
+ */
+static void LoadSlots(void)
+{
+	const UInt32 signals_array[CAN_DELTA_SLOTS / 4u] =
+	{
+		CAN_C_Delta_Signals0, CAN_C_Delta_Signals1, CAN_C_Delta_Signals2, CAN_C_Delta_Signals3
+	};
+	const UInt32 deadband_array[CAN_DELTA_SLOTS / 4u] =
+	{
+		CAN_C_Delta_Deadband0, CAN_C_Delta_Deadband1, CAN_C_Delta_Deadband2, CAN_C_Delta_Deadband3
+	};
+	uint32_t i;
+
+	for (i = 0; i < CAN_DELTA_SLOTS; i++)
+	{
+		uint8_t shift = (uint8_t)(8u * (i % 4u));
+		uint8_t index = (uint8_t)(signals_array[i / 4u] >> shift);
+
+		memset(&slot_array[i], 0, sizeof(slot_array[i]));
+		slot_array[i].Index = (CAN_Signals_Get(index) != 0) ? index : 0xFFu;
+		slot_array[i].Deadband = (uint8_t)(deadband_array[i / 4u] >> shift);
+	}
+}
+
+/**
+ * @brief Set the inputs of the synthetic ride at time t
+ * @param t: simulated time [ms]
+ */
+static void SetRide(uint32_t t)
+{
+	double cycle = (double)(t % RIDE_CYCLE_MS) / 1000.0;
+	double speed; /* [km/h] */
+	double accel; /* [km/h/s] */
+	double current; /* [A] */
+
+	/* 10s acceleration to 25km/h, 35s cruise, 8s braking, 7s stop */
+	if (cycle < 10.0)
+	{
+		accel = 2.5;
+		speed = accel * cycle;
+	}
+	else if (cycle < 45.0)
+	{
+		accel = 0.0;
+		speed = 25.0;
+	}
+	else if (cycle < 53.0)
+	{
+		accel = -25.0 / 8.0;
+		speed = 25.0 + accel * (cycle - 45.0);
+	}
+	else
+	{
+		accel = 0.0;
+		speed = 0.0;
+	}
+	current = (speed > 0.0) ? 2.0 + 0.06 * speed + 4.0 * accel : 0.0;
+
+	canApiSim_INFO_Vehicle_Speed = (Float32)speed;
+	canApiSim_INFO_Rotor_Speed = (Float32)(speed * 160.0);
+	canApiSim_INFO_Motor_Current_Iq = (Float32)(current * 2.5);
+	canApiSim_INFO_DC_Current = (Float32)current;
+	canApiSim_INFO_Rel_Torque_Setpoint = (Float32)((accel > 0.0) ? 80.0 : (speed > 0.0) ? 20.0 : 0.0);
+	canApiSim_INFO_Voltage_DC_Link = (Float32)(48.0 - 0.05 * current + 0.02 * Noise());
+
+	/* integrators with the 1ms step */
+	canApiSim_INFO_ODO_Total_Kilometers += (Float32)(speed / 3600000.0);
+	if (current > 0.0)
+	{
+		canApiSim_INFO_Ah_Pos += (Float32)(current / 3600000.0);
+	}
+	else
+	{
+		canApiSim_INFO_Ah_Neg += (Float32)(-current / 3600000.0);
+	}
+	canApiSim_SOC_State_of_Charge = (Float32)(100.0 - 100.0 * canApiSim_INFO_Ah_Pos / 14.0);
+
+	canApiSim_TEMP_FET_Max = (Float32)(25.0 + 0.0005 * t / 1000.0 * current);
+	canApiSim_TEMP_Motor = (Float32)(25.0 + 0.0004 * t / 1000.0 * current);
+	canApiSim_TEMP_MCU = (Float32)(25.0 + 0.01 * t / 1000.0);
+	canApiSim_APP_Boost_Avail_Rel = (Float32)((accel > 0.0) ? 100.0 - 8.0 * cycle : 100.0);
+}
+
+/**
+ * @brief Store and decode a frame of 0x3F1
+ */
+static void OnTransmit(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	if (message->Identifier != DELTA_ID || message->IDE != 0u)
+	{
+		return;
+	}
+
+	busBits += FrameBits(message->IDE, message->DLC);
+	(void)canDeltaDecoder_Feed(&decoder, message->Data, message->DLC, timestamp);
+
+	if (frameCount == frameCapacity)
+	{
+		uint32_t capacity = (frameCapacity == 0u) ? 4096u : 2u * frameCapacity;
+		benchFrame_TypeDef *grown = realloc(frame_array, capacity * sizeof(benchFrame_TypeDef));
+
+		if (grown == 0)
+		{
+			captureFailed = 1;
+			return;
+		}
+		frame_array = grown;
+		frameCapacity = capacity;
+	}
+	frame_array[frameCount].DLC = message->DLC;
+	memcpy(frame_array[frameCount].Data, message->Data, sizeof(frame_array[frameCount].Data));
+	frame_array[frameCount].Timestamp = timestamp;
+	frameCount++;
+}
+
+/**
+ * @brief Count the decoded tuples per signal
+ */
+static void OnUpdate(void *context, uint8_t index, int64_t raw, uint32_t timestamp)
+{
+	uint32_t i;
+
+	(void)context;
+	(void)raw;
+	(void)timestamp;
+	for (i = 0; i < CAN_DELTA_SLOTS; i++)
+	{
+		if (slot_array[i].Index == index)
+		{
+			slot_array[i].Tuples++;
+		}
+	}
+}
+
+/**
+ * @brief Compare every decoded signal with the value the module reads now
+ */
+static void CompareSlots(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < CAN_DELTA_SLOTS; i++)
+	{
+		benchSlot_TypeDef *slot = &slot_array[i];
+		const CAN_Signal_TypeDef *signal;
+		uint32_t truth;
+		int64_t expected;
+		int64_t decoded;
+		int64_t difference;
+
+		if (slot->Index == 0xFFu)
+		{
+			continue;
+		}
+		signal = CAN_Signals_Get(slot->Index);
+		(void)CAN_Signals_GetRaw(slot->Index, &truth);
+		if (signal->GetUInt32 != 0)
+		{
+			expected = (signal->Size == 2u) ? (int64_t)(truth & 0xFFFFu) : (int64_t)truth;
+		}
+		else
+		{
+			expected = (signal->Size == 2u) ? (int64_t)(int16_t)truth : (int64_t)(int32_t)truth;
+		}
+
+		if (canDeltaDecoder_Get(&decoder, slot->Index, &decoded) == CANDELTA_UNKNOWN)
+		{
+			difference = -1;
+		}
+		else
+		{
+			difference = (decoded > expected) ? decoded - expected : expected - decoded;
+		}
+		if (difference < 0 || difference > slot->Deadband)
+		{
+			slot->OutsideMs++;
+			if (slot->OutsideMs > slot->MaxOutsideMs)
+			{
+				slot->MaxOutsideMs = slot->OutsideMs;
+			}
+		}
+		else
+		{
+			slot->OutsideMs = 0;
+		}
+	}
+}
+
+/**
+ * @brief Bus bits per 10ms if every signal of the set was sent in full, packed into frames of 8 bytes
+ */
+static double FullBitsPerSlot(void)
+{
+	double bits = 0;
+	uint8_t used = 0;
+	uint32_t i;
+
+	for (i = 0; i < CAN_DELTA_SLOTS; i++)
+	{
+		const CAN_Signal_TypeDef *signal = (slot_array[i].Index != 0xFFu) ? CAN_Signals_Get(slot_array[i].Index) : 0;
+
+		if (signal == 0)
+		{
+			continue;
+		}
+		if (used + signal->Size > 8u)
+		{
+			bits += FrameBits(0, used);
+			used = 0;
+		}
+		used = (uint8_t)(used + signal->Size);
+	}
+	if (used > 0u)
+	{
+		bits += FrameBits(0, used);
+	}
+	return bits;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	unsigned long seconds = 600;
+	unsigned long framesPerSlot = 1;
+	unsigned long repetitions = 200;
+	uint32_t duration;
+	uint32_t limitMs;
+	uint32_t tuples = 0;
+	double deltaLoad;
+	double fullLoad;
+	double wall;
+	uint32_t t;
+	uint32_t i;
+	int failed = 0;
+
+	for (i = 1; i < (uint32_t)argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1u < (uint32_t)argc)
+		{
+			seconds = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-f") == 0 && i + 1u < (uint32_t)argc)
+		{
+			framesPerSlot = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1u < (uint32_t)argc)
+		{
+			repetitions = strtoul(argv[++i], 0, 0);
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (seconds == 0u || seconds > 86400u || framesPerSlot < 1u || framesPerSlot > 4u || repetitions == 0u)
+	{
+		PrintUsage();
+		return 2;
+	}
+	duration = (uint32_t)seconds * 1000u;
+
+	canApiSim_Init();
+	canApiSim_SetTransmitObserver(OnTransmit);
+	CAN_C_Delta_Enable = 1;
+	CAN_C_Delta_FramesPerSlot = (UInt32)framesPerSlot;
+	LoadSlots();
+	canDeltaDecoder_Init(&decoder, OnUpdate, 0);
+
+	/* every frame serves at least one marked slot, so the round robin reaches each slot within CAN_DELTA_SLOTS frames */
+	limitMs = ((CAN_DELTA_SLOTS + (uint32_t)framesPerSlot - 1u) / (uint32_t)framesPerSlot + 1u) * DELTA_SLOT_MS;
+
+	wall = WallSeconds();
+	for (t = 0; t < duration; t++)
+	{
+		SetRide(t);
+		canApiSim_Tick(1);
+		CompareSlots();
+	}
+	wall = WallSeconds() - wall;
+	if (captureFailed != 0u)
+	{
+		fprintf(stderr, "can_delta_bench: out of memory for the captured frames\n");
+		return 2;
+	}
+
+	printf("%lu s simulated in %.3f s, %lu frames per slot\n", seconds, wall, framesPerSlot);
+	printf("index name                                   deadband  tuples/s  max outside [ms]\n");
+	for (i = 0; i < CAN_DELTA_SLOTS; i++)
+	{
+		const benchSlot_TypeDef *slot = &slot_array[i];
+
+		if (slot->Index == 0xFFu)
+		{
+			continue;
+		}
+		tuples += slot->Tuples;
+		printf("%5u %-38s %8u  %8.2f  %6lu%s\n", slot->Index, CAN_Signals_Get(slot->Index)->Name, slot->Deadband,
+			(double)slot->Tuples / seconds, (unsigned long)slot->MaxOutsideMs,
+			(slot->MaxOutsideMs > limitMs) ? "  FAIL" : "");
+		if (slot->MaxOutsideMs > limitMs)
+		{
+			failed = 1;
+		}
+	}
+
+	deltaLoad = busBits / seconds;
+	fullLoad = FullBitsPerSlot() * (1000.0 / DELTA_SLOT_MS);
+	printf("0x%03X: %.1f frames/s, %.1f tuples/s, %.1f tuples/frame, %lu keyframe frames, %lu lost\n",
+		DELTA_ID, (double)frameCount / seconds, (double)tuples / seconds,
+		(frameCount > 0u) ? (double)tuples / frameCount : 0.0,
+		(unsigned long)decoder.KeyframeFrames, (unsigned long)decoder.LostFrames);
+	printf("bus load %.0f bit/s = %.2f %% of 500 kbit/s, every signal every %u ms: %.0f bit/s = %.2f %%, saved %.1f %%\n",
+		deltaLoad, 100.0 * deltaLoad / BENCH_BITRATE, DELTA_SLOT_MS, fullLoad, 100.0 * fullLoad / BENCH_BITRATE,
+		(fullLoad > 0.0) ? 100.0 * (1.0 - deltaLoad / fullLoad) : 0.0);
+	printf("signals outside their deadband longer than %lu ms: %s\n", (unsigned long)limitMs, (failed != 0) ? "yes" : "none");
+
+	/* decoder throughput, the decoder is reset for each pass so every pass sees the same sequence */
+	if (frameCount > 0u)
+	{
+		canDeltaDecoder_TypeDef replay;
+		unsigned long pass;
+		uint32_t decoded = 0;
+
+		wall = WallSeconds();
+		for (pass = 0; pass < repetitions; pass++)
+		{
+			canDeltaDecoder_Init(&replay, 0, 0);
+			for (i = 0; i < frameCount; i++)
+			{
+				(void)canDeltaDecoder_Feed(&replay, frame_array[i].Data, frame_array[i].DLC, frame_array[i].Timestamp);
+			}
+			decoded += replay.Tuples;
+		}
+		wall = WallSeconds() - wall;
+		printf("decoder: %lu frames in %.3f s, %.1f ns/frame, %.2f Mframes/s, %.2f Mtuples/s\n",
+			(unsigned long)frameCount * repetitions, wall, 1e9 * wall / ((double)frameCount * repetitions),
+			(double)frameCount * repetitions / wall / 1e6, (double)decoded / wall / 1e6);
+	}
+
+	free(frame_array);
+	return failed;
+}
+
+/** @} */
@@ -0,0 +1,849 @@
+/**
+*******************************************************************************
+* @file can_download.c
+* @brief Host tool: throughput of the UDS block download into a simulated flash
+* @author FRIWO
+* @date 20.10.2026 - 16:02:18
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Runs CAN_custom.c with its periodic traffic and a service tester on one
+* simulated bus and downloads a random image with RequestDownload,
+* TransferData and RequestTransferExit of CAN_uds.c.
+*
+* Flash backend: this file provides CAN_Uds_FlashErase(), CAN_Uds_FlashWrite()
+* and CAN_Uds_FlashGetState() for a flash of FLASH_SIZE bytes at FLASH_BASE
+* with pages of FLASH_PAGE_SIZE bytes. An erase takes -e ms per page, a write
+* -w us per halfword, both in simulated time. A write copies the block from
+* the buffer of the module only when it completes, so a module which reuses
+* the buffer too early corrupts the image and fails the verification.
+*
+* Tester: one mailbox, sends the ISO-TP frames as the flow control of the
+* module allows and waits for each response, responsePending included. Every
+* block carries the CRC-32 of its data; -c n corrupts the first transmission
+* of every n-th block, which is then sent again after transferDataSuspended.
+*
+* Bus model: arbitration between the module and the tester whenever the bus
+* turns idle, frame length bit by bit with the stuff bits of the actual frame,
+* as can_netsim.c. Time advances from event to event.
+*
+* Reported are the download time, throughput and bus load, in total and
+* after the erase, the throughput the tester's frames alone would reach back
+* to back on the bus, the time the flash was busy and the number of requests
+* which had to wait for the flash.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_download can_download.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_download [-s size_kB] [-a address] [-b bitrate] [-e erase_ms_per_page] [-w write_us_per_halfword] [-c corrupt_every_n]
+*
+* The exit code is 0 if the image was downloaded and verified, 1 otherwise and
+* 2 on usage errors.
+*/
+
+/**
+* @addtogroup can_download
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+#include "CAN_uds.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief simulated flash */
+#define FLASH_BASE 0x08000000u
+#define FLASH_SIZE (512u * 1024u)
+#define FLASH_PAGE_SIZE 2048u
+
+/** @brief bits after the CRC: CRC delimiter, ACK slot, ACK delimiter, 7 EOF and 3 intermission */
+#define DL_TRAILER_BITS 13u
+
+/** @brief no time */
+#define DL_NEVER UINT64_MAX
+
+/** @brief one millisecond in the time base of the simulation [ns] */
+#define DL_MS 1000000u
+
+/** @brief P2*server: the tester gives up if a response takes longer [ms] */
+#define DL_RESPONSE_TIMEOUT_MS 5000u
+
+/** @brief largest request of the tester, the tester sends only first frames with 12 bit length [byte] */
+#define DL_MAX_REQUEST 4095u
+
+/** @brief ISO-TP protocol control information */
+#define PCI_SINGLE 0x0u
+#define PCI_FIRST 0x1u
+#define PCI_CONSECUTIVE 0x2u
+#define PCI_FLOW_CONTROL 0x3u
+
+/** @brief flow status of a flow control frame */
+#define FLOW_CONTINUE 0x0u
+#define FLOW_WAIT 0x1u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Step of the tester */
+typedef enum
+{
+	STEP_REQUEST_DOWNLOAD, /**< @brief RequestDownload sent or to be sent */
+	STEP_TRANSFER, /**< @brief TransferData of the current block */
+	STEP_EXIT, /**< @brief RequestTransferExit */
+	STEP_DONE, /**< @brief positive response to RequestTransferExit */
+	STEP_FAILED /**< @brief negative response or timeout */
+}dlStep_TypeDef;
+
+/** @brief Phase of the ISO-TP transmission of the tester */
+typedef enum
+{
+	TX_IDLE, /**< @brief nothing to send, waiting for the response */
+	TX_SEND, /**< @brief next frame goes into the mailbox at ReadyNs */
+	TX_WAIT_FLOW /**< @brief first frame or block sent, waiting for the flow control */
+}dlTxPhase_TypeDef;
+
+/** @brief Simulated flash with one running operation */
+typedef struct
+{
+	uint8_t Memory[FLASH_SIZE]; /**< @brief content */
+	CAN_Uds_FlashState_TypeDef State; /**< @brief state reported to the module */
+	uint64_t BusyUntilUs; /**< @brief end of the running operation */
+	uint64_t BusyUs; /**< @brief sum of the operation times */
+	const uint8_t *Source; /**< @brief block of the running write, read at its end */
+	uint32_t Offset; /**< @brief target offset of the running write */
+	uint32_t Length; /**< @brief length of the running write, 0 for an erase */
+}dlFlash_TypeDef;
+
+/** @brief ISO-TP sender and UDS client of the tester */
+typedef struct
+{
+	uint8_t Step; /**< @brief dlStep_TypeDef */
+	uint8_t TxPhase; /**< @brief dlTxPhase_TypeDef */
+	uint8_t Request[DL_MAX_REQUEST]; /**< @brief request being sent */
+	uint32_t Length; /**< @brief request length */
+	uint32_t Offset; /**< @brief bytes of the request sent */
+	uint8_t Sequence; /**< @brief ISO-TP sequence number of the next consecutive frame */
+	uint8_t BlockLeft; /**< @brief consecutive frames until the next flow control, 0 = all */
+	uint8_t BlockSize; /**< @brief block size of the last flow control */
+	uint64_t SeparationNs; /**< @brief STmin of the last flow control */
+	uint64_t ReadyNs; /**< @brief earliest time of the next frame */
+	uint64_t TimeoutNs; /**< @brief end of the response wait */
+	uint64_t TransferNs; /**< @brief time of the positive response to RequestDownload, after the erase */
+	uint32_t BlockData; /**< @brief data bytes per TransferData from maxNumberOfBlockLength */
+	uint32_t Position; /**< @brief image bytes acknowledged */
+	uint8_t BlockSequence; /**< @brief blockSequenceCounter of the current block */
+	uint32_t BlockCount; /**< @brief blocks sent for the first time */
+	uint8_t Corrupted; /**< @brief 1 if the current transmission carries a damaged block */
+	uint32_t Repeated; /**< @brief blocks sent again after transferDataSuspended */
+	uint32_t Pending; /**< @brief responsePending received */
+	uint32_t EcuCrc; /**< @brief CRC-32 reported by RequestTransferExit */
+}dlTester_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static dlFlash_TypeDef flash;
+static dlTester_TypeDef tester;
+
+static uint8_t *image = 0;
+static uint32_t imageSize = 128u * 1024u;
+static uint32_t imageAddress = 0x08010000u;
+static uint32_t corruptEvery = 0;
+static uint64_t eraseUsPerPage = 20000u;
+static uint64_t writeUsPerHalfword = 50u;
+
+/** @brief simulated time [ns] */
+static uint64_t nowNs = 0;
+
+/* EnableTool variable of CAN_custom.c */
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Uds_Enable;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static double WallSeconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_download [-s size_kB] [-a address] [-b bitrate] [-e erase_ms_per_page] [-w write_us_per_halfword] [-c corrupt_every_n]\n");
+}
+
+/**
+ * @brief CRC-32 (IEEE 802.3) bit by bit, independent of the table in CAN_uds.c
+ */
+static uint32_t Crc32(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFFu;
+	uint32_t i;
+	int b;
+
+	for (i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for (b = 0; b < 8; b++)
+		{
+			crc = (crc >> 1) ^ ((crc & 1u) != 0u ? 0xEDB88320u : 0u);
+		}
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+/** @brief Write a value in Motorola byte order */
+static void PutUInt32(uint8_t *target, uint32_t value)
+{
+	target[0] = (uint8_t)(value >> 24);
+	target[1] = (uint8_t)(value >> 16);
+	target[2] = (uint8_t)(value >> 8);
+	target[3] = (uint8_t)value;
+}
+
+/**
+ * @brief Arbitration field as one number, a lower value wins the arbitration, as can_netsim.c
+ */
+static uint32_t ArbitrationKey(const canApi_MessageTypedef *message)
+{
+	if (message->IDE == 0u)
+	{
+		return ((message->Identifier & 0x7FFu) << 21) | ((uint32_t)(message->RTR != 0u) << 20);
+	}
+	return (((message->Identifier >> 18) & 0x7FFu) << 21) | (1u << 20) | (1u << 19)
+		| ((message->Identifier & 0x3FFFFu) << 1) | (uint32_t)(message->RTR != 0u);
+}
+
+/**
+ * @brief Number of bits of a classic CAN frame on the bus including its stuff bits, as can_netsim.c
+ * @return bits from SOF to the end of the intermission
+ */
+static uint32_t FrameBits(const canApi_MessageTypedef *message)
+{
+	uint8_t bits[160];
+	uint32_t n = 0;
+	uint32_t i;
+	uint32_t crc = 0;
+	uint32_t stuffed;
+	uint32_t run;
+	uint8_t dlc = (message->DLC > 8u) ? 8u : message->DLC;
+	uint8_t dataBytes = (message->RTR != 0u) ? 0u : dlc;
+	int b;
+
+#define DL_PUT(value, width) for (b = (int)(width) - 1; b >= 0; b--) { bits[n++] = (uint8_t)(((value) >> b) & 1u); }
+	DL_PUT(0u, 1);
+	if (message->IDE == 0u)
+	{
+		DL_PUT(message->Identifier & 0x7FFu, 11);
+		DL_PUT((uint32_t)(message->RTR != 0u), 1);
+		DL_PUT(0u, 2); /* IDE, r0 */
+	}
+	else
+	{
+		DL_PUT((message->Identifier >> 18) & 0x7FFu, 11);
+		DL_PUT(3u, 2); /* SRR, IDE */
+		DL_PUT(message->Identifier & 0x3FFFFu, 18);
+		DL_PUT((uint32_t)(message->RTR != 0u), 1);
+		DL_PUT(0u, 2); /* r1, r0 */
+	}
+	DL_PUT(dlc, 4);
+	for (i = 0; i < dataBytes; i++)
+	{
+		DL_PUT(message->Data[i], 8);
+	}
+	for (i = 0; i < n; i++)
+	{
+		uint32_t next = ((crc >> 14) & 1u) ^ bits[i];
+
+		crc = (crc << 1) & 0x7FFFu;
+		if (next != 0u)
+		{
+			crc ^= 0x4599u;
+		}
+	}
+	DL_PUT(crc, 15);
+#undef DL_PUT
+
+	stuffed = 0;
+	run = 1;
+	for (i = 1; i < n; i++)
+	{
+		if (bits[i] == bits[i - 1u] && run < 5u)
+		{
+			run++;
+		}
+		else if (run == 5u)
+		{
+			stuffed++;
+			run = (bits[i] == bits[i - 1u]) ? 1u : 2u;
+		}
+		else
+		{
+			run = 1;
+		}
+	}
+	if (run == 5u)
+	{
+		stuffed++;
+	}
+	return n + stuffed + DL_TRAILER_BITS;
+}
+
+/**
+ * @brief End the running flash operation if its time is over, a write copies its block now
+ */
+static void FlashPoll(void)
+{
+	uint32_t i;
+
+	if (flash.State != CAN_UDS_FLASH_BUSY || canApiSim_GetTimeUs() < flash.BusyUntilUs)
+	{
+		return;
+	}
+	flash.State = CAN_UDS_FLASH_IDLE;
+	for (i = 0; i < flash.Length; i++)
+	{
+		/* flash cells only change from 1 to 0 */
+		if (flash.Memory[flash.Offset + i] != 0xFFu)
+		{
+			flash.State = CAN_UDS_FLASH_ERROR;
+		}
+		flash.Memory[flash.Offset + i] = flash.Source[i];
+	}
+	flash.Length = 0;
+}
+
+/**
+ * @brief Start an operation of the given duration
+ */
+static void FlashStart(uint64_t durationUs)
+{
+	flash.State = CAN_UDS_FLASH_BUSY;
+	flash.BusyUntilUs = canApiSim_GetTimeUs() + durationUs;
+	flash.BusyUs += durationUs;
+}
+
+/**
+ * @brief Convert STmin of a flow control to ns, reserved values count as 127ms
+ */
+static uint64_t SeparationNs(uint8_t stMin)
+{
+	if (stMin <= 0x7Fu)
+	{
+		return (uint64_t)stMin * DL_MS;
+	}
+	if (stMin >= 0xF1u && stMin <= 0xF9u)
+	{
+		return (uint64_t)(stMin - 0xF0u) * 100000u;
+	}
+	return 127u * DL_MS;
+}
+
+/**
+ * @brief Start the transmission of a request, the response wait starts after its last frame
+ */
+static void SendRequest(uint32_t length)
+{
+	tester.Length = length;
+	tester.Offset = 0;
+	tester.TxPhase = TX_SEND;
+	tester.ReadyNs = nowNs;
+	tester.TimeoutNs = DL_NEVER;
+}
+
+/**
+ * @brief Build and send the TransferData request of the block at tester.Position
+ */
+static void SendBlock(uint8_t repeat)
+{
+	uint32_t count = imageSize - tester.Position;
+
+	if (count > tester.BlockData)
+	{
+		count = tester.BlockData;
+	}
+	tester.Request[0] = 0x36u;
+	tester.Request[1] = tester.BlockSequence;
+	memcpy(&tester.Request[2], &image[tester.Position], count);
+	PutUInt32(&tester.Request[2u + count], Crc32(&image[tester.Position], count));
+	tester.Corrupted = 0;
+	if (repeat == 0u)
+	{
+		tester.BlockCount++;
+		if (corruptEvery != 0u && tester.BlockCount % corruptEvery == 0u)
+		{
+			tester.Request[2u + count / 2u] ^= 0x01u;
+			tester.Corrupted = 1;
+		}
+	}
+	SendRequest(2u + count + 4u);
+}
+
+/**
+ * @brief Build the next frame of the tester, if one is due
+ * @return 1 if frame holds a frame for the mailbox
+ */
+static uint8_t TesterPeek(canApi_MessageTypedef *frame)
+{
+	uint32_t count;
+
+	if (tester.TxPhase != TX_SEND || nowNs < tester.ReadyNs)
+	{
+		return 0;
+	}
+	memset(frame, 0, sizeof(*frame));
+	frame->Identifier = CAN_UDS_REQUEST_ID;
+	frame->DLC = 8;
+	memset(frame->Data, 0xCC, sizeof(frame->Data));
+	if (tester.Offset == 0u && tester.Length <= 7u)
+	{
+		frame->Data[0] = (uint8_t)((PCI_SINGLE << 4) | tester.Length);
+		memcpy(&frame->Data[1], tester.Request, tester.Length);
+	}
+	else if (tester.Offset == 0u)
+	{
+		frame->Data[0] = (uint8_t)((PCI_FIRST << 4) | (tester.Length >> 8));
+		frame->Data[1] = (uint8_t)tester.Length;
+		memcpy(&frame->Data[2], tester.Request, 6);
+	}
+	else
+	{
+		count = tester.Length - tester.Offset;
+		count = (count > 7u) ? 7u : count;
+		frame->Data[0] = (uint8_t)((PCI_CONSECUTIVE << 4) | tester.Sequence);
+		memcpy(&frame->Data[1], &tester.Request[tester.Offset], count);
+	}
+	return 1;
+}
+
+/**
+ * @brief The frame of TesterPeek() is on the bus, advance the transmission
+ */
+static void TesterSent(void)
+{
+	if (tester.Offset == 0u && tester.Length <= 7u)
+	{
+		tester.Offset = tester.Length;
+	}
+	else if (tester.Offset == 0u)
+	{
+		tester.Offset = 6;
+		tester.Sequence = 1;
+		tester.TxPhase = TX_WAIT_FLOW;
+		tester.TimeoutNs = nowNs + DL_RESPONSE_TIMEOUT_MS * (uint64_t)DL_MS;
+		return;
+	}
+	else
+	{
+		tester.Offset += (tester.Length - tester.Offset > 7u) ? 7u : tester.Length - tester.Offset;
+		tester.Sequence = (uint8_t)((tester.Sequence + 1u) & 0x0Fu);
+	}
+
+	if (tester.Offset >= tester.Length)
+	{
+		tester.TxPhase = TX_IDLE;
+		tester.TimeoutNs = nowNs + DL_RESPONSE_TIMEOUT_MS * (uint64_t)DL_MS;
+		return;
+	}
+	tester.ReadyNs = nowNs + tester.SeparationNs;
+	if (tester.BlockSize != 0u)
+	{
+		tester.BlockLeft--;
+		if (tester.BlockLeft == 0u)
+		{
+			tester.TxPhase = TX_WAIT_FLOW;
+			tester.TimeoutNs = nowNs + DL_RESPONSE_TIMEOUT_MS * (uint64_t)DL_MS;
+		}
+	}
+}
+
+/**
+ * @brief Evaluate a response of the module and send the next request
+ */
+static void TesterResponse(const uint8_t *response, uint32_t length)
+{
+	if (length >= 3u && response[0] == 0x7Fu && response[2] == 0x78u)
+	{
+		tester.Pending++;
+		tester.TimeoutNs = nowNs + DL_RESPONSE_TIMEOUT_MS * (uint64_t)DL_MS;
+		return;
+	}
+
+	switch (tester.Step)
+	{
+		case STEP_REQUEST_DOWNLOAD:
+			if (length == 4u && response[0] == 0x74u && response[1] == 0x20u)
+			{
+				tester.BlockData = (((uint32_t)response[2] << 8) | response[3]) - 6u;
+				if (tester.BlockData > DL_MAX_REQUEST - 6u)
+				{
+					tester.BlockData = DL_MAX_REQUEST - 6u;
+				}
+				tester.Step = STEP_TRANSFER;
+				tester.TransferNs = nowNs;
+				tester.BlockSequence = 1;
+				SendBlock(0);
+				return;
+			}
+			break;
+
+		case STEP_TRANSFER:
+			if (length == 2u && response[0] == 0x76u && response[1] == tester.BlockSequence && tester.Corrupted == 0u)
+			{
+				tester.Position += (imageSize - tester.Position > tester.BlockData) ? tester.BlockData : imageSize - tester.Position;
+				tester.BlockSequence++;
+				if (tester.Position < imageSize)
+				{
+					SendBlock(0);
+				}
+				else
+				{
+					tester.Step = STEP_EXIT;
+					tester.Request[0] = 0x37u;
+					PutUInt32(&tester.Request[1], Crc32(image, imageSize));
+					SendRequest(5);
+				}
+				return;
+			}
+			if (length == 3u && response[0] == 0x7Fu && response[1] == 0x36u && response[2] == 0x71u && tester.Corrupted != 0u)
+			{
+				tester.Repeated++;
+				SendBlock(1);
+				return;
+			}
+			break;
+
+		case STEP_EXIT:
+			if (length == 5u && response[0] == 0x77u)
+			{
+				tester.EcuCrc = ((uint32_t)response[1] << 24) | ((uint32_t)response[2] << 16)
+					| ((uint32_t)response[3] << 8) | response[4];
+				tester.Step = STEP_DONE;
+				tester.TimeoutNs = DL_NEVER;
+				return;
+			}
+			break;
+
+		default:
+			return;
+	}
+
+	fprintf(stderr, "can_download: unexpected response");
+	for (length = (length > 8u) ? 8u : length; length > 0u; length--, response++)
+	{
+		fprintf(stderr, " %02X", *response);
+	}
+	fprintf(stderr, " at %.3f s\n", nowNs / 1e9);
+	tester.Step = STEP_FAILED;
+}
+
+/**
+ * @brief Frame of the module on the bus, the tester evaluates flow controls and single frame responses
+ */
+static void TesterReceive(const canApi_MessageTypedef *frame)
+{
+	if (frame->Identifier != CAN_UDS_RESPONSE_ID || frame->IDE != 0u || frame->DLC == 0u)
+	{
+		return;
+	}
+	switch (frame->Data[0] >> 4)
+	{
+		case PCI_SINGLE:
+			if (tester.TxPhase == TX_IDLE && (frame->Data[0] & 0x0Fu) != 0u && (frame->Data[0] & 0x0Fu) < frame->DLC)
+			{
+				TesterResponse(&frame->Data[1], frame->Data[0] & 0x0Fu);
+			}
+			break;
+
+		case PCI_FLOW_CONTROL:
+			if (tester.TxPhase != TX_WAIT_FLOW || frame->DLC < 3u)
+			{
+				break;
+			}
+			if ((frame->Data[0] & 0x0Fu) == FLOW_CONTINUE)
+			{
+				tester.BlockSize = frame->Data[1];
+				tester.BlockLeft = frame->Data[1];
+				tester.SeparationNs = SeparationNs(frame->Data[2]);
+				tester.TxPhase = TX_SEND;
+				tester.ReadyNs = nowNs;
+			}
+			else if ((frame->Data[0] & 0x0Fu) == FLOW_WAIT)
+			{
+				tester.TimeoutNs = nowNs + DL_RESPONSE_TIMEOUT_MS * (uint64_t)DL_MS;
+			}
+			else
+			{
+				fprintf(stderr, "can_download: flow control overflow at %.3f s\n", nowNs / 1e9);
+				tester.Step = STEP_FAILED;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+canApi_StatusTypeDef CAN_Uds_FlashErase(uint32_t address, uint32_t length)
+{
+	uint32_t first;
+	uint32_t last;
+
+	FlashPoll();
+	if (flash.State == CAN_UDS_FLASH_BUSY || address < FLASH_BASE || length > FLASH_SIZE
+		|| address - FLASH_BASE > FLASH_SIZE - length)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	first = (address - FLASH_BASE) / FLASH_PAGE_SIZE;
+	last = (address - FLASH_BASE + length - 1u) / FLASH_PAGE_SIZE;
+	memset(&flash.Memory[first * FLASH_PAGE_SIZE], 0xFF, (last - first + 1u) * FLASH_PAGE_SIZE);
+	flash.Length = 0;
+	FlashStart((last - first + 1u) * eraseUsPerPage);
+	return CAN_OK;
+}
+
+canApi_StatusTypeDef CAN_Uds_FlashWrite(uint32_t address, const uint8_t *data, uint32_t length)
+{
+	FlashPoll();
+	if (flash.State != CAN_UDS_FLASH_IDLE || address < FLASH_BASE || length > FLASH_SIZE
+		|| address - FLASH_BASE > FLASH_SIZE - length)
+	{
+		return CAN_ERROR;
+	}
+	flash.Source = data;
+	flash.Offset = address - FLASH_BASE;
+	flash.Length = length;
+	FlashStart((length + 1u) / 2u * writeUsPerHalfword);
+	return CAN_OK;
+}
+
+CAN_Uds_FlashState_TypeDef CAN_Uds_FlashGetState(void)
+{
+	FlashPoll();
+	return flash.State;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long bitrate = 500000u;
+	uint64_t bitTimeNs;
+	canApi_MessageTypedef onBus;
+	uint8_t onBusOwn = 0;
+	uint64_t busEnd = DL_NEVER;
+	uint64_t busyNs = 0;
+	uint64_t transferBusyNs = 0;
+	uint64_t testerNs = 0;
+	uint64_t frames = 0;
+	uint64_t testerFrames = 0;
+	uint64_t moduleUs = 0;
+	uint32_t randomState = 0x2545F491u;
+	uint32_t i;
+	double wall;
+	double seconds;
+	double transferSeconds;
+	int ok;
+
+	for (i = 1; i < (uint32_t)argc; i++)
+	{
+		if (strcmp(argv[i], "-s") == 0 && i + 1u < (uint32_t)argc)
+		{
+			imageSize = (uint32_t)strtoul(argv[++i], 0, 0) * 1024u;
+		}
+		else if (strcmp(argv[i], "-a") == 0 && i + 1u < (uint32_t)argc)
+		{
+			imageAddress = (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-b") == 0 && i + 1u < (uint32_t)argc)
+		{
+			bitrate = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-e") == 0 && i + 1u < (uint32_t)argc)
+		{
+			eraseUsPerPage = (uint64_t)(strtod(argv[++i], 0) * 1000.0);
+		}
+		else if (strcmp(argv[i], "-w") == 0 && i + 1u < (uint32_t)argc)
+		{
+			writeUsPerHalfword = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1u < (uint32_t)argc)
+		{
+			corruptEvery = (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (bitrate == 0u || bitrate > 1000000u || imageSize == 0u || imageSize > FLASH_SIZE
+		|| imageAddress < FLASH_BASE || imageAddress - FLASH_BASE > FLASH_SIZE - imageSize)
+	{
+		PrintUsage();
+		return 2;
+	}
+	bitTimeNs = 1000000000u / bitrate;
+
+	image = malloc(imageSize);
+	if (image == 0)
+	{
+		return 2;
+	}
+	for (i = 0; i < imageSize; i++)
+	{
+		randomState ^= randomState << 13;
+		randomState ^= randomState >> 17;
+		randomState ^= randomState << 5;
+		image[i] = (uint8_t)randomState;
+	}
+	memset(flash.Memory, 0x00, sizeof(flash.Memory));
+
+	/* the UDS filter is set by the init of the CAN peripheral */
+	CAN_C_Uds_Enable = 1;
+	canApiSim_Init();
+	canApiSim_SetTxPerTick(CANAPI_SIM_TX_EXTERNAL);
+	memset(&onBus, 0, sizeof(onBus));
+
+	/* RequestDownload after the module had a few ticks to open its channel */
+	nowNs = 10u * DL_MS;
+	canApiSim_RunForUs(10000u);
+	moduleUs = 10000u;
+	tester.Step = STEP_REQUEST_DOWNLOAD;
+	tester.Request[0] = 0x34u;
+	tester.Request[1] = 0x00u;
+	tester.Request[2] = 0x44u;
+	PutUInt32(&tester.Request[3], imageAddress);
+	PutUInt32(&tester.Request[7], imageSize);
+	SendRequest(11);
+
+	wall = WallSeconds();
+	while (tester.Step != STEP_DONE && tester.Step != STEP_FAILED)
+	{
+		uint64_t next = (nowNs / DL_MS + 1u) * DL_MS;
+		canApi_MessageTypedef own;
+		canApi_MessageTypedef request;
+		uint8_t ownPending;
+		uint8_t testerPending;
+
+		/* advance to the next event: 1ms tick, end of frame, next frame of the tester */
+		if (busEnd < next)
+		{
+			next = busEnd;
+		}
+		if (tester.TxPhase == TX_SEND && tester.ReadyNs > nowNs && tester.ReadyNs < next)
+		{
+			next = tester.ReadyNs;
+		}
+		nowNs = next;
+		if (nowNs / 1000u > moduleUs)
+		{
+			canApiSim_RunForUs((uint32_t)(nowNs / 1000u - moduleUs));
+			moduleUs = nowNs / 1000u;
+		}
+
+		if (nowNs >= busEnd)
+		{
+			if (onBusOwn != 0u)
+			{
+				canApiSim_CompleteTransmit(&onBus);
+				TesterReceive(&onBus);
+			}
+			else
+			{
+				TesterSent();
+				(void)canApiSim_Receive(&onBus);
+			}
+			busEnd = DL_NEVER;
+		}
+		if (nowNs >= tester.TimeoutNs)
+		{
+			fprintf(stderr, "can_download: no response at %.3f s\n", nowNs / 1e9);
+			tester.Step = STEP_FAILED;
+			break;
+		}
+		if (busEnd != DL_NEVER)
+		{
+			continue;
+		}
+
+		/* bitwise arbitration between the two nodes */
+		ownPending = (canApiSim_PeekTransmit(&own) == CAN_OK);
+		testerPending = TesterPeek(&request);
+		if (ownPending != 0u && (testerPending == 0u || ArbitrationKey(&own) < ArbitrationKey(&request)))
+		{
+			(void)canApiSim_TakeTransmit(&onBus);
+			onBusOwn = 1;
+		}
+		else if (testerPending != 0u)
+		{
+			onBus = request;
+			onBusOwn = 0;
+		}
+		else
+		{
+			continue;
+		}
+		busEnd = nowNs + FrameBits(&onBus) * bitTimeNs;
+		busyNs += busEnd - nowNs;
+		if (tester.Step != STEP_REQUEST_DOWNLOAD)
+		{
+			transferBusyNs += busEnd - nowNs;
+		}
+		frames++;
+		if (onBusOwn == 0u)
+		{
+			testerNs += busEnd - nowNs;
+			testerFrames++;
+		}
+	}
+	wall = WallSeconds() - wall;
+
+	FlashPoll();
+	seconds = (nowNs - 10u * DL_MS) / 1e9;
+	transferSeconds = (tester.TransferNs != 0u) ? (nowNs - tester.TransferNs) / 1e9 : seconds;
+	ok = (tester.Step == STEP_DONE && tester.EcuCrc == Crc32(image, imageSize)
+		&& memcmp(&flash.Memory[imageAddress - FLASH_BASE], image, imageSize) == 0);
+
+	printf("%lu bytes to 0x%08lX at %lu bit/s, %lu byte blocks, erase %.1f ms/page, write %lu us/halfword\n",
+		(unsigned long)imageSize, (unsigned long)imageAddress, bitrate, (unsigned long)tester.BlockData,
+		eraseUsPerPage / 1e3, (unsigned long)writeUsPerHalfword);
+	printf("download %.3f s, %.2f kB/s, bus load %.1f %%, %.2f s wall\n",
+		seconds, imageSize / 1024.0 / seconds, 100.0 * busyNs / (nowNs - 10u * DL_MS), wall);
+	printf("after the erase: transfer %.3f s, %.2f kB/s, bus load %.1f %%\n",
+		transferSeconds, imageSize / 1024.0 / transferSeconds, 100.0 * transferBusyNs / 1e9 / transferSeconds);
+	printf("frames: %llu total, %llu tester, %llu module\n", (unsigned long long)frames,
+		(unsigned long long)testerFrames, (unsigned long long)(frames - testerFrames));
+	printf("tester frames back to back: %.2f kB/s, reached %.1f %%\n",
+		imageSize / 1024.0 / (testerNs / 1e9), 100.0 * (testerNs / 1e9) / transferSeconds);
+	printf("flash busy %.3f s (%.1f %% of the download), responsePending %lu, blocks repeated %lu\n",
+		flash.BusyUs / 1e6, 100.0 * flash.BusyUs / 1e6 / seconds, (unsigned long)tester.Pending,
+		(unsigned long)tester.Repeated);
+	printf("image CRC-32 0x%08lX, module 0x%08lX, flash content %s\n", (unsigned long)Crc32(image, imageSize),
+		(unsigned long)tester.EcuCrc, (memcmp(&flash.Memory[imageAddress - FLASH_BASE], image, imageSize) == 0) ? "verified" : "WRONG");
+	printf("%s\n", ok ? "PASS" : "FAIL");
+
+	free(image);
+	return ok ? 0 : 1;
+}
+
+/** @} */
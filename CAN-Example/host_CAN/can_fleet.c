@@ -0,0 +1,312 @@
+/**
+*******************************************************************************
+* @file can_fleet.c
+* @brief Host tool: scaling benchmark for many CAN module instances in parallel
+* @author FRIWO
+* @date 19.10.2026 - 19:12:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Simulates a fleet of controllers with the multi-instance build of
+* CAN_custom.c. Every worker thread owns one module context and one simulated
+* canApi and runs its share of the fleet one instance after the other. Each
+* instance gets its own receive traffic, derived from the instance number, and
+* runs for the given simulated time.
+*
+* The fleet is run once per thread count 1, 2, 4 ... up to -j. The report shows
+* instances per second and the speedup against one thread. A checksum over all
+* transmitted frames and the counters of the EnableTool variables of each
+* instance must not depend on the thread count, otherwise instances share
+* state, e.g. with the instance run before on the same thread, and the tool
+* exits with 1.
+*
+* Build: gcc -std=c11 -O2 -DCAN_MULTI_INSTANCE -pthread -I../module_CAN -o can_fleet can_fleet.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_fleet [-j max_threads] [-n instances] [-t duration_ms]
+*/
+
+/**
+* @addtogroup can_fleet
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+
+#ifndef CAN_MULTI_INSTANCE
+#error "can_fleet needs the multi-instance build, compile with -DCAN_MULTI_INSTANCE"
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief upper limit for -j */
+#define FLEET_MAX_THREADS 256u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief One periodic frame of the receive traffic of an instance */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief CAN identifier */
+	uint8_t DLC; /**< @brief payload length */
+	uint32_t PeriodMs; /**< @brief send period */
+}fleetRxFrame_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief receive traffic of every instance, the reference setup of rx_traffic.txt */
+static const fleetRxFrame_TypeDef rxFrame_array[] =
+{
+	{0x111, 8, 10},
+	{0x1B6, 8, 100},
+	{0x171, 8, 100},
+	{0x172, 8, 1000},
+	{0x176, 8, 1000},
+	{0x178, 8, 1000},
+	{0x310, 8, 100},
+	{0x521, 8, 100},
+	{0x50C, 1, 100},
+	{0x600, 4, 250},
+};
+
+static uint32_t instanceCount = 1000u;
+static uint32_t durationMs = 1000u;
+
+/** @brief next instance to simulate, shared by the workers */
+static atomic_uint nextInstance;
+
+/** @brief transmit checksum per instance */
+static uint32_t *checksum_array = 0;
+
+/** @brief transmit checksum of the instance run by this thread */
+static _Thread_local uint32_t txChecksum;
+
+/* EnableTool counters of CAN_custom.c which accumulate over the run of an instance */
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_FastPath_Count;
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_HighWater;
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_HighWater;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Cheap integer hash for the payload and the checksum */
+static uint32_t Mix(uint32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x7FEB352Du;
+	value ^= value >> 15;
+	value *= 0x846CA68Bu;
+	value ^= value >> 16;
+	return value;
+}
+
+static void OnTransmit(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	uint8_t i;
+
+	txChecksum = Mix(txChecksum ^ message->Identifier ^ timestamp);
+	for (i = 0; i < message->DLC && i < 8u; i++)
+	{
+		txChecksum = Mix(txChecksum ^ message->Data[i]);
+	}
+}
+
+/**
+ * @brief Simulate one instance in the context of the calling thread
+ * @return checksum of all transmitted frames and the EnableTool counters at the end
+ */
+static uint32_t RunInstance(CAN_Context_TypeDef *context, uint32_t instance)
+{
+	canApi_MessageTypedef message;
+	uint32_t t;
+	unsigned k;
+	uint8_t i;
+
+	/* the same context again, a thread runs one context only */
+	(void)CAN_InitContext(context);
+	canApiSim_Init();
+	canApiSim_SetTransmitObserver(OnTransmit);
+	canApiSim_SetSignal("INFO_Voltage_DC_Link", 48.0 + (instance % 16u));
+	canApiSim_SetSignal("INFO_Vehicle_Speed", instance % 60u);
+	txChecksum = instance;
+
+	memset(&message, 0, sizeof(message));
+	for (t = 0; t < durationMs; t++)
+	{
+		for (k = 0; k < sizeof(rxFrame_array) / sizeof(rxFrame_array[0]); k++)
+		{
+			const fleetRxFrame_TypeDef *frame = &rxFrame_array[k];
+
+			if ((t + k) % frame->PeriodMs == 0u)
+			{
+				uint32_t payload = Mix(instance * 131u + t * 7u + k);
+
+				message.Identifier = frame->Identifier;
+				message.DLC = frame->DLC;
+				for (i = 0; i < 8u; i++)
+				{
+					message.Data[i] = (uint8_t)(payload >> (8u * (i & 3u)));
+				}
+				(void)canApiSim_Receive(&message);
+			}
+		}
+		canApiSim_Tick(1);
+	}
+	txChecksum = Mix(txChecksum ^ CAN_M_FastPath_Count);
+	txChecksum = Mix(txChecksum ^ CAN_M_TxBuffer_HighWater);
+	return Mix(txChecksum ^ CAN_M_RxBuffer_HighWater);
+}
+
+static void* Worker(void *argument)
+{
+	CAN_Context_TypeDef *context = malloc(CAN_GetContextSize());
+	uint32_t instance;
+
+	(void)argument;
+	if (context == 0 || CAN_InitContext(context) != CAN_OK || CAN_SelectContext(context) != CAN_OK)
+	{
+		free(context);
+		return 0;
+	}
+	while ((instance = atomic_fetch_add(&nextInstance, 1u)) < instanceCount)
+	{
+		checksum_array[instance] = RunInstance(context, instance);
+	}
+	CAN_SelectContext(0);
+	free(context);
+	return 0;
+}
+
+static double WallSeconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_fleet [-j max_threads] [-n instances] [-t duration_ms]\n");
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	pthread_t thread_array[FLEET_MAX_THREADS];
+	unsigned long maxThreads = (unsigned long)sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t *reference;
+	double singleRate = 0.0;
+	unsigned long threads;
+	int failed = 0;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+		{
+			maxThreads = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			instanceCount = (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			durationMs = (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (maxThreads == 0u || maxThreads > FLEET_MAX_THREADS || instanceCount == 0u)
+	{
+		PrintUsage();
+		return 2;
+	}
+	checksum_array = calloc(instanceCount, sizeof(uint32_t));
+	reference = calloc(instanceCount, sizeof(uint32_t));
+	if (checksum_array == 0 || reference == 0)
+	{
+		return 2;
+	}
+
+	printf("%lu instances of %lu ms, context %lu byte\n", (unsigned long)instanceCount,
+		(unsigned long)durationMs, (unsigned long)CAN_GetContextSize());
+	printf("threads  wall [s]  instances/s  speedup  checksums\n");
+	for (threads = 1; threads <= maxThreads; threads = (threads * 2u > maxThreads && threads < maxThreads) ? maxThreads : threads * 2u)
+	{
+		double start;
+		double wall;
+		double rate;
+		uint32_t mismatch = 0;
+		unsigned long t;
+
+		atomic_store(&nextInstance, 0u);
+		start = WallSeconds();
+		for (t = 0; t < threads; t++)
+		{
+			if (pthread_create(&thread_array[t], 0, Worker, 0) != 0)
+			{
+				fprintf(stderr, "can_fleet: cannot start thread %lu\n", t);
+				return 2;
+			}
+		}
+		for (t = 0; t < threads; t++)
+		{
+			pthread_join(thread_array[t], 0);
+		}
+		wall = WallSeconds() - start;
+		rate = (wall > 0.0) ? instanceCount / wall : 0.0;
+
+		if (threads == 1u)
+		{
+			memcpy(reference, checksum_array, instanceCount * sizeof(uint32_t));
+			singleRate = rate;
+		}
+		else
+		{
+			uint32_t k;
+
+			for (k = 0; k < instanceCount; k++)
+			{
+				mismatch += (checksum_array[k] != reference[k]);
+			}
+		}
+		printf("%7lu  %8.3f  %11.0f  %7.2f  %s\n", threads, wall, rate,
+			(singleRate > 0.0) ? rate / singleRate : 0.0, (mismatch == 0u) ? "ok" : "MISMATCH");
+		if (mismatch != 0u)
+		{
+			failed = 1;
+		}
+	}
+	free(reference);
+	free(checksum_array);
+	return failed;
+}
+
+/** @} */
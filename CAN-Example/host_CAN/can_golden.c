@@ -0,0 +1,741 @@
+/**
+*******************************************************************************
+* @file can_golden.c
+* @brief Host tool: golden-vector regression test of every transmitted message
+* @author FRIWO
+* @date 19.10.2026 - 22:05:18
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Includes CAN_custom.c to reach the send functions of txSchedule_array and
+* calls each of them with a matrix of input vectors on the simulated canApi.
+* Every vector sets all canApi_Get_ signals and the EnableTool switches
+* CAN_C_Switch_KilometerToMiles, CAN_C_SwitchDataInfo_ID_207 and
+* CAN_C_SwitchDataInfo_ID_306, including one value outside their limits.
+* The signal values are drawn reproducibly from a list of corner values per
+* basetype (zero, +-1, rounding edges, negatives, the extremes of the 8, 16
+* and 32 bit payload fields) and from random values.
+*
+* The optional messages are switched on for the vectors: all eight pages of
+* the multiplexed message 0x3F0 with GOLDEN_MUX_INTERVAL, so that the pages
+* take turns, and the delta telemetry 0x3F1 with its default signal set.
+* Before every call the millisecond counter of the module advances by the
+* interval of the message, like in the schedule. The frames of these two
+* messages depend on the vectors before, they are compared as a sequence.
+*
+* With -r the transmitted frames are written to a golden file, with -c they
+* are compared against it. can_golden_vectors.txt next to this tool holds the
+* frames of the committed send functions, can_golden -c can_golden_vectors.txt
+* checks a change of them (e.g. fixed-point or table-driven packing). A change
+* which alters the payload on purpose records the file again with
+* -r can_golden_vectors.txt in the same commit.
+* For the first mismatch the input vector is probed signal by signal to name
+* the inputs which drive the differing bits.
+*
+* The vectors of a send function are keyed by the CAN identifier of its first
+* transmitted frame, and the input values are derived from the signal names.
+* A message or a signal added later therefore leaves the vectors of the
+* existing messages valid: a message missing in the golden file is reported
+* and skipped, a message of the golden file which is no longer sent counts
+* as a mismatch. A send function which transmits nothing with the golden
+* inputs (a message switched off by default) is not compared.
+*
+* Float to integer conversions out of the range of the target type are
+* undefined in C, the golden file holds the result of the recording compiler
+* for them. Compare only against files recorded with the same compiler and
+* architecture. can_golden_vectors.txt is recorded with gcc on x86-64.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_golden can_golden.c canApi_sim.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_golden -r|-c golden.txt [-n vectors_per_message] [-s seed]
+*
+* The exit code is 0 if all frames match, 1 on a mismatch and 2 on usage or
+* file errors.
+*/
+
+/**
+* @addtogroup can_golden
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* module under test, including its private functions */
+#include "CAN_custom.c"
+
+#include "canApi_sim.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief version of the golden file format */
+#define GOLDEN_VERSION 2u
+
+/** @brief maximum number of messages in a golden file */
+#define GOLDEN_MAX_KEYS 128u
+
+/** @brief maximum number of frames one send function may transmit per call */
+#define GOLDEN_MAX_FRAMES 4u
+
+/** @brief number of EnableTool switches in the input vector */
+#define GOLDEN_SWITCHES 3u
+
+/** @brief interval of every page of 0x3F0 in the vectors, one page per 10 ms slot [ms] */
+#define GOLDEN_MUX_INTERVAL 80u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Frames transmitted by one call of a send function */
+typedef struct
+{
+	uint32_t Count; /**< @brief number of frames */
+	canApi_MessageTypedef Frame[GOLDEN_MAX_FRAMES]; /**< @brief frames in transmit order */
+}goldenResult_TypeDef;
+
+/** @brief EnableTool switch of the input vector */
+typedef struct
+{
+	const char *Name; /**< @brief EnableTool name */
+	volatile UInt32 *Value; /**< @brief switch variable of CAN_custom.c */
+	uint32_t States; /**< @brief number of tested states, the last one is outside the limits */
+}goldenSwitch_TypeDef;
+
+/** @brief Vectors of one message in the golden file */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief identifier of the first frame sent by the send function */
+	uint8_t IDE; /**< @brief 0 = standard, 1 = extended identifier */
+	uint8_t Compared; /**< @brief 1 once a send function of the schedule was compared against it */
+	long Position; /**< @brief file position of its first line */
+}goldenKey_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief corner values of Float32 signals: rounding edges of the scalings and field extremes */
+static const Float32 cornerFloat_array[] =
+{
+	0.0f, 0.004f, -0.004f, 0.005f, 0.0625f, 0.5f, -0.5f, 1.0f, -1.0f, 9.99f, 10.0f, -10.0f,
+	100.5f, -100.5f, 127.0f, 128.0f, 255.0f, 256.0f, -256.0f, 327.67f, -327.68f, 655.35f,
+	819.2f, 1000.0f, -1000.0f, 4095.9375f, 32767.0f, -32768.0f, 65535.0f, 1.0e6f, -1.0e6f
+};
+
+/** @brief corner values of Int16 signals */
+static const Int16 cornerInt16_array[] = {0, 1, -1, 2, 127, 128, 255, 256, -256, 32767, -32768};
+
+/** @brief corner values of UInt32 signals */
+static const UInt32 cornerUInt32_array[] = {0u, 1u, 2u, 3u, 255u, 256u, 65535u, 65536u, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu};
+
+/** @brief corner values of UInt8 signals */
+static const UInt8 cornerUInt8_array[] = {0u, 1u, 2u, 3u, 4u, 127u, 128u, 254u, 255u};
+
+static const goldenSwitch_TypeDef switch_array[GOLDEN_SWITCHES] =
+{
+	{"CAN_C_Switch_KilometerToMiles", &CAN_C_Switch_KilometerToMiles, 3u},
+	{"CAN_C_SwitchDataInfo_ID_207", &CAN_C_SwitchDataInfo_ID_207, 5u},
+	{"CAN_C_SwitchDataInfo_ID_306", &CAN_C_SwitchDataInfo_ID_306, 3u},
+};
+
+static uint32_t vectorCount = 1024u;
+static uint32_t seed = 1u;
+
+/** @brief hash of every signal name, in the order of canApiSim_GetSignalByIndex() */
+static uint32_t *nameHash_array = 0;
+
+/** @brief messages of the golden file */
+static goldenKey_TypeDef key_array[GOLDEN_MAX_KEYS];
+static uint32_t keyCount = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Cheap integer hash, the input matrix is a pure function of seed, vector and signal */
+static uint32_t Mix(uint32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x7FEB352Du;
+	value ^= value >> 15;
+	value *= 0x846CA68Bu;
+	value ^= value >> 16;
+	return value;
+}
+
+/** @brief FNV-1a hash of a signal name */
+static uint32_t NameHash(const char *name)
+{
+	uint32_t hash = 0x811C9DC5u;
+
+	while (*name != '\0')
+	{
+		hash = (hash ^ (uint8_t)*name++) * 0x01000193u;
+	}
+	return hash;
+}
+
+/**
+ * @brief Check if a signal is an input of the send functions.
+ * The bus error flags are state of the simulated peripheral, a set bus-off flag would stop the transmission.
+ */
+static int IsInput(const canApiSim_SignalTypeDef *signal)
+{
+	return signal->Direction == 0u && strncmp(signal->Name, "BSW_IO_F_CAN_", 13) != 0;
+}
+
+static uint32_t CornerCount(canApiSim_SignalType type)
+{
+	switch (type)
+	{
+		case CANAPI_SIM_FLOAT32: return sizeof(cornerFloat_array) / sizeof(cornerFloat_array[0]);
+		case CANAPI_SIM_INT16: return sizeof(cornerInt16_array) / sizeof(cornerInt16_array[0]);
+		case CANAPI_SIM_UINT32: return sizeof(cornerUInt32_array) / sizeof(cornerUInt32_array[0]);
+		default: return sizeof(cornerUInt8_array) / sizeof(cornerUInt8_array[0]);
+	}
+}
+
+/**
+ * @brief Write a corner value or, if corner is out of range, a random value derived from hash
+ * @param signal: signal to write
+ * @param corner: index into the corner list of the basetype
+ * @param hash: random bits
+ */
+static void WriteInput(const canApiSim_SignalTypeDef *signal, uint32_t corner, uint32_t hash)
+{
+	uint8_t random = (corner >= CornerCount(signal->Type));
+
+	switch (signal->Type)
+	{
+		case CANAPI_SIM_FLOAT32:
+			/* random magnitude between 2^-4 and 2^16 with both signs */
+			*(Float32*)signal->Value = random
+				? (Float32)((int32_t)(hash & 0xFFFFu) - 0x8000) / (Float32)(1u << (hash >> 28)) * 2.0f
+				: cornerFloat_array[corner];
+			break;
+		case CANAPI_SIM_INT16:
+			*(Int16*)signal->Value = random ? (Int16)hash : cornerInt16_array[corner];
+			break;
+		case CANAPI_SIM_UINT32:
+			*(UInt32*)signal->Value = random ? (UInt32)Mix(hash) : cornerUInt32_array[corner];
+			break;
+		default:
+			*(UInt8*)signal->Value = random ? (UInt8)hash : cornerUInt8_array[corner];
+			break;
+	}
+}
+
+/**
+ * @brief Set all inputs of a vector. Half of the input signals get a corner value, the others a random value.
+ * @param vector: vector number
+ */
+static void SetInputs(uint32_t vector)
+{
+	uint32_t count = canApiSim_GetSignalCount();
+	uint32_t states = 1;
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		const canApiSim_SignalTypeDef *signal = canApiSim_GetSignalByIndex(i);
+		uint32_t hash = Mix(seed ^ Mix(vector * 0x9E3779B9u + nameHash_array[i]));
+
+		if (IsInput(signal))
+		{
+			WriteInput(signal, ((hash & 1u) != 0u) ? (hash >> 1) % CornerCount(signal->Type) : UINT32_MAX, hash >> 4);
+		}
+	}
+	/* the switch states cycle through all combinations */
+	for (i = 0; i < GOLDEN_SWITCHES; i++)
+	{
+		*switch_array[i].Value = (vector / states) % switch_array[i].States;
+		states *= switch_array[i].States;
+	}
+}
+
+/**
+ * @brief Call one send function and collect the frames it puts into the transmit buffer
+ */
+static void RunSend(uint32_t entry, goldenResult_TypeDef *result)
+{
+	result->Count = 0;
+	canContext->MsCounter += txSchedule_array[entry].Interval;
+	txSchedule_array[entry].SendFunction();
+	while (result->Count < GOLDEN_MAX_FRAMES && canApiSim_TakeTransmit(&result->Frame[result->Count]) == CAN_OK)
+	{
+		result->Count++;
+	}
+	canApi_ClearTransmitBuffer();
+}
+
+/**
+ * @brief Get the key of a send function, the identifier of the first frame it sent in any vector
+ * @return 1 if it sent at least one frame
+ */
+static int FindKey(const goldenResult_TypeDef *result_array, goldenKey_TypeDef *key)
+{
+	uint32_t vector;
+
+	for (vector = 0; vector < vectorCount; vector++)
+	{
+		if (result_array[vector].Count != 0u)
+		{
+			key->Identifier = result_array[vector].Frame[0].Identifier;
+			key->IDE = result_array[vector].Frame[0].IDE;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void PrintFrame(FILE *f, const goldenKey_TypeDef *key, uint32_t vector, const goldenResult_TypeDef *result)
+{
+	uint32_t k;
+	uint8_t i;
+
+	if (result->Count == 0u)
+	{
+		fprintf(f, "%lX %u %lu none\n", (unsigned long)key->Identifier, key->IDE, (unsigned long)vector);
+	}
+	for (k = 0; k < result->Count; k++)
+	{
+		const canApi_MessageTypedef *frame = &result->Frame[k];
+
+		fprintf(f, "%lX %u %lu %lX %u %u ", (unsigned long)key->Identifier, key->IDE, (unsigned long)vector,
+			(unsigned long)frame->Identifier, frame->IDE, frame->DLC);
+		for (i = 0; i < 8u; i++)
+		{
+			fprintf(f, "%02X", (i < frame->DLC) ? frame->Data[i] : 0u);
+		}
+		fprintf(f, "\n");
+	}
+}
+
+/**
+ * @brief Index the golden file: the position of the first line of every message
+ * @return 1 on success, 0 if the file holds more than GOLDEN_MAX_KEYS messages
+ */
+static int IndexGolden(FILE *f)
+{
+	char line[128];
+	long position = ftell(f);
+
+	keyCount = 0;
+	while (fgets(line, sizeof(line), f) != 0)
+	{
+		unsigned long id;
+		unsigned ide;
+
+		if (sscanf(line, "%lx %u", &id, &ide) == 2
+			&& (keyCount == 0u || key_array[keyCount - 1u].Identifier != id || key_array[keyCount - 1u].IDE != ide))
+		{
+			if (keyCount >= GOLDEN_MAX_KEYS)
+			{
+				return 0;
+			}
+			key_array[keyCount].Identifier = (uint32_t)id;
+			key_array[keyCount].IDE = (uint8_t)ide;
+			key_array[keyCount].Compared = 0;
+			key_array[keyCount].Position = position;
+			keyCount++;
+		}
+		position = ftell(f);
+	}
+	return 1;
+}
+
+/**
+ * @brief Read the frames of one call from the golden file
+ * @return 1 on success, 0 if the file does not match the expected message and vector
+ */
+static int ReadGolden(FILE *f, const goldenKey_TypeDef *key, uint32_t vector, goldenResult_TypeDef *result)
+{
+	char line[128];
+	long position;
+
+	result->Count = 0;
+	for (;;)
+	{
+		unsigned long k, v, id;
+		unsigned keyIde, ide, dlc;
+		char data[17];
+		canApi_MessageTypedef *frame;
+		uint8_t i;
+
+		position = ftell(f);
+		if (fgets(line, sizeof(line), f) == 0)
+		{
+			return result->Count != 0u;
+		}
+		if (sscanf(line, "%lx %u %lu", &k, &keyIde, &v) != 3 || k != key->Identifier || keyIde != key->IDE || v != vector)
+		{
+			fseek(f, position, SEEK_SET);
+			return result->Count != 0u;
+		}
+		if (strstr(line, "none") != 0)
+		{
+			return 1;
+		}
+		if (result->Count >= GOLDEN_MAX_FRAMES
+			|| sscanf(line, "%lx %u %lu %lx %u %u %16s", &k, &keyIde, &v, &id, &ide, &dlc, data) != 7)
+		{
+			return 0;
+		}
+		frame = &result->Frame[result->Count++];
+		memset(frame, 0, sizeof(*frame));
+		frame->Identifier = (uint32_t)id;
+		frame->IDE = (uint8_t)ide;
+		frame->DLC = (uint8_t)dlc;
+		for (i = 0; i < 8u; i++)
+		{
+			unsigned byte;
+
+			sscanf(&data[2u * i], "%2x", &byte);
+			frame->Data[i] = (uint8_t)byte;
+		}
+	}
+}
+
+/**
+ * @brief Compare the frames of one call
+ * @param byteIndex: target pointer for the first differing byte, 0xFF if the frame headers differ
+ * @param frameIndex: target pointer for the first differing frame
+ * @return 1 if equal
+ */
+static int Equal(const goldenResult_TypeDef *golden, const goldenResult_TypeDef *now, uint8_t *byteIndex, uint32_t *frameIndex)
+{
+	uint32_t k;
+	uint8_t i;
+
+	for (k = 0; k < golden->Count || k < now->Count; k++)
+	{
+		const canApi_MessageTypedef *a = &golden->Frame[k];
+		const canApi_MessageTypedef *b = &now->Frame[k];
+
+		*frameIndex = k;
+		if (k >= golden->Count || k >= now->Count
+			|| a->Identifier != b->Identifier || a->IDE != b->IDE || a->DLC != b->DLC)
+		{
+			*byteIndex = 0xFFu;
+			return 0;
+		}
+		for (i = 0; i < a->DLC && i < 8u; i++)
+		{
+			if (a->Data[i] != b->Data[i])
+			{
+				*byteIndex = i;
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief Name the inputs which drive the given bits of a frame.
+ * Each input of the vector is set to every corner value of its basetype in turn; an input is
+ * reported if one of them changes at least one of the bits.
+ */
+static void ReportDrivers(uint32_t entry, uint32_t vector, uint32_t frameIndex, uint8_t byteIndex, uint8_t bits)
+{
+	goldenResult_TypeDef base;
+	goldenResult_TypeDef probe;
+	uint32_t count = canApiSim_GetSignalCount();
+	uint32_t i;
+	uint32_t c;
+	int found = 0;
+
+	if (txSchedule_array[entry].IsOn != 0)
+	{
+		printf("  the frame depends on the vectors before, inputs not probed\n");
+		return;
+	}
+	SetInputs(vector);
+	RunSend(entry, &base);
+	printf("  bits driven by:");
+	for (i = 0; i < count + GOLDEN_SWITCHES; i++)
+	{
+		const canApiSim_SignalTypeDef *signal = (i < count) ? canApiSim_GetSignalByIndex(i) : 0;
+		uint32_t corners = (signal != 0) ? CornerCount(signal->Type) : switch_array[i - count].States;
+		Float64 value = 0.0;
+		uint8_t changed = 0;
+
+		if (signal != 0 && !IsInput(signal))
+		{
+			continue;
+		}
+		SetInputs(vector);
+		if (signal != 0)
+		{
+			(void)canApiSim_GetSignal(signal->Name, &value);
+		}
+		else
+		{
+			value = *switch_array[i - count].Value;
+		}
+		for (c = 0; c < corners && changed == 0u; c++)
+		{
+			SetInputs(vector);
+			if (signal != 0)
+			{
+				WriteInput(signal, c, 0u);
+			}
+			else
+			{
+				*switch_array[i - count].Value = c;
+			}
+			RunSend(entry, &probe);
+			if (probe.Count != base.Count || (frameIndex < probe.Count
+				&& ((probe.Frame[frameIndex].Data[byteIndex] ^ base.Frame[frameIndex].Data[byteIndex]) & bits) != 0u))
+			{
+				changed = 1;
+			}
+		}
+		if (changed != 0u)
+		{
+			printf(" %s = %.9g", (signal != 0) ? signal->Name : switch_array[i - count].Name, value);
+			found = 1;
+		}
+	}
+	printf("%s\n", (found != 0) ? "" : " no single input (constant bits or a combination)");
+}
+
+static double WallSeconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_golden -r|-c golden.txt [-n vectors_per_message] [-s seed]\n");
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	const char *path = 0;
+	int record = 0;
+	FILE *f;
+	goldenResult_TypeDef *result_array;
+	uint32_t mismatch_array[TX_MESSAGES_AVAILABLE];
+	goldenKey_TypeDef entryKey_array[TX_MESSAGES_AVAILABLE];
+	uint32_t mismatches = 0;
+	uint32_t compared = 0;
+	uint32_t entry;
+	uint32_t vector;
+	uint32_t k;
+	double wall;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-c") == 0) && i + 1 < argc)
+		{
+			record = (argv[i][1] == 'r');
+			path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			vectorCount = (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			seed = (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (path == 0 || vectorCount == 0u)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	canApiSim_Init();
+	CAN_C_Mux_Page0_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page1_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page2_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page3_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page4_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page5_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page6_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Mux_Page7_Interval = GOLDEN_MUX_INTERVAL;
+	CAN_C_Delta_Enable = 1;
+	nameHash_array = malloc(canApiSim_GetSignalCount() * sizeof(uint32_t));
+	if (nameHash_array == 0)
+	{
+		return 2;
+	}
+	for (k = 0; k < canApiSim_GetSignalCount(); k++)
+	{
+		nameHash_array[k] = NameHash(canApiSim_GetSignalByIndex(k)->Name);
+	}
+	f = fopen(path, record ? "w" : "r");
+	if (f == 0)
+	{
+		fprintf(stderr, "can_golden: cannot open %s\n", path);
+		return 2;
+	}
+	if (record)
+	{
+		fprintf(f, "# golden frames of the send functions of CAN_custom.c, written by can_golden -r\n");
+		fprintf(f, "# <message id hex> <message ide> <vector> <id hex> <ide> <dlc> <data hex>\n");
+		fprintf(f, "can_golden %u %lu %lu\n", GOLDEN_VERSION, (unsigned long)vectorCount, (unsigned long)seed);
+	}
+	else
+	{
+		char line[256];
+		unsigned version = 0;
+		unsigned long vectors = 0, fileSeed = 0;
+
+		while (fgets(line, sizeof(line), f) != 0 && line[0] == '#')
+		{
+		}
+		if (sscanf(line, "can_golden %u %lu %lu", &version, &vectors, &fileSeed) != 3 || version != GOLDEN_VERSION)
+		{
+			fprintf(stderr, "can_golden: %s is no golden file of format %u, record it again\n", path, GOLDEN_VERSION);
+			fclose(f);
+			return 2;
+		}
+		if (IndexGolden(f) == 0)
+		{
+			fprintf(stderr, "can_golden: %s holds more than %u messages\n", path, GOLDEN_MAX_KEYS);
+			fclose(f);
+			return 2;
+		}
+		vectorCount = (uint32_t)vectors;
+		seed = (uint32_t)fileSeed;
+	}
+	result_array = malloc(vectorCount * sizeof(goldenResult_TypeDef));
+	if (result_array == 0)
+	{
+		fclose(f);
+		return 2;
+	}
+
+	memset(mismatch_array, 0, sizeof(mismatch_array));
+	wall = WallSeconds();
+	for (entry = 0; entry < TX_MESSAGES_AVAILABLE; entry++)
+	{
+		goldenKey_TypeDef *key = &entryKey_array[entry];
+
+		for (vector = 0; vector < vectorCount; vector++)
+		{
+			SetInputs(vector);
+			RunSend(entry, &result_array[vector]);
+		}
+		if (FindKey(result_array, key) == 0)
+		{
+			printf("txSchedule_array[%lu] sends nothing with the golden inputs, not %s\n", (unsigned long)entry,
+				record ? "recorded" : "compared");
+			continue;
+		}
+		if (record)
+		{
+			for (vector = 0; vector < vectorCount; vector++)
+			{
+				PrintFrame(f, key, vector, &result_array[vector]);
+			}
+			continue;
+		}
+
+		for (k = 0; k < keyCount && !(key_array[k].Identifier == key->Identifier && key_array[k].IDE == key->IDE); k++)
+		{
+		}
+		if (k == keyCount)
+		{
+			printf("txSchedule_array[%lu] 0x%lX is not in %s, record it again to include it\n", (unsigned long)entry,
+				(unsigned long)key->Identifier, path);
+			continue;
+		}
+		key_array[k].Compared = 1;
+		fseek(f, key_array[k].Position, SEEK_SET);
+		for (vector = 0; vector < vectorCount; vector++)
+		{
+			goldenResult_TypeDef golden;
+			const goldenResult_TypeDef *now = &result_array[vector];
+			uint32_t frameIndex;
+			uint8_t byteIndex;
+
+			if (ReadGolden(f, key, vector, &golden) == 0)
+			{
+				fprintf(stderr, "can_golden: %s ends or is damaged at message 0x%lX vector %lu\n", path,
+					(unsigned long)key->Identifier, (unsigned long)vector);
+				fclose(f);
+				return 2;
+			}
+			if (Equal(&golden, now, &byteIndex, &frameIndex) == 0)
+			{
+				if (mismatches == 0u)
+				{
+					printf("first mismatch: txSchedule_array[%lu] 0x%lX vector %lu frame %lu\n  golden ",
+						(unsigned long)entry, (unsigned long)key->Identifier, (unsigned long)vector, (unsigned long)frameIndex);
+					PrintFrame(stdout, key, vector, &golden);
+					printf("  now    ");
+					PrintFrame(stdout, key, vector, now);
+					if (byteIndex != 0xFFu)
+					{
+						uint8_t bits = golden.Frame[frameIndex].Data[byteIndex] ^ now->Frame[frameIndex].Data[byteIndex];
+
+						printf("  first differing byte %u, bit mask 0x%02X\n", byteIndex, bits);
+						ReportDrivers(entry, vector, frameIndex, byteIndex, bits);
+					}
+				}
+				mismatch_array[entry]++;
+				mismatches++;
+			}
+		}
+		compared += vectorCount;
+	}
+	wall = WallSeconds() - wall;
+	fclose(f);
+	free(result_array);
+	free(nameHash_array);
+
+	if (record)
+	{
+		printf("%lu vectors of %lu send functions recorded to %s in %.0f ms\n", (unsigned long)vectorCount,
+			(unsigned long)TX_MESSAGES_AVAILABLE, path, wall * 1e3);
+		return 0;
+	}
+	for (k = 0; k < keyCount; k++)
+	{
+		if (key_array[k].Compared == 0u)
+		{
+			printf("0x%lX of %s is no longer sent\n", (unsigned long)key_array[k].Identifier, path);
+			mismatches++;
+		}
+	}
+	for (entry = 0; entry < TX_MESSAGES_AVAILABLE; entry++)
+	{
+		if (mismatch_array[entry] != 0u)
+		{
+			printf("txSchedule_array[%lu] 0x%lX: %lu of %lu vectors differ\n", (unsigned long)entry,
+				(unsigned long)entryKey_array[entry].Identifier, (unsigned long)mismatch_array[entry], (unsigned long)vectorCount);
+		}
+	}
+	printf("%lu vectors compared in %.0f ms, %s\n", (unsigned long)compared, wall * 1e3,
+		(mismatches == 0u) ? "all equal" : "MISMATCH");
+	return (mismatches == 0u) ? 0 : 1;
+}
+
+/** @} */
@@ -0,0 +1,746 @@
+/**
+*******************************************************************************
+* @file can_netsim.c
+* @brief Host tool: discrete-event simulation of the CAN network around the module
+* @author FRIWO
+* @date 19.10.2026 - 20:41:07
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Runs CAN_custom.c on the simulated canApi as one node of a virtual bus,
+* together with the other nodes (BMS, display, external controller ...) of
+* the declared receive traffic. Further traffic, e.g. a misbehaving node, is
+* added with -x files of the same format:
+*   <id hex> <ide 0|1> <dlc> <period_ms> <sender node> [offset_ms]
+* Without offset the first release of a frame is placed at random within its
+* period, frames with the same offset and period are released as a burst.
+* -j adds a random release jitter of 0...jitter_us to every frame of the other
+* nodes. netsim_chatty_bms.txt is an example of a BMS which delays 0x111.
+*
+* Bus model:
+* - the length of every frame is computed bit by bit from SOF to the CRC
+*   delimiter with the stuff bits of its actual identifier, payload and CRC,
+*   plus ACK, EOF and intermission, at the bit time of -b
+* - whenever the bus turns idle, all pending frames arbitrate bitwise on
+*   identifier, SRR/RTR and IDE; the lowest value wins, the others count an
+*   arbitration loss and retry after the frame
+* - the other nodes have one mailbox per frame, a frame released before its
+*   previous instance was sent overwrites it (overrun)
+* - the module takes part with the next message of its canApi transmit
+*   buffer, i.e. in the order of the buffer mode set in canApi_UserInitCallBack()
+* - received frames pass the filter banks at the end of the frame, with
+*   CAN_RxIsrHook() at that time; no error frames are modelled
+*
+* Time advances from event to event (end of frame, release of a frame, 1ms
+* tick of the module), so idle bus time costs nothing and an hour of traffic
+* runs in seconds.
+*
+* The report shows per frame the count, overruns, arbitration losses and the
+* queueing delay from release to start of frame, plus the view of the module:
+* the longest receive gap of CAN_GetRxTiming() and the worst transmit latency
+* of CAN_GetTxLatency(). For the watched frame (-w, default 0x111) it lists
+* the frames it lost arbitration against and the latency from its end of frame
+* to the update of CAN_EXT_Alive_Counter.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_netsim can_netsim.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_netsim [-t duration_s] [-b bitrate] [-r rx_traffic.txt] [-x traffic.txt]... [-j jitter_us] [-w watch_id] [-s seed]
+*/
+
+/**
+* @addtogroup can_netsim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief maximum number of frames (own and other nodes) */
+#define NET_MAX_FRAMES 128u
+
+/** @brief maximum number of nodes including the module */
+#define NET_MAX_NODES 16u
+
+/** @brief maximum length of a node name */
+#define NET_MAX_NAME 48u
+
+/** @brief maximum number of -x traffic files */
+#define NET_MAX_FILES 8u
+
+/** @brief node index of the motor controller running CAN_custom.c */
+#define NET_NODE_OWN 0u
+
+/** @brief bits after the CRC: CRC delimiter, ACK slot, ACK delimiter, 7 EOF and 3 intermission */
+#define NET_TRAILER_BITS 13u
+
+/** @brief no time, e.g. no pending release */
+#define NET_NEVER UINT64_MAX
+
+/** @brief one millisecond in the time base of the simulation [ns] */
+#define NET_MS 1000000u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief One frame on the bus with its mailbox state and statistics, all times [ns] */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief CAN identifier */
+	uint8_t IDE; /**< @brief 0 = standard, 1 = extended identifier */
+	uint8_t DLC; /**< @brief payload length */
+	uint8_t Node; /**< @brief index into nodeName_array */
+	uint8_t Pending; /**< @brief 1 while an instance waits in the mailbox */
+	uint64_t Period; /**< @brief release period, 0 for frames of the module */
+	uint64_t Nominal; /**< @brief next release on the period grid, without jitter */
+	uint64_t NextRelease; /**< @brief next release of a frame of another node, with jitter */
+	uint64_t Queued; /**< @brief release of the pending instance */
+	uint32_t Count; /**< @brief number of transmissions */
+	uint32_t Overrun; /**< @brief instances overwritten before they were sent */
+	uint32_t ArbitrationLost; /**< @brief lost arbitration rounds */
+	uint64_t DelaySum; /**< @brief sum of the queueing delays */
+	uint64_t DelayMax; /**< @brief longest queueing delay */
+}netFrame_TypeDef;
+
+/** @brief Counter of the frames which won arbitration against the watched frame */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief winning identifier */
+	uint8_t IDE; /**< @brief identifier type of the winner */
+	uint32_t Count; /**< @brief number of won rounds */
+}netWinner_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static netFrame_TypeDef frame_array[NET_MAX_FRAMES];
+static uint32_t frameCount = 0;
+static char nodeName_array[NET_MAX_NODES][NET_MAX_NAME] = {"MotorController"};
+static uint32_t nodeCount = 1u;
+
+static netWinner_TypeDef winner_array[NET_MAX_FRAMES];
+static uint32_t winnerCount = 0;
+
+static uint32_t randomState = 1u;
+static uint64_t bitTimeNs = 2000u;
+static uint64_t jitterNs = 0u;
+static uint32_t watchId = 0x111u;
+
+/** @brief time since the module has the next message of its transmit buffer ready, NET_NEVER if none */
+static uint64_t ownReadySince = NET_NEVER;
+
+/** @brief end of the last instance of the watched frame delivered to the module, NET_NEVER once decoded */
+static uint64_t watchEndOfFrame = NET_NEVER;
+static uint64_t watchDecodeSum = 0;
+static uint64_t watchDecodeMax = 0;
+static uint32_t watchDecodeCount = 0;
+static const canApiSim_SignalTypeDef *watchSignal = 0;
+
+/** @brief simulated time [ns] */
+static uint64_t nowNs = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief xorshift32, reproducible with -s */
+static uint32_t Random(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+/**
+ * @brief Arbitration field as one number, a lower value wins the arbitration.
+ * Bit order on the bus: base identifier, RTR (standard) or SRR (extended), IDE,
+ * identifier extension, RTR (extended).
+ */
+static uint32_t ArbitrationKey(uint32_t identifier, uint8_t ide, uint8_t rtr)
+{
+	if (ide == 0u)
+	{
+		return ((identifier & 0x7FFu) << 21) | ((uint32_t)(rtr != 0u) << 20);
+	}
+	return (((identifier >> 18) & 0x7FFu) << 21) | (1u << 20) | (1u << 19)
+		| ((identifier & 0x3FFFFu) << 1) | (uint32_t)(rtr != 0u);
+}
+
+/**
+ * @brief Number of bits of a classic CAN frame on the bus, including the stuff bits of this payload
+ * @param message: frame to send
+ * @return bits from SOF to the end of the intermission
+ */
+static uint32_t FrameBits(const canApi_MessageTypedef *message)
+{
+	uint8_t bits[160];
+	uint32_t n = 0;
+	uint32_t i;
+	uint32_t crc = 0;
+	uint32_t stuffed;
+	uint32_t run;
+	uint8_t dlc = (message->DLC > 8u) ? 8u : message->DLC;
+	uint8_t dataBytes = (message->RTR != 0u) ? 0u : dlc;
+	int b;
+
+#define NET_PUT(value, width) for (b = (int)(width) - 1; b >= 0; b--) { bits[n++] = (uint8_t)(((value) >> b) & 1u); }
+	NET_PUT(0u, 1);
+	if (message->IDE == 0u)
+	{
+		NET_PUT(message->Identifier & 0x7FFu, 11);
+		NET_PUT((uint32_t)(message->RTR != 0u), 1);
+		NET_PUT(0u, 2); /* IDE, r0 */
+	}
+	else
+	{
+		NET_PUT((message->Identifier >> 18) & 0x7FFu, 11);
+		NET_PUT(3u, 2); /* SRR, IDE */
+		NET_PUT(message->Identifier & 0x3FFFFu, 18);
+		NET_PUT((uint32_t)(message->RTR != 0u), 1);
+		NET_PUT(0u, 2); /* r1, r0 */
+	}
+	NET_PUT(dlc, 4);
+	for (i = 0; i < dataBytes; i++)
+	{
+		NET_PUT(message->Data[i], 8);
+	}
+	for (i = 0; i < n; i++)
+	{
+		uint32_t next = ((crc >> 14) & 1u) ^ bits[i];
+
+		crc = (crc << 1) & 0x7FFFu;
+		if (next != 0u)
+		{
+			crc ^= 0x4599u;
+		}
+	}
+	NET_PUT(crc, 15);
+#undef NET_PUT
+
+	/* a stuff bit follows five equal bits and starts the next run itself */
+	stuffed = 0;
+	run = 1;
+	for (i = 1; i < n; i++)
+	{
+		if (bits[i] == bits[i - 1u] && run < 5u)
+		{
+			run++;
+		}
+		else if (run == 5u)
+		{
+			stuffed++;
+			run = (bits[i] == bits[i - 1u]) ? 1u : 2u;
+		}
+		else
+		{
+			run = 1;
+		}
+	}
+	if (run == 5u)
+	{
+		stuffed++;
+	}
+	return n + stuffed + NET_TRAILER_BITS;
+}
+
+static netFrame_TypeDef* FindFrame(uint32_t identifier, uint8_t ide)
+{
+	uint32_t i;
+
+	for (i = 0; i < frameCount; i++)
+	{
+		if (frame_array[i].Identifier == identifier && frame_array[i].IDE == ide)
+		{
+			return &frame_array[i];
+		}
+	}
+	return 0;
+}
+
+static netFrame_TypeDef* AddFrame(uint32_t identifier, uint8_t ide, uint8_t dlc, uint8_t node)
+{
+	netFrame_TypeDef *frame;
+
+	if (frameCount >= NET_MAX_FRAMES)
+	{
+		return 0;
+	}
+	frame = &frame_array[frameCount++];
+	memset(frame, 0, sizeof(*frame));
+	frame->Identifier = identifier;
+	frame->IDE = ide;
+	frame->DLC = dlc;
+	frame->Node = node;
+	frame->NextRelease = NET_NEVER;
+	return frame;
+}
+
+/**
+ * @brief Read the traffic of the other nodes.
+ * Each non-comment line reads "<id> <ide> <dlc> <period_ms> <node> [offset_ms]".
+ * @return number of frames read, negative on error
+ */
+static int ParseTraffic(const char *path)
+{
+	FILE *f = fopen(path, "r");
+	char line[256];
+	int found = 0;
+
+	if (f == 0)
+	{
+		fprintf(stderr, "can_netsim: cannot open %s\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f) != 0)
+	{
+		char node[NET_MAX_NAME];
+		unsigned long id, ide, dlc, period, offset;
+		netFrame_TypeDef *frame;
+		int fields;
+		uint32_t i;
+
+		fields = (line[0] == '#') ? 0 : sscanf(line, "%lx %lu %lu %lu %47s %lu", &id, &ide, &dlc, &period, node, &offset);
+		if (fields < 5 || period == 0u)
+		{
+			continue;
+		}
+		for (i = 1; i < nodeCount; i++)
+		{
+			if (strcmp(nodeName_array[i], node) == 0)
+			{
+				break;
+			}
+		}
+		if (i == nodeCount)
+		{
+			if (nodeCount >= NET_MAX_NODES)
+			{
+				fclose(f);
+				return -1;
+			}
+			strcpy(nodeName_array[nodeCount++], node);
+		}
+		if (FindFrame((uint32_t)id, (uint8_t)(ide != 0u)) != 0
+			|| (frame = AddFrame((uint32_t)id, (uint8_t)(ide != 0u), (uint8_t)((dlc > 8u) ? 8u : dlc), (uint8_t)i)) == 0)
+		{
+			fprintf(stderr, "can_netsim: %s: frame 0x%lX declared twice or too many frames\n", path, id);
+			fclose(f);
+			return -1;
+		}
+		frame->Period = (uint64_t)period * NET_MS;
+		frame->Nominal = (fields == 6) ? (uint64_t)offset * NET_MS : Random() % frame->Period;
+		frame->NextRelease = frame->Nominal;
+		found++;
+	}
+	fclose(f);
+	return found;
+}
+
+/**
+ * @brief Put every frame of the other nodes which is due into its mailbox
+ */
+static void ReleaseFrames(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < frameCount; i++)
+	{
+		netFrame_TypeDef *frame = &frame_array[i];
+
+		while (frame->NextRelease <= nowNs)
+		{
+			if (frame->Pending != 0u)
+			{
+				frame->Overrun++;
+			}
+			frame->Pending = 1;
+			frame->Queued = frame->NextRelease;
+			frame->Nominal += frame->Period;
+			frame->NextRelease = frame->Nominal + ((jitterNs != 0u) ? Random() % jitterNs : 0u);
+		}
+	}
+}
+
+static uint64_t NextReleaseTime(void)
+{
+	uint64_t next = NET_NEVER;
+	uint32_t i;
+
+	for (i = 0; i < frameCount; i++)
+	{
+		if (frame_array[i].NextRelease < next)
+		{
+			next = frame_array[i].NextRelease;
+		}
+	}
+	return next;
+}
+
+static void CountWinner(const canApi_MessageTypedef *winner)
+{
+	uint32_t i;
+
+	for (i = 0; i < winnerCount; i++)
+	{
+		if (winner_array[i].Identifier == winner->Identifier && winner_array[i].IDE == winner->IDE)
+		{
+			winner_array[i].Count++;
+			return;
+		}
+	}
+	if (winnerCount < NET_MAX_FRAMES)
+	{
+		winner_array[winnerCount].Identifier = winner->Identifier;
+		winner_array[winnerCount].IDE = winner->IDE;
+		winner_array[winnerCount].Count = 1;
+		winnerCount++;
+	}
+}
+
+static int CompareWinners(const void *a, const void *b)
+{
+	const netWinner_TypeDef *x = a;
+	const netWinner_TypeDef *y = b;
+
+	return (x->Count < y->Count) - (x->Count > y->Count);
+}
+
+static void OnSet(const canApiSim_SignalTypeDef *signal, Float64 value, uint32_t timestamp)
+{
+	(void)value;
+	(void)timestamp;
+	if (signal == watchSignal && watchEndOfFrame != NET_NEVER)
+	{
+		uint64_t latency = nowNs - watchEndOfFrame;
+
+		watchDecodeSum += latency;
+		watchDecodeCount++;
+		if (latency > watchDecodeMax)
+		{
+			watchDecodeMax = latency;
+		}
+		watchEndOfFrame = NET_NEVER;
+	}
+}
+
+static double WallSeconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_netsim [-t duration_s] [-b bitrate] [-r rx_traffic.txt] [-x traffic.txt]... [-j jitter_us] [-w watch_id] [-s seed]\n");
+}
+
+/**
+ * @brief Print the statistics of all frames and of the watched frame
+ */
+static void PrintReport(uint64_t busyNs, uint64_t frames, double wall)
+{
+	uint32_t i;
+
+	printf("%.1f s at %.0f bit/s, bus load %.1f %%, %llu frames, %.2f s wall (%.0fx realtime)\n\n",
+		nowNs / 1e9, 1e9 / (double)bitTimeNs, (nowNs != 0u) ? 100.0 * busyNs / nowNs : 0.0,
+		(unsigned long long)frames, wall, (wall > 0.0) ? nowNs / 1e9 / wall : 0.0);
+	printf("id          node                 count  overrun  arb lost  delay mean  delay max  module [us]\n");
+	for (i = 0; i < frameCount; i++)
+	{
+		const netFrame_TypeDef *frame = &frame_array[i];
+		CAN_RxTiming_TypeDef timing;
+		CAN_TxLatency_TypeDef latency;
+		char module[32] = "-";
+
+		if (frame->Node == NET_NODE_OWN
+			&& CAN_GetTxLatency(frame->Identifier, frame->IDE, &latency) == CAN_OK)
+		{
+			snprintf(module, sizeof(module), "tx max %lu", (unsigned long)latency.Max);
+		}
+		else if (frame->Node != NET_NODE_OWN
+			&& CAN_GetRxTiming(frame->Identifier, frame->IDE, &timing) == CAN_OK && timing.Count > 1u)
+		{
+			snprintf(module, sizeof(module), "rx gap max %lu", (unsigned long)timing.InterArrivalMax);
+		}
+		printf("0x%-8lX  %-18s  %7lu  %7lu  %8lu  %10.1f  %9.1f  %s\n", (unsigned long)frame->Identifier,
+			nodeName_array[frame->Node], (unsigned long)frame->Count, (unsigned long)frame->Overrun,
+			(unsigned long)frame->ArbitrationLost,
+			(frame->Count != 0u) ? frame->DelaySum / 1e3 / frame->Count : 0.0, frame->DelayMax / 1e3, module);
+	}
+
+	printf("\nwatch 0x%lX: ", (unsigned long)watchId);
+	if (winnerCount == 0u)
+	{
+		printf("never lost arbitration");
+	}
+	else
+	{
+		qsort(winner_array, winnerCount, sizeof(winner_array[0]), CompareWinners);
+		printf("lost arbitration against");
+		for (i = 0; i < winnerCount; i++)
+		{
+			printf(" 0x%lX (%lu)", (unsigned long)winner_array[i].Identifier, (unsigned long)winner_array[i].Count);
+		}
+	}
+	printf("\n");
+	if (watchDecodeCount != 0u)
+	{
+		printf("watch 0x%lX: end of frame to CAN_EXT_Alive_Counter update mean %.1f us, max %.1f us\n",
+			(unsigned long)watchId, watchDecodeSum / 1e3 / watchDecodeCount, watchDecodeMax / 1e3);
+	}
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	const char *rxPath = "rx_traffic.txt";
+	const char *extraPath_array[NET_MAX_FILES];
+	uint32_t extraCount = 0;
+	unsigned long durationS = 3600u;
+	unsigned long bitrate = 500000u;
+	canApi_MessageTypedef onBus;
+	netFrame_TypeDef *onBusFrame = 0;
+	uint64_t busEnd = NET_NEVER;
+	uint64_t busyNs = 0;
+	uint64_t frames = 0;
+	uint64_t endNs;
+	uint64_t moduleUs = 0;
+	double wall;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			durationS = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+		{
+			bitrate = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			rxPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc && extraCount < NET_MAX_FILES)
+		{
+			extraPath_array[extraCount++] = argv[++i];
+		}
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+		{
+			jitterNs = (uint64_t)strtoul(argv[++i], 0, 0) * 1000u;
+		}
+		else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+		{
+			watchId = (uint32_t)strtoul(argv[++i], 0, 16);
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			randomState = (uint32_t)strtoul(argv[++i], 0, 0);
+			randomState = (randomState == 0u) ? 1u : randomState;
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (bitrate == 0u || bitrate > 1000000u || durationS == 0u)
+	{
+		PrintUsage();
+		return 2;
+	}
+	bitTimeNs = 1000000000u / bitrate;
+	if (ParseTraffic(rxPath) < 0)
+	{
+		return 2;
+	}
+	for (i = 0; i < (int)extraCount; i++)
+	{
+		if (ParseTraffic(extraPath_array[i]) < 0)
+		{
+			return 2;
+		}
+	}
+
+	canApiSim_Init();
+	canApiSim_SetTxPerTick(CANAPI_SIM_TX_EXTERNAL);
+	canApiSim_SetSignalObserver(OnSet);
+	watchSignal = canApiSim_FindSignal("CAN_EXT_Alive_Counter");
+	memset(&onBus, 0, sizeof(onBus));
+
+	endNs = (uint64_t)durationS * 1000u * NET_MS;
+	wall = WallSeconds();
+	while (nowNs < endNs)
+	{
+		uint64_t next = (nowNs / NET_MS + 1u) * NET_MS;
+		uint64_t release = NextReleaseTime();
+
+		/* advance to the next event, the module runs every tick on the way */
+		if (busEnd < next)
+		{
+			next = busEnd;
+		}
+		if (release < next)
+		{
+			next = release;
+		}
+		nowNs = next;
+		if (nowNs / 1000u > moduleUs)
+		{
+			canApiSim_RunForUs((uint32_t)(nowNs / 1000u - moduleUs));
+			moduleUs = nowNs / 1000u;
+		}
+
+		if (nowNs >= busEnd)
+		{
+			if (onBusFrame->Node == NET_NODE_OWN)
+			{
+				canApiSim_CompleteTransmit(&onBus);
+			}
+			else
+			{
+				/* armed before the delivery, a fast path decodes within CAN_RxIsrHook() */
+				if (onBus.Identifier == watchId && onBus.IDE == 0u)
+				{
+					watchEndOfFrame = nowNs;
+				}
+				if (canApiSim_Receive(&onBus) != CAN_OK && onBus.Identifier == watchId && onBus.IDE == 0u)
+				{
+					watchEndOfFrame = NET_NEVER;
+				}
+			}
+			busEnd = NET_NEVER;
+		}
+
+		ReleaseFrames();
+		if (busEnd == NET_NEVER || ownReadySince == NET_NEVER)
+		{
+			canApi_MessageTypedef own;
+			uint8_t ownPending = (canApiSim_PeekTransmit(&own) == CAN_OK);
+			uint32_t bestKey = UINT32_MAX;
+			netFrame_TypeDef *best = 0;
+			uint8_t watchContends = 0;
+			uint32_t k;
+
+			if (ownPending != 0u && ownReadySince == NET_NEVER)
+			{
+				ownReadySince = nowNs;
+			}
+			if (busEnd != NET_NEVER)
+			{
+				continue;
+			}
+
+			/* bitwise arbitration: every pending frame sends its arbitration field, the lowest survives */
+			if (ownPending != 0u)
+			{
+				bestKey = ArbitrationKey(own.Identifier, own.IDE, own.RTR);
+				best = FindFrame(own.Identifier, own.IDE);
+				if (best == 0)
+				{
+					best = AddFrame(own.Identifier, own.IDE, own.DLC, NET_NODE_OWN);
+				}
+				if (best == 0)
+				{
+					fprintf(stderr, "can_netsim: too many frames\n");
+					return 2;
+				}
+				watchContends = (own.Identifier == watchId && own.IDE == 0u);
+			}
+			for (k = 0; k < frameCount; k++)
+			{
+				netFrame_TypeDef *frame = &frame_array[k];
+
+				if (frame->Pending != 0u)
+				{
+					uint32_t key = ArbitrationKey(frame->Identifier, frame->IDE, 0u);
+
+					watchContends |= (frame->Identifier == watchId && frame->IDE == 0u);
+					if (key < bestKey)
+					{
+						bestKey = key;
+						best = frame;
+					}
+				}
+			}
+
+			if (best != 0)
+			{
+				uint64_t delay;
+
+				for (k = 0; k < frameCount; k++)
+				{
+					if (&frame_array[k] != best && (frame_array[k].Pending != 0u
+						|| (ownPending != 0u && frame_array[k].Node == NET_NODE_OWN
+							&& frame_array[k].Identifier == own.Identifier && frame_array[k].IDE == own.IDE)))
+					{
+						frame_array[k].ArbitrationLost++;
+					}
+				}
+				if (best->Node == NET_NODE_OWN)
+				{
+					(void)canApiSim_TakeTransmit(&onBus);
+					delay = nowNs - ownReadySince;
+					ownReadySince = NET_NEVER;
+				}
+				else
+				{
+					uint32_t payload = Random();
+					uint32_t payload2 = Random();
+
+					memset(&onBus, 0, sizeof(onBus));
+					onBus.Identifier = best->Identifier;
+					onBus.IDE = best->IDE;
+					onBus.DLC = best->DLC;
+					for (k = 0; k < 8u; k++)
+					{
+						onBus.Data[k] = (uint8_t)(((k < 4u) ? payload : payload2) >> (8u * (k & 3u)));
+					}
+					delay = nowNs - best->Queued;
+					best->Pending = 0;
+				}
+				if (watchContends != 0u && !(best->Identifier == watchId && best->IDE == 0u))
+				{
+					CountWinner(&onBus);
+				}
+				best->Count++;
+				best->DelaySum += delay;
+				if (delay > best->DelayMax)
+				{
+					best->DelayMax = delay;
+				}
+				onBusFrame = best;
+				busEnd = nowNs + FrameBits(&onBus) * bitTimeNs;
+				busyNs += busEnd - nowNs;
+				frames++;
+			}
+		}
+	}
+	wall = WallSeconds() - wall;
+
+	PrintReport(busyNs, frames, wall);
+	return 0;
+}
+
+/** @} */
@@ -0,0 +1,707 @@
+/**
+*******************************************************************************
+* @file can_recorder.c
+* @brief Host tool: capture of the CAN flight recorder, fetched over UDS and checked
+* @author FRIWO
+* @date 21.10.2026 - 10:12:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Runs CAN_custom.c with received traffic on the identifiers of
+* msgManagment_array and its own periodic messages. After -t ms the tool stops
+* sending 0x111, its timeout triggers the flight recorder of CAN_recorder.c
+* (CAN_C_Recorder_TimeoutId). Once the capture is frozen a service tester
+* reads its state with DID CAN_UDS_DID_RECORDER and fetches the capture image
+* with ReadMemoryByAddress at CAN_UDS_RECORDER_ADDRESS, CAN_UDS_BLOCK_DATA
+* bytes per request, over one ISO-TP channel.
+*
+* The decoded records must be an unbroken sequence of the frames the tool saw
+* on the bus, with the same direction, identifier, data and microsecond time,
+* and must reach from before the trigger to after it. The negative responses
+* before the freeze and outside the image are checked as well.
+*
+* Reported are the pre- and post-trigger part of the capture, the mean record
+* size and the time of CAN_Recorder_Log() per frame on this host. -o writes
+* the capture as candump log, direction R or T at the end of each line.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_recorder can_recorder.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_recorder [-t stop_ms] [-p post_share_percent] [-P post_time_ms] [-o candump.log]
+*
+* The exit code is 0 if the capture matches the bus, 1 otherwise and 2 on
+* usage errors.
+*/
+
+/**
+* @addtogroup can_recorder
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+#include "CAN_recorder.h"
+#include "CAN_uds.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief time step of the traffic and the tester [us] */
+#define STEP_US 100u
+
+/** @brief frames of the bus the capture is compared with */
+#define REFERENCE_SIZE 200000u
+
+/** @brief frames of the module to the tester not yet handled */
+#define TESTER_QUEUE_SIZE 64u
+
+/** @brief largest UDS response [byte] */
+#define RESPONSE_MAX (1u + CAN_UDS_BLOCK_DATA)
+
+/** @brief the tester gives up if a response takes longer [us] */
+#define RESPONSE_TIMEOUT_US 2000000u
+
+/** @brief the capture has to freeze within this time after the stop of 0x111 [ms] */
+#define FREEZE_TIMEOUT_MS 10000u
+
+/** @brief calls of CAN_Recorder_Log() for the time per frame */
+#define TIMING_CALLS 4000000u
+
+/** @brief fill byte of the ISO-TP frames of the tester */
+#define PADDING 0xCCu
+
+/** @brief ISO-TP frame types */
+#define PCI_SINGLE 0x00u
+#define PCI_FIRST 0x10u
+#define PCI_CONSECUTIVE 0x20u
+#define PCI_FLOW 0x30u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief One frame the module received or transmitted
+ */
+typedef struct
+{
+	uint32_t Time; /**< @brief CAN_GetTimestampUs() of the frame [us] */
+	uint8_t Transmitted; /**< @brief 1 for a frame of the module */
+	canApi_MessageTypedef Message; /**< @brief the frame, Priority unused */
+}recFrame_TypeDef;
+
+/**
+ * @brief Received traffic, one periodic message
+ */
+typedef struct
+{
+	uint32_t Identifier;
+	uint8_t IDE;
+	uint8_t RTR;
+	uint8_t DLC;
+	uint32_t PeriodUs;
+	uint32_t PhaseUs;
+}recTraffic_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE CONSTANTS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief received traffic, 0x111 first, the filters of CAN_custom.c take no remote frames */
+static const recTraffic_TypeDef traffic_array[] =
+{
+	{0x111, 0, 0, 8, 10000u, 130u},
+	{0x1B6, 0, 0, 8, 20000u, 2470u},
+	{0x171, 0, 0, 8, 100000u, 5210u},
+	{0x172, 0, 0, 8, 1000000u, 7730u},
+	{0x310, 0, 0, 6, 50000u, 3310u},
+	{0x521, 0, 0, 8, 10000u, 4890u},
+	{0x600, 0, 0, 4, 100000u, 8120u},
+};
+
+/** @brief bytes of the time field per size code of the record header */
+static const uint8_t timeSize_array[4] = {0u, 1u, 2u, 4u};
+
+#define TRAFFIC_AVAILABLE (sizeof(traffic_array) / sizeof(recTraffic_TypeDef))
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static recFrame_TypeDef *reference = 0;
+static uint32_t referenceCount = 0;
+static uint8_t referenceOverflow = 0;
+static uint32_t nextSendUs[TRAFFIC_AVAILABLE];
+static uint32_t stopUs = 2000000u; /* -t, end of 0x111 */
+static uint32_t randomState = 1u;
+
+static canApi_MessageTypedef testerQueue[TESTER_QUEUE_SIZE];
+static uint32_t testerHead = 0;
+static uint32_t testerTail = 0;
+
+/* EnableTool variables of CAN_custom.c */
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_Enable;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_PostShare;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_PostTime;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Uds_Enable;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_recorder [-t stop_ms] [-p post_share_percent] [-P post_time_ms] [-o candump.log]\n");
+}
+
+static double WallSeconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static uint32_t Random(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static void AddReference(const canApi_MessageTypedef *message, uint8_t transmitted, uint32_t timestamp)
+{
+	if (referenceCount >= REFERENCE_SIZE)
+	{
+		referenceOverflow = 1;
+		return;
+	}
+	reference[referenceCount].Time = timestamp;
+	reference[referenceCount].Transmitted = transmitted;
+	reference[referenceCount].Message = *message;
+	referenceCount++;
+}
+
+/**
+ * @brief Every frame of the module goes into the reference, the UDS responses also to the tester
+ */
+static void OnTransmit(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	AddReference(message, 1, timestamp);
+	if (message->Identifier == CAN_UDS_RESPONSE_ID && message->IDE == 0u
+		&& testerHead - testerTail < TESTER_QUEUE_SIZE)
+	{
+		testerQueue[testerHead % TESTER_QUEUE_SIZE] = *message;
+		testerHead++;
+	}
+}
+
+static void SendToModule(const canApi_MessageTypedef *message)
+{
+	if (canApiSim_Receive(message) != CAN_INVALID_VALUE)
+	{
+		AddReference(message, 0, canApiSim_GetTimeUs());
+	}
+}
+
+/**
+ * @brief Run the module for one step and send the received traffic which is due
+ */
+static void Step(void)
+{
+	uint32_t now;
+	uint32_t i;
+	uint8_t n;
+
+	canApiSim_RunForUs(STEP_US);
+	now = canApiSim_GetTimeUs();
+	for (i = 0; i < TRAFFIC_AVAILABLE; i++)
+	{
+		canApi_MessageTypedef message;
+
+		if ((int32_t)(now - nextSendUs[i]) < 0)
+		{
+			continue;
+		}
+		nextSendUs[i] += traffic_array[i].PeriodUs;
+		if (i == 0u && now >= stopUs)
+		{
+			continue;
+		}
+		memset(&message, 0, sizeof(message));
+		message.Identifier = traffic_array[i].Identifier;
+		message.IDE = traffic_array[i].IDE;
+		message.RTR = traffic_array[i].RTR;
+		message.DLC = traffic_array[i].DLC;
+		for (n = 0; n < 8u; n++)
+		{
+			message.Data[n] = (traffic_array[i].RTR != 0u) ? 0u : (uint8_t)Random();
+		}
+		SendToModule(&message);
+	}
+}
+
+static void SendTesterFrame(const uint8_t *data, uint32_t length)
+{
+	canApi_MessageTypedef message;
+
+	memset(&message, 0, sizeof(message));
+	message.Identifier = CAN_UDS_REQUEST_ID;
+	message.DLC = 8;
+	memset(message.Data, PADDING, sizeof(message.Data));
+	memcpy(message.Data, data, length);
+	SendToModule(&message);
+}
+
+/**
+ * @brief Wait for the next frame of the module to the tester
+ * @return 0 if one arrived in time
+ */
+static int TesterWait(canApi_MessageTypedef *frame, uint32_t deadline)
+{
+	while (testerHead == testerTail)
+	{
+		if ((int32_t)(canApiSim_GetTimeUs() - deadline) >= 0)
+		{
+			return 1;
+		}
+		Step();
+	}
+	*frame = testerQueue[testerTail % TESTER_QUEUE_SIZE];
+	testerTail++;
+	return 0;
+}
+
+/**
+ * @brief Send a UDS request over ISO-TP and receive the response, responsePending is skipped
+ * @return response length, 0 on timeout or a broken transfer
+ */
+static uint32_t Request(const uint8_t *request, uint32_t length, uint8_t *response)
+{
+	canApi_MessageTypedef frame;
+	uint8_t data[8];
+	uint32_t deadline = canApiSim_GetTimeUs() + RESPONSE_TIMEOUT_US;
+	uint32_t total;
+	uint32_t received;
+	uint8_t sequence;
+
+	if (length <= 7u)
+	{
+		data[0] = (uint8_t)(PCI_SINGLE | length);
+		memcpy(&data[1], request, length);
+		SendTesterFrame(data, 1u + length);
+	}
+	else
+	{
+		uint32_t sent = 6;
+
+		data[0] = (uint8_t)(PCI_FIRST | (length >> 8));
+		data[1] = (uint8_t)length;
+		memcpy(&data[2], request, 6);
+		SendTesterFrame(data, 8);
+		if (TesterWait(&frame, deadline) != 0 || (frame.Data[0] & 0xF0u) != PCI_FLOW)
+		{
+			return 0;
+		}
+		for (sequence = 1; sent < length; sequence++)
+		{
+			uint32_t chunk = (length - sent > 7u) ? 7u : length - sent;
+
+			data[0] = (uint8_t)(PCI_CONSECUTIVE | (sequence & 0x0Fu));
+			memcpy(&data[1], &request[sent], chunk);
+			SendTesterFrame(data, 1u + chunk);
+			sent += chunk;
+			Step();
+		}
+	}
+
+	for (;;)
+	{
+		if (TesterWait(&frame, deadline) != 0)
+		{
+			return 0;
+		}
+		if ((frame.Data[0] & 0xF0u) == PCI_SINGLE)
+		{
+			total = frame.Data[0] & 0x0Fu;
+			if (total == 3u && frame.Data[1] == 0x7Fu && frame.Data[3] == 0x78u)
+			{
+				/* responsePending */
+				deadline = canApiSim_GetTimeUs() + RESPONSE_TIMEOUT_US;
+				continue;
+			}
+			memcpy(response, &frame.Data[1], total);
+			return total;
+		}
+		if ((frame.Data[0] & 0xF0u) == PCI_FIRST)
+		{
+			break;
+		}
+	}
+
+	total = ((uint32_t)(frame.Data[0] & 0x0Fu) << 8) | frame.Data[1];
+	if (total > RESPONSE_MAX)
+	{
+		return 0;
+	}
+	memcpy(response, &frame.Data[2], 6);
+	received = 6;
+	data[0] = PCI_FLOW;
+	data[1] = 0;
+	data[2] = 0;
+	SendTesterFrame(data, 3);
+	for (sequence = 1; received < total; sequence++)
+	{
+		uint32_t chunk = (total - received > 7u) ? 7u : total - received;
+
+		if (TesterWait(&frame, deadline) != 0 || frame.Data[0] != (uint8_t)(PCI_CONSECUTIVE | (sequence & 0x0Fu)))
+		{
+			return 0;
+		}
+		memcpy(&response[received], &frame.Data[1], chunk);
+		received += chunk;
+	}
+	return total;
+}
+
+/**
+ * @brief ReadMemoryByAddress with 4 address and 2 size bytes
+ * @return response length
+ */
+static uint32_t ReadMemory(uint32_t address, uint16_t size, uint8_t *response)
+{
+	uint8_t request[8];
+
+	request[0] = 0x23;
+	request[1] = 0x24;
+	request[2] = (uint8_t)(address >> 24);
+	request[3] = (uint8_t)(address >> 16);
+	request[4] = (uint8_t)(address >> 8);
+	request[5] = (uint8_t)address;
+	request[6] = (uint8_t)(size >> 8);
+	request[7] = (uint8_t)size;
+	return Request(request, sizeof(request), response);
+}
+
+static uint32_t GetUInt32(const uint8_t *source)
+{
+	return ((uint32_t)source[0] << 24) | ((uint32_t)source[1] << 16) | ((uint32_t)source[2] << 8) | source[3];
+}
+
+/**
+ * @brief Decode the capture image as described in CAN_recorder.h
+ * @return number of frames, 0 if the image is broken
+ */
+static uint32_t Decode(const uint8_t *image, uint32_t size, recFrame_TypeDef *frames, uint32_t maxFrames,
+	uint32_t *triggerIndex)
+{
+	uint32_t records = ((uint32_t)image[2] << 8) | image[3];
+	uint32_t time = GetUInt32(&image[4]);
+	uint32_t triggerOffset = ((uint32_t)image[12] << 8) | image[13];
+	uint32_t areaLength = ((uint32_t)image[14] << 8) | image[15];
+	uint32_t position = CAN_RECORDER_HEADER_SIZE;
+	uint32_t count = 0;
+
+	*triggerIndex = records;
+	if (image[0] != CAN_RECORDER_FORMAT || size != CAN_RECORDER_HEADER_SIZE + areaLength || records > maxFrames)
+	{
+		return 0;
+	}
+	while (position < size && count < records)
+	{
+		recFrame_TypeDef *frame = &frames[count];
+		uint8_t header = image[position];
+		uint8_t timeSize = timeSize_array[(header >> CAN_RECORDER_TIME_SHIFT) & 0x03u];
+		uint32_t delta = 0;
+		uint8_t dataLength;
+		uint8_t i;
+
+		if (position - CAN_RECORDER_HEADER_SIZE == triggerOffset)
+		{
+			*triggerIndex = count;
+		}
+		memset(frame, 0, sizeof(*frame));
+		frame->Transmitted = (uint8_t)((header & CAN_RECORDER_TRANSMITTED) != 0u);
+		frame->Message.DLC = (uint8_t)(header & CAN_RECORDER_DLC_MASK);
+		position++;
+		for (i = 0; i < timeSize; i++)
+		{
+			delta = (delta << 8) | image[position++];
+		}
+		time += delta;
+		frame->Time = time;
+		if ((header & CAN_RECORDER_LITERAL) == 0u)
+		{
+			uint32_t key = GetUInt32(&image[16u + 4u * image[position++]]);
+
+			frame->Message.IDE = (uint8_t)(key >> 31);
+			frame->Message.Identifier = key & 0x1FFFFFFFu;
+		}
+		else if ((image[position] & 0x80u) != 0u)
+		{
+			frame->Message.IDE = 1;
+			frame->Message.RTR = (uint8_t)((image[position] >> 6) & 1u);
+			frame->Message.Identifier = GetUInt32(&image[position]) & 0x1FFFFFFFu;
+			position += 4u;
+		}
+		else
+		{
+			frame->Message.RTR = (uint8_t)((image[position] >> 6) & 1u);
+			frame->Message.Identifier = (((uint32_t)image[position] & 0x07u) << 8) | image[position + 1u];
+			position += 2u;
+		}
+		dataLength = (frame->Message.RTR != 0u) ? 0u : ((frame->Message.DLC > 8u) ? 8u : frame->Message.DLC);
+		memcpy(frame->Message.Data, &image[position], dataLength);
+		position += dataLength;
+		count++;
+	}
+	return (position == size && count == records) ? count : 0u;
+}
+
+static int SameFrame(const recFrame_TypeDef *a, const recFrame_TypeDef *b)
+{
+	uint8_t dataLength = (a->Message.RTR != 0u) ? 0u : ((a->Message.DLC > 8u) ? 8u : a->Message.DLC);
+
+	return a->Time == b->Time && a->Transmitted == b->Transmitted && a->Message.Identifier == b->Message.Identifier
+		&& a->Message.IDE == b->Message.IDE && a->Message.RTR == b->Message.RTR && a->Message.DLC == b->Message.DLC
+		&& memcmp(a->Message.Data, b->Message.Data, dataLength) == 0;
+}
+
+static void WriteCandump(const char *path, const recFrame_TypeDef *frames, uint32_t count)
+{
+	FILE *file = fopen(path, "w");
+	uint32_t i;
+	uint8_t n;
+
+	if (file == 0)
+	{
+		fprintf(stderr, "can_recorder: cannot write %s\n", path);
+		return;
+	}
+	for (i = 0; i < count; i++)
+	{
+		const canApi_MessageTypedef *message = &frames[i].Message;
+
+		fprintf(file, "(%lu.%06lu) can0 ", (unsigned long)(frames[i].Time / 1000000u), (unsigned long)(frames[i].Time % 1000000u));
+		fprintf(file, (message->IDE != 0u) ? "%08lX#" : "%03lX#", (unsigned long)message->Identifier);
+		if (message->RTR != 0u)
+		{
+			fprintf(file, "R%u", (unsigned)message->DLC);
+		}
+		else
+		{
+			for (n = 0; n < message->DLC && n < 8u; n++)
+			{
+				fprintf(file, "%02X", message->Data[n]);
+			}
+		}
+		fprintf(file, " %c\n", (frames[i].Transmitted != 0u) ? 'T' : 'R');
+	}
+	fclose(file);
+}
+
+/**
+ * @brief Time of CAN_Recorder_Log() for a mix of the frames in the reference, the recorder records again afterwards
+ * @return time per call [ns]
+ */
+static double TimeLog(void)
+{
+	uint32_t timestamp = canApiSim_GetTimeUs();
+	uint32_t count = (referenceCount < 1024u) ? referenceCount : 1024u;
+	double start;
+	double seconds;
+	uint32_t i;
+
+	if (count == 0u)
+	{
+		return 0.0;
+	}
+	CAN_Recorder_Rearm();
+	start = WallSeconds();
+	for (i = 0; i < TIMING_CALLS; i++)
+	{
+		const recFrame_TypeDef *frame = &reference[i % count];
+
+		timestamp += 97u + (i & 0x3FFu);
+		CAN_Recorder_Log(&frame->Message, frame->Transmitted, timestamp);
+	}
+	seconds = WallSeconds() - start;
+	CAN_Recorder_Rearm();
+	return seconds * 1e9 / TIMING_CALLS;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char *argv[])
+{
+	static uint8_t image[CAN_RECORDER_HEADER_SIZE + CAN_RECORDER_SIZE];
+	static uint8_t response[RESPONSE_MAX];
+	static recFrame_TypeDef frames[CAN_RECORDER_SIZE];
+	const char *candumpPath = 0;
+	long postShare = 25;
+	long postTime = 1000;
+	uint32_t length;
+	uint32_t size;
+	uint32_t state;
+	uint32_t count;
+	uint32_t triggerIndex;
+	uint32_t first;
+	uint32_t i;
+	int failed = 0;
+
+	for (i = 1; i < (uint32_t)argc; i++)
+	{
+		if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-t") == 0)
+		{
+			stopUs = 1000u * (uint32_t)strtoul(argv[++i], 0, 0);
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-p") == 0)
+		{
+			postShare = strtol(argv[++i], 0, 0);
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-P") == 0)
+		{
+			postTime = strtol(argv[++i], 0, 0);
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-o") == 0)
+		{
+			candumpPath = argv[++i];
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (stopUs < 500000u || stopUs > 600000000u || postShare < 0 || postShare > (long)CAN_RECORDER_POST_MAX
+		|| postTime < 0 || postTime > 60000)
+	{
+		PrintUsage();
+		return 2;
+	}
+	reference = malloc(REFERENCE_SIZE * sizeof(recFrame_TypeDef));
+	if (reference == 0)
+	{
+		return 1;
+	}
+
+	/* the UDS filter is set by the init of the CAN peripheral */
+	CAN_C_Uds_Enable = 1;
+	canApiSim_Init();
+	canApiSim_SetTransmitObserver(OnTransmit);
+	CAN_C_Recorder_Enable = 1;
+	CAN_C_Recorder_PostShare = (UInt32)postShare;
+	CAN_C_Recorder_PostTime = (UInt32)postTime;
+	for (i = 0; i < TRAFFIC_AVAILABLE; i++)
+	{
+		nextSendUs[i] = traffic_array[i].PhaseUs;
+	}
+
+	/* no image before the trigger */
+	while (canApiSim_GetTimeUs() < stopUs / 2u)
+	{
+		Step();
+	}
+	length = ReadMemory(CAN_UDS_RECORDER_ADDRESS, 16, response);
+	if (length != 3u || response[0] != 0x7Fu || response[2] != 0x22u)
+	{
+		printf("FAIL: ReadMemoryByAddress before the trigger not answered with conditionsNotCorrect\n");
+		failed = 1;
+	}
+
+	while ((CAN_Recorder_GetState() & 0xFFu) != CAN_RECORDER_FROZEN
+		&& canApiSim_GetTimeUs() < stopUs + FREEZE_TIMEOUT_MS * 1000u)
+	{
+		Step();
+	}
+	length = Request((const uint8_t *)"\x22\xF1\xA3", 3, response);
+	if (length != 11u || response[0] != 0x62u)
+	{
+		printf("FAIL: DID 0x%04X not read\n", CAN_UDS_DID_RECORDER);
+		return 1;
+	}
+	state = GetUInt32(&response[3]);
+	size = GetUInt32(&response[7]);
+	printf("recorder state %lu, cause %lu, image %lu bytes\n", (unsigned long)(state & 0xFFu),
+		(unsigned long)((state >> 8) & 0xFFu), (unsigned long)size);
+	if ((state & 0xFFu) != CAN_RECORDER_FROZEN || ((state >> 8) & 0xFFu) != CAN_RECORDER_CAUSE_TIMEOUT
+		|| size < CAN_RECORDER_HEADER_SIZE || size > sizeof(image))
+	{
+		printf("FAIL: no capture of the timeout of 0x111\n");
+		return 1;
+	}
+
+	for (i = 0; i < size; i += length - 1u)
+	{
+		uint16_t chunk = (uint16_t)((size - i > CAN_UDS_BLOCK_DATA) ? CAN_UDS_BLOCK_DATA : size - i);
+
+		length = ReadMemory(CAN_UDS_RECORDER_ADDRESS + i, chunk, response);
+		if (length != 1u + chunk || response[0] != 0x63u)
+		{
+			printf("FAIL: ReadMemoryByAddress at offset %lu\n", (unsigned long)i);
+			return 1;
+		}
+		memcpy(&image[i], &response[1], chunk);
+	}
+	length = ReadMemory(CAN_UDS_RECORDER_ADDRESS + size - 1u, 2, response);
+	if (length != 3u || response[0] != 0x7Fu || response[2] != 0x31u)
+	{
+		printf("FAIL: ReadMemoryByAddress beyond the image not answered with requestOutOfRange\n");
+		failed = 1;
+	}
+
+	count = Decode(image, size, frames, CAN_RECORDER_SIZE, &triggerIndex);
+	if (count == 0u || referenceOverflow != 0u)
+	{
+		printf("FAIL: capture image not decoded\n");
+		return 1;
+	}
+	for (first = 0; first < referenceCount && SameFrame(&reference[first], &frames[0]) == 0; first++)
+	{
+	}
+	for (i = 0; i < count && first + i < referenceCount && SameFrame(&reference[first + i], &frames[i]) != 0; i++)
+	{
+	}
+	if (i != count)
+	{
+		printf("FAIL: record %lu of %lu differs from the bus\n", (unsigned long)i, (unsigned long)count);
+		failed = 1;
+	}
+	if (triggerIndex == 0u || triggerIndex > count || (triggerIndex == count && postShare > 0))
+	{
+		printf("FAIL: trigger not inside the capture\n");
+		failed = 1;
+	}
+	else
+	{
+		uint32_t triggerTime = GetUInt32(&image[8]);
+
+		printf("%lu frames, %lu before the trigger (%.1f ms), %lu after it (%.1f ms), %.2f bytes per frame\n",
+			(unsigned long)count, (unsigned long)triggerIndex, (triggerTime - frames[0].Time) / 1000.0,
+			(unsigned long)(count - triggerIndex), (triggerIndex < count) ? (frames[count - 1u].Time - triggerTime) / 1000.0 : 0.0,
+			(double)(size - CAN_RECORDER_HEADER_SIZE) / count);
+		printf("trigger at %.3f ms, last 0x111 received before %.3f ms\n", triggerTime / 1000.0, stopUs / 1000.0);
+	}
+	if (candumpPath != 0)
+	{
+		WriteCandump(candumpPath, frames, count);
+	}
+	printf("CAN_Recorder_Log(): %.1f ns per frame on this host\n", TimeLog());
+	printf("%s\n", (failed == 0) ? "capture matches the bus" : "FAIL");
+	free(reference);
+	return failed;
+}
+
+/** @} */
@@ -0,0 +1,833 @@
+/**
+*******************************************************************************
+* @file can_replay.c
+* @brief Host tool: replay candump and Vector ASC logs through CAN_custom.c
+* @author FRIWO
+* @date 19.10.2026 - 18:05:30
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Every frame of the log is delivered to the simulated canApi at its original
+* time offset, so the module sees the recorded inter-frame timing on its 1ms
+* tick grid. The simulation runs as fast as possible by default; -s paces it
+* against the wall clock (1 = real time, 10 = ten times faster).
+*
+* Every canApi_Set_ output and every transmitted frame is written to a compact
+* binary trace (-w). -d prints a trace as text, e.g. to diff two runs.
+*
+* Supported log formats, detected per line:
+*   candump -l:   (1700000000.123456) can0 123#DEADBEEF
+*   candump -ta:  (1700000000.123456)  can0  123   [4]  DE AD BE EF
+*   Vector ASC:   0.012345 1  1FFFFF00x       Rx   d 8 00 11 22 33 44 55 66 77
+* ASC "base dec" and "timestamps relative" headers are honoured. Remote
+* frames are replayed, error frames, CAN FD frames and events are skipped.
+*
+* Trace format, all integers little endian:
+*   "CANTRACE", uint8 version (1), uint16 signal count,
+*   per signal: uint8 type (canApiSim_SignalType), uint8 name length, name
+*   then records: uint8 tag, varint time delta to the previous record [us]
+*     tag 1 SET: varint signal index, value in the basetype of the signal
+*     tag 2 TX:  varint identifier | IDE << 29 | RTR << 30, uint8 DLC, DLC bytes
+* SET records are only written when the value changes, -a writes every call.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_replay can_replay.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_replay [-s speed] [-i channel] [-a] [-w trace.bin] log.(log|asc)
+*        can_replay -d trace.bin
+*/
+
+/**
+* @addtogroup can_replay
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief trace file identification */
+#define TRACE_MAGIC "CANTRACE"
+#define TRACE_VERSION 1u
+
+/** @brief record tags */
+#define TRACE_TAG_SET 1u
+#define TRACE_TAG_TX 2u
+
+/** @brief maximum number of canApi signals in a trace */
+#define TRACE_MAX_SIGNALS 256u
+
+/** @brief longest simulation step, keeps canApiSim_RunForUs() far from the 32 bit wrap */
+#define REPLAY_MAX_STEP_US 1000000000u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief State of the log parser */
+typedef struct
+{
+	uint8_t AscHex; /**< @brief ASC identifiers and data in hex (default) or decimal */
+	uint8_t AscRelative; /**< @brief ASC timestamps relative to the previous frame */
+	uint64_t AscLastUs; /**< @brief last absolute ASC timestamp */
+	const char *Channel; /**< @brief only frames of this channel, 0 = all */
+}replayParser_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static FILE *traceFile = 0;
+static uint32_t traceLastUs = 0;
+static uint8_t traceAllSets = 0;
+static const canApiSim_SignalTypeDef *signalBase = 0;
+static uint32_t signalLast_array[TRACE_MAX_SIGNALS];
+static uint8_t signalSeen_array[TRACE_MAX_SIGNALS];
+static uint64_t traceRecords = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* trace writer */
+
+static void PutVarint(uint64_t value)
+{
+	while (value >= 0x80u)
+	{
+		putc((int)(value & 0x7Fu) | 0x80, traceFile);
+		value >>= 7;
+	}
+	putc((int)value, traceFile);
+}
+
+static void PutLE(uint32_t value, unsigned bytes)
+{
+	while (bytes-- > 0u)
+	{
+		putc((int)(value & 0xFFu), traceFile);
+		value >>= 8;
+	}
+}
+
+/** @brief Size of a signal value in the trace */
+static unsigned SignalBytes(canApiSim_SignalType type)
+{
+	switch (type)
+	{
+		case CANAPI_SIM_UINT8:
+			return 1u;
+		case CANAPI_SIM_INT16:
+			return 2u;
+		default:
+			return 4u;
+	}
+}
+
+/** @brief Raw bits of a signal value in its basetype */
+static uint32_t SignalRaw(const canApiSim_SignalTypeDef *signal)
+{
+	uint32_t raw = 0;
+
+	switch (signal->Type)
+	{
+		case CANAPI_SIM_FLOAT32:
+			memcpy(&raw, signal->Value, sizeof(Float32));
+			break;
+		case CANAPI_SIM_INT16:
+			raw = (uint16_t)*(const Int16*)signal->Value;
+			break;
+		case CANAPI_SIM_UINT32:
+			raw = (uint32_t)*(const UInt32*)signal->Value;
+			break;
+		case CANAPI_SIM_UINT8:
+			raw = *(const UInt8*)signal->Value;
+			break;
+	}
+	return raw;
+}
+
+static void PutRecordHeader(uint8_t tag, uint32_t timestamp)
+{
+	putc(tag, traceFile);
+	PutVarint(timestamp - traceLastUs);
+	traceLastUs = timestamp;
+	traceRecords++;
+}
+
+static void OnSet(const canApiSim_SignalTypeDef *signal, Float64 value, uint32_t timestamp)
+{
+	uint32_t index = (uint32_t)(signal - signalBase);
+	uint32_t raw = SignalRaw(signal);
+
+	(void)value;
+	if (index >= TRACE_MAX_SIGNALS
+		|| (traceAllSets == 0 && signalSeen_array[index] != 0 && signalLast_array[index] == raw))
+	{
+		return;
+	}
+	signalSeen_array[index] = 1;
+	signalLast_array[index] = raw;
+	PutRecordHeader(TRACE_TAG_SET, timestamp);
+	PutVarint(index);
+	PutLE(raw, SignalBytes(signal->Type));
+}
+
+static void OnTransmit(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	uint8_t dlc = (message->DLC > 8u) ? 8u : message->DLC;
+
+	PutRecordHeader(TRACE_TAG_TX, timestamp);
+	PutVarint((uint64_t)message->Identifier | ((uint64_t)(message->IDE & 1u) << 29) | ((uint64_t)(message->RTR & 1u) << 30));
+	putc(dlc, traceFile);
+	fwrite(message->Data, 1, dlc, traceFile);
+}
+
+static void WriteTraceHeader(void)
+{
+	uint32_t count = canApiSim_GetSignalCount();
+	uint32_t i;
+
+	fwrite(TRACE_MAGIC, 1, 8, traceFile);
+	putc(TRACE_VERSION, traceFile);
+	PutLE(count, 2);
+	for (i = 0; i < count; i++)
+	{
+		const canApiSim_SignalTypeDef *signal = canApiSim_GetSignalByIndex(i);
+		size_t length = strlen(signal->Name);
+
+		putc(signal->Type, traceFile);
+		putc((int)length, traceFile);
+		fwrite(signal->Name, 1, length, traceFile);
+	}
+}
+
+/* log parser */
+
+static const char* SkipSpace(const char *p)
+{
+	while (*p == ' ' || *p == '\t')
+	{
+		p++;
+	}
+	return p;
+}
+
+static int HexDigit(char c)
+{
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f')
+	{
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+/**
+ * @brief Parse an unsigned number in base 16 or 10
+ * @return pointer behind the number, 0 if no digit was found
+ */
+static const char* ParseNumber(const char *p, uint8_t hex, uint32_t *value, unsigned *digits)
+{
+	uint32_t v = 0;
+	unsigned n = 0;
+	int d;
+
+	while ((d = hex ? HexDigit(*p) : ((*p >= '0' && *p <= '9') ? *p - '0' : -1)) >= 0)
+	{
+		v = v * (hex ? 16u : 10u) + (uint32_t)d;
+		p++;
+		n++;
+	}
+	*value = v;
+	if (digits != 0)
+	{
+		*digits = n;
+	}
+	return (n > 0) ? p : 0;
+}
+
+/**
+ * @brief Parse a timestamp "seconds.fraction" into microseconds
+ * @return pointer behind the timestamp, 0 on error
+ */
+static const char* ParseTime(const char *p, uint64_t *us)
+{
+	uint64_t seconds = 0;
+	uint64_t fraction = 0;
+	unsigned digits = 0;
+
+	if (*p < '0' || *p > '9')
+	{
+		return 0;
+	}
+	while (*p >= '0' && *p <= '9')
+	{
+		seconds = seconds * 10u + (uint64_t)(*p++ - '0');
+	}
+	if (*p == '.')
+	{
+		p++;
+		while (*p >= '0' && *p <= '9')
+		{
+			if (digits < 6u)
+			{
+				fraction = fraction * 10u + (uint64_t)(*p - '0');
+				digits++;
+			}
+			p++;
+		}
+	}
+	while (digits < 6u)
+	{
+		fraction *= 10u;
+		digits++;
+	}
+	*us = seconds * 1000000u + fraction;
+	return p;
+}
+
+/** @brief Compare a channel token with the -i selection */
+static int ChannelMatches(const replayParser_TypeDef *parser, const char *token, size_t length)
+{
+	return parser->Channel == 0
+		|| (strlen(parser->Channel) == length && strncmp(parser->Channel, token, length) == 0);
+}
+
+/**
+ * @brief Parse the payload "XX XX XX" of the candump -ta and ASC formats
+ */
+static int ParseByteList(const char *p, uint8_t hex, canApi_MessageTypedef *message)
+{
+	uint8_t i;
+
+	for (i = 0; i < message->DLC; i++)
+	{
+		uint32_t value;
+
+		p = SkipSpace(p);
+		p = ParseNumber(p, hex, &value, 0);
+		if (p == 0 || value > 0xFFu)
+		{
+			return 0;
+		}
+		message->Data[i] = (uint8_t)value;
+	}
+	return 1;
+}
+
+/**
+ * @brief Parse one candump line, with the timestamp already consumed
+ * @return 1 if a frame was read
+ */
+static int ParseCandump(replayParser_TypeDef *parser, const char *p, canApi_MessageTypedef *message)
+{
+	const char *channel = SkipSpace(p);
+	uint32_t id;
+	unsigned digits;
+
+	p = channel;
+	while (*p != ' ' && *p != '\t' && *p != '\0')
+	{
+		p++;
+	}
+	if (!ChannelMatches(parser, channel, (size_t)(p - channel)))
+	{
+		return 0;
+	}
+	p = ParseNumber(SkipSpace(p), 1, &id, &digits);
+	if (p == 0)
+	{
+		return 0;
+	}
+	message->Identifier = id;
+	message->IDE = (digits > 3u) ? 1u : 0u;
+
+	if (*p == '#')
+	{
+		/* candump -l: 123#DEADBEEF, 123#R, CAN FD 123##1... is skipped */
+		p++;
+		if (*p == '#')
+		{
+			return 0;
+		}
+		if (*p == 'R')
+		{
+			uint32_t dlc = 0;
+
+			message->RTR = 1;
+			(void)ParseNumber(p + 1, 0, &dlc, 0);
+			message->DLC = (uint8_t)((dlc > 8u) ? 8u : dlc);
+			return 1;
+		}
+		while (HexDigit(p[0]) >= 0 && HexDigit(p[1]) >= 0)
+		{
+			if (message->DLC >= 8u)
+			{
+				return 0;
+			}
+			message->Data[message->DLC++] = (uint8_t)(HexDigit(p[0]) * 16 + HexDigit(p[1]));
+			p += 2;
+			if (*p == '.')
+			{
+				p++;
+			}
+		}
+		return 1;
+	}
+
+	/* candump -ta: 123   [4]  DE AD BE EF, remote frames print "remote request" */
+	p = SkipSpace(p);
+	if (*p == '[')
+	{
+		uint32_t dlc;
+
+		p = ParseNumber(p + 1, 0, &dlc, 0);
+		if (p == 0 || *p != ']' || dlc > 8u)
+		{
+			return 0;
+		}
+		message->DLC = (uint8_t)dlc;
+		if (strstr(p, "remote request") != 0)
+		{
+			message->RTR = 1;
+			return 1;
+		}
+		return ParseByteList(p + 1, 1, message);
+	}
+	return 0;
+}
+
+/**
+ * @brief Parse one ASC line
+ * @return 1 if a frame was read
+ */
+static int ParseAsc(replayParser_TypeDef *parser, const char *p, uint64_t *us, canApi_MessageTypedef *message)
+{
+	uint64_t timestamp;
+	const char *channel;
+	uint32_t id;
+	uint32_t dlc;
+
+	if (strncmp(p, "base ", 5) == 0)
+	{
+		parser->AscHex = (strstr(p, "base dec") == 0);
+		parser->AscRelative = (strstr(p, "timestamps relative") != 0);
+		return 0;
+	}
+	p = ParseTime(p, &timestamp);
+	if (p == 0)
+	{
+		return 0;
+	}
+	channel = SkipSpace(p);
+	p = channel;
+	while (*p >= '0' && *p <= '9')
+	{
+		p++;
+	}
+	if (p == channel || !ChannelMatches(parser, channel, (size_t)(p - channel)))
+	{
+		return 0;
+	}
+	p = ParseNumber(SkipSpace(p), parser->AscHex, &id, 0);
+	if (p == 0)
+	{
+		return 0;
+	}
+	message->Identifier = id;
+	if (*p == 'x')
+	{
+		message->IDE = 1;
+		p++;
+	}
+	p = SkipSpace(p);
+	if (strncmp(p, "Rx", 2) != 0 && strncmp(p, "Tx", 2) != 0)
+	{
+		return 0;
+	}
+	p = SkipSpace(p + 2);
+	if (*p == 'r')
+	{
+		message->RTR = 1;
+		p = SkipSpace(p + 1);
+		message->DLC = 0;
+		if (ParseNumber(p, 16, &dlc, 0) != 0 && dlc <= 8u)
+		{
+			message->DLC = (uint8_t)dlc;
+		}
+	}
+	else if (*p == 'd')
+	{
+		p = ParseNumber(SkipSpace(p + 1), 1, &dlc, 0);
+		if (p == 0 || dlc > 8u)
+		{
+			return 0;
+		}
+		message->DLC = (uint8_t)dlc;
+		if (!ParseByteList(p, parser->AscHex, message))
+		{
+			return 0;
+		}
+	}
+	else
+	{
+		return 0;
+	}
+	if (parser->AscRelative)
+	{
+		timestamp += parser->AscLastUs;
+	}
+	parser->AscLastUs = timestamp;
+	*us = timestamp;
+	return 1;
+}
+
+/**
+ * @brief Parse one log line of any supported format
+ * @return 1 if a frame was read
+ */
+static int ParseLine(replayParser_TypeDef *parser, const char *line, uint64_t *us, canApi_MessageTypedef *message)
+{
+	const char *p = SkipSpace(line);
+
+	memset(message, 0, sizeof(*message));
+	if (*p == '(')
+	{
+		p = ParseTime(p + 1, us);
+		if (p == 0 || *p != ')')
+		{
+			return 0;
+		}
+		return ParseCandump(parser, p + 1, message);
+	}
+	return ParseAsc(parser, p, us, message);
+}
+
+/* trace reader */
+
+static int GetVarint(FILE *f, uint64_t *value)
+{
+	uint64_t v = 0;
+	unsigned shift = 0;
+	int c;
+
+	do
+	{
+		c = getc(f);
+		if (c == EOF || shift > 63u)
+		{
+			return 0;
+		}
+		v |= (uint64_t)(c & 0x7F) << shift;
+		shift += 7u;
+	} while (c & 0x80);
+	*value = v;
+	return 1;
+}
+
+/**
+ * @brief Print a trace as text, one record per line
+ * @return 0 on success, 2 on format errors
+ */
+static int DumpTrace(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	char magic[8];
+	char name_array[TRACE_MAX_SIGNALS][64];
+	uint8_t type_array[TRACE_MAX_SIGNALS];
+	uint64_t time = 0;
+	unsigned count;
+	unsigned i;
+	int c;
+
+	if (f == 0 || fread(magic, 1, 8, f) != 8 || memcmp(magic, TRACE_MAGIC, 8) != 0 || getc(f) != (int)TRACE_VERSION)
+	{
+		fprintf(stderr, "can_replay: %s is no trace file\n", path);
+		if (f != 0)
+		{
+			fclose(f);
+		}
+		return 2;
+	}
+	count = (unsigned)getc(f);
+	count |= (unsigned)getc(f) << 8;
+	if (count > TRACE_MAX_SIGNALS)
+	{
+		fclose(f);
+		return 2;
+	}
+	for (i = 0; i < count; i++)
+	{
+		int length;
+
+		type_array[i] = (uint8_t)getc(f);
+		length = getc(f);
+		if (length < 0 || length > 63 || fread(name_array[i], 1, (size_t)length, f) != (size_t)length)
+		{
+			fclose(f);
+			return 2;
+		}
+		name_array[i][length] = '\0';
+	}
+
+	while ((c = getc(f)) != EOF)
+	{
+		uint64_t delta;
+		uint64_t value;
+
+		if (!GetVarint(f, &delta))
+		{
+			break;
+		}
+		time += delta;
+		if (c == (int)TRACE_TAG_SET)
+		{
+			uint32_t raw = 0;
+			unsigned bytes;
+
+			if (!GetVarint(f, &value) || value >= count)
+			{
+				break;
+			}
+			bytes = SignalBytes((canApiSim_SignalType)type_array[value]);
+			for (i = 0; i < bytes; i++)
+			{
+				raw |= (uint32_t)getc(f) << (8u * i);
+			}
+			printf("%llu SET %s ", (unsigned long long)time, name_array[value]);
+			switch (type_array[value])
+			{
+				case CANAPI_SIM_FLOAT32:
+				{
+					Float32 f32;
+
+					memcpy(&f32, &raw, sizeof(f32));
+					printf("%.9g\n", (double)f32);
+					break;
+				}
+				case CANAPI_SIM_INT16:
+					printf("%d\n", (int)(int16_t)raw);
+					break;
+				default:
+					printf("%lu\n", (unsigned long)raw);
+					break;
+			}
+		}
+		else if (c == (int)TRACE_TAG_TX)
+		{
+			int dlc;
+
+			if (!GetVarint(f, &value))
+			{
+				break;
+			}
+			dlc = getc(f);
+			printf("%llu TX %0*lX%s [%d]", (unsigned long long)time, (value >> 29) & 1u ? 8 : 3,
+				(unsigned long)(value & 0x1FFFFFFFu), (value >> 30) & 1u ? " R" : "", dlc);
+			for (i = 0; i < (unsigned)dlc && i < 8u; i++)
+			{
+				printf(" %02X", getc(f));
+			}
+			printf("\n");
+		}
+		else
+		{
+			fprintf(stderr, "can_replay: unknown record %d\n", c);
+			fclose(f);
+			return 2;
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+/* pacing */
+
+static uint64_t WallUs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_replay [-s speed] [-i channel] [-a] [-w trace.bin] log\n"
+		"       can_replay -d trace.bin\n");
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	replayParser_TypeDef parser = {1, 0, 0, 0};
+	const char *logPath = 0;
+	const char *tracePath = 0;
+	double speed = 0.0;
+	FILE *log;
+	char line[512];
+	canApi_MessageTypedef message;
+	uint64_t firstUs = 0;
+	uint64_t simUs = 0;
+	uint64_t frames = 0;
+	uint64_t accepted = 0;
+	uint64_t dropped = 0;
+	uint64_t wallStart;
+	double wall;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+		{
+			return DumpTrace(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			speed = strtod(argv[++i], 0);
+		}
+		else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+		{
+			parser.Channel = argv[++i];
+		}
+		else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			traceAllSets = 1;
+		}
+		else if (argv[i][0] != '-' && logPath == 0)
+		{
+			logPath = argv[i];
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (logPath == 0)
+	{
+		PrintUsage();
+		return 2;
+	}
+	log = fopen(logPath, "r");
+	if (log == 0)
+	{
+		fprintf(stderr, "can_replay: cannot open %s\n", logPath);
+		return 2;
+	}
+
+	canApiSim_Init();
+	signalBase = canApiSim_GetSignalByIndex(0);
+	if (tracePath != 0)
+	{
+		traceFile = fopen(tracePath, "wb");
+		if (traceFile == 0)
+		{
+			fprintf(stderr, "can_replay: cannot write %s\n", tracePath);
+			fclose(log);
+			return 2;
+		}
+		setvbuf(traceFile, 0, _IOFBF, 1u << 20);
+		WriteTraceHeader();
+		canApiSim_SetSignalObserver(OnSet);
+		canApiSim_SetTransmitObserver(OnTransmit);
+	}
+
+	wallStart = WallUs();
+	while (fgets(line, sizeof(line), log) != 0)
+	{
+		uint64_t frameUs;
+
+		if (!ParseLine(&parser, line, &frameUs, &message))
+		{
+			continue;
+		}
+		if (frames == 0)
+		{
+			firstUs = frameUs;
+		}
+		frames++;
+
+		/* run the module up to the arrival time, logs are not always strictly monotonic */
+		frameUs = (frameUs > firstUs) ? frameUs - firstUs : 0u;
+		while (frameUs > simUs)
+		{
+			uint64_t step = frameUs - simUs;
+
+			if (step > REPLAY_MAX_STEP_US)
+			{
+				step = REPLAY_MAX_STEP_US;
+			}
+			canApiSim_RunForUs((uint32_t)step);
+			simUs += step;
+		}
+		if (speed > 0.0)
+		{
+			uint64_t due = wallStart + (uint64_t)((double)simUs / speed);
+			uint64_t now = WallUs();
+
+			if (due > now + 1000u)
+			{
+				struct timespec ts;
+
+				ts.tv_sec = (time_t)((due - now) / 1000000u);
+				ts.tv_nsec = (long)(((due - now) % 1000000u) * 1000u);
+				nanosleep(&ts, 0);
+			}
+		}
+
+		switch (canApiSim_Receive(&message))
+		{
+			case CAN_OK:
+				accepted++;
+				break;
+			case CAN_BUFFER_FULL:
+				dropped++;
+				break;
+			default:
+				break;
+		}
+	}
+	/* let the module process the last frames */
+	canApiSim_Tick(2);
+	simUs += 2000u;
+	wall = (double)(WallUs() - wallStart) / 1e6;
+	fclose(log);
+
+	if (traceFile != 0)
+	{
+		fclose(traceFile);
+	}
+	fprintf(stderr, "can_replay: %llu frames, %llu accepted, %llu dropped, %.1f s replayed in %.2f s (x%.0f), %llu trace records\n",
+		(unsigned long long)frames, (unsigned long long)accepted, (unsigned long long)dropped, (double)simUs / 1e6,
+		wall, (wall > 0.0) ? (double)simUs / 1e6 / wall : 0.0, (unsigned long long)traceRecords);
+	return 0;
+}
+
+/** @} */
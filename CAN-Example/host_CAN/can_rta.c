@@ -0,0 +1,1106 @@
+/**
+*******************************************************************************
+* @file can_rta.c
+* @brief Host tool: worst-case response-time analysis of the CAN transmit schedule
+* @author FRIWO
+* @date 19.10.2026 - 09:12:41
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Reads the transmit schedule (identifier, DLC, period) directly from
+* txSchedule_array and the send functions in CAN_custom.c and the declared receive traffic of the other bus nodes from a
+* text file, then computes the worst-case queuing and arbitration latency of
+* every frame at the given bitrate. The deadline of a frame is its period.
+* An optional message whose IsOn function only reads NV variables that
+* default to 0 is switched off in the delivered configuration and is not
+* analysed; -a analyses it as well.
+*
+* Frames of the other nodes and the own frames in PRIORITYBUFFER modes are
+* analysed with the classic CAN schedulability analysis (Tindell/Burns,
+* revised by Davis et al. 2007, sufficient test with blocking over lep(m)).
+* If the transmit buffer is a RINGBUFFER the own frames leave the controller
+* in FIFO order, so each own frame is analysed over the hyperperiod together
+* with every own frame queued in front of it; the whole FIFO prefix competes
+* at the priority of its lowest-priority member.
+*
+* Build: gcc -std=c99 -O2 -o can_rta can_rta.c
+* Usage: can_rta [-b bitrate]... [-r rx_traffic.txt] [-q fifo|prio] [-j jitter_us] [-a] [-o|-c expected.txt] CAN_custom.c
+*
+* The receive traffic is read from rx_traffic.txt in the working directory
+* unless -r names another file. -b may be given more than once, the analysis
+* is repeated for every bitrate (default 500000).
+*
+* The exit code is 0 if every frame meets its deadline, 1 if at least one
+* frame can miss it and 2 on usage or parse errors.
+*
+* Regression check: -o writes the worst-case response time of every frame
+* at every bitrate to a file; -c compares against such a file, analysing the
+* bitrates listed in it if no -b is given. With -c the exit code is 0 if
+* every response time matches, deadline misses included, and 1 otherwise.
+* can_rta_expected.txt holds the values of CAN_custom.c and rx_traffic.txt at
+* 500 and 250 kbit/s, run from host_CAN:
+*   can_rta -c can_rta_expected.txt ../module_CAN/CAN_custom.c
+* Record it again with -o -b 500000 -b 250000 together with a change of the
+* schedule or of rx_traffic.txt. The misses at 250 kbit/s are expected: in
+* slot 0 every own frame is queued at once and the FIFO needs more than 10 ms
+* to drain, so the later 10 ms frames of the next slot queue behind it.
+*/
+
+/**
+* @addtogroup can_rta
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief maximum number of frames (own and declared receive traffic) */
+#define RTA_MAX_FRAMES 128u
+
+/** @brief maximum length of a function or node name */
+#define RTA_MAX_NAME 48u
+
+/** @brief node index of the motor controller running CAN_custom.c */
+#define RTA_NODE_OWN 0u
+
+/** @brief upper bound for the hyperperiod in milliseconds */
+#define RTA_MAX_HYPERPERIOD_MS 60000u
+
+/** @brief maximum number of bitrates analysed in one run */
+#define RTA_MAX_BITRATES 8u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Queueing discipline of the own transmit buffer */
+typedef enum
+{
+	QUEUE_FIFO, /**< @brief frames leave in enqueue order (RINGBUFFER) */
+	QUEUE_PRIO /**< @brief frames leave in identifier order (PRIORITYBUFFER_*) */
+}rtaQueue_TypeDef;
+
+/** @brief One periodic frame on the bus */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief CAN identifier */
+	uint8_t IDE; /**< @brief 0 = standard, 1 = extended identifier */
+	uint8_t DLC; /**< @brief payload length */
+	uint32_t PeriodMs; /**< @brief period and deadline in milliseconds */
+	uint8_t Node; /**< @brief RTA_NODE_OWN or index of a declared receive node */
+	char Name[RTA_MAX_NAME]; /**< @brief send function or sender node name */
+	uint64_t C; /**< @brief worst-case transmission time [ns] */
+	uint64_t R; /**< @brief worst-case response time [ns], UINT64_MAX if unbounded */
+}rtaFrame_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static rtaFrame_TypeDef frames[RTA_MAX_FRAMES];
+static unsigned frameCount = 0;
+
+/** @brief bit time [ns] */
+static uint64_t tauBit = 2000u;
+
+/** @brief release jitter of the own frames [ns] */
+static uint64_t ownJitter = 0u;
+
+/** @brief 1 to analyse the optional messages which are switched off by default */
+static int analyseSwitchedOff = 0;
+
+/** @brief optional messages which are switched off by default and not analysed */
+static char switchedOff[RTA_MAX_FRAMES][2u * RTA_MAX_NAME + 16u];
+static unsigned switchedOffCount = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Read a whole file into a zero terminated buffer
+ * @param path: file to read
+ * @return allocated buffer or 0 on error
+ */
+static char* ReadFile(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	char *buf;
+	long len;
+
+	if (f == 0)
+	{
+		return 0;
+	}
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	buf = malloc((size_t)len + 1u);
+	if (buf != 0)
+	{
+		if (fread(buf, 1, (size_t)len, f) != (size_t)len)
+		{
+			free(buf);
+			buf = 0;
+		}
+		else
+		{
+			buf[len] = '\0';
+		}
+	}
+	fclose(f);
+	return buf;
+}
+
+/**
+ * @brief Worst-case number of bits of a classic CAN data frame including stuff bits
+ * @param ide: 0 = standard, 1 = extended identifier
+ * @param dlc: payload length
+ * @return number of bits including interframe space
+ */
+static uint64_t FrameBits(uint8_t ide, uint8_t dlc)
+{
+	uint64_t g = (ide != 0u) ? 54u : 34u; /* bits exposed to stuffing besides the payload */
+	uint64_t s = (dlc > 8u) ? 8u : dlc;
+
+	return g + 8u * s + 13u + (g + 8u * s - 1u) / 4u;
+}
+
+/**
+ * @brief Arbitration key, a lower key wins arbitration.
+ * A standard frame wins against an extended frame with the same base identifier.
+ */
+static uint64_t ArbitrationKey(const rtaFrame_TypeDef *frame)
+{
+	uint64_t id = (frame->IDE != 0u) ? frame->Identifier : ((uint64_t)frame->Identifier << 18);
+	return (id << 1) | frame->IDE;
+}
+
+static uint64_t CeilDiv(uint64_t a, uint64_t b)
+{
+	return (a + b - 1u) / b;
+}
+
+static uint64_t Gcd(uint64_t a, uint64_t b)
+{
+	while (b != 0u)
+	{
+		uint64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief Add a frame to the frame table
+ * @return pointer to the new entry or 0 if the table is full
+ */
+static rtaFrame_TypeDef* AddFrame(uint32_t id, uint8_t ide, uint8_t dlc, uint32_t periodMs, uint8_t node, const char *name)
+{
+	rtaFrame_TypeDef *frame;
+
+	if (frameCount >= RTA_MAX_FRAMES || periodMs == 0u)
+	{
+		return 0;
+	}
+	frame = &frames[frameCount++];
+	frame->Identifier = id;
+	frame->IDE = ide;
+	frame->DLC = dlc;
+	frame->PeriodMs = periodMs;
+	frame->Node = node;
+	strncpy(frame->Name, name, RTA_MAX_NAME - 1u);
+	frame->Name[RTA_MAX_NAME - 1u] = '\0';
+	frame->C = FrameBits(ide, dlc) * tauBit;
+	frame->R = 0u;
+	return frame;
+}
+
+/**
+ * @brief Find the body of a function definition in the source text
+ * @param src: source text
+ * @param name: function name
+ * @return pointer to the opening brace of the body or 0 if not found
+ */
+static const char* FindFunctionBody(const char *src, const char *name)
+{
+	size_t len = strlen(name);
+	const char *p = src;
+
+	while ((p = strstr(p, name)) != 0)
+	{
+		const char *q = p + len;
+		int isWord = (p == src || !(isalnum((unsigned char)p[-1]) || p[-1] == '_'));
+
+		p = q;
+		if (!isWord || isalnum((unsigned char)*q) || *q == '_')
+		{
+			continue;
+		}
+		while (isspace((unsigned char)*q))
+		{
+			q++;
+		}
+		if (*q != '(')
+		{
+			continue;
+		}
+		q = strchr(q, ')');
+		if (q == 0)
+		{
+			return 0;
+		}
+		q++;
+		while (isspace((unsigned char)*q))
+		{
+			q++;
+		}
+		if (*q == '{')
+		{
+			return q; /* definition, not a prototype or a call */
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Get the end of a brace delimited block
+ * @param open: pointer to the opening brace
+ * @return pointer to the matching closing brace or 0
+ */
+static const char* BlockEnd(const char *open)
+{
+	int depth = 0;
+	const char *p;
+
+	for (p = open; *p != '\0'; p++)
+	{
+		if (*p == '{')
+		{
+			depth++;
+		}
+		else if (*p == '}')
+		{
+			if (--depth == 0)
+			{
+				return p;
+			}
+		}
+		else
+		{
+			/* do nothing */
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Read "message.<field> = <number>" inside [begin, end)
+ * @return 1 if the assignment was found
+ */
+static int FindAssignment(const char *begin, const char *end, const char *field, uint32_t *value)
+{
+	char pattern[RTA_MAX_NAME];
+	const char *p = begin;
+
+	snprintf(pattern, sizeof(pattern), "message.%s", field);
+	while ((p = strstr(p, pattern)) != 0 && p < end)
+	{
+		const char *q = p + strlen(pattern);
+		p = q;
+		while (isspace((unsigned char)*q))
+		{
+			q++;
+		}
+		if (*q != '=')
+		{
+			continue;
+		}
+		q++;
+		*value = (uint32_t)strtoul(q, 0, 0);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Read the default value of an NV variable from its definition "<name> = <value>;"
+ * @return 1 if the definition was found
+ */
+static int FindNvDefault(const char *src, const char *name, uint32_t *value)
+{
+	size_t len = strlen(name);
+	const char *p = src;
+
+	while ((p = strstr(p, name)) != 0)
+	{
+		const char *q = p + len;
+		int isWord = (p == src || !(isalnum((unsigned char)p[-1]) || p[-1] == '_'));
+
+		p = q;
+		if (!isWord || isalnum((unsigned char)*q) || *q == '_')
+		{
+			continue;
+		}
+		while (*q == ' ' || *q == '\t')
+		{
+			q++;
+		}
+		if (*q == '=' && q[1] != '=')
+		{
+			*value = (uint32_t)strtoul(q + 1, 0, 0);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Tell if an optional message is switched off by default.
+ * That is the case if every NV variable CAN_C_* read by its IsOn function defaults to 0.
+ * @param src: source text of CAN_custom.c
+ * @param isOn: name of the IsOn function
+ * @return 1 if switched off, 0 if switched on or if the defaults cannot be read
+ */
+static int IsSwitchedOff(const char *src, const char *isOn)
+{
+	const char *body = FindFunctionBody(src, isOn);
+	const char *bodyEnd = (body != 0) ? BlockEnd(body) : 0;
+	const char *p = body;
+	int variables = 0;
+
+	if (bodyEnd == 0)
+	{
+		fprintf(stderr, "can_rta: %s() not found, analysed as switched on\n", isOn);
+		return 0;
+	}
+	while ((p = strstr(p, "CAN_C_")) != 0 && p < bodyEnd)
+	{
+		char name[RTA_MAX_NAME];
+		size_t n = 0;
+		uint32_t value;
+
+		while ((isalnum((unsigned char)p[n]) || p[n] == '_') && n < RTA_MAX_NAME - 1u)
+		{
+			name[n] = p[n];
+			n++;
+		}
+		name[n] = '\0';
+		p += n;
+		if (!FindNvDefault(src, name, &value) || value != 0u)
+		{
+			return 0;
+		}
+		variables++;
+	}
+	return (variables > 0);
+}
+
+/**
+ * @brief Parse the transmit schedule and the transmit buffer type from CAN_custom.c.
+ * The schedule is read from the rows "{Interval, Essential, Pending, SendFunction, IsOn, NextSlot}" of
+ * txSchedule_array, identifier, IDE and DLC from the body of each send function.
+ * @param src: source text of CAN_custom.c
+ * @param queue: detected transmit queue discipline
+ * @return number of own frames found, negative on parse error
+ */
+static int ParseSchedule(const char *src, rtaQueue_TypeDef *queue)
+{
+	const char *table = strstr(src, "txSchedule_array[] =");
+	const char *end;
+	const char *p;
+	const char *setup;
+	int found = 0;
+
+	if (table == 0 || (table = strchr(table, '{')) == 0 || (end = BlockEnd(table)) == 0)
+	{
+		fprintf(stderr, "can_rta: txSchedule_array not found\n");
+		return -1;
+	}
+
+	/* the second argument of canApi_SetupBuffer() is the transmit buffer type */
+	setup = strstr(src, "canApi_SetupBuffer(");
+	if (setup != 0 && (setup = strchr(setup, ',')) != 0)
+	{
+		while (isspace((unsigned char)*++setup))
+		{
+		}
+		*queue = (strncmp(setup, "RINGBUFFER", 10) == 0) ? QUEUE_FIFO : QUEUE_PRIO;
+	}
+
+	for (p = table + 1; p < end; p++)
+	{
+		char name[RTA_MAX_NAME];
+		size_t n = 0;
+		const char *row;
+		const char *rowEnd;
+		const char *fn;
+		const char *fnEnd;
+		const char *column;
+		char isOn[RTA_MAX_NAME];
+		size_t m = 0;
+		uint32_t interval;
+		uint32_t id = 0, ide = 0, dlc = 0;
+
+		if (*p == '/' && p[1] == '*')
+		{
+			/* skip comments, the column header is a comment with braces */
+			p = strstr(p + 2, "*/");
+			if (p == 0)
+			{
+				break;
+			}
+			p++;
+			continue;
+		}
+		if (*p != '{')
+		{
+			continue;
+		}
+		row = p;
+		rowEnd = strchr(row, '}');
+		if (rowEnd == 0 || rowEnd > end)
+		{
+			break;
+		}
+		p = rowEnd;
+
+		interval = (uint32_t)strtoul(row + 1, 0, 0);
+		row = strstr(row, "MessageSend");
+		if (row == 0 || row > rowEnd)
+		{
+			continue;
+		}
+		while ((isalnum((unsigned char)row[n]) || row[n] == '_') && n < RTA_MAX_NAME - 1u)
+		{
+			name[n] = row[n];
+			n++;
+		}
+		name[n] = '\0';
+
+		/* the column after the send function names the IsOn function of an optional message */
+		column = row + n;
+		while (*column == ',' || isspace((unsigned char)*column))
+		{
+			column++;
+		}
+		while ((isalpha((unsigned char)column[m]) || column[m] == '_' || (m > 0u && isdigit((unsigned char)column[m])))
+			&& m < RTA_MAX_NAME - 1u)
+		{
+			isOn[m] = column[m];
+			m++;
+		}
+		isOn[m] = '\0';
+
+		fn = FindFunctionBody(src, name);
+		if (fn == 0 || (fnEnd = BlockEnd(fn)) == 0
+			|| !FindAssignment(fn, fnEnd, "Identifier", &id)
+			|| !FindAssignment(fn, fnEnd, "DLC", &dlc))
+		{
+			fprintf(stderr, "can_rta: cannot read identifier/DLC of %s()\n", name);
+			return -1;
+		}
+		(void)FindAssignment(fn, fnEnd, "IDE", &ide);
+		if (m > 0u && !analyseSwitchedOff && IsSwitchedOff(src, isOn))
+		{
+			snprintf(switchedOff[switchedOffCount++], sizeof(switchedOff[0]), "0x%lX %s (%s)", (unsigned long)id, name, isOn);
+			continue;
+		}
+		if (AddFrame(id, (uint8_t)ide, (uint8_t)dlc, interval, RTA_NODE_OWN, name) == 0)
+		{
+			fprintf(stderr, "can_rta: too many frames\n");
+			return -1;
+		}
+		found++;
+	}
+	return found;
+}
+
+/**
+ * @brief Parse the declared receive traffic.
+ * Each non-comment line reads "<id> <ide> <dlc> <period_ms> <node>".
+ * @return number of frames read, negative on error
+ */
+static int ParseRxTraffic(const char *path, char nodeNames[][RTA_MAX_NAME], unsigned *nodeCount)
+{
+	FILE *f = fopen(path, "r");
+	char line[256];
+	int found = 0;
+
+	if (f == 0)
+	{
+		fprintf(stderr, "can_rta: cannot open %s\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f) != 0)
+	{
+		char node[RTA_MAX_NAME];
+		unsigned long id, ide, dlc, period;
+		unsigned i;
+
+		if (line[0] == '#' || sscanf(line, "%lx %lu %lu %lu %47s", &id, &ide, &dlc, &period, node) != 5)
+		{
+			continue;
+		}
+		for (i = 1; i < *nodeCount; i++)
+		{
+			if (strcmp(nodeNames[i], node) == 0)
+			{
+				break;
+			}
+		}
+		if (i == *nodeCount)
+		{
+			if (*nodeCount >= 16u)
+			{
+				fclose(f);
+				return -1;
+			}
+			strcpy(nodeNames[(*nodeCount)++], node);
+		}
+		if (AddFrame((uint32_t)id, (uint8_t)ide, (uint8_t)dlc, (uint32_t)period, (uint8_t)i, node) == 0)
+		{
+			fclose(f);
+			return -1;
+		}
+		found++;
+	}
+	fclose(f);
+	return found;
+}
+
+/**
+ * @brief Interference of periodic frames with a higher priority than the given key
+ * @param window: length of the busy window [ns]
+ * @param key: arbitration key of the frame under analysis
+ * @param includeOwn: 1 to include the own frames
+ */
+static uint64_t Interference(uint64_t window, uint64_t key, int includeOwn)
+{
+	uint64_t sum = 0;
+	unsigned k;
+
+	for (k = 0; k < frameCount; k++)
+	{
+		if (ArbitrationKey(&frames[k]) < key && (includeOwn || frames[k].Node != RTA_NODE_OWN))
+		{
+			uint64_t jitter = (frames[k].Node == RTA_NODE_OWN) ? ownJitter : 0u;
+			sum += CeilDiv(window + jitter + tauBit, (uint64_t)frames[k].PeriodMs * 1000000u) * frames[k].C;
+		}
+	}
+	return sum;
+}
+
+/**
+ * @brief Classic analysis for a frame queued in identifier order
+ */
+static void AnalysePriorityQueued(rtaFrame_TypeDef *frame)
+{
+	uint64_t key = ArbitrationKey(frame);
+	uint64_t deadline = (uint64_t)frame->PeriodMs * 1000000u;
+	uint64_t jitter = (frame->Node == RTA_NODE_OWN) ? ownJitter : 0u;
+	uint64_t blocking = frame->C;
+	uint64_t w;
+	uint64_t next;
+	unsigned k;
+
+	/* blocking by the longest frame of lower or equal priority (lep) */
+	for (k = 0; k < frameCount; k++)
+	{
+		if (ArbitrationKey(&frames[k]) > key && frames[k].C > blocking)
+		{
+			blocking = frames[k].C;
+		}
+	}
+
+	w = blocking;
+	for (;;)
+	{
+		next = blocking + Interference(w, key, 1);
+		if (next == w)
+		{
+			frame->R = jitter + w + frame->C;
+			break;
+		}
+		if (jitter + next + frame->C > deadline * 16u)
+		{
+			frame->R = UINT64_MAX;
+			break;
+		}
+		w = next;
+	}
+}
+
+/**
+ * @brief FIFO analysis of the own frames over the hyperperiod.
+ * Each own frame waits for every own frame queued in front of it. The FIFO
+ * prefix is interfered by all foreign frames that beat its lowest-priority
+ * member and blocked once by a foreign frame below its highest-priority member.
+ */
+static void AnalyseFifoQueued(void)
+{
+	uint64_t hyper = 1u;
+	uint64_t tick;
+	uint64_t busyStart = 0u;
+	uint64_t finish = 0u;
+	uint64_t sumC = 0u;
+	uint64_t keyLow = 0u;
+	uint64_t keyHigh = UINT64_MAX;
+	unsigned k;
+
+	for (k = 0; k < frameCount; k++)
+	{
+		if (frames[k].Node == RTA_NODE_OWN)
+		{
+			hyper = hyper / Gcd(hyper, frames[k].PeriodMs) * frames[k].PeriodMs;
+			if (hyper > RTA_MAX_HYPERPERIOD_MS)
+			{
+				hyper = RTA_MAX_HYPERPERIOD_MS;
+			}
+		}
+	}
+
+	for (tick = 0; tick < hyper; tick++)
+	{
+		for (k = 0; k < frameCount; k++)
+		{
+			rtaFrame_TypeDef *frame = &frames[k];
+			uint64_t release;
+			uint64_t blocking = 0u;
+			uint64_t w;
+			uint64_t next;
+			unsigned j;
+
+			if (frame->Node != RTA_NODE_OWN || tick % frame->PeriodMs != 0u || frame->R == UINT64_MAX)
+			{
+				continue;
+			}
+
+			release = tick * 1000000u + ownJitter;
+			if (release >= finish)
+			{
+				/* the FIFO ran empty, a new busy period starts with this frame */
+				busyStart = release;
+				sumC = 0u;
+				keyLow = 0u;
+				keyHigh = UINT64_MAX;
+			}
+			sumC += frame->C;
+			if (ArbitrationKey(frame) > keyLow)
+			{
+				keyLow = ArbitrationKey(frame);
+			}
+			if (ArbitrationKey(frame) < keyHigh)
+			{
+				keyHigh = ArbitrationKey(frame);
+			}
+
+			for (j = 0; j < frameCount; j++)
+			{
+				if (frames[j].Node != RTA_NODE_OWN && ArbitrationKey(&frames[j]) > keyHigh && frames[j].C > blocking)
+				{
+					blocking = frames[j].C;
+				}
+			}
+
+			w = blocking + sumC;
+			for (;;)
+			{
+				next = blocking + sumC + Interference(w, keyLow, 0);
+				if (next == w || next > hyper * 1000000u)
+				{
+					break;
+				}
+				w = next;
+			}
+
+			if (next > hyper * 1000000u)
+			{
+				/* the own FIFO does not drain within the hyperperiod */
+				for (j = 0; j < frameCount; j++)
+				{
+					if (frames[j].Node == RTA_NODE_OWN)
+					{
+						frames[j].R = UINT64_MAX;
+					}
+				}
+				return;
+			}
+
+			finish = busyStart + w;
+			if (finish - release + ownJitter > frame->R)
+			{
+				frame->R = finish - release + ownJitter;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Analyse all frames at the current bit time
+ * @param queue: queueing discipline of the own transmit buffer
+ * @return bus utilisation [0...1]
+ */
+static double Analyse(rtaQueue_TypeDef queue)
+{
+	double utilisation = 0.0;
+	unsigned k;
+
+	for (k = 0; k < frameCount; k++)
+	{
+		frames[k].C = FrameBits(frames[k].IDE, frames[k].DLC) * tauBit;
+		frames[k].R = 0u;
+	}
+	for (k = 0; k < frameCount; k++)
+	{
+		if (frames[k].Node != RTA_NODE_OWN || queue == QUEUE_PRIO)
+		{
+			AnalysePriorityQueued(&frames[k]);
+		}
+		utilisation += (double)frames[k].C / ((double)frames[k].PeriodMs * 1e6);
+	}
+	if (queue == QUEUE_FIFO)
+	{
+		AnalyseFifoQueued();
+	}
+	return utilisation;
+}
+
+/**
+ * @brief Print the result table of one bitrate
+ * @return number of frames which can miss their deadline
+ */
+static unsigned PrintResult(char nodeNames[][RTA_MAX_NAME], double utilisation)
+{
+	unsigned misses = 0u;
+	unsigned k;
+
+	printf("%-12s %-3s %3s %6s %8s %10s %10s  %-28s %s\n", "ID", "IDE", "DLC", "T[ms]", "C[us]", "R[us]", "slack[us]", "sender", "status");
+	for (k = 0; k < frameCount; k++)
+	{
+		const rtaFrame_TypeDef *frame = &frames[k];
+		uint64_t deadline = (uint64_t)frame->PeriodMs * 1000000u;
+		int miss = (frame->R > deadline);
+		char r[24];
+		char slack[24];
+
+		if (frame->R == UINT64_MAX)
+		{
+			strcpy(r, "unbounded");
+			strcpy(slack, "-");
+		}
+		else
+		{
+			snprintf(r, sizeof(r), "%.1f", (double)frame->R / 1000.0);
+			snprintf(slack, sizeof(slack), "%.1f", ((double)deadline - (double)frame->R) / 1000.0);
+		}
+		printf("0x%-10lX %-3s %3u %6lu %8.1f %10s %10s  %-28s %s\n",
+			(unsigned long)frame->Identifier, frame->IDE ? "ext" : "std", frame->DLC,
+			(unsigned long)frame->PeriodMs, (double)frame->C / 1000.0, r, slack,
+			(frame->Node == RTA_NODE_OWN) ? frame->Name : nodeNames[frame->Node],
+			miss ? "DEADLINE MISS" : "ok");
+		misses += (unsigned)miss;
+	}
+	printf("\nbus utilisation %.1f %%, %u frame(s) can miss their deadline\n", utilisation * 100.0, misses);
+	return misses;
+}
+
+/**
+ * @brief Write the response times of one bitrate, one line "<bitrate> <id> <ide> <R[ns]|unbounded>" per frame
+ */
+static void WriteExpected(FILE *f, unsigned long bitrate)
+{
+	unsigned k;
+
+	for (k = 0; k < frameCount; k++)
+	{
+		if (frames[k].R == UINT64_MAX)
+		{
+			fprintf(f, "%lu 0x%lX %u unbounded\n", bitrate, (unsigned long)frames[k].Identifier, frames[k].IDE);
+		}
+		else
+		{
+			fprintf(f, "%lu 0x%lX %u %llu\n", bitrate, (unsigned long)frames[k].Identifier, frames[k].IDE,
+				(unsigned long long)frames[k].R);
+		}
+	}
+}
+
+/**
+ * @brief Read the bitrates listed in an expected file, in the order of their first line
+ * @return number of bitrates, negative if the file cannot be read
+ */
+static int ReadExpectedBitrates(const char *path, unsigned long *bitrate_array)
+{
+	FILE *f = fopen(path, "r");
+	char line[256];
+	int count = 0;
+
+	if (f == 0)
+	{
+		fprintf(stderr, "can_rta: cannot open %s\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f) != 0)
+	{
+		unsigned long bitrate;
+		int i;
+
+		if (line[0] == '#' || sscanf(line, "%lu", &bitrate) != 1)
+		{
+			continue;
+		}
+		for (i = 0; i < count && bitrate_array[i] != bitrate; i++)
+		{
+		}
+		if (i == count && count < (int)RTA_MAX_BITRATES)
+		{
+			bitrate_array[count++] = bitrate;
+		}
+	}
+	fclose(f);
+	return count;
+}
+
+/**
+ * @brief Compare the response times of one bitrate to the lines of an expected file
+ * @return number of differences, frames missing on either side included
+ */
+static unsigned CompareExpected(const char *path, unsigned long bitrate)
+{
+	FILE *f = fopen(path, "r");
+	char line[256];
+	uint8_t listed[RTA_MAX_FRAMES] = {0};
+	unsigned differences = 0u;
+	unsigned k;
+
+	if (f == 0)
+	{
+		fprintf(stderr, "can_rta: cannot open %s\n", path);
+		return 1u;
+	}
+	while (fgets(line, sizeof(line), f) != 0)
+	{
+		unsigned long lineBitrate;
+		unsigned long id;
+		unsigned ide;
+		char value[24];
+		uint64_t expected;
+
+		if (line[0] == '#' || sscanf(line, "%lu %lx %u %23s", &lineBitrate, &id, &ide, value) != 4 || lineBitrate != bitrate)
+		{
+			continue;
+		}
+		expected = (strcmp(value, "unbounded") == 0) ? UINT64_MAX : strtoull(value, 0, 10);
+		for (k = 0; k < frameCount && !(frames[k].Identifier == id && frames[k].IDE == ide); k++)
+		{
+		}
+		if (k == frameCount)
+		{
+			fprintf(stderr, "can_rta: 0x%lX at %lu bit/s missing in the schedule\n", id, bitrate);
+			differences++;
+			continue;
+		}
+		listed[k] = 1u;
+		if (frames[k].R != expected)
+		{
+			fprintf(stderr, "can_rta: 0x%lX at %lu bit/s R %.1f us, expected %.1f us\n", id, bitrate,
+				(frames[k].R == UINT64_MAX) ? -1.0 : (double)frames[k].R / 1000.0,
+				(expected == UINT64_MAX) ? -1.0 : (double)expected / 1000.0);
+			differences++;
+		}
+	}
+	fclose(f);
+	for (k = 0; k < frameCount; k++)
+	{
+		if (listed[k] == 0u)
+		{
+			fprintf(stderr, "can_rta: 0x%lX at %lu bit/s missing in %s\n", (unsigned long)frames[k].Identifier, bitrate, path);
+			differences++;
+		}
+	}
+	return differences;
+}
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_rta [-b bitrate]... [-r rx_traffic.txt] [-q fifo|prio] [-j jitter_us] [-a] [-o|-c expected.txt] CAN_custom.c\n");
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	char nodeNames[16][RTA_MAX_NAME] = {"MC"};
+	unsigned nodeCount = 1u;
+	unsigned long bitrate_array[RTA_MAX_BITRATES];
+	int bitrateCount = 0;
+	const char *rxPath = "rx_traffic.txt";
+	const char *srcPath = 0;
+	const char *queueArg = 0;
+	const char *outPath = 0;
+	const char *expectedPath = 0;
+	FILE *out = 0;
+	rtaQueue_TypeDef queue = QUEUE_FIFO;
+	char *src;
+	int rxFrames;
+	unsigned misses = 0u;
+	unsigned differences = 0u;
+	unsigned k;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-b") == 0 && i + 1 < argc && bitrateCount < (int)RTA_MAX_BITRATES)
+		{
+			bitrate_array[bitrateCount++] = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			rxPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc)
+		{
+			queueArg = argv[++i];
+		}
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+		{
+			ownJitter = strtoull(argv[++i], 0, 0) * 1000u;
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			analyseSwitchedOff = 1;
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc && expectedPath == 0)
+		{
+			outPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && outPath == 0)
+		{
+			expectedPath = argv[++i];
+		}
+		else if (argv[i][0] != '-' && srcPath == 0)
+		{
+			srcPath = argv[i];
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (bitrateCount == 0 && expectedPath != 0)
+	{
+		bitrateCount = ReadExpectedBitrates(expectedPath, bitrate_array);
+		if (bitrateCount <= 0)
+		{
+			fprintf(stderr, "can_rta: no bitrate in %s\n", expectedPath);
+			return 2;
+		}
+	}
+	if (bitrateCount == 0)
+	{
+		bitrate_array[bitrateCount++] = 500000u;
+	}
+	for (i = 0; i < bitrateCount; i++)
+	{
+		if (bitrate_array[i] == 0u || bitrate_array[i] > 1000000u)
+		{
+			srcPath = 0;
+		}
+	}
+	if (srcPath == 0)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	src = ReadFile(srcPath);
+	if (src == 0)
+	{
+		fprintf(stderr, "can_rta: cannot read %s\n", srcPath);
+		return 2;
+	}
+	if (ParseSchedule(src, &queue) <= 0)
+	{
+		free(src);
+		return 2;
+	}
+	free(src);
+	rxFrames = ParseRxTraffic(rxPath, nodeNames, &nodeCount);
+	if (rxFrames < 0)
+	{
+		fprintf(stderr, "can_rta: invalid receive traffic file %s\n", rxPath);
+		return 2;
+	}
+	if (queueArg != 0)
+	{
+		queue = (strcmp(queueArg, "prio") == 0) ? QUEUE_PRIO : QUEUE_FIFO;
+	}
+	if (outPath != 0)
+	{
+		out = fopen(outPath, "w");
+		if (out == 0)
+		{
+			fprintf(stderr, "can_rta: cannot write %s\n", outPath);
+			return 2;
+		}
+		fprintf(out, "# worst-case response times of can_rta %s with %s, own release jitter %llu us\n",
+			srcPath, rxPath, (unsigned long long)(ownJitter / 1000u));
+		fprintf(out, "# <bitrate> <id hex> <ide> <R[ns]|unbounded>\n");
+	}
+
+	for (i = 0; i < bitrateCount; i++)
+	{
+		double utilisation;
+
+		tauBit = 1000000000u / bitrate_array[i];
+		utilisation = Analyse(queue);
+
+		printf("%sCAN response-time analysis of %s\n", (i > 0) ? "\n" : "", srcPath);
+		printf("bitrate %lu bit/s, own transmit buffer %s, own release jitter %llu us\n",
+			bitrate_array[i], (queue == QUEUE_FIFO) ? "FIFO" : "priority", (unsigned long long)(ownJitter / 1000u));
+		printf("receive traffic %s, %d frame(s) of %u node(s)\n", rxPath, rxFrames, nodeCount - 1u);
+		for (k = 0; k < switchedOffCount; k++)
+		{
+			printf("switched off by default, not analysed: %s\n", switchedOff[k]);
+		}
+		printf("\n");
+		misses += PrintResult(nodeNames, utilisation);
+		if (out != 0)
+		{
+			WriteExpected(out, bitrate_array[i]);
+		}
+		if (expectedPath != 0)
+		{
+			differences += CompareExpected(expectedPath, bitrate_array[i]);
+		}
+	}
+	if (out != 0)
+	{
+		fclose(out);
+	}
+	if (expectedPath != 0)
+	{
+		printf("\n%u response time(s) differ from %s\n", differences, expectedPath);
+		return (differences > 0u) ? 1 : 0;
+	}
+	return (misses > 0u) ? 1 : 0;
+}
+
+/** @} */
@@ -0,0 +1,431 @@
+/**
+*******************************************************************************
+* @file can_sim.c
+* @brief Host tool: run CAN_custom.c against the simulated canApi
+* @author FRIWO
+* @date 19.10.2026 - 14:02:11
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Runs the CAN module for the given simulated time as fast as the host allows.
+* The receive traffic declared in rx_traffic.txt in the working directory, or
+* in the file given with -r, is put on the simulated bus with its nominal
+* period. At the end the transmitted frames are listed with their measured
+* periods, followed by the buffer diagnostics of the module.
+*
+* Built with -DCAN_FD_ENABLE and run with -m 1 or -m 2 (CAN_C_Fd_Mode, default
+* 0 = classic frames) the frames packed into FD container frames are unpacked
+* and listed like classic frames, and the bus time of the containers is
+* compared with the bus time the packed frames need as classic frames.
+* The bus time is counted without dynamic stuff bits.
+*
+* With -o the bus goes off at the given time for the given length, the
+* frames queued at that moment are dropped by the module. After the run the
+* transmit queueing latency of every periodic message must stay below the
+* bus-off length, otherwise the exit code is 1. Combine it with -n 1 so that
+* frames are queued when the bus goes off, e.g. -t 3000 -n 1 -o 1001,200
+* drops the burst of timeslot 1000.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_sim can_sim.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_sim [-t duration_ms] [-r rx_traffic.txt] [-n tx_per_tick] [-o busoff_at_ms,busoff_ms]
+*
+* FD build: gcc -std=c99 -O2 -DCAN_FD_ENABLE -I../module_CAN -o can_sim_fd can_sim.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c ../module_CAN/CAN_fd.c -lm
+* FD usage: can_sim_fd [-t duration_ms] [-r rx_traffic.txt] [-n tx_per_tick] [-o busoff_at_ms,busoff_ms] [-m fd_mode] [-b bitrate] [-d data_bitrate]
+*/
+
+/**
+* @addtogroup can_sim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief maximum number of distinct frames in each direction */
+#define SIM_MAX_FRAMES 64u
+
+#ifdef CAN_FD_ENABLE
+/** @brief default nominal and data bit rate [bit/s] */
+#define SIM_BITRATE 500000u
+#define SIM_DATA_BITRATE 2000000u
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief One periodic frame of the declared receive traffic */
+typedef struct
+{
+	canApi_MessageTypedef Message; /**< @brief frame put on the bus */
+	uint32_t PeriodMs; /**< @brief send period */
+	uint32_t PhaseMs; /**< @brief offset of the first transmission */
+	uint32_t Count; /**< @brief frames accepted by the filter banks */
+}simRxFrame_TypeDef;
+
+/** @brief Statistics of one transmitted frame */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief CAN identifier */
+	uint8_t IDE; /**< @brief 0 = standard, 1 = extended identifier */
+	uint8_t DLC; /**< @brief payload length */
+	uint32_t Count; /**< @brief number of transmissions */
+	uint32_t LastUs; /**< @brief time of the last transmission */
+	uint32_t MinPeriodUs; /**< @brief minimum distance of two transmissions */
+	uint32_t MaxPeriodUs; /**< @brief maximum distance of two transmissions */
+}simTxFrame_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static simRxFrame_TypeDef rxFrame_array[SIM_MAX_FRAMES];
+static unsigned rxFrameCount = 0;
+static simTxFrame_TypeDef txFrame_array[SIM_MAX_FRAMES];
+static unsigned txFrameCount = 0;
+
+#ifdef CAN_FD_ENABLE
+static unsigned long bitrate = SIM_BITRATE;
+static unsigned long dataBitrate = SIM_DATA_BITRATE;
+static uint32_t fdFrameCount = 0; /* FD frames transmitted */
+static uint32_t fdPackedCount = 0; /* classic frames carried in them */
+static double classicBusUs = 0; /* bus time of the classic frames */
+static double fdBusUs = 0; /* bus time of the FD frames */
+static double packedAsClassicUs = 0; /* bus time the packed frames would need as classic frames */
+#endif
+
+/* EnableTool variables of CAN_custom.c shown at the end */
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_HighWater;
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_Overflow;
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_HighWater;
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_Overflow;
+extern MEDKit_Modul_Interfaces UInt32 CAN_M_RxQueue_BulkOverflow;
+#ifdef CAN_FD_ENABLE
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_Fd_Mode;
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Parse the declared receive traffic, same format as for can_rta.
+ * Each non-comment line reads "<id> <ide> <dlc> <period_ms> <node>".
+ * @return number of frames read, negative on error
+ */
+static int ParseRxTraffic(const char *path)
+{
+	FILE *f = fopen(path, "r");
+	char line[256];
+
+	if (f == 0)
+	{
+		fprintf(stderr, "can_sim: cannot open %s\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f) != 0)
+	{
+		unsigned long id, ide, dlc, period;
+		simRxFrame_TypeDef *frame;
+
+		if (line[0] == '#' || sscanf(line, "%lx %lu %lu %lu", &id, &ide, &dlc, &period) != 4)
+		{
+			continue;
+		}
+		if (rxFrameCount >= SIM_MAX_FRAMES || period == 0u || dlc > 8u)
+		{
+			fclose(f);
+			return -1;
+		}
+		frame = &rxFrame_array[rxFrameCount];
+		memset(frame, 0, sizeof(*frame));
+		frame->Message.Identifier = (uint32_t)id;
+		frame->Message.IDE = (uint8_t)ide;
+		frame->Message.DLC = (uint8_t)dlc;
+		frame->PeriodMs = (uint32_t)period;
+		/* spread the first transmissions like independent nodes would */
+		frame->PhaseMs = (rxFrameCount * 7u) % frame->PeriodMs;
+		rxFrameCount++;
+	}
+	fclose(f);
+	return (int)rxFrameCount;
+}
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief Bus time of a classic frame without dynamic stuff bits, including the interframe space
+ * @return bus time [us]
+ */
+static double ClassicFrameUs(uint8_t ide, uint8_t dlc)
+{
+	uint32_t bits = ((ide != 0) ? 67u : 47u) + 8u * dlc;
+
+	return bits * 1e6 / bitrate;
+}
+
+/**
+ * @brief Bus time of an FD frame without dynamic stuff bits, including the interframe space.
+ * The data phase runs from ESI to the CRC delimiter, with the fixed stuff bits of the CRC field.
+ * @return bus time [us]
+ */
+static double FdFrameUs(const CAN_Fd_MessageTypedef *message)
+{
+	uint32_t length = CAN_Fd_DlcToLength(message->DLC);
+	uint32_t arbitration = ((message->IDE != 0) ? 36u : 17u) + 12u;
+	uint32_t crc = (length > 16u) ? 21u : 17u;
+	uint32_t data = 1u + 4u + 8u * length + 4u + crc + (4u + crc + 3u) / 4u + 1u;
+
+	if (message->BRS == 0)
+	{
+		return (arbitration + data) * 1e6 / bitrate;
+	}
+	return arbitration * 1e6 / bitrate + data * 1e6 / dataBitrate;
+}
+#endif
+
+/**
+ * @brief Transmit observer, records the period of every transmitted frame
+ */
+static void OnTransmit(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	simTxFrame_TypeDef *frame = 0;
+	unsigned i;
+
+	for (i = 0; i < txFrameCount; i++)
+	{
+		if (txFrame_array[i].Identifier == message->Identifier && txFrame_array[i].IDE == message->IDE)
+		{
+			frame = &txFrame_array[i];
+			break;
+		}
+	}
+	if (frame == 0)
+	{
+		if (txFrameCount >= SIM_MAX_FRAMES)
+		{
+			return;
+		}
+		frame = &txFrame_array[txFrameCount++];
+		memset(frame, 0, sizeof(*frame));
+		frame->Identifier = message->Identifier;
+		frame->IDE = message->IDE;
+	}
+	if (frame->Count > 0)
+	{
+		uint32_t period = timestamp - frame->LastUs;
+
+		if (frame->Count == 1 || period < frame->MinPeriodUs)
+		{
+			frame->MinPeriodUs = period;
+		}
+		if (period > frame->MaxPeriodUs)
+		{
+			frame->MaxPeriodUs = period;
+		}
+	}
+	frame->DLC = message->DLC;
+	frame->LastUs = timestamp;
+	frame->Count++;
+#ifdef CAN_FD_ENABLE
+	classicBusUs += ClassicFrameUs(message->IDE, message->DLC);
+#endif
+}
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief FD transmit observer, unpacks container frames into the statistics of their classic frames
+ */
+static void OnFdTransmit(const CAN_Fd_MessageTypedef *message, uint32_t timestamp)
+{
+	canApi_MessageTypedef contained;
+	uint8_t offset = 0;
+
+	fdFrameCount++;
+	fdBusUs += FdFrameUs(message);
+	while (CAN_Fd_ContainerNext(message, &offset, &contained) != 0)
+	{
+		fdPackedCount++;
+		packedAsClassicUs += ClassicFrameUs(contained.IDE, contained.DLC);
+		OnTransmit(&contained, timestamp);
+		/* OnTransmit() counts classic bus time, the frame did not use any */
+		classicBusUs -= ClassicFrameUs(contained.IDE, contained.DLC);
+	}
+}
+#endif
+
+static void PrintUsage(void)
+{
+#ifdef CAN_FD_ENABLE
+	fprintf(stderr, "usage: can_sim_fd [-t duration_ms] [-r rx_traffic.txt] [-n tx_per_tick] [-o busoff_at_ms,busoff_ms] "
+		"[-m fd_mode] [-b bitrate] [-d data_bitrate]\n");
+#else
+	fprintf(stderr, "usage: can_sim [-t duration_ms] [-r rx_traffic.txt] [-n tx_per_tick] [-o busoff_at_ms,busoff_ms]\n");
+#endif
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char **argv)
+{
+	unsigned long duration = 10000u;
+	unsigned long txPerTick = 0u;
+	unsigned long busOffAt = 0u;
+	unsigned long busOffLength = 0u;
+	int result = 0;
+	const char *rxPath = "rx_traffic.txt";
+	uint32_t sent = 0;
+	clock_t start;
+	double elapsed;
+	uint32_t t;
+	unsigned k;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			duration = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			rxPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			txPerTick = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%lu,%lu", &busOffAt, &busOffLength) != 2 || busOffLength == 0u)
+			{
+				PrintUsage();
+				return 2;
+			}
+		}
+#ifdef CAN_FD_ENABLE
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+		{
+			CAN_C_Fd_Mode = (UInt32)strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+		{
+			bitrate = strtoul(argv[++i], 0, 0);
+		}
+		else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+		{
+			dataBitrate = strtoul(argv[++i], 0, 0);
+		}
+#endif
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+#ifdef CAN_FD_ENABLE
+	if (bitrate == 0u || dataBitrate == 0u || CAN_C_Fd_Mode > 2u)
+	{
+		PrintUsage();
+		return 2;
+	}
+#endif
+	if (ParseRxTraffic(rxPath) < 0)
+	{
+		fprintf(stderr, "can_sim: invalid receive traffic in %s\n", rxPath);
+		PrintUsage();
+		return 2;
+	}
+
+	canApiSim_Init();
+	canApiSim_SetTxPerTick((uint32_t)txPerTick);
+	canApiSim_SetTransmitObserver(OnTransmit);
+#ifdef CAN_FD_ENABLE
+	canApiSim_SetFdTransmitObserver(OnFdTransmit);
+#endif
+
+	start = clock();
+	for (t = 0; t < duration; t++)
+	{
+		for (k = 0; k < rxFrameCount; k++)
+		{
+			simRxFrame_TypeDef *frame = &rxFrame_array[k];
+
+			if ((t + frame->PeriodMs - frame->PhaseMs) % frame->PeriodMs == 0u
+				&& canApiSim_Receive(&frame->Message) == CAN_OK)
+			{
+				frame->Count++;
+			}
+		}
+		if (busOffLength != 0u && (t == busOffAt || t == busOffAt + busOffLength))
+		{
+			canApiSim_SetBusState((t == busOffAt) ? 1 : 0, 0, 0);
+		}
+		canApiSim_Tick(1);
+	}
+	elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("id          ide dlc   count  period min/max [ms]\n");
+	for (k = 0; k < txFrameCount; k++)
+	{
+		const simTxFrame_TypeDef *frame = &txFrame_array[k];
+
+		sent += frame->Count;
+		printf("0x%08lX  %u   %u  %6lu  %7.1f %7.1f\n", (unsigned long)frame->Identifier, frame->IDE, frame->DLC,
+			(unsigned long)frame->Count, frame->MinPeriodUs / 1000.0, frame->MaxPeriodUs / 1000.0);
+	}
+	printf("received:");
+	for (k = 0; k < rxFrameCount; k++)
+	{
+		printf(" 0x%lX=%lu", (unsigned long)rxFrame_array[k].Message.Identifier, (unsigned long)rxFrame_array[k].Count);
+	}
+	printf("\n%lu ms simulated in %.3f s, %lu frames transmitted\n", duration, elapsed, (unsigned long)sent);
+	printf("tx buffer high-water %lu overflow %lu, rx buffer high-water %lu overflow %lu, bulk queue overflow %lu\n",
+		(unsigned long)CAN_M_TxBuffer_HighWater, (unsigned long)CAN_M_TxBuffer_Overflow,
+		(unsigned long)CAN_M_RxBuffer_HighWater, (unsigned long)CAN_M_RxBuffer_Overflow,
+		(unsigned long)CAN_M_RxQueue_BulkOverflow);
+#ifdef CAN_FD_ENABLE
+	printf("fd containers %lu carrying %lu frames (%.1f per container), bus time %.1f ms/s (classic %.1f, fd %.1f)\n",
+		(unsigned long)fdFrameCount, (unsigned long)fdPackedCount,
+		(fdFrameCount > 0u) ? (double)fdPackedCount / fdFrameCount : 0.0,
+		(classicBusUs + fdBusUs) / duration, classicBusUs / duration, fdBusUs / duration);
+	printf("the packed frames as classic frames would need %.1f ms/s instead of %.1f ms/s\n",
+		packedAsClassicUs / duration, fdBusUs / duration);
+#endif
+	if (busOffLength != 0u)
+	{
+		CAN_TxLatency_TypeDef latency;
+		uint32_t worstId = 0;
+		uint32_t worst = 0;
+
+		for (k = 0; k < txFrameCount; k++)
+		{
+			if (CAN_GetTxLatency(txFrame_array[k].Identifier, txFrame_array[k].IDE, &latency) == CAN_OK
+				&& latency.Max >= worst)
+			{
+				worst = latency.Max;
+				worstId = txFrame_array[k].Identifier;
+			}
+		}
+		result = (worst < busOffLength * 1000u) ? 0 : 1;
+		printf("bus-off at %lu ms for %lu ms: max queueing latency %lu us (0x%lX), %s\n", busOffAt, busOffLength,
+			(unsigned long)worst, (unsigned long)worstId, (result == 0) ? "bounded" : "FAIL, includes the bus-off time");
+	}
+	return result;
+}
+
+/** @} */
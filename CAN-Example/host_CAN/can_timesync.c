@@ -0,0 +1,483 @@
+/**
+*******************************************************************************
+* @file can_timesync.c
+* @brief Host tool: convergence of the CAN time synchronization with drifting clocks
+* @author FRIWO
+* @date 20.10.2026 - 19:58:03
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Simulates a true time and derives the clocks of the nodes from it:
+* - the oscillator of the module runs -d ppm fast, changing by -r ppm per
+*   minute (warm-up); the simulated canApi clock, i.e. CAN_GetTimestampUs()
+*   and the 1ms callback, follows this oscillator
+* - the master runs -D ppm fast and starts at 1234.567890 s
+*
+* Slave mode (default): the tool is the master. Every -i ms of master time it
+* queues SYNC, the frame leaves the bus 0...-b us later and FUP follows 2ms
+* after. The module stamps the frames 0...-j us after the end of frame, -p
+* percent of the frames are lost. Every millisecond the corrected clock of the
+* module, CAN_TimeSync_GetTimeUs(), is compared with the true master time.
+* The table lists the first synchronizations with offset and drift estimate
+* of the module, the true drift and the largest error until the next
+* synchronization; the summary covers everything from the third
+* synchronization on, once the drift is estimated.
+*
+* Master mode (-m): the module is the master, its own clock is the time base.
+* Its frames leave the bus 0...-b us after they were queued, the tool
+* reconstructs the time of each SYNC from SYNC and FUP and compares it with the
+* clock of the module at the end of the SYNC frame.
+*
+* Build: gcc -std=c99 -O2 -I../module_CAN -o can_timesync can_timesync.c canApi_sim.c ../module_CAN/CAN_custom.c ../module_CAN/CAN_isotp.c ../module_CAN/CAN_xcp.c ../module_CAN/CAN_signals.c ../module_CAN/CAN_delta.c ../module_CAN/CAN_uds.c ../module_CAN/CAN_j1939.c ../module_CAN/CAN_timesync.c ../module_CAN/CAN_recorder.c -lm
+* Usage: can_timesync [-m] [-t duration_s] [-i interval_ms] [-d module_ppm] [-D master_ppm] [-r ppm_per_min]
+*                     [-j stamp_jitter_us] [-b bus_delay_us] [-p loss_percent] [-e limit_us] [-s seed]
+*
+* The exit code is 0 if the error stayed within -e us (default 20), 1
+* otherwise and 2 on usage errors.
+*/
+
+/**
+* @addtogroup can_timesync
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "canApi_sim.h"
+#include "CAN_custom.h"
+#include "CAN_timesync.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief time of the master at true time 0 [s] */
+#define MASTER_EPOCH 1234.567890
+
+/** @brief time from SYNC to FUP [s] */
+#define FUP_DELAY 0.002
+
+/** @brief interval of the error samples [s] */
+#define SAMPLE_PERIOD 0.001
+
+/** @brief synchronizations listed in the table */
+#define TABLE_ROWS 10u
+
+/** @brief never, for events which are not scheduled */
+#define NEVER 1e30
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static double moduleDrift = 40.0; /* -d [ppm] */
+static double masterDrift = -30.0; /* -D [ppm] */
+static double driftRamp = 0.0; /* -r [ppm/min] */
+static uint64_t localNow = 0; /* clock of the module [us] */
+static uint32_t randomState = 1u;
+
+/* master mode: view of the tool as slave */
+static uint64_t syncEndLocal; /* clock of the module at the end of the last SYNC frame [us] */
+static uint32_t syncSeconds;
+static uint8_t syncSequence;
+static uint8_t syncSeen;
+static uint32_t masterSyncs;
+static uint32_t masterBadSequence;
+static double masterMaxError; /* [us] */
+static double masterMaxDelay; /* queueing to end of frame of SYNC [us] */
+static uint64_t syncQueuedLocal; /* clock of the module when SYNC showed up in the transmit buffer [us] */
+
+/* EnableTool variables of CAN_custom.c */
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_TimeSync_Mode;
+extern MEDKit_Modul_Interfaces UInt32 CAN_C_TimeSync_Interval;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: can_timesync [-m] [-t duration_s] [-i interval_ms] [-d module_ppm] [-D master_ppm] [-r ppm_per_min]\n"
+		"                    [-j stamp_jitter_us] [-b bus_delay_us] [-p loss_percent] [-e limit_us] [-s seed]\n");
+}
+
+static uint32_t Random(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+/**
+ * @brief Uniform random value 0...limit
+ */
+static double Uniform(double limit)
+{
+	return limit * (double)(Random() % 1000001u) / 1e6;
+}
+
+/**
+ * @brief Clock of the module at a true time: integral of 1 + drift(t) [us]
+ */
+static double ModuleClock(double t)
+{
+	return 1e6 * (t + moduleDrift * 1e-6 * t + driftRamp * 1e-6 * t * t / 120.0);
+}
+
+/**
+ * @brief Time of the master at a true time [us]
+ */
+static double MasterClock(double t)
+{
+	return 1e6 * (MASTER_EPOCH + t * (1.0 + masterDrift * 1e-6));
+}
+
+/**
+ * @brief True drift of the master relative to the oscillator of the module at a true time [ppb]
+ */
+static double TrueDrift(double t)
+{
+	double module = moduleDrift + driftRamp * t / 60.0;
+
+	return 1e9 * ((1.0 + masterDrift * 1e-6) / (1.0 + module * 1e-6) - 1.0);
+}
+
+/**
+ * @brief Run the module up to a true time
+ */
+static void RunTo(double t)
+{
+	uint64_t target = (uint64_t)floor(ModuleClock(t));
+
+	while (target > localNow)
+	{
+		uint64_t step = target - localNow;
+
+		if (step > 1000000u)
+		{
+			step = 1000000u;
+		}
+		canApiSim_RunForUs((uint32_t)step);
+		localNow += step;
+	}
+}
+
+static void SendToModule(uint8_t type, uint8_t sequence, uint8_t byte3, uint32_t value)
+{
+	canApi_MessageTypedef message;
+
+	message.Identifier = CAN_TIMESYNC_ID;
+	message.IDE = 0;
+	message.RTR = 0;
+	message.DLC = 8;
+	message.Priority = 1;
+	message.Data[0] = type;
+	message.Data[1] = 0;
+	message.Data[2] = sequence;
+	message.Data[3] = byte3;
+	message.Data[4] = (uint8_t)(value >> 24);
+	message.Data[5] = (uint8_t)(value >> 16);
+	message.Data[6] = (uint8_t)(value >> 8);
+	message.Data[7] = (uint8_t)value;
+	(void)canApiSim_Receive(&message);
+}
+
+/**
+ * @brief Master mode: SYNC and FUP of the module as seen by a slave on the bus
+ */
+static void OnTransmit(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	uint32_t value;
+
+	(void)timestamp;
+	if (message->Identifier != CAN_TIMESYNC_ID || message->IDE != 0u || message->DLC != 8u)
+	{
+		return;
+	}
+	value = ((uint32_t)message->Data[4] << 24) | ((uint32_t)message->Data[5] << 16) | ((uint32_t)message->Data[6] << 8)
+		| message->Data[7];
+	if (message->Data[0] == CAN_TIMESYNC_TYPE_SYNC)
+	{
+		double delay = (double)(localNow - syncQueuedLocal);
+
+		syncEndLocal = localNow;
+		syncSeconds = value;
+		syncSequence = message->Data[2];
+		syncSeen = 1;
+		if (delay > masterMaxDelay)
+		{
+			masterMaxDelay = delay;
+		}
+	}
+	else if (message->Data[0] == CAN_TIMESYNC_TYPE_FUP)
+	{
+		double error;
+
+		if (syncSeen == 0u || message->Data[2] != syncSequence)
+		{
+			masterBadSequence++;
+			return;
+		}
+		syncSeen = 0;
+		error = ((double)syncSeconds + (message->Data[3] & 0x03u)) * 1e6 + (double)(value / 1000u) - (double)syncEndLocal;
+		if (fabs(error) > masterMaxError)
+		{
+			masterMaxError = fabs(error);
+		}
+		masterSyncs++;
+	}
+	else
+	{
+		/* not a time synchronization frame */
+	}
+}
+
+/**
+ * @brief The module is the master, its frames are sent with a random bus delay
+ */
+static int RunMaster(double duration, double busDelay, double limit)
+{
+	double t = 0;
+	double txAt = NEVER;
+	canApi_MessageTypedef pending;
+
+	canApiSim_SetTxPerTick(CANAPI_SIM_TX_EXTERNAL);
+	canApiSim_SetTransmitObserver(OnTransmit);
+	while (t < duration)
+	{
+		double next = (txAt < t + SAMPLE_PERIOD) ? txAt : t + SAMPLE_PERIOD;
+
+		RunTo(next);
+		if (next == txAt)
+		{
+			(void)canApiSim_Transmit(0);
+			txAt = NEVER;
+		}
+		else
+		{
+			t = next;
+		}
+		if (txAt == NEVER && canApiSim_PeekTransmit(&pending) == CAN_OK)
+		{
+			if (pending.Identifier == CAN_TIMESYNC_ID && pending.Data[0] == CAN_TIMESYNC_TYPE_SYNC)
+			{
+				syncQueuedLocal = localNow;
+			}
+			txAt = t + Uniform(busDelay) * 1e-6;
+		}
+	}
+
+	printf("master: %lu SYNC/FUP pairs, %lu FUP without SYNC, bus delay of SYNC up to %.0f us\n",
+		(unsigned long)masterSyncs, (unsigned long)masterBadSequence, masterMaxDelay);
+	printf("time of SYNC from SYNC/FUP minus module clock at its end of frame: max |error| %.0f us\n", masterMaxError);
+	return (masterSyncs > 0u && masterBadSequence == 0u && masterMaxError <= limit) ? 0 : 1;
+}
+
+/**
+ * @brief The module is a slave of the simulated master
+ */
+static int RunSlave(double duration, double interval, double busDelay, double jitter, double loss, double limit)
+{
+	double nextQueue; /* true time of the next SYNC queueing */
+	double syncAt = NEVER; /* true time the module stamps SYNC */
+	double fupAt = NEVER; /* true time the module stamps FUP */
+	double sampleAt = SAMPLE_PERIOD;
+	uint32_t syncSecondsSent = 0;
+	uint8_t overflow = 0;
+	uint32_t nanoseconds = 0;
+	uint32_t sequence = 0;
+	uint32_t synchronizations = 0;
+	uint32_t lost = 0;
+	double intervalMax = 0;
+	double steadyMax = 0;
+	double steadySquares = 0;
+	uint32_t steadySamples = 0;
+	CAN_TimeSync_Stats_TypeDef stats;
+	uint32_t k = 1;
+
+	nextQueue = interval * 1e-3 / (1.0 + masterDrift * 1e-6);
+	printf("sync   time [s]  offset [us]  drift [ppb]  true [ppb]  max |error| until next [us]\n");
+	while (sampleAt < duration)
+	{
+		double t = sampleAt;
+
+		if (nextQueue < t)
+		{
+			t = nextQueue;
+		}
+		if (syncAt < t)
+		{
+			t = syncAt;
+		}
+		if (fupAt < t)
+		{
+			t = fupAt;
+		}
+		RunTo(t);
+
+		if (t == nextQueue)
+		{
+			/* the master queues SYNC with its seconds and stamps the end of frame for FUP */
+			double end = t + Uniform(busDelay) * 1e-6;
+			double endTime = MasterClock(end);
+
+			syncSecondsSent = (uint32_t)(MasterClock(t) / 1e6);
+			overflow = (uint8_t)((endTime - syncSecondsSent * 1e6) / 1e6);
+			nanoseconds = (uint32_t)llround((endTime - (syncSecondsSent + overflow) * 1e6) * 1000.0);
+			if (nanoseconds >= 1000000000u)
+			{
+				nanoseconds = 999999999u;
+			}
+			syncAt = end + Uniform(jitter) * 1e-6;
+			fupAt = end + FUP_DELAY + Uniform(jitter) * 1e-6;
+			k++;
+			nextQueue = k * interval * 1e-3 / (1.0 + masterDrift * 1e-6);
+		}
+		else if (t == syncAt)
+		{
+			syncAt = NEVER;
+			if (Uniform(100.0) >= loss)
+			{
+				SendToModule(CAN_TIMESYNC_TYPE_SYNC, (uint8_t)(sequence & 0x0Fu), 0, syncSecondsSent);
+			}
+			else
+			{
+				lost++;
+			}
+		}
+		else if (t == fupAt)
+		{
+			fupAt = NEVER;
+			if (Uniform(100.0) >= loss)
+			{
+				SendToModule(CAN_TIMESYNC_TYPE_FUP, (uint8_t)(sequence & 0x0Fu), overflow, nanoseconds);
+			}
+			else
+			{
+				lost++;
+			}
+			sequence++;
+		}
+		else
+		{
+			double error = (double)CAN_TimeSync_GetTimeUs() - MasterClock(t);
+
+			CAN_TimeSync_GetStats(&stats);
+			if (stats.SyncCount != synchronizations)
+			{
+				/* the module took a new synchronization in the last 1ms callback */
+				if (synchronizations > 0u && synchronizations <= TABLE_ROWS)
+				{
+					printf("%26.0f\n", intervalMax);
+				}
+				synchronizations = stats.SyncCount;
+				if (synchronizations <= TABLE_ROWS)
+				{
+					printf("%4lu %10.3f %12ld %12ld %11.0f", (unsigned long)synchronizations, t, (long)stats.Offset,
+						(long)stats.Drift, TrueDrift(t));
+				}
+				intervalMax = 0;
+			}
+			if (fabs(error) > intervalMax)
+			{
+				intervalMax = fabs(error);
+			}
+			if (synchronizations >= 3u)
+			{
+				if (fabs(error) > steadyMax)
+				{
+					steadyMax = fabs(error);
+				}
+				steadySquares += error * error;
+				steadySamples++;
+			}
+			sampleAt += SAMPLE_PERIOD;
+		}
+	}
+	if (synchronizations > 0u && synchronizations <= TABLE_ROWS)
+	{
+		printf("%26.0f\n", intervalMax);
+	}
+
+	CAN_TimeSync_GetStats(&stats);
+	printf("%lu synchronizations, %lu frames lost, %lu FUP without SYNC, status %d\n", (unsigned long)stats.SyncCount,
+		(unsigned long)lost, (unsigned long)stats.ErrorCount, (int)CAN_TimeSync_GetStatus());
+	printf("from the 3rd synchronization on: max |error| %.1f us, rms %.2f us, max |offset| %lu us, drift %ld ppb (true %.0f)\n",
+		steadyMax, (steadySamples > 0u) ? sqrt(steadySquares / steadySamples) : 0.0, (unsigned long)stats.MaxOffset,
+		(long)stats.Drift, TrueDrift(duration));
+	return (steadySamples > 0u && steadyMax <= limit) ? 0 : 1;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char *argv[])
+{
+	double duration = 60.0;
+	double interval = 1000.0;
+	double jitter = 5.0;
+	double busDelay = 300.0;
+	double loss = 0.0;
+	double limit = 20.0;
+	int master = 0;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-m") == 0)
+		{
+			master = 1;
+		}
+		else if (i + 1 < argc && strlen(argv[i]) == 2u && argv[i][0] == '-' && strchr("tidDrjbpes", argv[i][1]) != 0)
+		{
+			double value = strtod(argv[++i], 0);
+
+			switch (argv[i - 1][1])
+			{
+				case 't': duration = value; break;
+				case 'i': interval = value; break;
+				case 'd': moduleDrift = value; break;
+				case 'D': masterDrift = value; break;
+				case 'r': driftRamp = value; break;
+				case 'j': jitter = value; break;
+				case 'b': busDelay = value; break;
+				case 'p': loss = value; break;
+				case 'e': limit = value; break;
+				default: randomState = (uint32_t)value; break;
+			}
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	if (duration <= 0.0 || duration > 86400.0 || interval < 10.0 || interval > 60000.0 || fabs(moduleDrift) > 500.0
+		|| fabs(masterDrift) > 500.0 || jitter < 0.0 || busDelay < 0.0 || loss < 0.0 || loss >= 100.0 || randomState == 0u)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	canApiSim_Init();
+	CAN_C_TimeSync_Interval = (UInt32)interval;
+	CAN_C_TimeSync_Mode = (master != 0) ? CAN_TIMESYNC_MASTER : CAN_TIMESYNC_SLAVE;
+	printf("module %+.1f ppm %+.2f ppm/min, master %+.1f ppm, interval %.0f ms, bus delay 0...%.0f us, stamp jitter 0...%.0f us, loss %.1f %%\n",
+		moduleDrift, driftRamp, masterDrift, interval, busDelay, jitter, loss);
+	if (master != 0)
+	{
+		return RunMaster(duration, busDelay, limit);
+	}
+	return RunSlave(duration, interval, busDelay, jitter, loss, limit);
+}
+
+/** @} */
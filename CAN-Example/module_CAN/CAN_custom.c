@@ -18,8 +18,21 @@
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* INCLUDES */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <math.h>
+#include <string.h>
 #include "CAN_custom.h"
+#include "CAN_delta.h"
+#include "CAN_isotp.h"
+#include "CAN_j1939.h"
+#include "CAN_recorder.h"
+#include "CAN_signals.h"
+#include "CAN_timesync.h"
+#include "CAN_uds.h"
+#include "CAN_xcp.h"
 #include "canApi.h"
+#ifdef CAN_FD_ENABLE
+#include "CAN_fd.h"
+#endif
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PRIVATE DEFINES */
@@ -28,6 +41,95 @@
 /** @brief number of known CAN messages to receive */
 #define COMMANDS_AVAILABLE ((uint8_t)(sizeof(msgManagment_array) / sizeof(msgManagement_TypeDef)))
 
+/** @brief number of periodic CAN messages to send */
+#define TX_MESSAGES_AVAILABLE ((uint8_t)(sizeof(txSchedule_array) / sizeof(txSchedule_TypeDef)))
+
+/** @brief number of periodic CAN messages sent in FD container frames */
+#define FD_CONTAINED_AVAILABLE ((uint8_t)(sizeof(fdContained_array) / sizeof(fdContained_array[0])))
+
+/** @brief number of bins of the transmit latency histograms, the last bin collects all larger values */
+#define TX_LATENCY_BINS 16u
+
+/** @brief width of one transmit latency histogram bin in microseconds */
+#define TX_LATENCY_BIN_US 100u
+
+/** @brief entry index of no periodic message */
+#define TX_ENTRY_NONE 0xFFu
+
+/** @brief number of EnableTool variables of this file, see CopyInterfaces() */
+#define INTERFACES_AVAILABLE 103u
+
+/** @brief number of receive timestamps buffered between the receive interrupt and canApi_UserPeriodicCallBack(), power of two */
+#define RX_TIMESTAMP_RING_SIZE 32u
+
+/** @brief maximum number of messages decoded directly in the receive interrupt */
+#define FAST_PATH_MAX 4u
+
+/** @brief depth of the software receive queue per priority class, see rxClass_TypeDef */
+#define RX_QUEUE_DEPTH_CONTROL 8u
+#define RX_QUEUE_DEPTH_NORMAL 16u
+#define RX_QUEUE_DEPTH_BULK 32u
+
+/** @brief number of receive priority classes */
+#define RX_CLASS_COUNT 3u
+
+/** @brief pages of the multiplexed diagnostic message 0x3F0, signals per page and the marker for no page */
+#define MUX_PAGES 8u
+#define MUX_SIGNALS_PER_PAGE 3u
+#define MUX_PAGE_NONE 0xFFu
+
+/** @brief longest interval of a page of the multiplexed message, upper limit of CAN_C_Mux_PageN_Interval [ms] */
+#define MUX_INTERVAL_MAX 60000u
+
+/** @brief signals of the delta telemetry 0x3F1 per NV variable */
+#define DELTA_SLOTS_PER_VARIABLE 4u
+
+/** @brief number of entries of j1939Pgn_array */
+#define J1939_PGNS_AVAILABLE ((uint8_t)(sizeof(j1939Pgn_array) / sizeof(j1939Pgn_array[0])))
+
+/** @brief J1939 PGNs answered on request: active diagnostic trouble codes (DM1) and software identification */
+#define J1939_PGN_DM1 0xFECAu
+#define J1939_PGN_SOFTWARE_ID 0xFEDAu
+
+/** @brief repetition time of DM1 [ms] */
+#define J1939_DM1_INTERVAL_MS 1000u
+
+/** @brief DM1: bits of canApi_Get_ERR_Errorcode() with an error number, first proprietary SPN, failure mode "condition exists" */
+#define J1939_DTC_COUNT 31u
+#define J1939_SPN_BASE 0x7F000u
+#define J1939_FMI_CONDITION_EXISTS 31u
+
+/** @brief DM1 lamp status "amber warning lamp on" */
+#define J1939_LAMP_AMBER 0x04u
+
+/** @brief software identification field "RRRRRRRR.VVVVVVVV*": BSW release and revision in hex [byte] */
+#define J1939_SOFTWARE_ID_LENGTH 18u
+
+/** @brief J1939 priority of the diagnostic messages and the acknowledgement */
+#define J1939_PRIORITY_DIAGNOSTIC 6u
+
+/** @brief no J1939 request to answer */
+#define J1939_NO_REQUEST 0xFFFFu
+
+/** @brief bits of CAN_C_Recorder_Triggers */
+#define RECORDER_TRIGGER_ERROR 0x01u
+#define RECORDER_TRIGGER_BUSOFF 0x02u
+#define RECORDER_TRIGGER_TIMEOUT 0x04u
+
+/** @brief values of CAN_C_Recorder_Command */
+#define RECORDER_COMMAND_TRIGGER 1u
+#define RECORDER_COMMAND_REARM 2u
+
+/** @brief bytes of the capture image shown in CAN_M_Recorder_Data0...3 */
+#define RECORDER_WINDOW_SIZE 16u
+
+/** @brief statistics of a window, values of CAN_C_Aggregate_Temperature and CAN_C_Aggregate_SOC */
+#define AGGREGATE_SAMPLE 0u
+#define AGGREGATE_MIN 1u
+#define AGGREGATE_MAX 2u
+#define AGGREGATE_MEAN 3u
+#define AGGREGATE_RMS 4u
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PRIVATE TYPEDEF */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -38,6 +140,17 @@ typedef void (*FptrOnTimeout)(void);
 /** @brief define pointer to function for message receive callback */
 typedef void (*FptrOnReceive)(const canApi_MessageTypedef *message);
 
+/**
+ * @brief Priority class of a received message.
+ * Each class has its own software receive queue. Queues are decoded in this order.
+ */
+typedef enum
+{
+	RX_CLASS_CONTROL = 0, /**< @brief control messages, always decoded in the same 1ms callback */
+	RX_CLASS_NORMAL = 1, /**< @brief cyclic messages, always decoded in the same 1ms callback */
+	RX_CLASS_BULK = 2 /**< @brief information messages, at most CAN_C_RxQueue_BulkBudget per 1ms callback */
+}rxClass_TypeDef;
+
 /**
  * @brief Typedef to map received messages to timeout settings and callback functions.
  * This is part of the helper functions to manage message receival and timeout management.
@@ -48,10 +161,129 @@ typedef struct
 	uint8_t IDE; /**< @brief 0x00u = standard frame identifier, 0x01u = extended frame identifier*/
 	int16_t TimeoutCounter; /**< @brief Current timeout counter value, set to negative value to disable timeout */
 	int16_t TimeoutReloadValue; /**< @brief Reload counter value. Timeout counter is reset to this value on message receive, set to negative value to disable timeout*/
+	rxClass_TypeDef Class; /**< @brief priority class, selects the software receive queue */
 	FptrOnTimeout TimeoutFunction; /**< @brief pointer to function which is called on message timeout detection */
 	FptrOnReceive ReceiveFunction; /**< @brief pointer to function which is called on message receive */
 }msgManagement_TypeDef;
 
+/** @brief define pointer to function for periodic message send */
+typedef void (*FptrOnSend)(void);
+
+/** @brief define pointer to function which tells if an optional periodic message is switched on */
+typedef uint8_t (*FptrIsOn)(void);
+
+/**
+ * @brief Typedef to map periodically sent messages to their send interval.
+ * Essential messages are control frames which are kept when the bus is degraded.
+ */
+typedef struct
+{
+	uint16_t Interval; /**< @brief Send interval in milliseconds */
+	uint8_t Essential; /**< @brief 0x01u = control frame, 0x00u = frame may be slowed down or shed on a degraded bus */
+	uint8_t Pending; /**< @brief Set when the message is due but was held back by the recovery ramp */
+	FptrOnSend SendFunction; /**< @brief pointer to function which packs and sends the message */
+	FptrIsOn IsOn; /**< @brief NV switch of an optional message, the message is skipped while it returns 0; 0 = always sent */
+	uint32_t NextSlot; /**< @brief timeslot in which the message is due next, 0 in txSchedule_array */
+}txSchedule_TypeDef;
+
+/**
+ * @brief Typedef for the queueing latency of one periodic message, from canApi_SendMessage() to transmit complete.
+ */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief Identifier of the message, filled on first send */
+	uint8_t IDE; /**< @brief 0x00u = standard frame identifier, 0x01u = extended frame identifier*/
+	uint8_t InFlight; /**< @brief 0x01u while the message is queued in the transmit buffer */
+	uint32_t EnqueueTimestamp; /**< @brief CAN_GetTimestampUs() when the message was queued */
+	uint32_t Count; /**< @brief number of measured transmissions */
+	uint32_t Min; /**< @brief minimum queueing latency [us] */
+	uint32_t Max; /**< @brief maximum queueing latency [us] */
+	uint16_t Histogram[TX_LATENCY_BINS]; /**< @brief latency histogram with TX_LATENCY_BIN_US wide bins, saturating */
+}txLatency_TypeDef;
+
+/**
+ * @brief Typedef for one receive timestamp captured in the receive interrupt
+ */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief Identifier of the received message */
+	uint8_t IDE; /**< @brief 0x00u = standard frame identifier, 0x01u = extended frame identifier*/
+	uint32_t Timestamp; /**< @brief CAN_GetTimestampUs() in the receive interrupt */
+}rxTimestamp_TypeDef;
+
+/**
+ * @brief Typedef for a message whose receive callback is called from the receive interrupt.
+ * IsrCount is written in the interrupt, PollCount in canApi_UserPeriodicCallBack(). The difference
+ * tells the polled path that a message from the receive buffer was already decoded.
+ */
+typedef struct
+{
+	uint8_t Index; /**< @brief index in msgManagment_array */
+	volatile uint8_t Active; /**< @brief 0x01u while decoded in the interrupt, cleared on too many budget overruns */
+	volatile uint32_t IsrCount; /**< @brief number of messages decoded in the interrupt */
+	uint32_t Overruns; /**< @brief consecutive budget overruns of this message, reset by a call within the budget */
+	uint32_t PollCount; /**< @brief number of those messages skipped by the polled path */
+}fastPath_TypeDef;
+
+/**
+ * @brief Typedef for a message waiting in a software receive queue.
+ */
+typedef struct
+{
+	canApi_MessageTypedef Message; /**< @brief received message */
+	uint8_t Index; /**< @brief index in msgManagment_array */
+}rxQueueEntry_TypeDef;
+
+/**
+ * @brief Typedef for the software receive queue of one priority class.
+ */
+typedef struct
+{
+	rxQueueEntry_TypeDef *Entries; /**< @brief queue storage */
+	uint8_t Depth; /**< @brief number of entries in the storage */
+	uint8_t Head; /**< @brief index of the oldest entry */
+	uint8_t Count; /**< @brief number of queued entries */
+}rxQueue_TypeDef;
+
+/**
+ * @brief Signals sampled every 1ms for the window statistics of the slow messages, index into aggregate_array
+ */
+typedef enum
+{
+	AGGREGATE_TEMP_FET = 0, /**< @brief MC_Temperature_01 */
+	AGGREGATE_TEMP_MOTOR = 1, /**< @brief MC_Temperature_01 */
+	AGGREGATE_TEMP_MCU = 2, /**< @brief MC_Temperature_01 */
+	AGGREGATE_SOC = 3, /**< @brief MC_APP_02 */
+	AGGREGATE_SIGNALS = 4
+}aggregateSignal_TypeDef;
+
+/**
+ * @brief Typedef for the statistics of one signal over the window since its message was last sent.
+ * The sums are taken relative to the first sample, so Float32 keeps its resolution for signals with
+ * a large offset and a small variation, like temperatures.
+ */
+typedef struct
+{
+	Float32 Reference; /**< @brief first sample of the window */
+	Float32 Min; /**< @brief smallest sample */
+	Float32 Max; /**< @brief largest sample */
+	Float32 Sum; /**< @brief sum of the samples minus Reference */
+	Float32 SumSquares; /**< @brief sum of the squares of the samples minus Reference */
+	uint32_t Count; /**< @brief number of samples, 0 = window empty */
+}aggregate_TypeDef;
+
+/**
+ * @brief Error state of the CAN peripheral as seen by the transmit policy
+ */
+typedef enum
+{
+	BUS_STATE_ACTIVE = 0, /**< @brief error active, all messages are sent */
+	BUS_STATE_WARNING = 1, /**< @brief error warning, non-essential messages are slowed down */
+	BUS_STATE_PASSIVE = 2, /**< @brief error passive, non-essential messages are shed */
+	BUS_STATE_BUSOFF = 3, /**< @brief bus-off, transmit buffer is flushed and nothing is sent */
+	BUS_STATE_RECOVERY = 4 /**< @brief after bus-off, the number of messages per millisecond is ramped up */
+}busState_TypeDef;
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PRIVATE CONSTANTS */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -73,151 +305,2123 @@ __attribute__((section("EMERGE_NV_RAM_PAGE1")))
 MEDKit_Modul_Interfaces UInt32 CAN_C_SwitchDataInfo_ID_306 = 0; /* 
 	Description: CAN-bus Display Data[-];StateList;0 = BateryVoltage; 1 = RemainigDistance; Limits: 0...1 */
 	
-__attribute__((section("EMERGE_DISP_RAM")))
-MEDKit_Modul_Interfaces UInt32 CAN_M_ReceivedTestData = 0; /* 
-	Description: CAN-bus Test data, received value via CAN in demo code */
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_BusWarning_Slowdown = 10; /* 
+	Description: Factor by which the send interval of non-essential messages is stretched while the CAN peripheral is error warning [-]; Limits: 1...60 */
 
-/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-/* PRIVATE FUNCTION PROTOTYPES */
-/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_BusRecovery_RampStep = 50; /* 
+	Description: Time after bus-off after which one more message per millisecond may be sent [ms]; Limits: 0...1000 */
 
-/* helper function to manage receive and timeout callbacks */
-static msgManagement_TypeDef* GetMessageManagement(const canApi_MessageTypedef *message);
-static void HandleMessageTimeouts(void);
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_TxLatency_Identifier = 0x2B9; /* 
+	Description: Identifier of the periodic message whose transmit queueing latency is shown in CAN_M_TxLatency_*; Limits: 0...536870911 */
 
-/* callback functions for received messages and their timeouts */
-static void MessageTimeout0x111(void);
-static void MessageReceive0x111(const canApi_MessageTypedef *message);
-static void MessageTimeout0x1B6(void);
-static void MessageReceive0x1B6(const canApi_MessageTypedef *message);
-static void MessageTimeout0x171(void);
-static void MessageReceive0x171(const canApi_MessageTypedef *message);
-static void MessageTimeout0x172(void);
-static void MessageReceive0x172(const canApi_MessageTypedef *message);
-static void MessageTimeout0x176(void);
-static void MessageReceive0x176(const canApi_MessageTypedef *message);
-static void MessageTimeout0x178(void);
-static void MessageReceive0x178(const canApi_MessageTypedef *message);
-static void MessageTimeout0x310(void);
-static void MessageReceive0x310(const canApi_MessageTypedef *message);
-static void MessageTimeout0x521(void);
-static void MessageReceive0x521(const canApi_MessageTypedef *message);
-static void MessageTimeout0x50C(void);
-static void MessageReceive0x50C(const canApi_MessageTypedef *message);
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_FastPath_Budget = 20; /* 
+	Description: Execution time budget of a receive callback called from the receive interrupt [us]; Limits: 1...1000 */
 
-static void MessageTimeoutDemo(void);
-static void MessageReceiveDemo(const canApi_MessageTypedef *message);
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_FastPath_MaxOverruns = 0; /* 
+	Description: Number of consecutive budget overruns after which a message falls back to the polled path, 0 = never [-]; Limits: 0...65535 */
 
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_RxQueue_BulkBudget = 4; /* 
+	Description: Maximum number of bulk class messages decoded per 1ms callback [-]; Limits: 1...32 */
 
-/* functions to send individual predefined messages */
-static void MessageSend0x1BF(void); /* PE_Act_05 */
-static void MessageSend0x1BD(void); /* MC_Temperature_01 */
-static void MessageSend0x1BC(void); /* MC_Errorflags_01 */
-static void MessageSend0x2B9(void); /* MC_State_01 */
-static void MessageSend0x1BA(void); /* MC_Current_01 */
-static void MessageSend0x601(void); /* MC_Prod_Data_01 */
-static void MessageSend0x602(void); /* MC_Prod_Data_02 */
-static void MessageSend0x603(void); /* MC_Prod_Data_03 */
-static void MessageSend0x604(void); /* MC_Prod_Data_04 */
-static void MessageSend0x1F0(void); /* MC_APP_01*/
-static void MessageSend0x1F1(void); /* MC_APP_02*/
-static void MessageSend0x1F2(void); /* MC_APP_03*/
-static void MessageSend0x1F4(void); /* MC_APP_04*/
-static void MessageSend0x90(void);  /* ICS_Info_01 */
-static void MessageSend0x206(void); /* Odo */
-static void MessageSend0x207(void); /* Display_01 */
-static void MessageSend0x305(void); /* Display_02 */
-static void MessageSend0x306(void); /* Display_03 */
-static void MessageSend0x209(void); /* Error */
-static void MessageSend0x1B5(void); /* Challenge for Immo Unlocking*/
-static void MessageSend0x1B7(void); /* Unlock Code sent to GRID-BMS if needed by GRID */
-static void MessageSend0x160(void); /* BMS Ctrl 01 */
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_IsoTp_FramesPerMs = 4; /* 
+	Description: Maximum number of ISO-TP frames put into the transmit buffer per 1ms callback while the bus is error active [-]; Limits: 1...32 */
 
-static void MessageSendFictionalDisplay(void); /* new message for our example */
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Xcp_Enable = 0; /* 
+	Description: XCP measurement on the identifiers 0x6F0/0x6F1;StateList;0=Off;1=On; Limits: 0...1 */
 
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Xcp_FramesPerMs = 8; /* 
+	Description: Maximum number of XCP DAQ frames put into the transmit buffer per 1ms callback while the bus is error active [-]; Limits: 1...32 */
 
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Uds_Enable = 0; /* 
+	Description: UDS diagnostic server on the identifiers 0x7E0/0x7E8 for ReadDataByIdentifier, ReadDTCInformation and TesterPresent, the filter is set at the next init of the CAN peripheral;StateList;0=Off;1=On; Limits: 0...1 */
 
-/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-/* PRIVATE VARIABLES */
-/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-		
-/**
- * @brief array of commands with their corresponing execution functions
- * All received messages and their timeouts and callbacks must be defined here.
- */
-static msgManagement_TypeDef msgManagment_array[] =
-{
-	/*{Identifier, IDE, TimeoutCounter, TimeoutReloadValue, TimeoutCallback, ReceiveCallback}*/ 
-	{0x111, 0, 200, 200,  MessageTimeout0x111, MessageReceive0x111}, /* Message EXT_Torque_Control_01 */
-	{0x1B6, 0, 200, 200,  MessageTimeout0x1B6, MessageReceive0x1B6}, /* Message EXT_Immo_Control_01 */
-	{0x171, 0, 200, 200,  MessageTimeout0x171, MessageReceive0x171}, /* Message BMS_Info_01 */
-	{0x172, 0, 2500, 2500,  MessageTimeout0x172, MessageReceive0x172}, /* Message BMS_Info_02 */
-	{0x176, 0, 2500, 2500,  MessageTimeout0x176, MessageReceive0x176}, /* Message BMS_Info_06 */
-	{0x178, 0, 2500, 2500,  MessageTimeout0x178, MessageReceive0x178}, /* Message BMS_Info_08 */
-	{0x310, 0, 200, 200,  MessageTimeout0x310, MessageReceive0x310}, /* Message Dyno_Act_01 */
-	{0x521, 0, 200, 200,  MessageTimeout0x521, MessageReceive0x521}, /* Message ISA_Scale_F1_Current_Sensor */
-	{0x50C, 0, 200, 200,  MessageTimeout0x50C, MessageReceive0x50C}, /* Message CAN Display Reset Message */
-	{0x600, 0, 500, 500, MessageTimeoutDemo, MessageReceiveDemo}, /* Demo message for display in EnableTool */
-};
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_ProdData_Broadcast = 1; /* 
+	Description: Periodic broadcast of the production data 0x601...0x604, off = only readable with UDS ReadDataByIdentifier;StateList;0=Off;1=On; Limits: 0...1 */
 
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_J1939_Enable = 0; /* 
+	Description: J1939 controller application with address claiming, DM1 and software identification, the filters are set at the next init of the CAN peripheral;StateList;0=Off;1=On; Limits: 0...1 */
 
-/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-/* PRIVATE FUNCTIONS */
-/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_J1939_Address = 0x90; /* 
+	Description: Preferred J1939 source address, claimed first [-]; Limits: 0...253 */
 
-/* helper function to manage receive and timeout callbacks */
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_J1939_Name_High = 0x80000000; /* 
+	Description: Upper 32 bits of the J1939 NAME: arbitrary address capable, industry group, vehicle system and function, bit 31 allows a fallback to the addresses 128...247 [-]; Limits: 0...4294967295 */
 
-/**
- * @brief Get the entry with timeout management and callbacks for given message
- * @param message: Pointer to received message
- * @return pointer to entry. Is 0 if no entry available
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_J1939_Manufacturer = 0x7FF; /* 
+	Description: Manufacturer code of the J1939 NAME, the identity number is taken from PROD_C_HW_Prod_Info_1 [-]; Limits: 0...2047 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_TimeSync_Mode = 0; /* 
+	Description: Time synchronization with SYNC/FUP on the identifier 0x080, the corrected clock stamps the XCP measurement;StateList;0=Off;1=Master;2=Slave; Limits: 0...2 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_TimeSync_Domain = 0; /* 
+	Description: Time domain of SYNC/FUP, frames of other domains are ignored [-]; Limits: 0...15 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_TimeSync_Interval = 1000; /* 
+	Description: Time between two SYNC messages as master [ms]; Limits: 10...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_TimeSync_Timeout = 5000; /* 
+	Description: Time without synchronization as slave until the status changes to timeout, 0 = never [ms]; Limits: 0...600000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_Enable = 0; /* 
+	Description: Flight recorder of the received and transmitted frames, needs CAN_RxIsrHook() and CAN_TxCompleteHook();StateList;0=Off;1=On; Limits: 0...1 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_Triggers = 7; /* 
+	Description: Events which freeze the flight recorder, bit 0 = new bit in the error code, bit 1 = bus-off, bit 2 = timeout of CAN_C_Recorder_TimeoutId [-]; Limits: 0...7 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_ErrorMask = 0xFFFFFFFF; /* 
+	Description: Bits of the error code which trigger the flight recorder [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_TimeoutId = 0x111; /* 
+	Description: Identifier of the received message whose timeout triggers the flight recorder, 0 = any message of msgManagment_array [-]; Limits: 0...536870911 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_PostShare = 25; /* 
+	Description: Share of the flight recorder for the frames after the trigger, the rest holds the frames before it [%]; Limits: 0...75 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_PostTime = 1000; /* 
+	Description: Time after the trigger until the capture is frozen, even if its share is not filled [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_Command = 0; /* 
+	Description: Change to 1 to trigger the flight recorder by hand, change to 2 to drop the capture and record again;StateList;0=None;1=Trigger;2=Rearm; Limits: 0...2 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Recorder_ReadOffset = 0; /* 
+	Description: First byte of the capture image shown in CAN_M_Recorder_Data0...3 [-]; Limits: 0...65535 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Aggregate_Enable = 0; /* 
+	Description: Window statistics of 1ms samples in the slow messages, off sends the sample at the time of the message;StateList;0=Off;1=On; Limits: 0...1 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Aggregate_Temperature = 2; /* 
+	Description: Statistic of the temperatures in MC_Temperature_01 0x1BD over the 1ms samples since the last message, needs CAN_C_Aggregate_Enable;StateList;0=Sample;1=Min;2=Max;3=Mean;4=RMS; Limits: 0...4 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Aggregate_SOC = 3; /* 
+	Description: Statistic of the state of charge in MC_APP_02 0x1F1 over the 1ms samples since the last message, needs CAN_C_Aggregate_Enable;StateList;0=Sample;1=Min;2=Max;3=Mean;4=RMS; Limits: 0...4 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Fd_Mode = 0; /* 
+	Description: Transmission of the messages in fdContained_array in CAN FD builds, 1 and 2 need FD capable or FD tolerant nodes only and receivers which unpack the container 0x1B0, 2 also a data bit rate all nodes support;StateList;0=Classic frames;1=FD container;2=FD container with bit rate switch; Limits: 0...2 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page0_Signals = 0xFF020100; /* 
+	Description: Signals of page 0 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page0_Interval = 0; /* 
+	Description: Repetition time of page 0 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page1_Signals = 0xFF060403; /* 
+	Description: Signals of page 1 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page1_Interval = 0; /* 
+	Description: Repetition time of page 1 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page2_Signals = 0xFF121110; /* 
+	Description: Signals of page 2 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page2_Interval = 0; /* 
+	Description: Repetition time of page 2 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page3_Signals = 0xFF24231E; /* 
+	Description: Signals of page 3 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page3_Interval = 0; /* 
+	Description: Repetition time of page 3 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page4_Signals = 0xFFFF2809; /* 
+	Description: Signals of page 4 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page4_Interval = 0; /* 
+	Description: Repetition time of page 4 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page5_Signals = 0xFFFF1A14; /* 
+	Description: Signals of page 5 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page5_Interval = 0; /* 
+	Description: Repetition time of page 5 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page6_Signals = 0xFF281C13; /* 
+	Description: Signals of page 6 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page6_Interval = 0; /* 
+	Description: Repetition time of page 6 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page7_Signals = 0xFF2B2A29; /* 
+	Description: Signals of page 7 of the multiplexed message 0x3F0, bytes 0...2 are indices into signal_array of CAN_signals.c packed in this order, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Mux_Page7_Interval = 0; /* 
+	Description: Repetition time of page 7 of the multiplexed message 0x3F0, rounded up to 10ms steps, 0 = page off [ms]; Limits: 0...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Enable = 0; /* 
+	Description: Delta telemetry on 0x3F1, only signals which changed beyond their deadband are sent;StateList;0=Off;1=On; Limits: 0...1 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_KeyframeInterval = 5000; /* 
+	Description: Time between two keyframes of the delta telemetry, which send every signal of the set [ms]; Limits: 100...60000 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_FramesPerSlot = 1; /* 
+	Description: Maximum number of delta telemetry frames per 10ms slot, can_rta assumes 1 [-]; Limits: 1...4 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals0 = 0x0E121110; /* 
+	Description: Signals 0...3 of the delta telemetry set, one index into signal_array of CAN_signals.c per byte, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband0 = 0x00050505; /* 
+	Description: Deadbands of the signals in CAN_C_Delta_Signals0, one per byte, a change up to the deadband is not sent [raw LSB]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals1 = 0x02032815; /* 
+	Description: Signals 4...7 of the delta telemetry set, one index into signal_array of CAN_signals.c per byte, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband1 = 0x05140500; /* 
+	Description: Deadbands of the signals in CAN_C_Delta_Signals1, one per byte, a change up to the deadband is not sent [raw LSB]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals2 = 0x0B000406; /* 
+	Description: Signals 8...11 of the delta telemetry set, one index into signal_array of CAN_signals.c per byte, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband2 = 0x05051402; /* 
+	Description: Deadbands of the signals in CAN_C_Delta_Signals2, one per byte, a change up to the deadband is not sent [raw LSB]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Signals3 = 0x0A091C14; /* 
+	Description: Signals 12...15 of the delta telemetry set, one index into signal_array of CAN_signals.c per byte, 0xFF = empty [-]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_Delta_Deadband3 = 0x0A0A0500; /* 
+	Description: Deadbands of the signals in CAN_C_Delta_Signals3, one per byte, a change up to the deadband is not sent [raw LSB]; Limits: 0...4294967295 */
+
+__attribute__((section("EMERGE_NV_RAM_PAGE1")))
+MEDKit_Modul_Interfaces UInt32 CAN_C_BufferDiag_Reset = 0; /* 
+	Description: Change from 0 to 1 to reset the CAN_M_TxBuffer_*, CAN_M_RxBuffer_* and CAN_M_RxQueue_* counters [-]; Limits: 0...1 */
+	
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_ReceivedTestData = 0; /* 
+	Description: CAN-bus Test data, received value via CAN in demo code */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState = 0; /* 
+	Description: Error state used by the transmit policy;StateList;0 = Active; 1 = Warning; 2 = Passive; 3 = BusOff; 4 = Recovery */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_WarningCount = 0; /* 
+	Description: Number of transitions into error warning state */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_PassiveCount = 0; /* 
+	Description: Number of transitions into error passive state */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_BusOffCount = 0; /* 
+	Description: Number of transitions into bus-off state */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_WarningTime = 0; /* 
+	Description: Time spent in error warning state [ms] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_PassiveTime = 0; /* 
+	Description: Time spent in error passive state [ms] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_BusOffTime = 0; /* 
+	Description: Time spent in bus-off state [ms] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_BusState_RecoveryTime = 0; /* 
+	Description: Time spent ramping up transmission after bus-off [ms] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxLatency_Count = 0; /* 
+	Description: Number of measured transmissions of message CAN_C_TxLatency_Identifier */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxLatency_Min = 0; /* 
+	Description: Minimum transmit queueing latency of message CAN_C_TxLatency_Identifier [us] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxLatency_Max = 0; /* 
+	Description: Maximum transmit queueing latency of message CAN_C_TxLatency_Identifier [us] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxLatency_P99 = 0; /* 
+	Description: 99th percentile of the transmit queueing latency of message CAN_C_TxLatency_Identifier, upper bin bound [us] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_FastPath_Count = 0; /* 
+	Description: Number of messages decoded in the receive interrupt */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_FastPath_Overruns = 0; /* 
+	Description: Number of receive callbacks in the receive interrupt which exceeded CAN_C_FastPath_Budget */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_FastPath_MaxTime = 0; /* 
+	Description: Maximum execution time of a receive callback in the receive interrupt [us] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxQueue_ControlOverflow = 0; /* 
+	Description: Number of control class messages dropped because the control receive queue was full */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxQueue_NormalOverflow = 0; /* 
+	Description: Number of normal class messages dropped because the normal receive queue was full */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxQueue_BulkOverflow = 0; /* 
+	Description: Number of bulk class messages dropped because the bulk receive queue was full */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_Fill = 0; /* 
+	Description: Number of messages in the canApi transmit buffer, needs CAN_TxCompleteHook() */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_HighWater = 0; /* 
+	Description: Maximum of CAN_M_TxBuffer_Fill since reset */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_Overflow = 0; /* 
+	Description: Number of messages rejected by the canApi transmit buffer */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TxBuffer_LastDropId = 0; /* 
+	Description: Identifier of the last message rejected by the canApi transmit buffer */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_Fill = 0; /* 
+	Description: Number of messages taken from the canApi receive buffer in the last 1ms callback */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_HighWater = 0; /* 
+	Description: Maximum of CAN_M_RxBuffer_Fill since reset */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_Overflow = 0; /* 
+	Description: Number of messages seen in the receive interrupt but lost in the canApi receive buffer, needs CAN_RxIsrHook() */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_RxBuffer_LastDropId = 0; /* 
+	Description: Identifier of the last message lost in the canApi receive buffer */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Xcp_DaqOverload = 0; /* 
+	Description: Number of XCP DAQ list samples skipped because the frame budget or the transmit buffer was exhausted */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_J1939_Address = 254; /* 
+	Description: Claimed J1939 source address, 254 = none */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TimeSync_Status = 0; /* 
+	Description: State of the corrected clock;StateList;0 = Unsynchronized; 1 = Synchronized; 2 = Timeout */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces Int32 CAN_M_TimeSync_Offset = 0; /* 
+	Description: Time of the master minus the corrected clock at the last synchronization [us] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TimeSync_MaxOffset = 0; /* 
+	Description: Largest magnitude of CAN_M_TimeSync_Offset once the drift is estimated [us] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces Int32 CAN_M_TimeSync_Drift = 0; /* 
+	Description: Rate of the master relative to the local oscillator [ppb] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_TimeSync_Count = 0; /* 
+	Description: Number of synchronizations as slave */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_State = 0; /* 
+	Description: State of the flight recorder;StateList;0 = Off; 1 = Recording; 2 = Triggered; 3 = Frozen */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_Cause = 0; /* 
+	Description: Trigger of the capture;StateList;0 = None; 1 = Error; 2 = BusOff; 3 = Timeout; 4 = Manual */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_Size = 0; /* 
+	Description: Size of the capture image, 0 until it is frozen [byte] */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_Data0 = 0; /* 
+	Description: Bytes 0...3 of the capture image from CAN_C_Recorder_ReadOffset on, Motorola byte order */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_Data1 = 0; /* 
+	Description: Bytes 4...7 of the capture image from CAN_C_Recorder_ReadOffset on, Motorola byte order */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_Data2 = 0; /* 
+	Description: Bytes 8...11 of the capture image from CAN_C_Recorder_ReadOffset on, Motorola byte order */
+
+__attribute__((section("EMERGE_DISP_RAM")))
+MEDKit_Modul_Interfaces UInt32 CAN_M_Recorder_Data3 = 0; /* 
+	Description: Bytes 12...15 of the capture image from CAN_C_Recorder_ReadOffset on, Motorola byte order */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* helper function to manage receive and timeout callbacks */
+static msgManagement_TypeDef* GetMessageManagement(const canApi_MessageTypedef *message);
+static void HandleMessageTimeouts(void);
+
+/* helper functions to adapt the periodic transmission to the bus error state */
+static void UpdateBusState(void);
+static void SendPeriodicMessages(uint32_t timeslot);
+static uint32_t GetIsoTpBudget(void);
+static uint32_t GetXcpBudget(void);
+
+/* helper functions to rotate the pages of the multiplexed message */
+static uint8_t IsMuxDiagOn(void);
+static uint8_t SelectMuxPage(void);
+
+/* helper functions to apply the NV configuration of the delta telemetry */
+static uint8_t IsDeltaTelemetryOn(void);
+static void ConfigureDeltaTelemetry(void);
+static void ProcessJ1939(void);
+static void ProcessTimeSync(void);
+static void ProcessRecorder(void);
+static void ProcessAggregation(void);
+static Float32 AggregateWindow(aggregateSignal_TypeDef signal, UInt32 statistic);
+static void SendJ1939Dm1(void);
+static void SendJ1939SoftwareId(uint8_t destination);
+
+/* helper functions to send messages and measure their transmit queueing latency */
+static canApi_StatusTypeDef SendMessage(const canApi_MessageTypedef *message);
+static uint32_t TxLatencyPercentile(const txLatency_TypeDef *latency, uint8_t percent);
+static void UpdateTxLatencyDisplay(void);
+
+#ifdef CAN_FD_ENABLE
+/* helper functions for FD container frames */
+static uint8_t IsFdContained(const canApi_MessageTypedef *message);
+static canApi_StatusTypeDef AddToFdContainer(const canApi_MessageTypedef *message);
+static void FlushFdContainer(void);
+#endif
+
+/* helper functions to track the reception time of messages */
+static uint32_t GetRxTimestamp(const canApi_MessageTypedef *message);
+static void UpdateRxTiming(uint8_t index, uint32_t timestamp);
+static const CAN_RxTiming_TypeDef* FindRxTiming(uint32_t identifier, uint8_t ide);
+
+/* helper function for messages decoded in the receive interrupt */
+static uint8_t IsDecodedInInterrupt(uint8_t index);
+
+/* helper functions for the buffer diagnostics */
+static void ClearTransmitBuffer(void);
+static void UpdateBufferDiagnostics(void);
+
+/* helper functions for the software receive queues */
+static void DrainReceiveBuffer(void);
+static void SortReceivedMessage(const canApi_MessageTypedef *message, uint32_t timestamp);
+static void DecodeReceiveQueue(rxClass_TypeDef rxClass, uint32_t budget);
+static void CountRxQueueOverflow(rxClass_TypeDef rxClass);
+
+/* helper functions for the module context */
+static void InitContext(CAN_Context_TypeDef *context);
+#ifdef CAN_MULTI_INSTANCE
+static void CopyInterfaces(uint8_t restore);
+#endif
+
+/* callback functions for received messages and their timeouts */
+static void MessageTimeout0x111(void);
+static void MessageReceive0x111(const canApi_MessageTypedef *message);
+static void MessageTimeout0x1B6(void);
+static void MessageReceive0x1B6(const canApi_MessageTypedef *message);
+static void MessageTimeout0x171(void);
+static void MessageReceive0x171(const canApi_MessageTypedef *message);
+static void MessageTimeout0x172(void);
+static void MessageReceive0x172(const canApi_MessageTypedef *message);
+static void MessageTimeout0x176(void);
+static void MessageReceive0x176(const canApi_MessageTypedef *message);
+static void MessageTimeout0x178(void);
+static void MessageReceive0x178(const canApi_MessageTypedef *message);
+static void MessageTimeout0x310(void);
+static void MessageReceive0x310(const canApi_MessageTypedef *message);
+static void MessageTimeout0x521(void);
+static void MessageReceive0x521(const canApi_MessageTypedef *message);
+static void MessageTimeout0x50C(void);
+static void MessageReceive0x50C(const canApi_MessageTypedef *message);
+
+static void MessageTimeoutDemo(void);
+static void MessageReceiveDemo(const canApi_MessageTypedef *message);
+
+static void MessageReceiveJ1939Request(uint32_t pgn, uint8_t source, uint8_t destination, const uint8_t *data, uint32_t length);
+
+
+/* functions to send individual predefined messages */
+static void MessageSend0x1BF(void); /* PE_Act_05 */
+static void MessageSend0x1BD(void); /* MC_Temperature_01 */
+static void MessageSend0x1BC(void); /* MC_Errorflags_01 */
+static void MessageSend0x2B9(void); /* MC_State_01 */
+static void MessageSend0x1BA(void); /* MC_Current_01 */
+static void MessageSend0x601(void); /* MC_Prod_Data_01 */
+static void MessageSend0x602(void); /* MC_Prod_Data_02 */
+static void MessageSend0x603(void); /* MC_Prod_Data_03 */
+static void MessageSend0x604(void); /* MC_Prod_Data_04 */
+static void MessageSend0x1F0(void); /* MC_APP_01*/
+static void MessageSend0x1F1(void); /* MC_APP_02*/
+static void MessageSend0x1F2(void); /* MC_APP_03*/
+static void MessageSend0x1F4(void); /* MC_APP_04*/
+static void MessageSend0x90(void);  /* ICS_Info_01 */
+static void MessageSend0x206(void); /* Odo */
+static void MessageSend0x207(void); /* Display_01 */
+static void MessageSend0x305(void); /* Display_02 */
+static void MessageSend0x306(void); /* Display_03 */
+static void MessageSend0x209(void); /* Error */
+static void MessageSend0x1B5(void); /* Challenge for Immo Unlocking*/
+static void MessageSend0x1B7(void); /* Unlock Code sent to GRID-BMS if needed by GRID */
+static void MessageSend0x160(void); /* BMS Ctrl 01 */
+
+static void MessageSend0x3F0(void); /* Mux_Diag_01 */
+static void MessageSend0x3F1(void); /* Delta_Telemetry_01 */
+static void MessageSendFictionalDisplay(void); /* new message for our example */
+
+
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+		
+/**
+ * @brief array of commands with their corresponing execution functions
+ * All received messages and their timeouts and callbacks must be defined here.
+ */
+static const msgManagement_TypeDef msgManagment_array[] =
+{
+	/*{Identifier, IDE, TimeoutCounter, TimeoutReloadValue, Class, TimeoutCallback, ReceiveCallback}*/ 
+	{0x111, 0, 200, 200, RX_CLASS_CONTROL, MessageTimeout0x111, MessageReceive0x111}, /* Message EXT_Torque_Control_01 */
+	{0x1B6, 0, 200, 200, RX_CLASS_CONTROL, MessageTimeout0x1B6, MessageReceive0x1B6}, /* Message EXT_Immo_Control_01 */
+	{0x171, 0, 200, 200, RX_CLASS_BULK, MessageTimeout0x171, MessageReceive0x171}, /* Message BMS_Info_01 */
+	{0x172, 0, 2500, 2500, RX_CLASS_BULK, MessageTimeout0x172, MessageReceive0x172}, /* Message BMS_Info_02 */
+	{0x176, 0, 2500, 2500, RX_CLASS_BULK, MessageTimeout0x176, MessageReceive0x176}, /* Message BMS_Info_06 */
+	{0x178, 0, 2500, 2500, RX_CLASS_BULK, MessageTimeout0x178, MessageReceive0x178}, /* Message BMS_Info_08 */
+	{0x310, 0, 200, 200, RX_CLASS_NORMAL, MessageTimeout0x310, MessageReceive0x310}, /* Message Dyno_Act_01 */
+	{0x521, 0, 200, 200, RX_CLASS_NORMAL, MessageTimeout0x521, MessageReceive0x521}, /* Message ISA_Scale_F1_Current_Sensor */
+	{0x50C, 0, 200, 200, RX_CLASS_NORMAL, MessageTimeout0x50C, MessageReceive0x50C}, /* Message CAN Display Reset Message */
+	{0x600, 0, 500, 500, RX_CLASS_BULK, MessageTimeoutDemo, MessageReceiveDemo}, /* Demo message for display in EnableTool */
+};
+
+/**
+ * @brief getters of the signals sampled every 1ms, indexed by aggregateSignal_TypeDef
+ */
+static const CAN_Signal_FptrGetFloat32 aggregate_array[AGGREGATE_SIGNALS] =
+{
+	canApi_Get_TEMP_FET_Max,
+	canApi_Get_TEMP_Motor,
+	canApi_Get_TEMP_MCU,
+	canApi_Get_SOC_State_of_Charge,
+};
+
+/**
+ * @brief array of J1939 PGNs with their receive functions, sorted by ascending PGN.
+ * Only used while CAN_C_J1939_Enable is set, the messages are matched by PGN instead of identifier.
+ */
+static const CAN_J1939_Pgn_TypeDef j1939Pgn_array[] =
+{
+	/*{Pgn, ReceiveFunction}*/
+	{CAN_J1939_PGN_REQUEST, MessageReceiveJ1939Request}, /* Request */
+};
+
+/**
+ * @brief array of periodically sent messages with their send interval
+ * All periodic messages must be defined here. Messages are queued in the order of this array,
+ * so essential messages are listed first.
+ */
+static const txSchedule_TypeDef txSchedule_array[] =
+{
+	/*{Interval, Essential, Pending, SendFunction, IsOn, NextSlot}*/
+	{10, 1, 0, MessageSend0x160, 0, 0}, /* BMS Ctrl 01 */
+	{10, 1, 0, MessageSend0x90, 0, 0},  /* ICS_Info_01 */
+	{10, 1, 0, MessageSend0x1BA, 0, 0}, /* MC_Current_01 */
+	{10, 1, 0, MessageSend0x1BC, 0, 0}, /* MC_Errorflags_01 */
+	{10, 1, 0, MessageSend0x2B9, 0, 0}, /* MC_State_01 */
+	{100, 1, 0, MessageSend0x1B5, 0, 0}, /* Challenge for Immo Unlocking*/
+	{100, 1, 0, MessageSend0x1B7, 0, 0}, /* Unlock Code sent to GRID-BMS if needed by GRID */
+	{100, 0, 0, MessageSend0x1BF, 0, 0}, /* PE_Act_05 */
+	{100, 0, 0, MessageSend0x1F0, 0, 0}, /* MC_APP_01*/
+	{100, 0, 0, MessageSend0x1F4, 0, 0}, /* MC_APP_04*/
+	{100, 0, 0, MessageSend0x206, 0, 0}, /* Odo */
+	{100, 0, 0, MessageSend0x207, 0, 0}, /* Display_01 */
+	{100, 0, 0, MessageSend0x209, 0, 0}, /* Error */
+	{100, 0, 0, MessageSend0x305, 0, 0}, /* Display_02 */
+	{100, 0, 0, MessageSend0x306, 0, 0}, /* Display_03 */
+	{1000, 0, 0, MessageSend0x1BD, 0, 0}, /* MC_Temperature_01 */
+	{1000, 0, 0, MessageSend0x1F1, 0, 0}, /* MC_APP_02*/
+	{1000, 0, 0, MessageSend0x1F2, 0, 0}, /* MC_APP_03*/
+	{1000, 0, 0, MessageSend0x601, 0, 0}, /* MC_Prod_Data_01 */
+	{1000, 0, 0, MessageSend0x602, 0, 0}, /* MC_Prod_Data_02 */
+	{1000, 0, 0, MessageSend0x603, 0, 0}, /* MC_Prod_Data_03 */
+	{1000, 0, 0, MessageSend0x604, 0, 0}, /* MC_Prod_Data_04 */
+	{1000, 0, 0, MessageSendFictionalDisplay, 0, 0}, /* Send the data to our fictional display */
+	{10, 0, 0, MessageSend0x3F0, IsMuxDiagOn, 0}, /* Mux_Diag_01, at most one page per slot */
+	{10, 0, 0, MessageSend0x3F1, IsDeltaTelemetryOn, 0}, /* Delta_Telemetry_01, up to CAN_C_Delta_FramesPerSlot frames per slot */
+};
+
+#ifdef CAN_FD_ENABLE
+/**
+ * @brief standard identifiers of the periodic messages which are packed into FD container frames.
+ * A classic CAN controller raises an error frame on every FD frame, so CAN_C_Fd_Mode 1 and 2 need a bus
+ * with FD capable or FD tolerant nodes only, also when they do not read the containers. The receivers of
+ * the listed messages, including the display for 0x206, 0x207, 0x209, 0x305 and 0x306, must unpack the
+ * container 0x1B0. Messages for the BMS, the ICS and the immobilizer are never packed.
+ */
+static const uint32_t fdContained_array[] =
+{
+	0x1BA, /* MC_Current_01 */
+	0x1BC, /* MC_Errorflags_01 */
+	0x2B9, /* MC_State_01 */
+	0x1BF, /* PE_Act_05 */
+	0x1F0, /* MC_APP_01*/
+	0x1F4, /* MC_APP_04*/
+	0x206, /* Odo */
+	0x207, /* Display_01 */
+	0x209, /* Error */
+	0x305, /* Display_02 */
+	0x306, /* Display_03 */
+	0x1BD, /* MC_Temperature_01 */
+	0x1F1, /* MC_APP_02*/
+	0x1F2, /* MC_APP_03*/
+	0x601, /* MC_Prod_Data_01 */
+	0x602, /* MC_Prod_Data_02 */
+	0x603, /* MC_Prod_Data_03 */
+	0x604, /* MC_Prod_Data_04 */
+};
+#endif
+
+/**
+ * @brief Runtime state of this file, see CAN_Context_TypeDef.
+ * Everything of CAN_custom.c which changes after canApi_UserInitCallBack() lives here, so a host simulation
+ * can run many controller instances side by side. msgManagment_array and txSchedule_array are the power-up
+ * values of the timeout counters and pending flags, each context works on its own copy.
+ * The EnableTool variables and the sub-modules (ISO-TP, UDS, XCP, J1939, time sync, delta telemetry,
+ * recorder) keep their state per thread, CAN_InitContext() resets them with the context. Therefore a
+ * context stays with the thread which initialized it.
+ */
+struct CAN_ContextTag
+{
+	uint8_t Initialized; /**< @brief 0x01u after CAN_InitContext() */
+#ifdef CAN_MULTI_INSTANCE
+	const void *Owner; /**< @brief thread which initialized the context, address of its canThreadContext */
+#endif
+	msgManagement_TypeDef MsgManagement[COMMANDS_AVAILABLE]; /**< @brief copy of msgManagment_array */
+	txSchedule_TypeDef TxSchedule[TX_MESSAGES_AVAILABLE]; /**< @brief copy of txSchedule_array */
+	
+	busState_TypeDef BusState; /**< @brief current error state of the CAN peripheral */
+	uint8_t RecoveryBudget; /**< @brief number of messages which may be sent per millisecond while recovering from bus-off */
+	uint16_t RecoveryTimer; /**< @brief time since the recovery budget was last raised [ms] */
+	uint32_t MsCounter; /**< @brief number of calls of canApi_UserPeriodicCallBack(), default timestamp source */
+	uint32_t TxTimeslot; /**< @brief free running millisecond counter of the tx message intervals */
+	UInt16 IcsCounter; /**< @brief alive counter of ICS_Info_01 */
+	
+	txLatency_TypeDef TxLatency[TX_MESSAGES_AVAILABLE]; /**< @brief queueing latency side table, same index as txSchedule_array */
+	uint8_t TxCurrentEntry; /**< @brief index of the TxSchedule entry currently being sent, TX_ENTRY_NONE outside the scheduler */
+	
+	/**
+	 * @brief receive timestamps in the order of reception, parallel to the receive buffer.
+	 * Written by CAN_RxIsrHook() at RxTimestampHead, read in canApi_UserPeriodicCallBack() at RxTimestampTail.
+	 */
+	rxTimestamp_TypeDef RxTimestampRing[RX_TIMESTAMP_RING_SIZE];
+	volatile uint8_t RxTimestampHead;
+	volatile uint8_t RxTimestampTail;
+	
+	/**
+	 * @brief transmit buffer fill estimation.
+	 * TxAcceptedCount is written in canApi_UserPeriodicCallBack(), TxCompletedCount by CAN_TxCompleteHook().
+	 * The fill is only shown once the hook was called, otherwise the difference would grow forever.
+	 */
+	uint32_t TxAcceptedCount;
+	volatile uint32_t TxCompletedCount;
+	volatile uint8_t TxCompleteSeen;
+	UInt32 BufferDiagResetLast; /**< @brief last value of CAN_C_BufferDiag_Reset, to detect the reset command */
+	
+	CAN_RxTiming_TypeDef RxTiming[COMMANDS_AVAILABLE]; /**< @brief receive timing side table, same index as msgManagment_array */
+	
+	fastPath_TypeDef FastPath[FAST_PATH_MAX]; /**< @brief messages decoded in the receive interrupt, see CAN_RegisterFastPath() */
+	uint8_t FastPathCount;
+	
+	rxQueueEntry_TypeDef RxQueueControl[RX_QUEUE_DEPTH_CONTROL]; /**< @brief storage of the software receive queues */
+	rxQueueEntry_TypeDef RxQueueNormal[RX_QUEUE_DEPTH_NORMAL];
+	rxQueueEntry_TypeDef RxQueueBulk[RX_QUEUE_DEPTH_BULK];
+	rxQueue_TypeDef RxQueue[RX_CLASS_COUNT]; /**< @brief software receive queues, indexed by rxClass_TypeDef */
+	
+	int32_t MuxCountdown[MUX_PAGES]; /**< @brief time until each page of 0x3F0 is due, negative when overdue [ms] */
+	uint32_t MuxLastMs; /**< @brief MsCounter at the last slot of 0x3F0 */
+	uint8_t DeltaRunning; /**< @brief 0x01u while the delta telemetry is on, a start sends a keyframe */
+	uint32_t DeltaKeyframeMs; /**< @brief MsCounter at the last keyframe of 0x3F1 */
+	
+	uint8_t J1939Dm1Requested; /**< @brief 0x01u if DM1 was requested and is sent before the next interval */
+	uint16_t J1939SoftwareIdRequest; /**< @brief destination of the requested software identification, J1939_NO_REQUEST if none */
+	uint16_t J1939NackRequest; /**< @brief requester of an unsupported PGN, J1939_NO_REQUEST if none */
+	uint32_t J1939NackPgn; /**< @brief unsupported PGN, answered with a negative acknowledgement */
+	uint8_t J1939Dm1[2u + 4u * J1939_DTC_COUNT]; /**< @brief DM1 payload, read by the transport protocol until it ends */
+	uint8_t J1939SoftwareId[1u + J1939_SOFTWARE_ID_LENGTH]; /**< @brief software identification payload */
+	
+	UInt32 RecorderErrorLast; /**< @brief error code bits of CAN_C_Recorder_ErrorMask in the last 1ms callback */
+	UInt32 RecorderCommandLast; /**< @brief last value of CAN_C_Recorder_Command, to detect a command */
+	
+	aggregate_TypeDef Aggregate[AGGREGATE_SIGNALS]; /**< @brief window statistics, indexed by aggregateSignal_TypeDef */
+	
+#ifdef CAN_FD_ENABLE
+	CAN_Fd_Container_TypeDef FdContainer; /**< @brief container frame filled by the periodic messages of this millisecond */
+#endif
+};
+
+/** @brief context of the controller, the only one on the target */
+static CAN_Context_TypeDef canDefaultContext;
+
+#ifdef CAN_MULTI_INSTANCE
+/** @brief context used by the entry points, selected per thread with CAN_SelectContext() */
+static _Thread_local CAN_Context_TypeDef *canContext = &canDefaultContext;
+
+/** @brief the one context initialized by this thread, 0 while the thread has none */
+static _Thread_local CAN_Context_TypeDef *canThreadContext = 0;
+
+/** @brief power-up values of the EnableTool variables of this thread, saved by its first CAN_InitContext() */
+static _Thread_local UInt32 canInterfacePowerUp[INTERFACES_AVAILABLE];
+static _Thread_local uint8_t canInterfaceSaved = 0;
+#else
+/** @brief context used by the entry points, constant so that the compiler resolves every access statically */
+static CAN_Context_TypeDef * const canContext = &canDefaultContext;
+#endif
+
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* helper function to manage receive and timeout callbacks */
+
+/**
+ * @brief Get the entry with timeout management and callbacks for given message
+ * @param message: Pointer to received message
+ * @return pointer to entry. Is 0 if no entry available
+ */
+static msgManagement_TypeDef* GetMessageManagement(const canApi_MessageTypedef *message)
+{
+	uint8_t i;
+	msgManagement_TypeDef* retval = (msgManagement_TypeDef*)0;
+	
+	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	{
+			if (canContext->MsgManagement[i].CanIdentifier == message->Identifier
+				&& canContext->MsgManagement[i].IDE == message->IDE)
+			{
+					retval = &canContext->MsgManagement[i];
+			}
+	}
+	return retval;
+}
+
+/**
+ * @brief Decrement all message timeout counter values.
+ * If a counter reaches 0, the message timout callback function is called
+ */
+static void HandleMessageTimeouts(void)
+{
+	uint8_t i;
+	
+	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	{
+		if (canContext->MsgManagement[i].TimeoutCounter > 0)
+		{
+			canContext->MsgManagement[i].TimeoutCounter--;
+		}
+		else if (canContext->MsgManagement[i].TimeoutCounter == 0)
+		{
+			/* call timeout function if counter reaches 0 */
+			if (canContext->MsgManagement[i].TimeoutFunction != 0)
+			{
+				canContext->MsgManagement[i].TimeoutFunction();
+			}
+			if ((CAN_C_Recorder_Triggers & RECORDER_TRIGGER_TIMEOUT) != 0
+				&& (CAN_C_Recorder_TimeoutId == 0 || CAN_C_Recorder_TimeoutId == canContext->MsgManagement[i].CanIdentifier))
+			{
+				CAN_Recorder_Trigger(CAN_RECORDER_CAUSE_TIMEOUT);
+			}
+			/* set to -1 to avoid calling the timeout callback every millisecond */
+			canContext->MsgManagement[i].TimeoutCounter = -1;
+		}
+		else
+		{
+			/* do nothing */
+		}
+	}
+}
+
+/* helper functions to adapt the periodic transmission to the bus error state */
+
+/**
+ * @brief Read the error state flags of the CAN peripheral and update the transmit policy.
+ * Entering bus-off flushes the transmit buffer. Leaving bus-off starts a recovery ramp which
+ * allows one message per millisecond and raises the budget every CAN_C_BusRecovery_RampStep.
+ * Transitions and the time spent in each state are recorded for the EnableTool.
+ */
+static void UpdateBusState(void)
+{
+	busState_TypeDef newState;
+	
+	if (canApi_Get_BSW_IO_F_CAN_BSW_BusOff() != 0)
+	{
+		newState = BUS_STATE_BUSOFF;
+	}
+	else if (canContext->BusState == BUS_STATE_BUSOFF
+		|| (canContext->BusState == BUS_STATE_RECOVERY && canContext->RecoveryBudget < TX_MESSAGES_AVAILABLE))
+	{
+		newState = BUS_STATE_RECOVERY;
+	}
+	else if (canApi_Get_BSW_IO_F_CAN_BSW_Passive() != 0)
+	{
+		newState = BUS_STATE_PASSIVE;
+	}
+	else if (canApi_Get_BSW_IO_F_CAN_BSW_Warning() != 0)
+	{
+		newState = BUS_STATE_WARNING;
+	}
+	else
+	{
+		newState = BUS_STATE_ACTIVE;
+	}
+	
+	if (newState != canContext->BusState)
+	{
+		switch (newState)
+		{
+			case BUS_STATE_WARNING:
+				CAN_M_BusState_WarningCount++;
+				break;
+			
+			case BUS_STATE_PASSIVE:
+				CAN_M_BusState_PassiveCount++;
+				break;
+			
+			case BUS_STATE_BUSOFF:
+				/* drop everything queued, it would only be sent late after recovery */
+				ClearTransmitBuffer();
+				CAN_M_BusState_BusOffCount++;
+				if ((CAN_C_Recorder_Triggers & RECORDER_TRIGGER_BUSOFF) != 0)
+				{
+					CAN_Recorder_Trigger(CAN_RECORDER_CAUSE_BUSOFF);
+				}
+				break;
+			
+			case BUS_STATE_RECOVERY:
+				canContext->RecoveryBudget = (CAN_C_BusRecovery_RampStep == 0) ? TX_MESSAGES_AVAILABLE : 1;
+				canContext->RecoveryTimer = 0;
+				break;
+			
+			default:
+				break;
+		}
+		canContext->BusState = newState;
+	}
+	
+	switch (canContext->BusState)
+	{
+		case BUS_STATE_WARNING:
+			CAN_M_BusState_WarningTime++;
+			break;
+		
+		case BUS_STATE_PASSIVE:
+			CAN_M_BusState_PassiveTime++;
+			break;
+		
+		case BUS_STATE_BUSOFF:
+			CAN_M_BusState_BusOffTime++;
+			break;
+		
+		case BUS_STATE_RECOVERY:
+			CAN_M_BusState_RecoveryTime++;
+			canContext->RecoveryTimer++;
+			if (canContext->RecoveryTimer >= CAN_C_BusRecovery_RampStep && canContext->RecoveryBudget < TX_MESSAGES_AVAILABLE)
+			{
+				canContext->RecoveryBudget++;
+				canContext->RecoveryTimer = 0;
+			}
+			break;
+		
+		default:
+			break;
+	}
+	CAN_M_BusState = (UInt32)canContext->BusState;
+}
+
+/**
+ * @brief Queue all periodic messages which are due in this timeslot.
+ * On error warning the interval of non-essential messages is stretched by CAN_C_BusWarning_Slowdown,
+ * on error passive and during recovery they are shed. In bus-off nothing is queued. During recovery
+ * due messages beyond the budget stay pending for the next millisecond.
+ * Each entry keeps the slot it is due next, so any interval and slowdown keeps its period when the counter wraps.
+ * @param timeslot: free running millisecond counter
+ */
+static void SendPeriodicMessages(uint32_t timeslot)
+{
+	uint8_t i;
+	uint8_t budget = (canContext->BusState == BUS_STATE_RECOVERY) ? canContext->RecoveryBudget : TX_MESSAGES_AVAILABLE;
+	uint32_t slowdown = (CAN_C_BusWarning_Slowdown > 0) ? CAN_C_BusWarning_Slowdown : 1;
+	
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		txSchedule_TypeDef *entry = &canContext->TxSchedule[i];
+		uint32_t interval = entry->Interval;
+		
+		if (entry->Essential == 0 && canContext->BusState == BUS_STATE_WARNING)
+		{
+			interval *= slowdown;
+		}
+		
+		/* shed messages keep their phase as well */
+		if ((int32_t)(timeslot - entry->NextSlot) >= 0)
+		{
+			entry->Pending = 1;
+			entry->NextSlot += interval;
+			if ((int32_t)(timeslot - entry->NextSlot) >= 0)
+			{
+				/* more than one interval late, the timeslot was set from outside */
+				entry->NextSlot = timeslot + interval;
+			}
+		}
+		else if (entry->NextSlot - timeslot > interval)
+		{
+			/* the interval got shorter at the end of the error warning state */
+			entry->NextSlot = timeslot + interval;
+		}
+		else
+		{
+			/* not due yet */
+		}
+		
+		if (canContext->BusState == BUS_STATE_BUSOFF
+			|| (entry->Essential == 0 && (canContext->BusState == BUS_STATE_PASSIVE || canContext->BusState == BUS_STATE_RECOVERY)))
+		{
+			entry->Pending = 0;
+			continue;
+		}
+		if (entry->Pending != 0 && entry->IsOn != 0 && entry->IsOn() == 0)
+		{
+			/* switched off, does not take from the recovery budget */
+			entry->Pending = 0;
+		}
+		else if (entry->Pending != 0 && budget > 0)
+		{
+			canContext->TxCurrentEntry = i;
+			entry->SendFunction();
+			canContext->TxCurrentEntry = TX_ENTRY_NONE;
+			entry->Pending = 0;
+			budget--;
+		}
+		else
+		{
+			/* not due or beyond the recovery budget */
+		}
+	}
+#ifdef CAN_FD_ENABLE
+	FlushFdContainer();
+#endif
+}
+
+/**
+ * @brief Number of ISO-TP frames which may be sent in this millisecond.
+ * Segmented transfers are not essential: slowed down to one frame in error warning state, stopped beyond.
+ * @return frame budget for CAN_IsoTp_Process()
+ */
+static uint32_t GetIsoTpBudget(void)
+{
+	switch (canContext->BusState)
+	{
+		case BUS_STATE_ACTIVE:
+			return CAN_C_IsoTp_FramesPerMs;
+		
+		case BUS_STATE_WARNING:
+			return 1;
+		
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Number of XCP DAQ frames which may be sent in this millisecond.
+ * Measurement is stopped as soon as the bus leaves the error active state, command responses are still sent.
+ * @return frame budget for CAN_Xcp_Process()
+ */
+static uint32_t GetXcpBudget(void)
+{
+	if (canContext->BusState == BUS_STATE_ACTIVE)
+	{
+		return CAN_C_Xcp_FramesPerMs;
+	}
+	return 0;
+}
+
+/**
+ * @brief Tell if the multiplexed message 0x3F0 is switched on
+ * @return 1 if at least one page has an interval
+ */
+static uint8_t IsMuxDiagOn(void)
+{
+	return (uint8_t)((CAN_C_Mux_Page0_Interval | CAN_C_Mux_Page1_Interval | CAN_C_Mux_Page2_Interval | CAN_C_Mux_Page3_Interval
+		| CAN_C_Mux_Page4_Interval | CAN_C_Mux_Page5_Interval | CAN_C_Mux_Page6_Interval | CAN_C_Mux_Page7_Interval) != 0);
+}
+
+/**
+ * @brief Choose the page of the multiplexed message 0x3F0 for this slot.
+ * The most overdue page wins, on a tie the lower page number. Its countdown is reloaded with its interval,
+ * so pages whose intervals add up to more than the slot rate share the slots instead of starving each other.
+ * @return page number, MUX_PAGE_NONE if no page is due
+ */
+static uint8_t SelectMuxPage(void)
+{
+	const UInt32 interval_array[MUX_PAGES] =
+	{
+		CAN_C_Mux_Page0_Interval, CAN_C_Mux_Page1_Interval, CAN_C_Mux_Page2_Interval, CAN_C_Mux_Page3_Interval,
+		CAN_C_Mux_Page4_Interval, CAN_C_Mux_Page5_Interval, CAN_C_Mux_Page6_Interval, CAN_C_Mux_Page7_Interval
+	};
+	uint32_t elapsed = canContext->MsCounter - canContext->MuxLastMs;
+	uint8_t page = MUX_PAGE_NONE;
+	uint8_t i;
+	
+	canContext->MuxLastMs = canContext->MsCounter;
+	if (elapsed > MUX_INTERVAL_MAX)
+	{
+		elapsed = MUX_INTERVAL_MAX;
+	}
+	for (i = 0; i < MUX_PAGES; i++)
+	{
+		int32_t *countdown = &canContext->MuxCountdown[i];
+		int32_t interval = (int32_t)((interval_array[i] <= MUX_INTERVAL_MAX) ? interval_array[i] : MUX_INTERVAL_MAX);
+		
+		if (interval == 0)
+		{
+			*countdown = 0;
+			continue;
+		}
+		/* an overdue page is not owed more than one frame */
+		*countdown -= (int32_t)elapsed;
+		if (*countdown < -interval)
+		{
+			*countdown = -interval;
+		}
+		if (*countdown <= 0 && (page == MUX_PAGE_NONE || *countdown < canContext->MuxCountdown[page]))
+		{
+			page = i;
+		}
+	}
+	if (page != MUX_PAGE_NONE)
+	{
+		canContext->MuxCountdown[page] += (int32_t)((interval_array[page] <= MUX_INTERVAL_MAX) ? interval_array[page] : MUX_INTERVAL_MAX);
+	}
+	return page;
+}
+
+/**
+ * @brief Tell if the delta telemetry 0x3F1 is switched on.
+ * While it is off the telemetry is stopped, so that the first frame after switching on is a keyframe.
+ * @return 1 if CAN_C_Delta_Enable is set
+ */
+static uint8_t IsDeltaTelemetryOn(void)
+{
+	if (CAN_C_Delta_Enable == 0)
+	{
+		canContext->DeltaRunning = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Pass the signal set and the deadbands of the NV variables to the delta telemetry.
+ * Only a changed signal index restarts a slot, so this is cheap enough for every slot.
+ */
+static void ConfigureDeltaTelemetry(void)
+{
+	const UInt32 signals_array[CAN_DELTA_SLOTS / DELTA_SLOTS_PER_VARIABLE] =
+	{
+		CAN_C_Delta_Signals0, CAN_C_Delta_Signals1, CAN_C_Delta_Signals2, CAN_C_Delta_Signals3
+	};
+	const UInt32 deadband_array[CAN_DELTA_SLOTS / DELTA_SLOTS_PER_VARIABLE] =
+	{
+		CAN_C_Delta_Deadband0, CAN_C_Delta_Deadband1, CAN_C_Delta_Deadband2, CAN_C_Delta_Deadband3
+	};
+	uint8_t slot;
+	
+	for (slot = 0; slot < CAN_DELTA_SLOTS; slot++)
+	{
+		uint8_t shift = (uint8_t)(8u * (slot % DELTA_SLOTS_PER_VARIABLE));
+		
+		CAN_Delta_Configure(slot, (uint8_t)(signals_array[slot / DELTA_SLOTS_PER_VARIABLE] >> shift),
+			(uint8_t)(deadband_array[slot / DELTA_SLOTS_PER_VARIABLE] >> shift));
+	}
+}
+
+/* helper functions of the time synchronization */
+
+/**
+ * @brief Pass the NV variables to the time synchronization, run it and show its statistics
+ */
+static void ProcessTimeSync(void)
+{
+	CAN_TimeSync_Stats_TypeDef stats;
+	
+	CAN_TimeSync_Configure((CAN_TimeSync_Mode_TypeDef)((CAN_C_TimeSync_Mode <= CAN_TIMESYNC_SLAVE) ? CAN_C_TimeSync_Mode : CAN_TIMESYNC_OFF),
+		(uint8_t)CAN_C_TimeSync_Domain, CAN_C_TimeSync_Interval, CAN_C_TimeSync_Timeout);
+	CAN_TimeSync_Process();
+	
+	CAN_TimeSync_GetStats(&stats);
+	CAN_M_TimeSync_Status = CAN_TimeSync_GetStatus();
+	CAN_M_TimeSync_Offset = stats.Offset;
+	CAN_M_TimeSync_MaxOffset = stats.MaxOffset;
+	CAN_M_TimeSync_Drift = stats.Drift;
+	CAN_M_TimeSync_Count = stats.SyncCount;
+}
+
+/* helper function of the flight recorder */
+
+/**
+ * @brief Pass the NV variables to the flight recorder, trigger it on new error bits and by command
+ * and show its state and a window of the capture image. Bus-off and timeouts trigger it where they are detected.
+ */
+static void ProcessRecorder(void)
+{
+	UInt32 errorCode;
+	uint8_t window[RECORDER_WINDOW_SIZE];
+	uint32_t state;
+	
+	if (CAN_C_Recorder_Enable == 0)
+	{
+		/* switched off: drop the capture once, afterwards nothing but this check */
+		if (CAN_M_Recorder_State != CAN_RECORDER_OFF)
+		{
+			CAN_Recorder_Configure(0, 0, 0);
+			CAN_M_Recorder_State = CAN_RECORDER_OFF;
+			CAN_M_Recorder_Cause = CAN_RECORDER_CAUSE_NONE;
+			CAN_M_Recorder_Size = 0;
+			CAN_M_Recorder_Data0 = 0;
+			CAN_M_Recorder_Data1 = 0;
+			CAN_M_Recorder_Data2 = 0;
+			CAN_M_Recorder_Data3 = 0;
+		}
+		return;
+	}
+	
+	errorCode = canApi_Get_ERR_Errorcode() & CAN_C_Recorder_ErrorMask;
+	if (CAN_M_Recorder_State == CAN_RECORDER_OFF)
+	{
+		/* bits already set when the recorder is switched on do not trigger */
+		canContext->RecorderErrorLast = errorCode;
+	}
+	CAN_Recorder_Configure(1,
+		(uint8_t)((CAN_C_Recorder_PostShare < CAN_RECORDER_POST_MAX) ? CAN_C_Recorder_PostShare : CAN_RECORDER_POST_MAX),
+		CAN_C_Recorder_PostTime);
+	
+	/* bits which stay set do not trigger again */
+	if ((CAN_C_Recorder_Triggers & RECORDER_TRIGGER_ERROR) != 0 && (errorCode & ~canContext->RecorderErrorLast) != 0)
+	{
+		CAN_Recorder_Trigger(CAN_RECORDER_CAUSE_ERROR);
+	}
+	canContext->RecorderErrorLast = errorCode;
+	
+	if (CAN_C_Recorder_Command != canContext->RecorderCommandLast)
+	{
+		if (CAN_C_Recorder_Command == RECORDER_COMMAND_TRIGGER)
+		{
+			CAN_Recorder_Trigger(CAN_RECORDER_CAUSE_MANUAL);
+		}
+		else if (CAN_C_Recorder_Command == RECORDER_COMMAND_REARM)
+		{
+			CAN_Recorder_Rearm();
+		}
+		else
+		{
+			/* no command */
+		}
+	}
+	canContext->RecorderCommandLast = CAN_C_Recorder_Command;
+	CAN_Recorder_Process();
+	
+	state = CAN_Recorder_GetState();
+	CAN_M_Recorder_State = state & 0xFFu;
+	CAN_M_Recorder_Cause = (state >> 8) & 0xFFu;
+	CAN_M_Recorder_Size = CAN_Recorder_GetSize();
+	memset(window, 0, sizeof(window));
+	(void)CAN_Recorder_Read(CAN_C_Recorder_ReadOffset, window, RECORDER_WINDOW_SIZE);
+	CAN_M_Recorder_Data0 = ((UInt32)window[0] << 24) | ((UInt32)window[1] << 16) | ((UInt32)window[2] << 8) | window[3];
+	CAN_M_Recorder_Data1 = ((UInt32)window[4] << 24) | ((UInt32)window[5] << 16) | ((UInt32)window[6] << 8) | window[7];
+	CAN_M_Recorder_Data2 = ((UInt32)window[8] << 24) | ((UInt32)window[9] << 16) | ((UInt32)window[10] << 8) | window[11];
+	CAN_M_Recorder_Data3 = ((UInt32)window[12] << 24) | ((UInt32)window[13] << 16) | ((UInt32)window[14] << 8) | window[15];
+}
+
+/* helper functions of the window statistics */
+
+/**
+ * @brief Sample the signals of aggregate_array into their windows while CAN_C_Aggregate_Enable is set, O(1) per signal
+ */
+static void ProcessAggregation(void)
+{
+	uint8_t i;
+	
+	if (CAN_C_Aggregate_Enable == 0)
+	{
+		return;
+	}
+	for (i = 0; i < AGGREGATE_SIGNALS; i++)
+	{
+		aggregate_TypeDef *aggregate = &canContext->Aggregate[i];
+		Float32 value = aggregate_array[i]();
+		Float32 delta;
+		
+		if (aggregate->Count == 0u)
+		{
+			aggregate->Reference = value;
+			aggregate->Min = value;
+			aggregate->Max = value;
+			aggregate->Sum = 0.0f;
+			aggregate->SumSquares = 0.0f;
+		}
+		else if (value < aggregate->Min)
+		{
+			aggregate->Min = value;
+		}
+		else if (value > aggregate->Max)
+		{
+			aggregate->Max = value;
+		}
+		else
+		{
+			/* inside the range of the window */
+		}
+		delta = value - aggregate->Reference;
+		aggregate->Sum += delta;
+		aggregate->SumSquares += delta * delta;
+		aggregate->Count++;
+	}
+}
+
+/**
+ * @brief Get a statistic of the window of a signal and start the next window. Called by the send function of its message.
+ * @param signal: signal of aggregate_array
+ * @param statistic: AGGREGATE_SAMPLE...AGGREGATE_RMS, other values, an empty window and CAN_C_Aggregate_Enable = 0 give the current value
+ * @return statistic in the unit of the signal
+ */
+static Float32 AggregateWindow(aggregateSignal_TypeDef signal, UInt32 statistic)
+{
+	aggregate_TypeDef *aggregate = &canContext->Aggregate[signal];
+	Float32 result = aggregate_array[signal]();
+	
+	/* a window left over from before the statistics were switched off is dropped */
+	if (aggregate->Count != 0u && CAN_C_Aggregate_Enable != 0)
+	{
+		Float32 meanDelta = aggregate->Sum / (Float32)aggregate->Count;
+		Float32 variance = aggregate->SumSquares / (Float32)aggregate->Count - meanDelta * meanDelta;
+		Float32 mean = aggregate->Reference + meanDelta;
+		
+		switch (statistic)
+		{
+			case AGGREGATE_MIN:
+				result = aggregate->Min;
+				break;
+			
+			case AGGREGATE_MAX:
+				result = aggregate->Max;
+				break;
+			
+			case AGGREGATE_MEAN:
+				result = mean;
+				break;
+			
+			case AGGREGATE_RMS:
+				/* mean square = square of the mean + variance, the variance is rounded up to 0 */
+				result = sqrtf(mean * mean + ((variance > 0.0f) ? variance : 0.0f));
+				break;
+			
+			default:
+				break;
+		}
+	}
+	aggregate->Count = 0;
+	return result;
+}
+
+/* helper functions of the J1939 controller application */
+
+/**
+ * @brief Run the J1939 controller application while CAN_C_J1939_Enable is set.
+ * The address is claimed with the NAME of the NV variables. DM1 is sent every J1939_DM1_INTERVAL_MS
+ * and on request, a requested software identification is sent with BAM or RTS/CTS, other requests
+ * to the own address get a negative acknowledgement. Only one of the larger messages is in transport at a time.
+ */
+static void ProcessJ1939(void)
+{
+	CAN_J1939_Config_TypeDef config;
+	CAN_J1939_State_TypeDef state;
+	uint8_t address;
+	
+	if (CAN_C_J1939_Enable == 0)
+	{
+		CAN_J1939_Close();
+		CAN_M_J1939_Address = CAN_J1939_ADDRESS_NULL;
+		return;
+	}
+	if (CAN_J1939_GetAddressState(0) == CAN_J1939_IDLE)
+	{
+		config.Name = ((uint64_t)CAN_C_J1939_Name_High << 32) | ((uint64_t)(CAN_C_J1939_Manufacturer & 0x7FFu) << 21)
+			| (canApi_Get_PROD_C_HW_Prod_Info_1() & 0x1FFFFFu);
+		config.PreferredAddress = (uint8_t)((CAN_C_J1939_Address < CAN_J1939_ADDRESS_NULL) ? CAN_C_J1939_Address : 0u);
+		config.PgnTable = j1939Pgn_array;
+		config.PgnCount = J1939_PGNS_AVAILABLE;
+		(void)CAN_J1939_Open(&config);
+	}
+	
+	/* the transport protocol shares the frame budget of the segmented transfers */
+	CAN_J1939_Process(GetIsoTpBudget());
+	state = CAN_J1939_GetAddressState(&address);
+	CAN_M_J1939_Address = address;
+	if (state != CAN_J1939_DONE)
+	{
+		return;
+	}
+	
+	if (canContext->MsCounter % J1939_DM1_INTERVAL_MS == 0u)
+	{
+		canContext->J1939Dm1Requested = 1;
+	}
+	if (canContext->J1939NackRequest != J1939_NO_REQUEST)
+	{
+		uint8_t data[8];
+		
+		data[0] = 1; /* negative acknowledgement */
+		data[1] = 0xFF;
+		data[2] = 0xFF;
+		data[3] = 0xFF;
+		data[4] = (uint8_t)canContext->J1939NackRequest;
+		data[5] = (uint8_t)canContext->J1939NackPgn;
+		data[6] = (uint8_t)(canContext->J1939NackPgn >> 8);
+		data[7] = (uint8_t)(canContext->J1939NackPgn >> 16);
+		if (CAN_J1939_Send(CAN_J1939_PGN_ACKNOWLEDGEMENT, J1939_PRIORITY_DIAGNOSTIC, CAN_J1939_ADDRESS_GLOBAL, data, 8) == CAN_OK)
+		{
+			canContext->J1939NackRequest = J1939_NO_REQUEST;
+		}
+	}
+	
+	/* the payload buffers are read until the running transport ends */
+	if (CAN_J1939_GetTxState() == CAN_J1939_BUSY)
+	{
+		return;
+	}
+	if (canContext->J1939Dm1Requested != 0)
+	{
+		SendJ1939Dm1();
+	}
+	else if (canContext->J1939SoftwareIdRequest != J1939_NO_REQUEST)
+	{
+		SendJ1939SoftwareId((uint8_t)canContext->J1939SoftwareIdRequest);
+	}
+	else
+	{
+		/* do nothing */
+	}
+}
+
+/**
+ * @brief Send DM1 with one proprietary SPN per active bit of canApi_Get_ERR_Errorcode(), numbered like message 0x209.
+ * Without an active error the DTC is all zero. More than one DTC is sent with BAM.
+ */
+static void SendJ1939Dm1(void)
+{
+	uint32_t errorCode = canApi_Get_ERR_Errorcode();
+	uint32_t length = 2;
+	uint8_t *data = canContext->J1939Dm1;
+	uint8_t bit;
+	
+	data[0] = (errorCode != 0u) ? J1939_LAMP_AMBER : 0x00u;
+	data[1] = 0xFF;
+	for (bit = 0; bit < J1939_DTC_COUNT; bit++)
+	{
+		uint32_t spn = J1939_SPN_BASE + bit + 1u;
+		
+		if (((errorCode >> bit) & 1u) == 0u)
+		{
+			continue;
+		}
+		data[length] = (uint8_t)spn;
+		data[length + 1u] = (uint8_t)(spn >> 8);
+		data[length + 2u] = (uint8_t)((((spn >> 16) & 0x07u) << 5) | J1939_FMI_CONDITION_EXISTS);
+		data[length + 3u] = 0x7F; /* occurrence count not available */
+		length += 4u;
+	}
+	if (length == 2u)
+	{
+		memset(&data[2], 0, 4);
+		length = 6;
+	}
+	/* a single frame is padded to 8 bytes */
+	while (length < 8u)
+	{
+		data[length] = 0xFF;
+		length++;
+	}
+	if (CAN_J1939_Send(J1939_PGN_DM1, J1939_PRIORITY_DIAGNOSTIC, CAN_J1939_ADDRESS_GLOBAL, data, length) == CAN_OK)
+	{
+		canContext->J1939Dm1Requested = 0;
+	}
+}
+
+/**
+ * @brief Send the software identification, with RTS/CTS to a requester or with BAM to the global address
+ * @param destination: requester or CAN_J1939_ADDRESS_GLOBAL
+ */
+static void SendJ1939SoftwareId(uint8_t destination)
+{
+	static const char hex_array[] = "0123456789ABCDEF";
+	uint32_t version = canApi_Get_PROD_M_BSW_Ver_Release();
+	uint8_t *data = canContext->J1939SoftwareId;
+	uint8_t i;
+	
+	data[0] = 1; /* number of fields */
+	for (i = 0; i < 8u; i++)
+	{
+		data[1u + i] = (uint8_t)hex_array[(version >> (28u - 4u * i)) & 0x0Fu];
+	}
+	data[9] = '.';
+	version = canApi_Get_PROD_M_BSW_Ver_Revision();
+	for (i = 0; i < 8u; i++)
+	{
+		data[10u + i] = (uint8_t)hex_array[(version >> (28u - 4u * i)) & 0x0Fu];
+	}
+	data[18] = '*';
+	if (CAN_J1939_Send(J1939_PGN_SOFTWARE_ID, J1939_PRIORITY_DIAGNOSTIC, destination, data, sizeof(canContext->J1939SoftwareId)) == CAN_OK)
+	{
+		canContext->J1939SoftwareIdRequest = J1939_NO_REQUEST;
+	}
+}
+
+/* helper functions to send messages and measure their transmit queueing latency */
+
+/**
+ * @brief Put a message into the transmit buffer and stamp the enqueue time for the latency side table.
+ * If an older instance of the same message is still queued, its timestamp is kept because
+ * the transmit complete of the older instance comes first.
+ * In CAN FD builds the messages of fdContained_array are packed into the container frame instead,
+ * they have no transmit complete of their own and are not part of the latency statistics.
+ * @param message: message to send
+ * @return Status of the transmit buffer system
+ */
+static canApi_StatusTypeDef SendMessage(const canApi_MessageTypedef *message)
+{
+	canApi_StatusTypeDef status;
+	txLatency_TypeDef *latency = 0;
+	
+#ifdef CAN_FD_ENABLE
+	if (canContext->TxCurrentEntry != TX_ENTRY_NONE && CAN_C_Fd_Mode != 0 && IsFdContained(message) != 0)
+	{
+		return AddToFdContainer(message);
+	}
+#endif
+	if (canContext->TxCurrentEntry != TX_ENTRY_NONE)
+	{
+		latency = &canContext->TxLatency[canContext->TxCurrentEntry];
+		if (latency->InFlight == 0)
+		{
+			latency->Identifier = message->Identifier;
+			latency->IDE = message->IDE;
+			latency->EnqueueTimestamp = CAN_GetTimestampUs();
+			latency->InFlight = 1;
+		}
+		else
+		{
+			latency = 0;
+		}
+	}
+	
+	status = canApi_SendMessage(message);
+	
+	if (status == CAN_OK)
+	{
+		canContext->TxAcceptedCount++;
+	}
+	else
+	{
+		CAN_M_TxBuffer_Overflow++;
+		CAN_M_TxBuffer_LastDropId = message->Identifier;
+		if (latency != 0)
+		{
+			latency->InFlight = 0;
+		}
+	}
+	return status;
+}
+
+/**
+ * @brief Get a percentile of the transmit queueing latency from its histogram
+ * @param latency: latency entry
+ * @param percent: requested percentile, 0...100
+ * @return upper bound of the histogram bin containing the percentile [us]
+ */
+static uint32_t TxLatencyPercentile(const txLatency_TypeDef *latency, uint8_t percent)
+{
+	uint32_t total = 0;
+	uint32_t sum = 0;
+	uint8_t i;
+	
+	for (i = 0; i < TX_LATENCY_BINS; i++)
+	{
+		total += latency->Histogram[i];
+	}
+	if (total == 0)
+	{
+		return 0;
+	}
+	for (i = 0; i < TX_LATENCY_BINS - 1u; i++)
+	{
+		sum += latency->Histogram[i];
+		if (sum * 100u >= total * percent)
+		{
+			return (i + 1u) * TX_LATENCY_BIN_US;
+		}
+	}
+	/* percentile lies in the overflow bin, report the maximum */
+	return latency->Max;
+}
+
+/**
+ * @brief Copy the statistics of message CAN_C_TxLatency_Identifier to the EnableTool variables
+ */
+static void UpdateTxLatencyDisplay(void)
+{
+	uint8_t i;
+	
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		const txLatency_TypeDef *latency = &canContext->TxLatency[i];
+		
+		if (latency->Count > 0 && latency->Identifier == CAN_C_TxLatency_Identifier)
+		{
+			CAN_M_TxLatency_Count = latency->Count;
+			CAN_M_TxLatency_Min = latency->Min;
+			CAN_M_TxLatency_Max = latency->Max;
+			CAN_M_TxLatency_P99 = TxLatencyPercentile(latency, 99);
+			return;
+		}
+	}
+	CAN_M_TxLatency_Count = 0;
+	CAN_M_TxLatency_Min = 0;
+	CAN_M_TxLatency_Max = 0;
+	CAN_M_TxLatency_P99 = 0;
+}
+
+#ifdef CAN_FD_ENABLE
+/* helper functions for FD container frames */
+
+/**
+ * @brief Check if a message is sent in the container frame
+ * @param message: message to send
+ * @return 1 if the message is listed in fdContained_array, else 0
+ */
+static uint8_t IsFdContained(const canApi_MessageTypedef *message)
+{
+	uint8_t i;
+	
+	if (message->IDE != 0)
+	{
+		return 0;
+	}
+	for (i = 0; i < FD_CONTAINED_AVAILABLE; i++)
+	{
+		if (fdContained_array[i] == message->Identifier)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Append a message to the container frame, a full container is sent first
+ * @param message: message to send
+ * @return CAN_OK, or the status of the rejected message
+ */
+static canApi_StatusTypeDef AddToFdContainer(const canApi_MessageTypedef *message)
+{
+	canApi_StatusTypeDef status = CAN_Fd_ContainerAdd(&canContext->FdContainer, message);
+	
+	if (status == CAN_BUFFER_FULL)
+	{
+		FlushFdContainer();
+		status = CAN_Fd_ContainerAdd(&canContext->FdContainer, message);
+	}
+	if (status != CAN_OK)
+	{
+		CAN_M_TxBuffer_Overflow++;
+		CAN_M_TxBuffer_LastDropId = message->Identifier;
+	}
+	return status;
+}
+
+/**
+ * @brief Send the container frame if it holds any message and start a new one
+ */
+static void FlushFdContainer(void)
+{
+	CAN_Fd_Container_TypeDef *container = &canContext->FdContainer;
+	
+	if (container->Count > 0)
+	{
+		CAN_Fd_ContainerClose(container);
+		if (CAN_Fd_SendMessage(&container->Message) != CAN_OK)
+		{
+			/* all contained messages are lost, the container identifier tells so */
+			CAN_M_TxBuffer_Overflow += container->Count;
+			CAN_M_TxBuffer_LastDropId = container->Message.Identifier;
+		}
+	}
+	CAN_Fd_ContainerInit(container, CAN_FD_CONTAINER_ID, 0, (CAN_C_Fd_Mode == 2) ? 1 : 0);
+}
+#endif
+
+/* helper functions to track the reception time of messages */
+
+/**
+ * @brief Get the reception time of a message taken from the receive buffer.
+ * The timestamp ring runs parallel to the receive buffer. Entries in front of the matching one
+ * belong to messages which were dropped by the receive buffer and are discarded. Without a
+ * matching entry (receive hook not called by the basic software) the current time is used.
+ * @param message: message taken from the receive buffer
+ * @return reception time [us]
+ */
+static uint32_t GetRxTimestamp(const canApi_MessageTypedef *message)
+{
+	uint8_t tail = canContext->RxTimestampTail;
+	uint8_t head = canContext->RxTimestampHead;
+	
+	while (tail != head)
+	{
+		const rxTimestamp_TypeDef *entry = &canContext->RxTimestampRing[tail];
+		
+		tail = (uint8_t)((tail + 1u) & (RX_TIMESTAMP_RING_SIZE - 1u));
+		if (entry->Identifier == message->Identifier && entry->IDE == message->IDE)
+		{
+			uint32_t timestamp = entry->Timestamp;
+			uint8_t skip = canContext->RxTimestampTail;
+			
+			/* every skipped entry is a message the receive buffer has lost */
+			while (skip != (uint8_t)((tail - 1u) & (RX_TIMESTAMP_RING_SIZE - 1u)))
+			{
+				CAN_M_RxBuffer_Overflow++;
+				CAN_M_RxBuffer_LastDropId = canContext->RxTimestampRing[skip].Identifier;
+				skip = (uint8_t)((skip + 1u) & (RX_TIMESTAMP_RING_SIZE - 1u));
+			}
+			canContext->RxTimestampTail = tail;
+			return timestamp;
+		}
+	}
+	return CAN_GetTimestampUs();
+}
+
+/**
+ * @brief Update the receive timing of a managed message
+ * @param index: index in msgManagment_array
+ * @param timestamp: reception time [us]
+ */
+static void UpdateRxTiming(uint8_t index, uint32_t timestamp)
+{
+	CAN_RxTiming_TypeDef *timing = &canContext->RxTiming[index];
+	
+	if (timing->Count > 0)
+	{
+		timing->InterArrival = timestamp - timing->Timestamp;
+		if (timing->Count == 1 || timing->InterArrival < timing->InterArrivalMin)
+		{
+			timing->InterArrivalMin = timing->InterArrival;
+		}
+		if (timing->InterArrival > timing->InterArrivalMax)
+		{
+			timing->InterArrivalMax = timing->InterArrival;
+		}
+	}
+	timing->Timestamp = timestamp;
+	timing->Count++;
+}
+
+/**
+ * @brief Find the receive timing of a managed message
+ * @return pointer to the timing or 0 if the message is not managed or never received
+ */
+static const CAN_RxTiming_TypeDef* FindRxTiming(uint32_t identifier, uint8_t ide)
+{
+	uint8_t i;
+	
+	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	{
+		if (canContext->MsgManagement[i].CanIdentifier == identifier && canContext->MsgManagement[i].IDE == ide)
+		{
+			return (canContext->RxTiming[i].Count > 0) ? &canContext->RxTiming[i] : 0;
+		}
+	}
+	return 0;
+}
+
+/* helper function for messages decoded in the receive interrupt */
+
+/**
+ * @brief Check if a message taken from the receive buffer was already decoded in the receive interrupt
+ * @param index: index in msgManagment_array
+ * @return 1 if the polled path must skip the receive callback, else 0
+ */
+static uint8_t IsDecodedInInterrupt(uint8_t index)
+{
+	uint8_t i;
+	
+	for (i = 0; i < canContext->FastPathCount; i++)
+	{
+		fastPath_TypeDef *fastPath = &canContext->FastPath[i];
+		
+		if (fastPath->Index == index)
+		{
+			uint32_t isrCount = fastPath->IsrCount;
+			
+			if (fastPath->Active != 0 && isrCount != fastPath->PollCount)
+			{
+				fastPath->PollCount++;
+				return 1;
+			}
+			/* fallen back to the polled path or interrupt hook not called */
+			fastPath->PollCount = isrCount;
+			return 0;
+		}
+	}
+	return 0;
+}
+
+/* helper functions for the software receive queues */
+
+/**
+ * @brief Move all messages from the canApi receive buffer into the software receive queue of their class.
+ * The canApi receive buffer is emptied in every 1ms callback, so a burst of bulk messages overflows
+ * the bulk queue instead of displacing control messages in the shared buffer.
+ */
+static void DrainReceiveBuffer(void)
+{
+	canApi_MessageTypedef message;
+	uint32_t fill = 0;
+#ifdef CAN_FD_ENABLE
+	CAN_Fd_MessageTypedef fdMessage;
+#endif
+	
+	while(canApi_ReceiveMessage(&message) == CAN_OK)
+	{
+		/* consume the timestamp of every message, unmanaged ones would otherwise count as lost */
+		SortReceivedMessage(&message, GetRxTimestamp(&message));
+		fill++;
+	}
+	
+#ifdef CAN_FD_ENABLE
+	/* FD frames bypass the receive interrupt hook, containers are unpacked into their classic messages */
+	while (CAN_Fd_ReceiveMessage(&fdMessage) == CAN_OK)
+	{
+		uint32_t timestamp = CAN_GetTimestampUs();
+		uint8_t offset = 0;
+		
+		fill++;
+		if (fdMessage.FDF == 0 || fdMessage.DLC <= 8u)
+		{
+			message.Identifier = fdMessage.Identifier;
+			message.Priority = fdMessage.Priority;
+			message.IDE = fdMessage.IDE;
+			message.RTR = 0;
+			message.DLC = CAN_Fd_DlcToLength(fdMessage.DLC);
+			memcpy(message.Data, fdMessage.Data, message.DLC);
+			SortReceivedMessage(&message, timestamp);
+			continue;
+		}
+		while (CAN_Fd_ContainerNext(&fdMessage, &offset, &message) != 0)
+		{
+			SortReceivedMessage(&message, timestamp);
+		}
+	}
+#endif
+	
+	CAN_M_RxBuffer_Fill = fill;
+	if (fill > CAN_M_RxBuffer_HighWater)
+	{
+		CAN_M_RxBuffer_HighWater = fill;
+	}
+}
+
+/**
+ * @brief Put a received message into the software receive queue of its class
+ * @param message: received message
+ * @param timestamp: reception time [us]
+ */
+static void SortReceivedMessage(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	msgManagement_TypeDef* msgManagement;
+	rxQueueEntry_TypeDef entry;
+	
+	/* J1939 messages are dispatched by PGN, the address fields of their identifiers vary */
+	if (message->IDE != 0 && CAN_C_J1939_Enable != 0 && CAN_J1939_Receive(message) != 0)
+	{
+		return;
+	}
+	
+	/* check if we have a callback for the received message */
+	msgManagement = GetMessageManagement(message);
+	if (msgManagement != 0)
+	{
+		entry.Index = (uint8_t)(msgManagement - canContext->MsgManagement);
+		entry.Message = *message;
+		
+		/* record reception time and inter-arrival time */
+		UpdateRxTiming(entry.Index, timestamp);
+		
+		if (msgManagement->ReceiveFunction == 0 || IsDecodedInInterrupt(entry.Index) != 0)
+		{
+			/* nothing left to decode, reset timeout counter to reload value */
+			msgManagement->TimeoutCounter = msgManagement->TimeoutReloadValue;
+		}
+		else
+		{
+			rxQueue_TypeDef *queue = &canContext->RxQueue[msgManagement->Class];
+			
+			if (queue->Count < queue->Depth)
+			{
+				queue->Entries[(uint8_t)((queue->Head + queue->Count) % queue->Depth)] = entry;
+				queue->Count++;
+			}
+			else
+			{
+				CountRxQueueOverflow(msgManagement->Class);
+			}
+		}
+	}
+	else if (CAN_TimeSync_Receive(message, timestamp) == 0)
+	{
+		/* XCP commands and segmented transfers are handled right away, answered in the same millisecond */
+		if (CAN_C_Xcp_Enable == 0 || CAN_Xcp_Receive(message) == 0)
+		{
+			(void)CAN_IsoTp_Receive(message);
+		}
+	}
+	else
+	{
+		/* SYNC and FUP are evaluated with the receive timestamp */
+	}
+}
+
+/**
+ * @brief Decode messages from the software receive queue of one class, oldest first
+ * @param rxClass: priority class of the queue
+ * @param budget: maximum number of messages to decode, the rest is left for the next 1ms callback
+ */
+static void DecodeReceiveQueue(rxClass_TypeDef rxClass, uint32_t budget)
+{
+	rxQueue_TypeDef *queue = &canContext->RxQueue[rxClass];
+	
+	while (queue->Count > 0 && budget > 0)
+	{
+		const rxQueueEntry_TypeDef *entry = &queue->Entries[queue->Head];
+		msgManagement_TypeDef* msgManagement = &canContext->MsgManagement[entry->Index];
+		
+		/* reset timeout counter to reload value */
+		msgManagement->TimeoutCounter = msgManagement->TimeoutReloadValue;
+		msgManagement->ReceiveFunction(&entry->Message);
+		
+		queue->Head = (uint8_t)((queue->Head + 1u) % queue->Depth);
+		queue->Count--;
+		budget--;
+	}
+}
+
+/**
+ * @brief Count a message dropped by a full software receive queue
+ * @param rxClass: priority class of the queue
+ */
+static void CountRxQueueOverflow(rxClass_TypeDef rxClass)
+{
+	switch (rxClass)
+	{
+		case RX_CLASS_CONTROL:
+			CAN_M_RxQueue_ControlOverflow++;
+			break;
+		
+		case RX_CLASS_NORMAL:
+			CAN_M_RxQueue_NormalOverflow++;
+			break;
+		
+		default:
+			CAN_M_RxQueue_BulkOverflow++;
+			break;
+	}
+}
+
+/* helper functions for the buffer diagnostics */
+
+/**
+ * @brief Clear the canApi transmit buffer and restart the fill estimation
+ *
+ * The flushed messages never complete, their latency measurements are dropped
+ * so that the next transmit complete is not matched to a stale enqueue time.
+ */
+static void ClearTransmitBuffer(void)
+{
+	uint8_t i;
+	
+	canApi_ClearTransmitBuffer();
+	canContext->TxAcceptedCount = canContext->TxCompletedCount;
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		canContext->TxLatency[i].InFlight = 0;
+		canContext->TxLatency[i].EnqueueTimestamp = 0;
+	}
+}
+
+/**
+ * @brief Update the transmit buffer fill and handle the reset command CAN_C_BufferDiag_Reset
+ */
+static void UpdateBufferDiagnostics(void)
+{
+	if (CAN_C_BufferDiag_Reset != 0 && canContext->BufferDiagResetLast == 0)
+	{
+		CAN_ResetBufferDiagnostics();
+	}
+	canContext->BufferDiagResetLast = CAN_C_BufferDiag_Reset;
+	
+	if (canContext->TxCompleteSeen != 0)
+	{
+		uint32_t fill = canContext->TxAcceptedCount - canContext->TxCompletedCount;
+		
+		/* the transmit complete interrupt may come before txAcceptedCount is incremented */
+		if ((int32_t)fill < 0)
+		{
+			fill = 0;
+		}
+		CAN_M_TxBuffer_Fill = fill;
+		if (fill > CAN_M_TxBuffer_HighWater)
+		{
+			CAN_M_TxBuffer_HighWater = fill;
+		}
+	}
+}
+
+/* helper function for the module context */
+
+/**
+ * @brief Set a context to the power-up state of the module
+ * @param context: context to initialize
  */
-static msgManagement_TypeDef* GetMessageManagement(const canApi_MessageTypedef *message)
+static void InitContext(CAN_Context_TypeDef *context)
 {
 	uint8_t i;
-	msgManagement_TypeDef* retval = (msgManagement_TypeDef*)0;
 	
+	memset(context, 0, sizeof(*context));
 	for (i = 0; i < COMMANDS_AVAILABLE; i++)
 	{
-			if (msgManagment_array[i].CanIdentifier == message->Identifier
-				&& msgManagment_array[i].IDE == message->IDE)
-			{
-					retval = &msgManagment_array[i];
-			}
+		context->MsgManagement[i] = msgManagment_array[i];
 	}
-	return retval;
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		context->TxSchedule[i] = txSchedule_array[i];
+	}
+	context->BusState = BUS_STATE_ACTIVE;
+	context->TxCurrentEntry = TX_ENTRY_NONE;
+	context->RxQueue[RX_CLASS_CONTROL].Entries = context->RxQueueControl;
+	context->RxQueue[RX_CLASS_CONTROL].Depth = RX_QUEUE_DEPTH_CONTROL;
+	context->RxQueue[RX_CLASS_NORMAL].Entries = context->RxQueueNormal;
+	context->RxQueue[RX_CLASS_NORMAL].Depth = RX_QUEUE_DEPTH_NORMAL;
+	context->RxQueue[RX_CLASS_BULK].Entries = context->RxQueueBulk;
+	context->RxQueue[RX_CLASS_BULK].Depth = RX_QUEUE_DEPTH_BULK;
+	context->Initialized = 1;
+	
+	CAN_IsoTp_Init();
+	CAN_Uds_Init();
+	CAN_Xcp_Init();
+	CAN_Delta_Init();
+	CAN_J1939_Init();
+	CAN_TimeSync_Init();
+	CAN_Recorder_Init();
+	context->J1939SoftwareIdRequest = J1939_NO_REQUEST;
+	context->J1939NackRequest = J1939_NO_REQUEST;
+#ifdef CAN_FD_ENABLE
+	CAN_Fd_ContainerInit(&context->FdContainer, CAN_FD_CONTAINER_ID, 0, 0);
+#endif
 }
 
+#ifdef CAN_MULTI_INSTANCE
 /**
- * @brief Decrement all message timeout counter values.
- * If a counter reaches 0, the message timout callback function is called
+ * @brief Save or restore the power-up values of the EnableTool variables of the calling thread.
+ * The list follows the declarations at the top of this file, a new EnableTool variable is added here too.
+ * @param restore: 0 to save the current values, 1 to write the saved values back
  */
-static void HandleMessageTimeouts(void)
+static void CopyInterfaces(uint8_t restore)
 {
+	volatile UInt32 * const interface_array[] =
+	{
+		&CAN_C_Switch_KilometerToMiles,
+		&CAN_C_SwitchDataInfo_ID_207,
+		&CAN_C_SwitchDataInfo_ID_306,
+		&CAN_C_BusWarning_Slowdown,
+		&CAN_C_BusRecovery_RampStep,
+		&CAN_C_TxLatency_Identifier,
+		&CAN_C_FastPath_Budget,
+		&CAN_C_FastPath_MaxOverruns,
+		&CAN_C_RxQueue_BulkBudget,
+		&CAN_C_IsoTp_FramesPerMs,
+		&CAN_C_Xcp_Enable,
+		&CAN_C_Xcp_FramesPerMs,
+		&CAN_C_Uds_Enable,
+		&CAN_C_ProdData_Broadcast,
+		&CAN_C_J1939_Enable,
+		&CAN_C_J1939_Address,
+		&CAN_C_J1939_Name_High,
+		&CAN_C_J1939_Manufacturer,
+		&CAN_C_TimeSync_Mode,
+		&CAN_C_TimeSync_Domain,
+		&CAN_C_TimeSync_Interval,
+		&CAN_C_TimeSync_Timeout,
+		&CAN_C_Recorder_Enable,
+		&CAN_C_Recorder_Triggers,
+		&CAN_C_Recorder_ErrorMask,
+		&CAN_C_Recorder_TimeoutId,
+		&CAN_C_Recorder_PostShare,
+		&CAN_C_Recorder_PostTime,
+		&CAN_C_Recorder_Command,
+		&CAN_C_Recorder_ReadOffset,
+		&CAN_C_Aggregate_Enable,
+		&CAN_C_Aggregate_Temperature,
+		&CAN_C_Aggregate_SOC,
+		&CAN_C_Fd_Mode,
+		&CAN_C_Mux_Page0_Signals,
+		&CAN_C_Mux_Page0_Interval,
+		&CAN_C_Mux_Page1_Signals,
+		&CAN_C_Mux_Page1_Interval,
+		&CAN_C_Mux_Page2_Signals,
+		&CAN_C_Mux_Page2_Interval,
+		&CAN_C_Mux_Page3_Signals,
+		&CAN_C_Mux_Page3_Interval,
+		&CAN_C_Mux_Page4_Signals,
+		&CAN_C_Mux_Page4_Interval,
+		&CAN_C_Mux_Page5_Signals,
+		&CAN_C_Mux_Page5_Interval,
+		&CAN_C_Mux_Page6_Signals,
+		&CAN_C_Mux_Page6_Interval,
+		&CAN_C_Mux_Page7_Signals,
+		&CAN_C_Mux_Page7_Interval,
+		&CAN_C_Delta_Enable,
+		&CAN_C_Delta_KeyframeInterval,
+		&CAN_C_Delta_FramesPerSlot,
+		&CAN_C_Delta_Signals0,
+		&CAN_C_Delta_Deadband0,
+		&CAN_C_Delta_Signals1,
+		&CAN_C_Delta_Deadband1,
+		&CAN_C_Delta_Signals2,
+		&CAN_C_Delta_Deadband2,
+		&CAN_C_Delta_Signals3,
+		&CAN_C_Delta_Deadband3,
+		&CAN_C_BufferDiag_Reset,
+		&CAN_M_ReceivedTestData,
+		&CAN_M_BusState,
+		&CAN_M_BusState_WarningCount,
+		&CAN_M_BusState_PassiveCount,
+		&CAN_M_BusState_BusOffCount,
+		&CAN_M_BusState_WarningTime,
+		&CAN_M_BusState_PassiveTime,
+		&CAN_M_BusState_BusOffTime,
+		&CAN_M_BusState_RecoveryTime,
+		&CAN_M_TxLatency_Count,
+		&CAN_M_TxLatency_Min,
+		&CAN_M_TxLatency_Max,
+		&CAN_M_TxLatency_P99,
+		&CAN_M_FastPath_Count,
+		&CAN_M_FastPath_Overruns,
+		&CAN_M_FastPath_MaxTime,
+		&CAN_M_RxQueue_ControlOverflow,
+		&CAN_M_RxQueue_NormalOverflow,
+		&CAN_M_RxQueue_BulkOverflow,
+		&CAN_M_TxBuffer_Fill,
+		&CAN_M_TxBuffer_HighWater,
+		&CAN_M_TxBuffer_Overflow,
+		&CAN_M_TxBuffer_LastDropId,
+		&CAN_M_RxBuffer_Fill,
+		&CAN_M_RxBuffer_HighWater,
+		&CAN_M_RxBuffer_Overflow,
+		&CAN_M_RxBuffer_LastDropId,
+		&CAN_M_Xcp_DaqOverload,
+		&CAN_M_J1939_Address,
+		&CAN_M_TimeSync_Status,
+		(volatile UInt32*)&CAN_M_TimeSync_Offset,
+		&CAN_M_TimeSync_MaxOffset,
+		(volatile UInt32*)&CAN_M_TimeSync_Drift,
+		&CAN_M_TimeSync_Count,
+		&CAN_M_Recorder_State,
+		&CAN_M_Recorder_Cause,
+		&CAN_M_Recorder_Size,
+		&CAN_M_Recorder_Data0,
+		&CAN_M_Recorder_Data1,
+		&CAN_M_Recorder_Data2,
+		&CAN_M_Recorder_Data3
+	};
 	uint8_t i;
 	
-	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	_Static_assert(sizeof(interface_array) / sizeof(interface_array[0]) == INTERFACES_AVAILABLE, "INTERFACES_AVAILABLE");
+	for (i = 0; i < INTERFACES_AVAILABLE; i++)
 	{
-		if (msgManagment_array[i].TimeoutCounter > 0)
+		if (restore != 0)
 		{
-			msgManagment_array[i].TimeoutCounter--;
-		}
-		else if (msgManagment_array[i].TimeoutCounter == 0)
-		{
-			/* call timeout function if counter reaches 0 */
-			if (msgManagment_array[i].TimeoutFunction != 0)
-			{
-				msgManagment_array[i].TimeoutFunction();
-			}
-			/* set to -1 to avoid calling the timeout callback every millisecond */
-			msgManagment_array[i].TimeoutCounter = -1;
+			*interface_array[i] = canInterfacePowerUp[i];
 		}
 		else
 		{
-			/* do nothing */
+			canInterfacePowerUp[i] = *interface_array[i];
 		}
 	}
 }
+#endif
 
 /* Callbacks to handle receival and timeout management of individual CAN messages. */
 /* See our CAN database file (.dbc) for details about our reference implementation */
@@ -467,6 +2671,43 @@ static void MessageReceiveDemo(const canApi_MessageTypedef *message)
 	CAN_M_ReceivedTestData = tmp;
 }
 
+/**
+ * @brief J1939 request: the answer is sent in the next canApi_UserPeriodicCallBack(), see ProcessJ1939()
+ */
+static void MessageReceiveJ1939Request(uint32_t pgn, uint8_t source, uint8_t destination, const uint8_t *data, uint32_t length)
+{
+	uint32_t requested;
+	
+	(void)pgn;
+	if (length < 3u)
+	{
+		return;
+	}
+	requested = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16);
+	if (requested == J1939_PGN_DM1)
+	{
+		canContext->J1939Dm1Requested = 1;
+	}
+	else if (requested == J1939_PGN_SOFTWARE_ID)
+	{
+		canContext->J1939SoftwareIdRequest = destination;
+		if (destination != CAN_J1939_ADDRESS_GLOBAL)
+		{
+			canContext->J1939SoftwareIdRequest = source;
+		}
+	}
+	else if (destination != CAN_J1939_ADDRESS_GLOBAL)
+	{
+		/* a global request for an unsupported PGN is not answered */
+		canContext->J1939NackRequest = source;
+		canContext->J1939NackPgn = requested;
+	}
+	else
+	{
+		/* do nothing */
+	}
+}
+
 
 /* PE_Act_05 */
 static void MessageSend0x1BF(void)
@@ -501,12 +2742,16 @@ static void MessageSend0x1BF(void)
 	message.Data[6] = (UInt8)(temp_trip_m >> 16);
 	message.Data[7] = (UInt8)(temp_trip_m >> 24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
  /* MC_Temperature_01 */
 static void MessageSend0x1BD(void)
 {
+	Float32 temp_fet = AggregateWindow(AGGREGATE_TEMP_FET, CAN_C_Aggregate_Temperature);
+	Float32 temp_motor = AggregateWindow(AGGREGATE_TEMP_MOTOR, CAN_C_Aggregate_Temperature);
+	Float32 temp_mcu = AggregateWindow(AGGREGATE_TEMP_MCU, CAN_C_Aggregate_Temperature);
+	
 	canApi_MessageTypedef message;
 	message.DLC = 6;
 	message.IDE = 0;
@@ -514,14 +2759,14 @@ static void MessageSend0x1BD(void)
 	message.Priority = 1;
 	message.RTR = 0;
 	
-	message.Data[0] = (UInt8)((UInt32)(canApi_Get_TEMP_FET_Max()*16) >>4);
-	message.Data[1] = (UInt8)((UInt32)(canApi_Get_TEMP_FET_Max()*16) >> 12 );
-	message.Data[2] = (UInt8)((UInt32)(canApi_Get_TEMP_Motor()*16) >>4);
-	message.Data[3] = (UInt8)((UInt32)(canApi_Get_TEMP_Motor()*16) >> 12);
-	message.Data[4] = (UInt8)((UInt32)(canApi_Get_TEMP_MCU()*16) >>4);
-	message.Data[5] = (UInt8)((UInt32)(canApi_Get_TEMP_MCU()*16) >> 12);
+	message.Data[0] = (UInt8)((UInt32)(temp_fet*16) >>4);
+	message.Data[1] = (UInt8)((UInt32)(temp_fet*16) >> 12 );
+	message.Data[2] = (UInt8)((UInt32)(temp_motor*16) >>4);
+	message.Data[3] = (UInt8)((UInt32)(temp_motor*16) >> 12);
+	message.Data[4] = (UInt8)((UInt32)(temp_mcu*16) >>4);
+	message.Data[5] = (UInt8)((UInt32)(temp_mcu*16) >> 12);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
 /* MC_Errorflags_01 */
@@ -543,7 +2788,7 @@ static void MessageSend0x1BC(void)
 	message.Data[6] = (UInt8)(((UInt32)canApi_Get_ERR_MEM_Trace_0_Errorcode())>>16);
 	message.Data[7] = (UInt8)(((UInt32)canApi_Get_ERR_MEM_Trace_0_Errorcode())>>24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
  /* MC_State_01 */
@@ -584,7 +2829,7 @@ static void MessageSend0x2B9(void)
 	message.Data[6] |= (UInt8)((UInt32)canApi_Get_TRQ_LIM_Derating_Rotor_Speed() << 7) & 0x80; 
 	message.Data[7] = 0;
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
 /* MC_Current_01 */
@@ -606,7 +2851,7 @@ static void MessageSend0x1BA(void)
 	message.Data[6] = (UInt8)(((UInt32)(canApi_Get_INFO_Voltage_DC_Link()/0.01f)) >> 0);
 	message.Data[7] = (UInt8)(((UInt32)(canApi_Get_INFO_Voltage_DC_Link()/0.01f)) >> 8);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
  /* MC_Prod_Data_01 */
@@ -619,6 +2864,11 @@ static void MessageSend0x601(void)
 	message.Priority = 1;
 	message.RTR = 0;
 	
+	if (CAN_C_ProdData_Broadcast == 0)
+	{
+		return; /* read with UDS ReadDataByIdentifier instead */
+	}
+	
 	message.Data[0] = (UInt8)(canApi_Get_PROD_M_BSW_Ver_Release());
 	message.Data[1] = (UInt8)(canApi_Get_PROD_M_BSW_Ver_Release()>>8);
 	message.Data[2] = (UInt8)(canApi_Get_PROD_M_BSW_Ver_Release()>>16);
@@ -628,7 +2878,7 @@ static void MessageSend0x601(void)
 	message.Data[6] = (UInt8)(canApi_Get_PROD_M_BSW_Ver_Revision()>>16);
 	message.Data[7] = (UInt8)(canApi_Get_PROD_M_BSW_Ver_Revision()>>24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
  /* MC_Prod_Data_02 */
 static void MessageSend0x602(void)
@@ -640,6 +2890,11 @@ static void MessageSend0x602(void)
 	message.Priority = 1;
 	message.RTR = 0;
 	
+	if (CAN_C_ProdData_Broadcast == 0)
+	{
+		return; /* read with UDS ReadDataByIdentifier instead */
+	}
+	
 	message.Data[0] = (UInt8)(canApi_Get_BSW_C_BSW_ET_Dataset_ID1());
 	message.Data[1] = (UInt8)(canApi_Get_BSW_C_BSW_ET_Dataset_ID1()>>8);
 	message.Data[2] = (UInt8)(canApi_Get_BSW_C_BSW_ET_Dataset_ID2());
@@ -649,7 +2904,7 @@ static void MessageSend0x602(void)
 	message.Data[6] = (UInt8)((canApi_Get_BSW_C_BSW_ET_Dataset_ID3()/1000));
 	message.Data[7] = (UInt8)((canApi_Get_BSW_C_BSW_ET_Dataset_ID3()/1000)>>8);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* MC_Prod_Data_03 */
 static void MessageSend0x603(void)
@@ -661,6 +2916,11 @@ static void MessageSend0x603(void)
 	message.Priority = 1;
 	message.RTR = 0;
 	
+	if (CAN_C_ProdData_Broadcast == 0)
+	{
+		return; /* read with UDS ReadDataByIdentifier instead */
+	}
+	
 	message.Data[0] = (UInt8)(UInt8)(canApi_Get_PROD_C_HW_Prod_Info_1());
 	message.Data[1] = (UInt8)(UInt8)(canApi_Get_PROD_C_HW_Prod_Info_1()>>8);
 	message.Data[2] = (UInt8)(UInt8)(canApi_Get_PROD_C_HW_Prod_Info_1()>>16);
@@ -670,7 +2930,7 @@ static void MessageSend0x603(void)
 	message.Data[6] = (UInt8)0;
 	message.Data[7] = (UInt8)0;
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* MC_Prod_Data_04 */
 static void MessageSend0x604(void)
@@ -682,6 +2942,11 @@ static void MessageSend0x604(void)
 	message.Priority = 1;
 	message.RTR = 0;
 	
+	if (CAN_C_ProdData_Broadcast == 0)
+	{
+		return; /* read with UDS ReadDataByIdentifier instead */
+	}
+	
 	message.Data[0] = (UInt8)(canApi_Get_PROD_M_HW_ID1());
 	message.Data[1] = (UInt8)(canApi_Get_PROD_M_HW_ID1()>>8);
 	message.Data[2] = (UInt8)(canApi_Get_PROD_M_HW_ID1()>>16);
@@ -691,7 +2956,7 @@ static void MessageSend0x604(void)
 	message.Data[6] = (UInt8)(canApi_Get_PROD_M_HW_ID2()>>16);
 	message.Data[7] = (UInt8)(canApi_Get_PROD_M_HW_ID2()>>24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
  /* MC_APP_01*/
 static void MessageSend0x1F0(void)
@@ -726,7 +2991,7 @@ static void MessageSend0x1F0(void)
 	message.Data[6] = (UInt8)(temp_odo_trip >> 16);
 	message.Data[7] = (UInt8)(temp_odo_trip >> 24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
  /* MC_APP_02*/
 static void MessageSend0x1F1(void)
@@ -757,14 +3022,14 @@ static void MessageSend0x1F1(void)
 	
 	message.Data[0] = (UInt8)(temp_rem_distance);
 	message.Data[1] = (UInt8)(temp_rem_distance >> 8);
-	message.Data[2] = (UInt8)canApi_Get_SOC_State_of_Charge();
+	message.Data[2] = (UInt8)AggregateWindow(AGGREGATE_SOC, CAN_C_Aggregate_SOC);
 	message.Data[3] = (UInt8)(temp_odo_total);
 	message.Data[4] = (UInt8)(temp_odo_total >> 8);
 	message.Data[5] = (UInt8)(temp_odo_total >> 16);
 	message.Data[6] = (UInt8)(temp_odo_trip);
 	message.Data[7] = (UInt8)(temp_odo_trip >> 8);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
  /* MC_APP_03*/
@@ -798,7 +3063,7 @@ static void MessageSend0x1F2(void)
 	message.Data[6] = (UInt8)((UInt32)((canApi_Get_INFO_Ah_Neg()*10)) >> 8);
 	message.Data[7] = (UInt8)((UInt32)((canApi_Get_INFO_Ah_Neg()*10)) >> 16);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* MC_APP_04*/
 static void MessageSend0x1F4(void)
@@ -819,13 +3084,11 @@ static void MessageSend0x1F4(void)
 	message.Data[6] = (UInt8)(0);
 	message.Data[7] = (UInt8)(0);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
   /* ICS_Info_01 */
 static void MessageSend0x90(void)
 {
-	static UInt16 ICS_Counter=0;
-	
 	canApi_MessageTypedef message;
 	message.DLC = 8;
 	message.IDE = 0;
@@ -833,8 +3096,8 @@ static void MessageSend0x90(void)
 	message.Priority = 1;
 	message.RTR = 0;
 	
-	ICS_Counter = (ICS_Counter+1)%16;
-	message.Data[0] = (UInt8) ICS_Counter;
+	canContext->IcsCounter = (canContext->IcsCounter+1)%16;
+	message.Data[0] = (UInt8) canContext->IcsCounter;
 	message.Data[1] = (UInt8)((Int32)(canApi_Get_INFO_DC_Current()*-32));
 	message.Data[2] = (UInt8)(((Int32)(canApi_Get_INFO_DC_Current()*-32))>>8);
 	message.Data[3] = (UInt8)(((Int32)(canApi_Get_INFO_Voltage_DC_Link()*64)));
@@ -845,7 +3108,7 @@ static void MessageSend0x90(void)
 	message.Data[6] = (UInt8)(30);
 	message.Data[7] = (UInt8)(30);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Odo */
 static void MessageSend0x206(void)
@@ -893,7 +3156,7 @@ static void MessageSend0x206(void)
 	message.Data[6] = (0);
 	message.Data[7] = (0);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Display_01 */
 static void MessageSend0x207(void)
@@ -983,7 +3246,7 @@ static void MessageSend0x207(void)
 	message.Data[6] = (UInt8)(temp_odo_total>>0);
 	message.Data[7] = (UInt8)(temp_odo_total>>8);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Display_02 */
 static void MessageSend0x305(void)
@@ -1004,7 +3267,7 @@ static void MessageSend0x305(void)
 	message.Data[6] = (UInt8)0;
 	message.Data[7] = (UInt8)0;
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Display_03 */
 static void MessageSend0x306(void)
@@ -1044,7 +3307,7 @@ static void MessageSend0x306(void)
 	}
 	message.Data[7] = (UInt8)0;
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Error */
 static void MessageSend0x209(void)
@@ -1198,7 +3461,7 @@ static void MessageSend0x209(void)
 	message.Data[6] = (UInt8)0;
 	message.Data[7] = (UInt8)0;
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Challenge for Immo Unlocking*/
 static void MessageSend0x1B5(void)
@@ -1222,7 +3485,7 @@ static void MessageSend0x1B5(void)
 	message.Data[6] = (UInt8)(BSW_Immo_Challenge_Higher>>16);
 	message.Data[7] = (UInt8)(BSW_Immo_Challenge_Higher>>24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* Unlock Code sent to GRID-BMS if needed by GRID */
 static void MessageSend0x1B7(void)
@@ -1246,7 +3509,7 @@ static void MessageSend0x1B7(void)
 	message.Data[6] = (UInt8)(BSW_BMS_Unlock_Code_Higher>>16);
 	message.Data[7] = (UInt8)(BSW_BMS_Unlock_Code_Higher>>24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 /* BMS Ctrl 01 */
 static void MessageSend0x160(void)
@@ -1267,7 +3530,80 @@ static void MessageSend0x160(void)
 	message.Data[6] = (UInt8)0;
 	message.Data[7] = (UInt8)0;
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
+}
+/* Mux_Diag_01 */
+static void MessageSend0x3F0(void)
+{
+	const UInt32 signals_array[MUX_PAGES] =
+	{
+		CAN_C_Mux_Page0_Signals, CAN_C_Mux_Page1_Signals, CAN_C_Mux_Page2_Signals, CAN_C_Mux_Page3_Signals,
+		CAN_C_Mux_Page4_Signals, CAN_C_Mux_Page5_Signals, CAN_C_Mux_Page6_Signals, CAN_C_Mux_Page7_Signals
+	};
+	uint8_t page = SelectMuxPage();
+	uint8_t length = 1;
+	uint8_t i;
+	
+	canApi_MessageTypedef message;
+	message.DLC = 8;
+	message.IDE = 0;
+	message.Identifier = 0x3F0;
+	message.Priority = 1;
+	message.RTR = 0;
+	
+	if (page == MUX_PAGE_NONE)
+	{
+		return;
+	}
+	
+	/* byte 0 is the mux selector, the signals of the page follow without gaps, unused bytes are 0 */
+	memset(message.Data, 0, sizeof(message.Data));
+	message.Data[0] = page;
+	for (i = 0; i < MUX_SIGNALS_PER_PAGE; i++)
+	{
+		uint8_t index = (uint8_t)(signals_array[page] >> (8u * i));
+		
+		if (index != CAN_SIGNAL_NONE)
+		{
+			length = (uint8_t)(length + CAN_Signals_Encode(index, &message.Data[length], (uint8_t)(8u - length)));
+		}
+	}
+	
+	SendMessage(&message);
+}
+
+/* Delta_Telemetry_01 */
+static void MessageSend0x3F1(void)
+{
+	uint8_t keyframe = 0;
+	uint32_t frames;
+	
+	canApi_MessageTypedef message;
+	message.DLC = 8;
+	message.IDE = 0;
+	message.Identifier = 0x3F1;
+	message.Priority = 1;
+	message.RTR = 0;
+	
+	if (IsDeltaTelemetryOn() == 0)
+	{
+		return;
+	}
+	
+	ConfigureDeltaTelemetry();
+	if (canContext->DeltaRunning == 0 || canContext->MsCounter - canContext->DeltaKeyframeMs >= CAN_C_Delta_KeyframeInterval)
+	{
+		canContext->DeltaRunning = 1;
+		canContext->DeltaKeyframeMs = canContext->MsCounter;
+		keyframe = 1;
+	}
+	CAN_Delta_Sample(keyframe);
+	
+	/* the DLC is the number of used bytes, signals which did not fit follow in the next slot */
+	for (frames = 0; frames < CAN_C_Delta_FramesPerSlot && CAN_Delta_NextFrame(&message) != 0; frames++)
+	{
+		SendMessage(&message);
+	}
 }
 
 static void MessageSendFictionalDisplay(void)
@@ -1294,7 +3630,7 @@ static void MessageSendFictionalDisplay(void)
 	message.Data[6] = (UInt8)(temp_speed >> 16);
 	message.Data[7] = (UInt8)(temp_speed >> 24);
 	
-	canApi_SendMessage(&message);
+	SendMessage(&message);
 }
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -1307,6 +3643,12 @@ static void MessageSendFictionalDisplay(void)
  */
 void canApi_UserInitCallBack(void)
 {
+	/* a second init of the peripheral keeps the module state */
+	if (canContext->Initialized == 0)
+	{
+		InitContext(canContext);
+	}
+	
 	/* Init the buffer structure. We use a ringbuffer implementation in this example */
 	canApi_SetupBuffer(RINGBUFFER, RINGBUFFER);
 	canApi_ClearTransmitBuffer();
@@ -1318,83 +3660,425 @@ void canApi_UserInitCallBack(void)
 	canApi_FilterSetTwoStdIdListMode(FilterBank03, 0x50C, 0, 0x0, 0);
 	
 	canApi_FilterSetOneStdIdListMode(FilterBank04,0x600,0);
+	canApi_FilterSetOneStdIdListMode(FilterBank05, CAN_XCP_CRO_ID, 0);
+	if (CAN_C_Uds_Enable != 0)
+	{
+		canApi_FilterSetOneStdIdListMode(FilterBank06, CAN_UDS_REQUEST_ID, 0);
+	}
+	canApi_FilterSetOneStdIdListMode(FilterBank07, CAN_TIMESYNC_ID, 0);
+	
+	/* J1939 messages are accepted by PGN with extended mask mode filters */
+	if (CAN_C_J1939_Enable != 0)
+	{
+		(void)CAN_J1939_SetupFilters(j1939Pgn_array, J1939_PGNS_AVAILABLE, FilterBank08, FilterBank15);
+	}
+	
+	/* decode the torque request of the external controller in the receive interrupt */
+	(void)CAN_RegisterFastPath(0x111, 0);
 }
 
 /**
- * @brief Callback called every 1ms.
- * The user can check the CAN input buffer for received messages and can put messages to sent into the output buffer.
+ * @brief Default timestamp source, derived from the millisecond counter of this module.
+ * Declared weak so that the basic software can provide a free running hardware timer or cycle counter.
+ * @return timestamp [us]
  */
-void canApi_UserPeriodicCallBack(void)
+__attribute__((weak)) uint32_t CAN_GetTimestampUs(void)
 {
-	canApi_MessageTypedef message;
+	return canContext->MsCounter * 1000u;
+}
+
+/**
+ * @brief Record the transmit complete of a message for the queueing latency statistics.
+ * Called by the basic software from the transmit complete interrupt.
+ * @param message: message which was transmitted on the bus
+ */
+void CAN_TxCompleteHook(const canApi_MessageTypedef *message)
+{
+	uint32_t now = CAN_GetTimestampUs();
+	uint8_t i;
 	
-	static uint16_t timeslot = 0; /* used to control tx message intervals */
+	CAN_TimeSync_TxComplete(message, now);
+	if (CAN_C_Recorder_Enable != 0)
+	{
+		CAN_Recorder_Log(message, 1, now);
+	}
+	canContext->TxCompletedCount++;
+	canContext->TxCompleteSeen = 1;
 	
-	/* get all messages from the input buffer */
-	while(canApi_ReceiveMessage(&message) == CAN_OK)
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		txLatency_TypeDef *latency = &canContext->TxLatency[i];
+		
+		if (latency->InFlight != 0 && latency->Identifier == message->Identifier && latency->IDE == message->IDE)
+		{
+			uint32_t elapsed = now - latency->EnqueueTimestamp;
+			uint32_t bin = elapsed / TX_LATENCY_BIN_US;
+			
+			if (bin >= TX_LATENCY_BINS)
+			{
+				bin = TX_LATENCY_BINS - 1u;
+			}
+			if (latency->Histogram[bin] < 0xFFFFu)
+			{
+				latency->Histogram[bin]++;
+			}
+			if (latency->Count == 0 || elapsed < latency->Min)
+			{
+				latency->Min = elapsed;
+			}
+			if (elapsed > latency->Max)
+			{
+				latency->Max = elapsed;
+			}
+			latency->Count++;
+			latency->InFlight = 0;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Get the transmit queueing latency statistics of a periodic message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @param stats: target pointer to store the statistics
+ * @return CAN_OK if the message was measured, CAN_INVALID_VALUE otherwise
+ */
+canApi_StatusTypeDef CAN_GetTxLatency(uint32_t identifier, uint8_t ide, CAN_TxLatency_TypeDef *stats)
+{
+	uint8_t i;
+	
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		const txLatency_TypeDef *latency = &canContext->TxLatency[i];
+		
+		if (latency->Count > 0 && latency->Identifier == identifier && latency->IDE == ide)
+		{
+			stats->Count = latency->Count;
+			stats->Min = latency->Min;
+			stats->Max = latency->Max;
+			stats->P50 = TxLatencyPercentile(latency, 50);
+			stats->P99 = TxLatencyPercentile(latency, 99);
+			return CAN_OK;
+		}
+	}
+	return CAN_INVALID_VALUE;
+}
+
+/**
+ * @brief Clear the transmit queueing latency statistics of all messages
+ */
+void CAN_ResetTxLatency(void)
+{
+	uint8_t i;
+	uint8_t bin;
+	
+	for (i = 0; i < TX_MESSAGES_AVAILABLE; i++)
+	{
+		canContext->TxLatency[i].Count = 0;
+		canContext->TxLatency[i].Min = 0;
+		canContext->TxLatency[i].Max = 0;
+		for (bin = 0; bin < TX_LATENCY_BINS; bin++)
+		{
+			canContext->TxLatency[i].Histogram[bin] = 0;
+		}
+	}
+}
+
+/**
+ * @brief Clear the high-water marks and overflow counters of the canApi buffers and the receive queues.
+ * Also triggered by a change of CAN_C_BufferDiag_Reset from 0 to 1.
+ */
+void CAN_ResetBufferDiagnostics(void)
+{
+	CAN_M_TxBuffer_HighWater = CAN_M_TxBuffer_Fill;
+	CAN_M_TxBuffer_Overflow = 0;
+	CAN_M_TxBuffer_LastDropId = 0;
+	CAN_M_RxBuffer_HighWater = CAN_M_RxBuffer_Fill;
+	CAN_M_RxBuffer_Overflow = 0;
+	CAN_M_RxBuffer_LastDropId = 0;
+	CAN_M_RxQueue_ControlOverflow = 0;
+	CAN_M_RxQueue_NormalOverflow = 0;
+	CAN_M_RxQueue_BulkOverflow = 0;
+}
+
+/**
+ * @brief Capture the reception time of a message.
+ * Called by the basic software from the receive interrupt before the message is put into the receive buffer.
+ * @param message: received message
+ */
+void CAN_RxIsrHook(const canApi_MessageTypedef *message)
+{
+	uint8_t head = canContext->RxTimestampHead;
+	uint8_t next = (uint8_t)((head + 1u) & (RX_TIMESTAMP_RING_SIZE - 1u));
+	
+	uint32_t timestamp = CAN_GetTimestampUs();
+	uint8_t i;
+	
+	if (CAN_C_Recorder_Enable != 0)
+	{
+		CAN_Recorder_Log(message, 0, timestamp);
+	}
+	if (next != canContext->RxTimestampTail)
+	{
+		canContext->RxTimestampRing[head].Identifier = message->Identifier;
+		canContext->RxTimestampRing[head].IDE = message->IDE;
+		canContext->RxTimestampRing[head].Timestamp = timestamp;
+		canContext->RxTimestampHead = next;
+	}
+	
+	/* decode registered control messages right away instead of waiting for the next 1ms callback */
+	for (i = 0; i < canContext->FastPathCount; i++)
 	{
-		/* check if we have a callback for the received message */
-		msgManagement_TypeDef* msgManagement = GetMessageManagement(&message);
+		fastPath_TypeDef *fastPath = &canContext->FastPath[i];
+		msgManagement_TypeDef *msgManagement = &canContext->MsgManagement[fastPath->Index];
 		
-		if (msgManagement != 0)
+		if (fastPath->Active != 0
+			&& msgManagement->CanIdentifier == message->Identifier && msgManagement->IDE == message->IDE)
 		{
-			/* reset timeout counter to reload value */
+			uint32_t elapsed;
+			
 			msgManagement->TimeoutCounter = msgManagement->TimeoutReloadValue;
+			msgManagement->ReceiveFunction(message);
+			fastPath->IsrCount++;
 			
-			/* call the callback function if defined */
-			if (msgManagement->ReceiveFunction != 0)
+			elapsed = CAN_GetTimestampUs() - timestamp;
+			CAN_M_FastPath_Count++;
+			if (elapsed > CAN_M_FastPath_MaxTime)
+			{
+				CAN_M_FastPath_MaxTime = elapsed;
+			}
+			if (elapsed > CAN_C_FastPath_Budget)
+			{
+				/* the total of all messages is only reported, each message is judged by its own overruns */
+				CAN_M_FastPath_Overruns++;
+				fastPath->Overruns++;
+				if (CAN_C_FastPath_MaxOverruns > 0 && fastPath->Overruns >= CAN_C_FastPath_MaxOverruns)
+				{
+					/* callback too slow for interrupt context, fall back to the polled path */
+					fastPath->Active = 0;
+				}
+			}
+			else
 			{
-				msgManagement->ReceiveFunction(&message);
+				fastPath->Overruns = 0;
 			}
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Decode a managed message directly in the receive interrupt.
+ * The receive callback of the message is called from CAN_RxIsrHook() instead of canApi_UserPeriodicCallBack().
+ * It must finish within CAN_C_FastPath_Budget. Only a few short control messages should be registered.
+ * @param identifier: identifier of the message, must be listed in msgManagment_array
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @return CAN_OK on success, CAN_INVALID_VALUE if the message is not managed, CAN_BUFFER_FULL if FAST_PATH_MAX messages are registered
+ */
+canApi_StatusTypeDef CAN_RegisterFastPath(uint32_t identifier, uint8_t ide)
+{
+	uint8_t i;
+	
+	for (i = 0; i < canContext->FastPathCount; i++)
+	{
+		const msgManagement_TypeDef *msgManagement = &canContext->MsgManagement[canContext->FastPath[i].Index];
+		
+		if (msgManagement->CanIdentifier == identifier && msgManagement->IDE == ide)
+		{
+			/* already registered, e.g. by a second init */
+			return CAN_OK;
+		}
+	}
+	if (canContext->FastPathCount >= FAST_PATH_MAX)
+	{
+		return CAN_BUFFER_FULL;
+	}
+	for (i = 0; i < COMMANDS_AVAILABLE; i++)
+	{
+		if (canContext->MsgManagement[i].CanIdentifier == identifier && canContext->MsgManagement[i].IDE == ide
+			&& canContext->MsgManagement[i].ReceiveFunction != 0)
+		{
+			canContext->FastPath[canContext->FastPathCount].Index = i;
+			canContext->FastPath[canContext->FastPathCount].IsrCount = 0;
+			canContext->FastPath[canContext->FastPathCount].PollCount = 0;
+			canContext->FastPath[canContext->FastPathCount].Overruns = 0;
+			canContext->FastPath[canContext->FastPathCount].Active = 1;
+			canContext->FastPathCount++;
+			return CAN_OK;
 		}
 	}
+	return CAN_INVALID_VALUE;
+}
+
+/**
+ * @brief Get the receive timing of a managed message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @param timing: target pointer to store the timing
+ * @return CAN_OK if the message was received at least once, CAN_INVALID_VALUE otherwise
+ */
+canApi_StatusTypeDef CAN_GetRxTiming(uint32_t identifier, uint8_t ide, CAN_RxTiming_TypeDef *timing)
+{
+	const CAN_RxTiming_TypeDef *entry = FindRxTiming(identifier, ide);
+	
+	if (entry == 0)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	*timing = *entry;
+	return CAN_OK;
+}
+
+/**
+ * @brief Get the age of the last received instance of a managed message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @return time since reception [us], 0xFFFFFFFF if the message was never received
+ */
+uint32_t CAN_GetRxAge(uint32_t identifier, uint8_t ide)
+{
+	const CAN_RxTiming_TypeDef *entry = FindRxTiming(identifier, ide);
+	
+	return (entry != 0) ? (uint32_t)(CAN_GetTimestampUs() - entry->Timestamp) : 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Get the time between the last two receptions of a managed message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @return inter-arrival time [us], 0 if the message was received less than twice
+ */
+uint32_t CAN_GetRxInterArrival(uint32_t identifier, uint8_t ide)
+{
+	const CAN_RxTiming_TypeDef *entry = FindRxTiming(identifier, ide);
+	
+	return (entry != 0) ? entry->InterArrival : 0u;
+}
+
+#ifdef CAN_MULTI_INSTANCE
+/**
+ * @brief Get the memory needed for one module context
+ * @return size of CAN_Context_TypeDef [byte]
+ */
+uint32_t CAN_GetContextSize(void)
+{
+	return (uint32_t)sizeof(CAN_Context_TypeDef);
+}
+
+/**
+ * @brief Set a context to the power-up state of the module and bind it to the calling thread.
+ * The sub-modules and the EnableTool variables keep their state per thread, so a thread runs one context
+ * at a time. They are set to their power-up state too: the first call of a thread saves the values of the
+ * EnableTool variables, every later call writes them back.
+ * @param context: context to initialize, CAN_GetContextSize() bytes
+ * @return CAN_OK on success, CAN_INVALID_VALUE if the thread already runs another context
+ */
+canApi_StatusTypeDef CAN_InitContext(CAN_Context_TypeDef *context)
+{
+	if (context == 0 || (canThreadContext != 0 && canThreadContext != context))
+	{
+		return CAN_INVALID_VALUE;
+	}
+	CopyInterfaces(canInterfaceSaved);
+	canInterfaceSaved = 1;
+	InitContext(context);
+	context->Owner = &canThreadContext;
+	canThreadContext = context;
+	return CAN_OK;
+}
+
+/**
+ * @brief Select the context used by all entry points of the module in the calling thread.
+ * Selecting the default context releases the context of the thread, afterwards the thread may initialize another one.
+ * @param context: context initialized by the calling thread, 0 for the default context
+ * @return CAN_OK on success, CAN_INVALID_VALUE if the context was not initialized by the calling thread
+ */
+canApi_StatusTypeDef CAN_SelectContext(CAN_Context_TypeDef *context)
+{
+	if (context == 0)
+	{
+		canContext = &canDefaultContext;
+		canThreadContext = 0;
+		return CAN_OK;
+	}
+	if (context != canThreadContext || context->Owner != &canThreadContext)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	canContext = context;
+	return CAN_OK;
+}
+#endif
+
+/**
+ * @brief Callback called every 1ms.
+ * The user can check the CAN input buffer for received messages and can put messages to sent into the output buffer.
+ */
+void canApi_UserPeriodicCallBack(void)
+{
+	canContext->MsCounter++;
+	
+	/* get all messages from the input buffer and sort them into the receive queues */
+	DrainReceiveBuffer();
+	
+	/* decode control messages first, bulk messages only up to their budget */
+	DecodeReceiveQueue(RX_CLASS_CONTROL, RX_QUEUE_DEPTH_CONTROL);
+	DecodeReceiveQueue(RX_CLASS_NORMAL, RX_QUEUE_DEPTH_NORMAL);
+	DecodeReceiveQueue(RX_CLASS_BULK, CAN_C_RxQueue_BulkBudget);
 	
 	/* check if a registered message has a timeout and call the corresponding callback */
 	HandleMessageTimeouts();
 	
+	/* adapt the transmit policy to the error state of the CAN peripheral */
+	UpdateBusState();
+	
+	/* the flight recorder sees the timeouts and the bus state of this millisecond */
+	ProcessRecorder();
 	
-	/* send periodic messages */
+	/* the slow messages report the statistics of the samples up to this millisecond */
+	ProcessAggregation();
 	
-	if (timeslot % 10 == 0)
+	/* SYNC is queued in front of the periodic messages */
+	ProcessTimeSync();
+	
+	/* send periodic messages, see txSchedule_array for the intervals */
+	SendPeriodicMessages(canContext->TxTimeslot);
+	
+	/* XCP measurement samples in the same millisecond as the periodic messages */
+	if (CAN_C_Xcp_Enable != 0)
 	{
-		/* send messages in 10 millisecond interval */
-		MessageSend0x160(); /* BMS Ctrl 01 */
-		MessageSend0x90();  /* ICS_Info_01 */
-		MessageSend0x1BA(); /* MC_Current_01 */
-		MessageSend0x1BC(); /* MC_Errorflags_01 */
-		MessageSend0x2B9(); /* MC_State_01 */
+		CAN_Xcp_Process(GetXcpBudget());
 	}
-	
-	if (timeslot % 100 == 0)
+	else
 	{
-		/* send messages in 100 millisecond interval */
-		MessageSend0x1B5(); /* Challenge for Immo Unlocking*/
-		MessageSend0x1B7(); /* Unlock Code sent to GRID-BMS if needed by GRID */
-		MessageSend0x1BF(); /* PE_Act_05 */
-		MessageSend0x1F0(); /* MC_APP_01*/
-		MessageSend0x1F4(); /* MC_APP_04*/
-		MessageSend0x206(); /* Odo */
-		MessageSend0x207(); /* Display_01 */
-		MessageSend0x209(); /* Error */
-		MessageSend0x305(); /* Display_02 */
-		MessageSend0x306(); /* Display_03 */
+		CAN_Xcp_Disconnect();
 	}
+	CAN_M_Xcp_DaqOverload = CAN_Xcp_GetOverloadCount();
 	
-	if (timeslot % 1000 == 0)
+	/* diagnostic requests are answered before the segmented transfers are sent */
+	if (CAN_C_Uds_Enable != 0)
 	{
-		/* send messages in 1000 millisecond interval */
-		MessageSend0x1BD(); /* MC_Temperature_01 */
-		MessageSend0x1F1(); /* MC_APP_02*/
-		MessageSend0x1F2(); /* MC_APP_03*/
-		MessageSend0x601(); /* MC_Prod_Data_01 */
-		MessageSend0x602(); /* MC_Prod_Data_02 */
-		MessageSend0x603(); /* MC_Prod_Data_03 */
-		MessageSend0x604(); /* MC_Prod_Data_04 */
-		
-		MessageSendFictionalDisplay(); /* Send the data to our fictional display */
+		CAN_Uds_Process();
+	}
+	else
+	{
+		CAN_Uds_Close();
 	}
 	
-	timeslot++;
+	/* J1939 network management, DM1 and answers to requests */
+	ProcessJ1939();
+	
+	/* segmented transfers use what is left of the transmit buffer */
+	CAN_IsoTp_Process(GetIsoTpBudget());
+	
+	/* show the queueing latency of the selected message in the EnableTool */
+	UpdateTxLatencyDisplay();
+	
+	/* show the fill of the transmit buffer in the EnableTool */
+	UpdateBufferDiagnostics();
+	
+	canContext->TxTimeslot++;
 	
 	return;
 }
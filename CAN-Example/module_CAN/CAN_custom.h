@@ -21,18 +21,51 @@
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* INCLUDES */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-
+#include "canApi.h"
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PUBLIC DEFINES */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+#ifdef CAN_MULTI_INSTANCE
+/* host simulation with one controller instance per thread, see CAN_SelectContext() */
+#define MEDKit_Modul_Interfaces _Thread_local volatile
+#else
 #define MEDKit_Modul_Interfaces volatile
+#endif
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PUBLIC TYPEDEF */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+/**
+ * @brief Transmit queueing latency of a periodic message, from canApi_SendMessage() to transmit complete
+ */
+typedef struct
+{
+	uint32_t Count; /**< @brief number of measured transmissions */
+	uint32_t Min; /**< @brief minimum latency [us] */
+	uint32_t Max; /**< @brief maximum latency [us] */
+	uint32_t P50; /**< @brief median, upper bound of the histogram bin [us] */
+	uint32_t P99; /**< @brief 99th percentile, upper bound of the histogram bin [us] */
+}CAN_TxLatency_TypeDef;
+
+/**
+ * @brief Receive timing of a managed message, based on the timestamps of CAN_RxIsrHook()
+ */
+typedef struct
+{
+	uint32_t Count; /**< @brief number of receptions */
+	uint32_t Timestamp; /**< @brief reception time of the last instance [us] */
+	uint32_t InterArrival; /**< @brief time between the last two receptions [us] */
+	uint32_t InterArrivalMin; /**< @brief minimum time between two receptions [us] */
+	uint32_t InterArrivalMax; /**< @brief maximum time between two receptions [us] */
+}CAN_RxTiming_TypeDef;
+
+/**
+ * @brief Runtime state of one controller instance, only used through a pointer outside CAN_custom.c
+ */
+typedef struct CAN_ContextTag CAN_Context_TypeDef;
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PUBLIC CONSTANTS */
@@ -48,6 +81,128 @@
 /* PUBLIC FUNCTION PROTOTYPES */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+/**
+ * @brief Timestamp source in microseconds for the latency instrumentation.
+ * The default implementation is weak and only has the 1ms resolution of canApi_UserPeriodicCallBack().
+ * Provide this function in the basic software, e.g. from a free running timer or cycle counter,
+ * to measure sub-millisecond latencies.
+ * @return free running timestamp [us], wraps at 2^32
+ */
+uint32_t CAN_GetTimestampUs(void);
+
+/**
+ * @brief Record the transmit complete of a message for the queueing latency statistics.
+ * Must be called by the basic software from the transmit complete interrupt. If it is
+ * never called, no latency is recorded and the flight recorder misses the transmitted messages.
+ * @param message: message which was transmitted on the bus
+ */
+void CAN_TxCompleteHook(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Get the transmit queueing latency statistics of a periodic message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @param stats: target pointer to store the statistics
+ * @return CAN_OK if the message was measured, CAN_INVALID_VALUE otherwise
+ */
+canApi_StatusTypeDef CAN_GetTxLatency(uint32_t identifier, uint8_t ide, CAN_TxLatency_TypeDef *stats);
+
+/**
+ * @brief Clear the transmit queueing latency statistics of all messages
+ */
+void CAN_ResetTxLatency(void);
+
+/**
+ * @brief Clear the high-water marks and overflow counters of the canApi buffers and the receive queues.
+ * Also triggered by a change of CAN_C_BufferDiag_Reset from 0 to 1 in the EnableTool.
+ */
+void CAN_ResetBufferDiagnostics(void);
+
+/**
+ * @brief Capture the reception time of a message.
+ * Must be called by the basic software from the receive interrupt before the message is put
+ * into the receive buffer. The timestamps are matched in reception order, which requires a
+ * RINGBUFFER receive buffer. If the hook is not called, messages are stamped when they are
+ * taken from the receive buffer, i.e. with up to 1ms error. It also logs the message into the
+ * flight recorder, see CAN_recorder.h.
+ * @param message: received message
+ */
+void CAN_RxIsrHook(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Get the receive timing of a managed message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @param timing: target pointer to store the timing
+ * @return CAN_OK if the message was received at least once, CAN_INVALID_VALUE otherwise
+ */
+canApi_StatusTypeDef CAN_GetRxTiming(uint32_t identifier, uint8_t ide, CAN_RxTiming_TypeDef *timing);
+
+/**
+ * @brief Get the age of the last received instance of a managed message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @return time since reception [us], 0xFFFFFFFF if the message was never received
+ */
+uint32_t CAN_GetRxAge(uint32_t identifier, uint8_t ide);
+
+/**
+ * @brief Get the time between the last two receptions of a managed message
+ * @param identifier: identifier of the message
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @return inter-arrival time [us], 0 if the message was received less than twice
+ */
+uint32_t CAN_GetRxInterArrival(uint32_t identifier, uint8_t ide);
+
+/**
+ * @brief Decode a managed message directly in the receive interrupt.
+ * The receive callback of the message is called from CAN_RxIsrHook() instead of canApi_UserPeriodicCallBack(),
+ * so CAN_RxIsrHook() must be called by the basic software. The callback must finish within CAN_C_FastPath_Budget.
+ * @param identifier: identifier of the message, must be listed in msgManagment_array
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @return CAN_OK on success, CAN_INVALID_VALUE if the message is not managed, CAN_BUFFER_FULL if no slot is left
+ */
+canApi_StatusTypeDef CAN_RegisterFastPath(uint32_t identifier, uint8_t ide);
+
+#ifdef CAN_MULTI_INSTANCE
+/*
+ * Multi-instance build for host simulations, compile all files with -DCAN_MULTI_INSTANCE.
+ * Each thread initializes and selects its own context before it calls any entry point of the module:
+ *   CAN_Context_TypeDef *context = malloc(CAN_GetContextSize());
+ *   CAN_InitContext(context);
+ *   CAN_SelectContext(context);
+ *   canApi_UserInitCallBack(); ...
+ * Isolated is one instance per thread, not one per context. The context holds the state of CAN_custom.c
+ * only; the EnableTool variables and the state of the sub-modules (ISO-TP, UDS, XCP, J1939, time sync,
+ * delta telemetry, recorder) are thread-local. CAN_InitContext() resets them together with the context,
+ * so instances run one after the other on a thread each start from the power-up state. The first call
+ * of a thread saves the power-up values of the EnableTool variables, set them only after it.
+ * A thread switching between contexts would mix the thread-local state, a context moved to another
+ * thread would lose it. CAN_InitContext() binds a context to the calling thread and refuses a second
+ * one, CAN_SelectContext() refuses a context of another thread. CAN_SelectContext(0) releases the
+ * context of the thread.
+ */
+
+/**
+ * @brief Get the memory needed for one module context
+ * @return size of CAN_Context_TypeDef [byte]
+ */
+uint32_t CAN_GetContextSize(void);
+
+/**
+ * @brief Set a context to the power-up state of the module and bind it to the calling thread
+ * @param context: context to initialize, CAN_GetContextSize() bytes
+ * @return CAN_OK on success, CAN_INVALID_VALUE if the thread already runs another context
+ */
+canApi_StatusTypeDef CAN_InitContext(CAN_Context_TypeDef *context);
+
+/**
+ * @brief Select the context used by all entry points of the module in the calling thread
+ * @param context: context initialized by the calling thread, 0 for the default context which releases the context of the thread
+ * @return CAN_OK on success, CAN_INVALID_VALUE if the context was not initialized by the calling thread
+ */
+canApi_StatusTypeDef CAN_SelectContext(CAN_Context_TypeDef *context);
+#endif
 
 
 /** @} */ 
@@ -0,0 +1,219 @@
+/**
+*******************************************************************************
+* @file CAN_delta.c
+* @brief Telemetry which only sends the signals that changed
+* @author FRIWO
+* @date 20.10.2026 - 11:26:48
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_delta
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_delta.h"
+#include "CAN_signals.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief marker of an empty slot */
+#define SLOT_EMPTY 0xFFu
+
+/** @brief payload of a classic frame */
+#define FRAME_LENGTH 8u
+
+/** @brief storage of the encoder state, one encoder per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_DELTA_LOCAL _Thread_local
+#else
+#define CAN_DELTA_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Complete state of the encoder
+ */
+typedef struct
+{
+	uint8_t Index[CAN_DELTA_SLOTS]; /**< @brief signal index per slot, SLOT_EMPTY if unused */
+	uint8_t Deadband[CAN_DELTA_SLOTS]; /**< @brief deadband per slot [raw LSB] */
+	uint8_t Format[CAN_DELTA_SLOTS]; /**< @brief CAN_DELTA_FORMAT_* per slot */
+	uint32_t Current[CAN_DELTA_SLOTS]; /**< @brief raw value of the last CAN_Delta_Sample() */
+	uint32_t Shadow[CAN_DELTA_SLOTS]; /**< @brief raw value the receiver has */
+	uint16_t Changed; /**< @brief slots to send because of a change, bit n = slot n */
+	uint16_t Key; /**< @brief slots to send because of a keyframe or a new configuration */
+	uint8_t Next; /**< @brief slot to start the next frame with */
+	uint8_t Sequence; /**< @brief sequence counter of the next frame */
+}deltaState_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static uint8_t FormatSize(uint8_t format);
+static uint8_t IsOutsideDeadband(uint8_t slot);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_DELTA_LOCAL deltaState_TypeDef delta;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static uint8_t FormatSize(uint8_t format)
+{
+	return (format == CAN_DELTA_FORMAT_INT16 || format == CAN_DELTA_FORMAT_UINT16) ? 2u : 4u;
+}
+
+/**
+ * @brief Compare the current raw value of a slot with its shadow copy
+ * @return 1 if the difference is larger than the deadband
+ */
+static uint8_t IsOutsideDeadband(uint8_t slot)
+{
+	uint32_t current = delta.Current[slot];
+	uint32_t shadow = delta.Shadow[slot];
+	uint32_t difference;
+
+	if (delta.Format[slot] == CAN_DELTA_FORMAT_UINT16 || delta.Format[slot] == CAN_DELTA_FORMAT_UINT32)
+	{
+		difference = (current > shadow) ? current - shadow : shadow - current;
+	}
+	else
+	{
+		int64_t signedDifference = (int64_t)(int32_t)current - (int64_t)(int32_t)shadow;
+
+		difference = (uint32_t)((signedDifference < 0) ? -signedDifference : signedDifference);
+	}
+	return (difference > delta.Deadband[slot]) ? 1u : 0u;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_Delta_Init(void)
+{
+	memset(&delta, 0, sizeof(delta));
+	memset(delta.Index, SLOT_EMPTY, sizeof(delta.Index));
+}
+
+void CAN_Delta_Configure(uint8_t slot, uint8_t index, uint8_t deadband)
+{
+	const CAN_Signal_TypeDef *signal = (index <= CAN_DELTA_MAX_INDEX) ? CAN_Signals_Get(index) : 0;
+	uint16_t bit;
+
+	if (slot >= CAN_DELTA_SLOTS)
+	{
+		return;
+	}
+	bit = (uint16_t)(1u << slot);
+	delta.Deadband[slot] = deadband;
+	if (signal == 0)
+	{
+		delta.Index[slot] = SLOT_EMPTY;
+		delta.Changed &= (uint16_t)~bit;
+		delta.Key &= (uint16_t)~bit;
+		return;
+	}
+	if (delta.Index[slot] != index)
+	{
+		delta.Index[slot] = index;
+		if (signal->GetUInt32 != 0)
+		{
+			delta.Format[slot] = (signal->Size == 4u) ? CAN_DELTA_FORMAT_UINT32 : CAN_DELTA_FORMAT_UINT16;
+		}
+		else
+		{
+			delta.Format[slot] = (signal->Size == 4u) ? CAN_DELTA_FORMAT_INT32 : CAN_DELTA_FORMAT_INT16;
+		}
+		(void)CAN_Signals_GetRaw(index, &delta.Current[slot]);
+		delta.Key |= bit;
+	}
+}
+
+void CAN_Delta_Sample(uint8_t keyframe)
+{
+	uint8_t slot;
+
+	for (slot = 0; slot < CAN_DELTA_SLOTS; slot++)
+	{
+		if (delta.Index[slot] == SLOT_EMPTY)
+		{
+			continue;
+		}
+		(void)CAN_Signals_GetRaw(delta.Index[slot], &delta.Current[slot]);
+		if (keyframe != 0u)
+		{
+			delta.Key |= (uint16_t)(1u << slot);
+		}
+		else if (IsOutsideDeadband(slot) != 0u)
+		{
+			delta.Changed |= (uint16_t)(1u << slot);
+		}
+	}
+}
+
+uint8_t CAN_Delta_NextFrame(canApi_MessageTypedef *message)
+{
+	uint8_t length = 1;
+	uint8_t last = delta.Next;
+	uint8_t n;
+
+	if ((delta.Changed | delta.Key) == 0u)
+	{
+		return 0;
+	}
+
+	message->Data[0] = (uint8_t)(delta.Sequence & CAN_DELTA_SEQUENCE_MASK);
+	for (n = 0; n < CAN_DELTA_SLOTS; n++)
+	{
+		uint8_t slot = (uint8_t)((delta.Next + n) % CAN_DELTA_SLOTS);
+		uint16_t bit = (uint16_t)(1u << slot);
+		uint8_t size = FormatSize(delta.Format[slot]);
+		uint8_t i;
+
+		if (((delta.Changed | delta.Key) & bit) == 0u || length + 1u + size > FRAME_LENGTH)
+		{
+			continue;
+		}
+		if ((delta.Key & bit) != 0u)
+		{
+			message->Data[0] |= CAN_DELTA_FLAG_KEYFRAME;
+		}
+		message->Data[length] = (uint8_t)(delta.Index[slot] | (delta.Format[slot] << CAN_DELTA_FORMAT_SHIFT));
+		for (i = 0; i < size; i++)
+		{
+			message->Data[length + 1u + i] = (uint8_t)(delta.Current[slot] >> (8u * i));
+		}
+		length = (uint8_t)(length + 1u + size);
+		delta.Shadow[slot] = delta.Current[slot];
+		delta.Changed &= (uint16_t)~bit;
+		delta.Key &= (uint16_t)~bit;
+		last = slot;
+	}
+
+	delta.Next = (uint8_t)((last + 1u) % CAN_DELTA_SLOTS);
+	delta.Sequence++;
+	message->DLC = length;
+	return 1;
+}
+
+/** @} */
@@ -0,0 +1,99 @@
+/**
+*******************************************************************************
+* @file CAN_delta.h
+* @brief Telemetry which only sends the signals that changed
+* @author FRIWO
+* @date 20.10.2026 - 11:26:48
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Keeps a shadow copy of the last sent raw value of up to CAN_DELTA_SLOTS
+* signals of CAN_signals.c. CAN_Delta_Sample() reads the signals and marks
+* those whose raw value moved more than the deadband of their slot away from
+* the shadow copy. CAN_Delta_NextFrame() packs the marked signals into a frame
+* and updates their shadow copy. A keyframe marks every signal, so a receiver
+* which lost frames or started late is complete again after one keyframe.
+*
+* Frame layout, DLC 1...8:
+* - byte 0: bit 7 = frame carries keyframe values, bits 0...3 = sequence counter
+* - then tuples without gaps: a header byte with the signal index in bits
+*   0...5 and the format in bits 6...7, followed by the raw value in Intel byte
+*   order, see CAN_DELTA_FORMAT_*
+* Values are absolute, a tuple does not depend on earlier frames. A gap in the
+* sequence counter tells the receiver that values may be stale until the next
+* keyframe.
+*/
+
+#ifndef CAN_DELTA_H_
+#define CAN_DELTA_H_
+
+/**
+* @addtogroup CAN_delta
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of signals in the telemetry set */
+#define CAN_DELTA_SLOTS 16u
+
+/** @brief highest signal index which fits into a tuple header */
+#define CAN_DELTA_MAX_INDEX 63u
+
+/** @brief bits of the first byte of a frame */
+#define CAN_DELTA_FLAG_KEYFRAME 0x80u
+#define CAN_DELTA_SEQUENCE_MASK 0x0Fu
+
+/** @brief fields of a tuple header */
+#define CAN_DELTA_INDEX_MASK 0x3Fu
+#define CAN_DELTA_FORMAT_SHIFT 6u
+
+/** @brief tuple formats: raw size and signedness */
+#define CAN_DELTA_FORMAT_INT16 0u
+#define CAN_DELTA_FORMAT_INT32 1u
+#define CAN_DELTA_FORMAT_UINT16 2u
+#define CAN_DELTA_FORMAT_UINT32 3u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Empty the telemetry set. Called by the CAN module when its state is initialized.
+ */
+void CAN_Delta_Init(void);
+
+/**
+ * @brief Assign a signal to a slot of the telemetry set. A new signal is sent with the next frame.
+ * @param slot: 0...CAN_DELTA_SLOTS-1
+ * @param index: signal index of CAN_signals.c up to CAN_DELTA_MAX_INDEX, anything else empties the slot
+ * @param deadband: change of the raw value which is not sent yet, 0 = every change is sent [raw LSB]
+ */
+void CAN_Delta_Configure(uint8_t slot, uint8_t index, uint8_t deadband);
+
+/**
+ * @brief Read all signals of the set and mark the changed ones
+ * @param keyframe: 1 to mark every signal regardless of its deadband
+ */
+void CAN_Delta_Sample(uint8_t keyframe);
+
+/**
+ * @brief Pack marked signals into the next frame. Slots are served round robin, so a signal which
+ * changes every time can not starve the others when frames are limited.
+ * @param message: target, only DLC and Data are written
+ * @return 1 if a frame was packed, 0 if no signal is marked
+ */
+uint8_t CAN_Delta_NextFrame(canApi_MessageTypedef *message);
+
+/** @} */
+
+#endif /* CAN_DELTA_H_ */
@@ -0,0 +1,157 @@
+/**
+*******************************************************************************
+* @file CAN_fd.c
+* @brief CAN FD frames and container frames which carry several classic frames
+* @author FRIWO
+* @date 19.10.2026 - 23:58:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_fd
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_fd.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief header size of a contained frame with standard and with extended identifier */
+#define HEADER_SIZE_STD 2u
+#define HEADER_SIZE_EXT 5u
+
+/** @brief flag in the first header byte for an extended identifier */
+#define HEADER_FLAG_EXT 0x80u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE CONSTANTS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief payload length of the data length codes 0...15 */
+static const uint8_t dlcLength_array[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+uint8_t CAN_Fd_DlcToLength(uint8_t dlc)
+{
+	return dlcLength_array[dlc & 0x0Fu];
+}
+
+uint8_t CAN_Fd_LengthToDlc(uint8_t length)
+{
+	uint8_t dlc = 0;
+
+	while (dlc < 15u && dlcLength_array[dlc] < length)
+	{
+		dlc++;
+	}
+	return dlc;
+}
+
+void CAN_Fd_ContainerInit(CAN_Fd_Container_TypeDef *container, uint32_t identifier, uint8_t ide, uint8_t brs)
+{
+	container->Message.Identifier = identifier;
+	container->Message.Priority = 1;
+	container->Message.IDE = ide;
+	container->Message.FDF = 1;
+	container->Message.BRS = brs;
+	container->Message.DLC = 0;
+	container->Length = 0;
+	container->Count = 0;
+}
+
+canApi_StatusTypeDef CAN_Fd_ContainerAdd(CAN_Fd_Container_TypeDef *container, const canApi_MessageTypedef *message)
+{
+	uint8_t *target = &container->Message.Data[container->Length];
+	uint8_t header = (message->IDE != 0) ? HEADER_SIZE_EXT : HEADER_SIZE_STD;
+
+	if (message->RTR != 0 || message->DLC > 8u || (message->IDE == 0 && message->Identifier == 0u && message->DLC == 0u))
+	{
+		return CAN_INVALID_VALUE;
+	}
+	if ((uint32_t)container->Length + header + message->DLC > CAN_FD_MAX_LENGTH)
+	{
+		return CAN_BUFFER_FULL;
+	}
+
+	if (message->IDE != 0)
+	{
+		target[0] = (uint8_t)(HEADER_FLAG_EXT | (message->DLC << 3));
+		target[1] = (uint8_t)((message->Identifier >> 24) & 0x1Fu);
+		target[2] = (uint8_t)(message->Identifier >> 16);
+		target[3] = (uint8_t)(message->Identifier >> 8);
+		target[4] = (uint8_t)message->Identifier;
+	}
+	else
+	{
+		target[0] = (uint8_t)((message->DLC << 3) | ((message->Identifier >> 8) & 0x07u));
+		target[1] = (uint8_t)message->Identifier;
+	}
+	memcpy(&target[header], message->Data, message->DLC);
+	container->Length = (uint8_t)(container->Length + header + message->DLC);
+	container->Count++;
+	return CAN_OK;
+}
+
+void CAN_Fd_ContainerClose(CAN_Fd_Container_TypeDef *container)
+{
+	uint8_t dlc = CAN_Fd_LengthToDlc(container->Length);
+
+	container->Message.DLC = dlc;
+	memset(&container->Message.Data[container->Length], 0, CAN_Fd_DlcToLength(dlc) - container->Length);
+}
+
+uint8_t CAN_Fd_ContainerNext(const CAN_Fd_MessageTypedef *message, uint8_t *offset, canApi_MessageTypedef *contained)
+{
+	uint8_t length = CAN_Fd_DlcToLength(message->DLC);
+	const uint8_t *source = &message->Data[*offset];
+	uint8_t header;
+
+	if (*offset + HEADER_SIZE_STD > length || (source[0] == 0u && source[1] == 0u))
+	{
+		return 0;
+	}
+
+	contained->DLC = (uint8_t)((source[0] >> 3) & 0x0Fu);
+	contained->RTR = 0;
+	contained->Priority = message->Priority;
+	if ((source[0] & HEADER_FLAG_EXT) != 0u)
+	{
+		header = HEADER_SIZE_EXT;
+		if (*offset + header > length)
+		{
+			return 0;
+		}
+		contained->IDE = 1;
+		contained->Identifier = ((uint32_t)(source[1] & 0x1Fu) << 24) | ((uint32_t)source[2] << 16)
+			| ((uint32_t)source[3] << 8) | source[4];
+	}
+	else
+	{
+		header = HEADER_SIZE_STD;
+		contained->IDE = 0;
+		contained->Identifier = ((uint32_t)(source[0] & 0x07u) << 8) | source[1];
+	}
+	if (contained->DLC > 8u || *offset + header + contained->DLC > length)
+	{
+		return 0;
+	}
+
+	memcpy(contained->Data, &source[header], contained->DLC);
+	*offset = (uint8_t)(*offset + header + contained->DLC);
+	return 1;
+}
+
+/** @} */
@@ -0,0 +1,151 @@
+/**
+*******************************************************************************
+* @file CAN_fd.h
+* @brief CAN FD frames and container frames which carry several classic frames
+* @author FRIWO
+* @date 19.10.2026 - 23:58:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* canApi_MessageTypedef of the basic firmware is limited to classic CAN with
+* 8 data bytes. CAN_Fd_MessageTypedef is the FD variant with up to 64 bytes,
+* the FDF and BRS flags and the FD DLC coding.
+*
+* A container frame packs several classic frames into one FD frame. Each
+* contained frame is a header followed by its data bytes:
+* - standard identifier, 2 bytes: 0DDDDIII IIIIIIII
+* - extended identifier, 5 bytes: 1DDDD000 followed by the identifier, MSB first
+* where D is the DLC 0...8 and I the identifier. The rest of the frame is
+* padded with 0x00, so a header 0x00 0x00 ends the container. A standard frame
+* with identifier 0 and DLC 0 can therefore not be contained.
+*
+* The FD peripheral is accessed with CAN_Fd_SendMessage() and
+* CAN_Fd_ReceiveMessage(), which are not part of the canApi. They must be
+* provided by an FD capable basic software, or by the host simulation, when
+* the module is built with CAN_FD_ENABLE.
+*/
+
+#ifndef CAN_FD_H_
+#define CAN_FD_H_
+
+/**
+* @addtogroup CAN_fd
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief maximum payload of an FD frame [byte] */
+#define CAN_FD_MAX_LENGTH 64u
+
+/** @brief identifier of the container frames sent by this module, standard identifier */
+#ifndef CAN_FD_CONTAINER_ID
+#define CAN_FD_CONTAINER_ID 0x1B0u
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Represents a CAN FD or classic CAN message with up to 64 bytes payload
+ */
+typedef struct
+{
+	uint32_t Identifier; /**< @brief standard or extended identifier */
+	uint8_t Priority; /**< @brief priority of the message in a priority buffer */
+	uint8_t IDE; /**< @brief 0x00u = standard frame identifier, 0x01u = extended frame identifier */
+	uint8_t FDF; /**< @brief 0x00u = classic frame, 0x01u = FD frame */
+	uint8_t BRS; /**< @brief 0x01u = data phase with the data bit rate, FD frames only */
+	uint8_t DLC; /**< @brief data length code 0...15, see CAN_Fd_DlcToLength() */
+	uint8_t Data[CAN_FD_MAX_LENGTH]; /**< @brief buffer for the payload */
+}CAN_Fd_MessageTypedef;
+
+/**
+ * @brief Container frame being filled
+ */
+typedef struct
+{
+	CAN_Fd_MessageTypedef Message; /**< @brief frame, valid after CAN_Fd_ContainerClose() */
+	uint8_t Length; /**< @brief bytes used in Message.Data */
+	uint8_t Count; /**< @brief number of contained frames */
+}CAN_Fd_Container_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Get the payload length of a data length code
+ * @param dlc: data length code, 9...15 are FD lengths 12...64
+ * @return payload length [byte]
+ */
+uint8_t CAN_Fd_DlcToLength(uint8_t dlc);
+
+/**
+ * @brief Get the smallest data length code which holds a payload
+ * @param length: payload length, 0...64 [byte]
+ * @return data length code, 15 for lengths above 64
+ */
+uint8_t CAN_Fd_LengthToDlc(uint8_t length);
+
+/**
+ * @brief Start an empty container frame
+ * @param container: container to start
+ * @param identifier: identifier of the container frame
+ * @param ide: 0x00u = standard frame identifier, 0x01u = extended frame identifier
+ * @param brs: 0x01u to send the data phase with the data bit rate
+ */
+void CAN_Fd_ContainerInit(CAN_Fd_Container_TypeDef *container, uint32_t identifier, uint8_t ide, uint8_t brs);
+
+/**
+ * @brief Append a classic frame to a container
+ * @param container: started container
+ * @param message: classic data frame
+ * @return CAN_OK, CAN_BUFFER_FULL if the frame does not fit, CAN_INVALID_VALUE for frames which can not be contained
+ */
+canApi_StatusTypeDef CAN_Fd_ContainerAdd(CAN_Fd_Container_TypeDef *container, const canApi_MessageTypedef *message);
+
+/**
+ * @brief Set DLC and padding of the container frame, afterwards container->Message can be sent
+ * @param container: container with at least one frame
+ */
+void CAN_Fd_ContainerClose(CAN_Fd_Container_TypeDef *container);
+
+/**
+ * @brief Extract the next classic frame from a received container frame
+ * @param message: container frame
+ * @param offset: read position, 0 for the first frame, advanced by the call
+ * @param contained: target pointer to store the classic frame
+ * @return 1 if a frame was extracted, 0 at the end of the container or on a malformed header
+ */
+uint8_t CAN_Fd_ContainerNext(const CAN_Fd_MessageTypedef *message, uint8_t *offset, canApi_MessageTypedef *contained);
+
+/* FD peripheral access, provided by the basic software */
+
+/**
+ * @brief Put an FD message into the transmit buffer of the FD peripheral
+ * @param message: message to send
+ * @return Status of the transmit buffer system
+ */
+canApi_StatusTypeDef CAN_Fd_SendMessage(const CAN_Fd_MessageTypedef *message);
+
+/**
+ * @brief Get an FD message from the receive buffer of the FD peripheral
+ * @param message: Target pointer to store the received message
+ * @return Status of the receive buffer system
+ */
+canApi_StatusTypeDef CAN_Fd_ReceiveMessage(CAN_Fd_MessageTypedef *message);
+
+/** @} */
+
+#endif /* CAN_FD_H_ */
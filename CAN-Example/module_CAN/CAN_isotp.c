@@ -0,0 +1,660 @@
+/**
+*******************************************************************************
+* @file CAN_isotp.c
+* @brief ISO-TP (ISO 15765-2) transport layer on top of the canApi
+* @author FRIWO
+* @date 19.10.2026 - 23:10:52
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_isotp
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_isotp.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief protocol control information, upper nibble of the first byte */
+#define PCI_SINGLE 0x0u
+#define PCI_FIRST 0x1u
+#define PCI_CONSECUTIVE 0x2u
+#define PCI_FLOW_CONTROL 0x3u
+
+/** @brief flow status of a flow control frame */
+#define FLOW_CONTINUE 0x0u
+#define FLOW_WAIT 0x1u
+#define FLOW_OVERFLOW 0x2u
+
+/** @brief no flow control frame to send */
+#define FLOW_NONE 0xFFu
+
+/** @brief largest payload of a first frame with 12 bit length */
+#define FF_DL_12BIT_MAX 4095u
+
+/** @brief storage of the channel state, one set of channels per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_ISOTP_LOCAL _Thread_local
+#else
+#define CAN_ISOTP_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Transmit phase of a channel while its state is CAN_ISOTP_BUSY
+ */
+typedef enum
+{
+	TX_PHASE_FIRST = 0, /**< @brief single or first frame to send */
+	TX_PHASE_WAIT_FLOW = 1, /**< @brief waiting for a flow control */
+	TX_PHASE_CONSECUTIVE = 2 /**< @brief sending consecutive frames */
+}isoTpTxPhase_TypeDef;
+
+/**
+ * @brief Runtime state of one channel
+ */
+typedef struct
+{
+	uint8_t Open; /**< @brief 1 after CAN_IsoTp_Open() */
+	CAN_IsoTp_Config_TypeDef Config; /**< @brief copy of the configuration */
+
+	CAN_IsoTp_State_TypeDef TxState; /**< @brief state of the transmit direction */
+	isoTpTxPhase_TypeDef TxPhase; /**< @brief phase while TxState is CAN_ISOTP_BUSY */
+	const uint8_t *TxData; /**< @brief caller's payload */
+	uint32_t TxLength; /**< @brief payload length */
+	uint32_t TxOffset; /**< @brief bytes sent */
+	uint8_t TxSequence; /**< @brief sequence number of the next consecutive frame */
+	uint8_t TxBlockLeft; /**< @brief consecutive frames left in this block, 0 = no limit */
+	uint8_t TxSTmin; /**< @brief separation time from the receiver, raw coding */
+	uint8_t TxWaitCount; /**< @brief flow control WAIT frames in a row */
+	uint32_t TxTimer; /**< @brief ms left until N_Bs expires, or until the next consecutive frame may be sent */
+
+	CAN_IsoTp_State_TypeDef RxState; /**< @brief state of the receive direction */
+	uint32_t RxLength; /**< @brief announced payload length */
+	uint32_t RxOffset; /**< @brief bytes received */
+	uint8_t RxSequence; /**< @brief expected sequence number */
+	uint8_t RxBlockCount; /**< @brief consecutive frames received in this block */
+	uint32_t RxTimer; /**< @brief ms left until N_Cr expires */
+	uint8_t FlowPending; /**< @brief flow status to send, FLOW_NONE if none */
+}isoTpChannel_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static canApi_StatusTypeDef SendFrame(const isoTpChannel_TypeDef *channel, const uint8_t *data, uint8_t length);
+static uint32_t SeparationTimeMs(uint8_t stmin);
+static void EndTransmission(uint8_t index, CAN_IsoTp_State_TypeDef state);
+static void EndReception(uint8_t index, CAN_IsoTp_State_TypeDef state);
+static void ReceiveSingleFrame(uint8_t index, const canApi_MessageTypedef *message);
+static void ReceiveFirstFrame(uint8_t index, const canApi_MessageTypedef *message);
+static void ReceiveConsecutiveFrame(uint8_t index, const canApi_MessageTypedef *message);
+static void ReceiveFlowControl(uint8_t index, const canApi_MessageTypedef *message);
+static uint32_t ProcessTransmission(uint8_t index, uint32_t budget);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_ISOTP_LOCAL isoTpChannel_TypeDef channel_array[CAN_ISOTP_CHANNELS];
+
+/** @brief channel served first in the next CAN_IsoTp_Process(), so all channels share the budget */
+static CAN_ISOTP_LOCAL uint8_t nextChannel = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Put one frame of a channel into the transmit buffer, padded to 8 bytes
+ * @param channel: sending channel
+ * @param data: PCI and payload
+ * @param length: number of valid bytes in data, 1...8
+ * @return result of canApi_SendMessage()
+ */
+static canApi_StatusTypeDef SendFrame(const isoTpChannel_TypeDef *channel, const uint8_t *data, uint8_t length)
+{
+	canApi_MessageTypedef message;
+
+	message.Identifier = channel->Config.TxIdentifier;
+	message.IDE = channel->Config.IDE;
+	message.RTR = 0;
+	message.DLC = 8;
+	message.Priority = 1;
+	memcpy(message.Data, data, length);
+	memset(&message.Data[length], channel->Config.Padding, 8u - length);
+
+	return canApi_SendMessage(&message);
+}
+
+/**
+ * @brief Convert a separation time to the 1ms grid of CAN_IsoTp_Process()
+ * @param stmin: raw STmin of a flow control frame
+ * @return number of ms between two consecutive frames, 0 = back to back
+ */
+static uint32_t SeparationTimeMs(uint8_t stmin)
+{
+	if (stmin == 0u)
+	{
+		return 0;
+	}
+	if (stmin <= 0x7Fu)
+	{
+		return stmin;
+	}
+	if (stmin >= 0xF1u && stmin <= 0xF9u)
+	{
+		/* 100...900 us, one frame per call keeps the separation */
+		return 1;
+	}
+	/* reserved values are treated as the longest separation time */
+	return 0x7Fu;
+}
+
+static void EndTransmission(uint8_t index, CAN_IsoTp_State_TypeDef state)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+
+	channel->TxState = state;
+	if (channel->Config.OnTransmit != 0)
+	{
+		channel->Config.OnTransmit(index, state, channel->TxLength);
+	}
+}
+
+static void EndReception(uint8_t index, CAN_IsoTp_State_TypeDef state)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+
+	channel->RxState = state;
+	if (channel->Config.OnReceive != 0)
+	{
+		channel->Config.OnReceive(index, state, channel->RxLength);
+	}
+}
+
+static void ReceiveSingleFrame(uint8_t index, const canApi_MessageTypedef *message)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+	uint8_t length = message->Data[0] & 0x0Fu;
+
+	if (length == 0u || length + 1u > message->DLC || channel->RxState == CAN_ISOTP_DONE)
+	{
+		return;
+	}
+	/* a single frame ends a running reception */
+	channel->RxLength = length;
+	if (length > channel->Config.RxBufferSize)
+	{
+		EndReception(index, CAN_ISOTP_ERROR_OVERFLOW);
+		return;
+	}
+	memcpy(channel->Config.RxBuffer, &message->Data[1], length);
+	channel->RxOffset = length;
+	EndReception(index, CAN_ISOTP_DONE);
+}
+
+static void ReceiveFirstFrame(uint8_t index, const canApi_MessageTypedef *message)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+	uint32_t length = ((uint32_t)(message->Data[0] & 0x0Fu) << 8) | message->Data[1];
+	uint8_t start = 2;
+
+	if (message->DLC < 8u)
+	{
+		return;
+	}
+	if (length == 0u)
+	{
+		/* escaped first frame with 32 bit length */
+		length = ((uint32_t)message->Data[2] << 24) | ((uint32_t)message->Data[3] << 16)
+			| ((uint32_t)message->Data[4] << 8) | message->Data[5];
+		start = 6;
+		if (length <= FF_DL_12BIT_MAX)
+		{
+			return;
+		}
+	}
+	else if (length < 8u)
+	{
+		return;
+	}
+	if (channel->RxState == CAN_ISOTP_DONE || length > channel->Config.RxBufferSize)
+	{
+		/* the buffer still holds a payload or is too small */
+		channel->FlowPending = FLOW_OVERFLOW;
+		if (channel->RxState != CAN_ISOTP_DONE)
+		{
+			channel->RxLength = length;
+			EndReception(index, CAN_ISOTP_ERROR_OVERFLOW);
+		}
+		return;
+	}
+
+	channel->RxState = CAN_ISOTP_BUSY;
+	channel->RxLength = length;
+	channel->RxOffset = 8u - start;
+	memcpy(channel->Config.RxBuffer, &message->Data[start], channel->RxOffset);
+	channel->RxSequence = 1;
+	channel->RxBlockCount = 0;
+	channel->RxTimer = CAN_ISOTP_TIMEOUT_MS;
+	channel->FlowPending = FLOW_CONTINUE;
+}
+
+static void ReceiveConsecutiveFrame(uint8_t index, const canApi_MessageTypedef *message)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+	uint32_t count = channel->RxLength - channel->RxOffset;
+
+	if (channel->RxState != CAN_ISOTP_BUSY)
+	{
+		return;
+	}
+	if ((message->Data[0] & 0x0Fu) != channel->RxSequence)
+	{
+		EndReception(index, CAN_ISOTP_ERROR_SEQUENCE);
+		return;
+	}
+	if (count > 7u)
+	{
+		count = 7u;
+	}
+	if (count + 1u > message->DLC)
+	{
+		EndReception(index, CAN_ISOTP_ERROR_SEQUENCE);
+		return;
+	}
+
+	memcpy(&channel->Config.RxBuffer[channel->RxOffset], &message->Data[1], count);
+	channel->RxOffset += count;
+	channel->RxSequence = (uint8_t)((channel->RxSequence + 1u) & 0x0Fu);
+	channel->RxTimer = CAN_ISOTP_TIMEOUT_MS;
+	if (channel->RxOffset >= channel->RxLength)
+	{
+		EndReception(index, CAN_ISOTP_DONE);
+		return;
+	}
+	channel->RxBlockCount++;
+	if (channel->Config.BlockSize != 0u && channel->RxBlockCount >= channel->Config.BlockSize)
+	{
+		channel->RxBlockCount = 0;
+		channel->FlowPending = FLOW_CONTINUE;
+	}
+}
+
+static void ReceiveFlowControl(uint8_t index, const canApi_MessageTypedef *message)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+
+	if (channel->TxState != CAN_ISOTP_BUSY || channel->TxPhase != TX_PHASE_WAIT_FLOW || message->DLC < 3u)
+	{
+		return;
+	}
+	switch (message->Data[0] & 0x0Fu)
+	{
+		case FLOW_CONTINUE:
+			channel->TxPhase = TX_PHASE_CONSECUTIVE;
+			channel->TxBlockLeft = message->Data[1];
+			channel->TxSTmin = message->Data[2];
+			channel->TxWaitCount = 0;
+			channel->TxTimer = 0;
+			break;
+
+		case FLOW_WAIT:
+			channel->TxWaitCount++;
+			if (channel->TxWaitCount > CAN_ISOTP_MAX_WAIT)
+			{
+				EndTransmission(index, CAN_ISOTP_ERROR_TIMEOUT);
+			}
+			else
+			{
+				channel->TxTimer = CAN_ISOTP_TIMEOUT_MS;
+			}
+			break;
+
+		case FLOW_OVERFLOW:
+			EndTransmission(index, CAN_ISOTP_ERROR_OVERFLOW);
+			break;
+
+		default:
+			EndTransmission(index, CAN_ISOTP_ERROR_SEQUENCE);
+			break;
+	}
+}
+
+/**
+ * @brief Send the next frames of a transmission
+ * @param index: channel number
+ * @param budget: maximum number of frames
+ * @return number of frames put into the transmit buffer
+ */
+static uint32_t ProcessTransmission(uint8_t index, uint32_t budget)
+{
+	isoTpChannel_TypeDef *channel = &channel_array[index];
+	uint8_t frame[8];
+	uint32_t sent = 0;
+
+	if (channel->TxState != CAN_ISOTP_BUSY)
+	{
+		return 0;
+	}
+
+	if (channel->TxPhase == TX_PHASE_WAIT_FLOW)
+	{
+		if (channel->TxTimer > 0u)
+		{
+			channel->TxTimer--;
+		}
+		if (channel->TxTimer == 0u)
+		{
+			EndTransmission(index, CAN_ISOTP_ERROR_TIMEOUT);
+		}
+		return 0;
+	}
+
+	if (channel->TxPhase == TX_PHASE_FIRST)
+	{
+		if (budget == 0u)
+		{
+			return 0;
+		}
+		if (channel->TxLength <= 7u)
+		{
+			frame[0] = (uint8_t)((PCI_SINGLE << 4) | channel->TxLength);
+			memcpy(&frame[1], channel->TxData, channel->TxLength);
+			if (SendFrame(channel, frame, (uint8_t)(channel->TxLength + 1u)) != CAN_OK)
+			{
+				return 0;
+			}
+			channel->TxOffset = channel->TxLength;
+			EndTransmission(index, CAN_ISOTP_DONE);
+			return 1;
+		}
+		if (channel->TxLength <= FF_DL_12BIT_MAX)
+		{
+			frame[0] = (uint8_t)((PCI_FIRST << 4) | (channel->TxLength >> 8));
+			frame[1] = (uint8_t)channel->TxLength;
+			channel->TxOffset = 6;
+		}
+		else
+		{
+			frame[0] = (uint8_t)(PCI_FIRST << 4);
+			frame[1] = 0;
+			frame[2] = (uint8_t)(channel->TxLength >> 24);
+			frame[3] = (uint8_t)(channel->TxLength >> 16);
+			frame[4] = (uint8_t)(channel->TxLength >> 8);
+			frame[5] = (uint8_t)channel->TxLength;
+			channel->TxOffset = 2;
+		}
+		memcpy(&frame[8u - channel->TxOffset], channel->TxData, channel->TxOffset);
+		if (SendFrame(channel, frame, 8) != CAN_OK)
+		{
+			channel->TxOffset = 0;
+			return 0;
+		}
+		channel->TxSequence = 1;
+		channel->TxPhase = TX_PHASE_WAIT_FLOW;
+		channel->TxTimer = CAN_ISOTP_TIMEOUT_MS;
+		return 1;
+	}
+
+	/* consecutive frames, back to back up to the budget or one per separation time */
+	if (channel->TxTimer > 0u)
+	{
+		channel->TxTimer--;
+		if (channel->TxTimer > 0u)
+		{
+			return 0;
+		}
+	}
+	while (sent < budget)
+	{
+		uint32_t count = channel->TxLength - channel->TxOffset;
+		uint32_t separation = SeparationTimeMs(channel->TxSTmin);
+
+		if (count > 7u)
+		{
+			count = 7u;
+		}
+		frame[0] = (uint8_t)((PCI_CONSECUTIVE << 4) | channel->TxSequence);
+		memcpy(&frame[1], &channel->TxData[channel->TxOffset], count);
+		if (SendFrame(channel, frame, (uint8_t)(count + 1u)) != CAN_OK)
+		{
+			break;
+		}
+		sent++;
+		channel->TxOffset += count;
+		channel->TxSequence = (uint8_t)((channel->TxSequence + 1u) & 0x0Fu);
+		if (channel->TxOffset >= channel->TxLength)
+		{
+			EndTransmission(index, CAN_ISOTP_DONE);
+			break;
+		}
+		if (channel->TxBlockLeft != 0u)
+		{
+			channel->TxBlockLeft--;
+			if (channel->TxBlockLeft == 0u)
+			{
+				channel->TxPhase = TX_PHASE_WAIT_FLOW;
+				channel->TxTimer = CAN_ISOTP_TIMEOUT_MS;
+				break;
+			}
+		}
+		if (separation != 0u)
+		{
+			channel->TxTimer = separation;
+			break;
+		}
+	}
+	return sent;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_IsoTp_Init(void)
+{
+	memset(channel_array, 0, sizeof(channel_array));
+	nextChannel = 0;
+}
+
+canApi_StatusTypeDef CAN_IsoTp_Open(uint8_t channel, const CAN_IsoTp_Config_TypeDef *config)
+{
+	isoTpChannel_TypeDef *entry;
+
+	if (channel >= CAN_ISOTP_CHANNELS || config == 0 || (config->RxBuffer == 0 && config->RxBufferSize != 0u))
+	{
+		return CAN_INVALID_VALUE;
+	}
+	entry = &channel_array[channel];
+	memset(entry, 0, sizeof(*entry));
+	entry->Config = *config;
+	entry->FlowPending = FLOW_NONE;
+	entry->Open = 1;
+	return CAN_OK;
+}
+
+void CAN_IsoTp_Close(uint8_t channel)
+{
+	if (channel < CAN_ISOTP_CHANNELS)
+	{
+		memset(&channel_array[channel], 0, sizeof(channel_array[channel]));
+	}
+}
+
+canApi_StatusTypeDef CAN_IsoTp_Send(uint8_t channel, const uint8_t *data, uint32_t length)
+{
+	isoTpChannel_TypeDef *entry;
+
+	if (channel >= CAN_ISOTP_CHANNELS || channel_array[channel].Open == 0u || data == 0 || length == 0u)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	entry = &channel_array[channel];
+	if (entry->TxState == CAN_ISOTP_BUSY)
+	{
+		return CAN_BUFFER_FULL;
+	}
+	entry->TxData = data;
+	entry->TxLength = length;
+	entry->TxOffset = 0;
+	entry->TxPhase = TX_PHASE_FIRST;
+	entry->TxWaitCount = 0;
+	entry->TxState = CAN_ISOTP_BUSY;
+	return CAN_OK;
+}
+
+CAN_IsoTp_State_TypeDef CAN_IsoTp_GetTxState(uint8_t channel)
+{
+	return (channel < CAN_ISOTP_CHANNELS) ? channel_array[channel].TxState : CAN_ISOTP_IDLE;
+}
+
+CAN_IsoTp_State_TypeDef CAN_IsoTp_GetRxState(uint8_t channel, uint32_t *length)
+{
+	if (channel >= CAN_ISOTP_CHANNELS)
+	{
+		return CAN_ISOTP_IDLE;
+	}
+	if (length != 0)
+	{
+		*length = channel_array[channel].RxLength;
+	}
+	return channel_array[channel].RxState;
+}
+
+canApi_StatusTypeDef CAN_IsoTp_SetRxBuffer(uint8_t channel, uint8_t *buffer, uint32_t size)
+{
+	isoTpChannel_TypeDef *entry;
+
+	if (channel >= CAN_ISOTP_CHANNELS || channel_array[channel].Open == 0u || buffer == 0)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	entry = &channel_array[channel];
+	if (entry->RxState == CAN_ISOTP_BUSY)
+	{
+		return CAN_ERROR;
+	}
+	entry->Config.RxBuffer = buffer;
+	entry->Config.RxBufferSize = size;
+	return CAN_OK;
+}
+
+void CAN_IsoTp_Release(uint8_t channel)
+{
+	if (channel < CAN_ISOTP_CHANNELS && channel_array[channel].RxState == CAN_ISOTP_DONE)
+	{
+		channel_array[channel].RxState = CAN_ISOTP_IDLE;
+	}
+}
+
+uint8_t CAN_IsoTp_Receive(const canApi_MessageTypedef *message)
+{
+	uint8_t i;
+
+	if (message->RTR != 0 || message->DLC == 0)
+	{
+		return 0;
+	}
+	for (i = 0; i < CAN_ISOTP_CHANNELS; i++)
+	{
+		isoTpChannel_TypeDef *channel = &channel_array[i];
+
+		if (channel->Open == 0u || channel->Config.RxIdentifier != message->Identifier || channel->Config.IDE != message->IDE)
+		{
+			continue;
+		}
+		switch (message->Data[0] >> 4)
+		{
+			case PCI_SINGLE:
+				if (channel->Config.RxBuffer != 0)
+				{
+					ReceiveSingleFrame(i, message);
+				}
+				break;
+
+			case PCI_FIRST:
+				if (channel->Config.RxBuffer != 0)
+				{
+					ReceiveFirstFrame(i, message);
+				}
+				break;
+
+			case PCI_CONSECUTIVE:
+				ReceiveConsecutiveFrame(i, message);
+				break;
+
+			case PCI_FLOW_CONTROL:
+				ReceiveFlowControl(i, message);
+				break;
+
+			default:
+				break;
+		}
+		return 1;
+	}
+	return 0;
+}
+
+void CAN_IsoTp_Process(uint32_t budget)
+{
+	uint8_t n;
+
+	/* receive direction: flow control frames and N_Cr */
+	for (n = 0; n < CAN_ISOTP_CHANNELS; n++)
+	{
+		isoTpChannel_TypeDef *channel = &channel_array[n];
+
+		if (channel->Open == 0u)
+		{
+			continue;
+		}
+		if (channel->FlowPending != FLOW_NONE)
+		{
+			uint8_t frame[3];
+
+			frame[0] = (uint8_t)((PCI_FLOW_CONTROL << 4) | channel->FlowPending);
+			frame[1] = channel->Config.BlockSize;
+			frame[2] = channel->Config.STmin;
+			if (SendFrame(channel, frame, 3) == CAN_OK)
+			{
+				channel->FlowPending = FLOW_NONE;
+			}
+		}
+		if (channel->RxState == CAN_ISOTP_BUSY)
+		{
+			channel->RxTimer--;
+			if (channel->RxTimer == 0u)
+			{
+				EndReception(n, CAN_ISOTP_ERROR_TIMEOUT);
+			}
+		}
+	}
+
+	/* transmit direction, the first channel rotates so all channels share the budget */
+	for (n = 0; n < CAN_ISOTP_CHANNELS; n++)
+	{
+		uint8_t index = (uint8_t)((nextChannel + n) % CAN_ISOTP_CHANNELS);
+		uint32_t sent = ProcessTransmission(index, budget);
+
+		budget -= sent;
+	}
+	nextChannel = (uint8_t)((nextChannel + 1u) % CAN_ISOTP_CHANNELS);
+}
+
+/** @} */
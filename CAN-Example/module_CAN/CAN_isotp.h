@@ -0,0 +1,184 @@
+/**
+*******************************************************************************
+* @file CAN_isotp.h
+* @brief ISO-TP (ISO 15765-2) transport layer on top of the canApi
+* @author FRIWO
+* @date 19.10.2026 - 23:10:52
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Moves payloads larger than one CAN frame with single, first, consecutive
+* and flow control frames, normal addressing, classic CAN with 8 byte frames.
+* Payloads above 4095 bytes use the escaped first frame with 32 bit length.
+*
+* Each channel is a pair of identifiers and works in both directions at the
+* same time. Nothing is copied: a transmission reads from the caller's buffer
+* while it runs, a reception writes into the buffer given to CAN_IsoTp_Open()
+* or CAN_IsoTp_SetRxBuffer() and the data stays there until CAN_IsoTp_Release().
+*
+* CAN_custom.c passes every received message which is not listed in
+* msgManagment_array to CAN_IsoTp_Receive() and calls CAN_IsoTp_Process()
+* once per canApi_UserPeriodicCallBack(). Nothing blocks: a consecutive frame
+* which does not fit into the transmit buffer is sent in the next millisecond.
+* The receive identifier of a channel must pass a filter bank set in
+* canApi_UserInitCallBack().
+*/
+
+#ifndef CAN_ISOTP_H_
+#define CAN_ISOTP_H_
+
+/**
+* @addtogroup CAN_isotp
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of channels */
+#ifndef CAN_ISOTP_CHANNELS
+#define CAN_ISOTP_CHANNELS 4u
+#endif
+
+/** @brief N_Bs and N_Cr: time to wait for a flow control or the next consecutive frame [ms] */
+#ifndef CAN_ISOTP_TIMEOUT_MS
+#define CAN_ISOTP_TIMEOUT_MS 1000u
+#endif
+
+/** @brief maximum number of flow control WAIT frames in a row before a transmission is aborted */
+#ifndef CAN_ISOTP_MAX_WAIT
+#define CAN_ISOTP_MAX_WAIT 10u
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief State of the transmit or the receive direction of a channel
+ */
+typedef enum
+{
+	CAN_ISOTP_IDLE = 0, /**< @brief no transfer */
+	CAN_ISOTP_BUSY = 1, /**< @brief transfer running */
+	CAN_ISOTP_DONE = 2, /**< @brief transfer complete, a received payload is kept until CAN_IsoTp_Release() */
+	CAN_ISOTP_ERROR_TIMEOUT = 3, /**< @brief no flow control or consecutive frame within CAN_ISOTP_TIMEOUT_MS */
+	CAN_ISOTP_ERROR_OVERFLOW = 4, /**< @brief payload larger than the receive buffer, or the receiver reported overflow */
+	CAN_ISOTP_ERROR_SEQUENCE = 5 /**< @brief wrong sequence number or invalid frame */
+}CAN_IsoTp_State_TypeDef;
+
+/**
+ * @brief Called at the end of a transfer from CAN_IsoTp_Receive() or CAN_IsoTp_Process()
+ * @param channel: channel number
+ * @param state: CAN_ISOTP_DONE or an error state
+ * @param length: payload length [byte]
+ */
+typedef void (*CAN_IsoTp_FptrComplete)(uint8_t channel, CAN_IsoTp_State_TypeDef state, uint32_t length);
+
+/**
+ * @brief Configuration of one channel
+ */
+typedef struct
+{
+	uint32_t TxIdentifier; /**< @brief identifier of the frames we send */
+	uint32_t RxIdentifier; /**< @brief identifier of the frames we receive */
+	uint8_t IDE; /**< @brief 0x00u = standard, 0x01u = extended identifiers */
+	uint8_t BlockSize; /**< @brief consecutive frames we accept per flow control, 0 = all */
+	uint8_t STmin; /**< @brief separation time we request, ISO 15765-2 coding: 0...127 ms, 0xF1...0xF9 = 100...900 us */
+	uint8_t Padding; /**< @brief fill byte, all frames are sent with DLC 8 */
+	uint8_t *RxBuffer; /**< @brief receive buffer, 0 for a transmit-only channel */
+	uint32_t RxBufferSize; /**< @brief size of the receive buffer [byte] */
+	CAN_IsoTp_FptrComplete OnReceive; /**< @brief called when a reception ends, may be 0 */
+	CAN_IsoTp_FptrComplete OnTransmit; /**< @brief called when a transmission ends, may be 0 */
+}CAN_IsoTp_Config_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Close all channels. Called by the CAN module when its state is initialized.
+ */
+void CAN_IsoTp_Init(void);
+
+/**
+ * @brief Open a channel, a running transfer on it is dropped
+ * @param channel: 0...CAN_ISOTP_CHANNELS-1
+ * @param config: configuration, copied
+ * @return CAN_OK, CAN_INVALID_VALUE on a wrong channel number or configuration
+ */
+canApi_StatusTypeDef CAN_IsoTp_Open(uint8_t channel, const CAN_IsoTp_Config_TypeDef *config);
+
+/**
+ * @brief Close a channel, running transfers are dropped without callback
+ * @param channel: 0...CAN_ISOTP_CHANNELS-1
+ */
+void CAN_IsoTp_Close(uint8_t channel);
+
+/**
+ * @brief Start a transmission. The data is read from the caller's buffer until the transmission ends.
+ * @param channel: open channel
+ * @param data: payload, must stay valid and unchanged until the state is no longer CAN_ISOTP_BUSY
+ * @param length: payload length, 1...0xFFFFFFFF [byte]
+ * @return CAN_OK, CAN_BUFFER_FULL if a transmission is running, CAN_INVALID_VALUE on wrong arguments
+ */
+canApi_StatusTypeDef CAN_IsoTp_Send(uint8_t channel, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Get the state of the transmit direction
+ * @param channel: 0...CAN_ISOTP_CHANNELS-1
+ * @return state of the last transmission
+ */
+CAN_IsoTp_State_TypeDef CAN_IsoTp_GetTxState(uint8_t channel);
+
+/**
+ * @brief Get the state of the receive direction
+ * @param channel: 0...CAN_ISOTP_CHANNELS-1
+ * @param length: target pointer for the payload length, may be 0
+ * @return state of the last reception, CAN_ISOTP_DONE while the payload waits in the receive buffer
+ */
+CAN_IsoTp_State_TypeDef CAN_IsoTp_GetRxState(uint8_t channel, uint32_t *length);
+
+/**
+ * @brief Change the receive buffer of an open channel, e.g. to take the next payload while the last
+ * one is still used. Not possible during a reception; a payload which waits for CAN_IsoTp_Release()
+ * stays in the old buffer.
+ * @param channel: open channel
+ * @param buffer: new receive buffer
+ * @param size: size of the new receive buffer [byte]
+ * @return CAN_OK, CAN_ERROR during a reception, CAN_INVALID_VALUE on wrong arguments
+ */
+canApi_StatusTypeDef CAN_IsoTp_SetRxBuffer(uint8_t channel, uint8_t *buffer, uint32_t size);
+
+/**
+ * @brief Hand the receive buffer back after a payload was processed.
+ * Until then a new first frame is rejected with a flow control overflow and single frames are dropped.
+ * @param channel: 0...CAN_ISOTP_CHANNELS-1
+ */
+void CAN_IsoTp_Release(uint8_t channel);
+
+/**
+ * @brief Process a received message
+ * @param message: received message
+ * @return 1 if the message belongs to an open channel, else 0
+ */
+uint8_t CAN_IsoTp_Receive(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Send pending flow control and consecutive frames and run the timeouts, call every 1ms
+ * @param budget: maximum number of single, first and consecutive frames put into the transmit buffer
+ * in this call, flow control frames are always sent
+ */
+void CAN_IsoTp_Process(uint32_t budget);
+
+/** @} */
+
+#endif /* CAN_ISOTP_H_ */
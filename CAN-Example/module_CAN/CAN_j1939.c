@@ -0,0 +1,1000 @@
+/**
+*******************************************************************************
+* @file CAN_j1939.c
+* @brief SAE J1939 network layer: address claiming, PGN dispatch and transport protocol
+* @author FRIWO
+* @date 20.10.2026 - 17:36:50
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_j1939
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_j1939.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief fields of the 29 bit identifier */
+#define ID_PRIORITY_SHIFT 26u
+#define ID_PGN_SHIFT 8u
+#define PGN_MASK 0x3FFFFu
+#define PGN_PDU1_MASK 0x3FF00u
+#define PDU2_FORMAT_MIN 240u
+
+/** @brief filter masks: data page and PDU format, for PDU2 also PDU specific */
+#define FILTER_MASK_PDU1 (PGN_PDU1_MASK << ID_PGN_SHIFT)
+#define FILTER_MASK_PDU2 (PGN_MASK << ID_PGN_SHIFT)
+
+/** @brief priority of the network management and transport protocol frames */
+#define PRIORITY_CLAIM 6u
+#define PRIORITY_TRANSPORT 7u
+
+/** @brief control bytes of TP.CM */
+#define TP_CM_RTS 16u
+#define TP_CM_CTS 17u
+#define TP_CM_EOMA 19u
+#define TP_CM_BAM 32u
+#define TP_CM_ABORT 255u
+
+/** @brief abort reasons */
+#define ABORT_BUSY 1u
+#define ABORT_RESOURCES 2u
+#define ABORT_TIMEOUT 3u
+#define ABORT_BAD_SEQUENCE 7u
+
+/** @brief connection management frame to send for a receive session */
+#define CM_NONE 0u
+#define CM_CTS 1u
+#define CM_EOMA 2u
+
+/** @brief timeouts of J1939-21 and J1939-81 [ms] */
+#define TIMEOUT_T1_MS 750u /**< @brief receiver: between two data packets */
+#define TIMEOUT_T2_MS 1250u /**< @brief receiver: after a CTS */
+#define TIMEOUT_T3_MS 1250u /**< @brief sender: after the last packet or the RTS */
+#define TIMEOUT_T4_MS 1050u /**< @brief sender: after a CTS with 0 packets (hold) */
+#define CLAIM_WAIT_MS 250u /**< @brief after an address claim */
+
+/** @brief range of the addresses for self-configurable controller applications */
+#define ADDRESS_ARBITRARY_FIRST 128u
+#define ADDRESS_ARBITRARY_LAST 247u
+
+/** @brief data bytes per TP.DT packet */
+#define PACKET_DATA 7u
+
+/** @brief fill byte of unused bytes */
+#define PADDING 0xFFu
+
+#define PROTOCOL_PGNS (sizeof(protocolPgn_array) / sizeof(protocolPgn_array[0]))
+
+/** @brief storage of the layer state, one controller application per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_J1939_LOCAL _Thread_local
+#else
+#define CAN_J1939_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Transmit phase while the transport state is CAN_J1939_BUSY
+ */
+typedef enum
+{
+	TX_PHASE_ANNOUNCE = 0, /**< @brief BAM or RTS to send */
+	TX_PHASE_BAM_DATA = 1, /**< @brief BAM packets, one per CAN_J1939_BAM_INTERVAL_MS */
+	TX_PHASE_WAIT = 2, /**< @brief waiting for a CTS or the end of message acknowledge */
+	TX_PHASE_DATA = 3 /**< @brief sending the packets of a CTS */
+}j1939TxPhase_TypeDef;
+
+/**
+ * @brief One transport protocol reception
+ */
+typedef struct
+{
+	uint8_t Active; /**< @brief 1 while packets are expected or a CTS/EOMA is pending */
+	uint8_t Bam; /**< @brief 1 for BAM, 0 for RTS/CTS */
+	uint8_t Source; /**< @brief address of the sender */
+	uint8_t Destination; /**< @brief own address or CAN_J1939_ADDRESS_GLOBAL */
+	uint32_t Pgn; /**< @brief PGN of the transported message */
+	uint16_t Length; /**< @brief message size [byte] */
+	uint8_t Packets; /**< @brief number of packets */
+	uint8_t NextPacket; /**< @brief sequence number expected next */
+	uint8_t WindowEnd; /**< @brief last packet of the current CTS */
+	uint8_t MaxPerCts; /**< @brief limit of the sender for one CTS */
+	uint8_t PendingCm; /**< @brief CM_NONE, CM_CTS or CM_EOMA */
+	uint16_t Timer; /**< @brief time left until the session is aborted [ms] */
+	uint8_t Buffer[CAN_J1939_RX_SIZE]; /**< @brief reassembled message */
+}j1939RxSession_TypeDef;
+
+/**
+ * @brief Complete state of the layer
+ */
+typedef struct
+{
+	uint8_t Open; /**< @brief 1 after CAN_J1939_Open() */
+	CAN_J1939_Config_TypeDef Config; /**< @brief copy of the configuration */
+
+	uint8_t Address; /**< @brief claimed or claiming address, CAN_J1939_ADDRESS_NULL when lost */
+	CAN_J1939_State_TypeDef AddressState; /**< @brief state of the claim */
+	uint8_t ClaimPending; /**< @brief 1 if an address claim or Cannot Claim has to be sent */
+	uint16_t ClaimTimer; /**< @brief time until the claimed address may be used [ms] */
+	uint8_t Claimed[32]; /**< @brief bitmap of the addresses claimed by other nodes */
+
+	CAN_J1939_State_TypeDef TxState; /**< @brief state of the transport transmission */
+	j1939TxPhase_TypeDef TxPhase; /**< @brief phase while TxState is CAN_J1939_BUSY */
+	const uint8_t *TxData; /**< @brief caller's payload */
+	uint16_t TxLength; /**< @brief payload length */
+	uint32_t TxPgn; /**< @brief PGN of the payload */
+	uint8_t TxDestination; /**< @brief receiver, CAN_J1939_ADDRESS_GLOBAL for BAM */
+	uint8_t TxPackets; /**< @brief number of packets */
+	uint8_t TxNextPacket; /**< @brief sequence number of the next packet */
+	uint8_t TxWindowEnd; /**< @brief last packet allowed by the CTS */
+	uint16_t TxTimer; /**< @brief BAM: time until the next packet, RTS/CTS: time left to wait [ms] */
+
+	uint8_t AbortPending; /**< @brief 1 if an abort has to be sent */
+	uint8_t AbortDestination; /**< @brief receiver of the abort */
+	uint8_t AbortReason; /**< @brief reason of the abort */
+	uint32_t AbortPgn; /**< @brief PGN of the aborted session */
+
+	j1939RxSession_TypeDef Rx[CAN_J1939_RX_SESSIONS]; /**< @brief receive sessions */
+}j1939State_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static uint8_t IsPdu1(uint32_t pgn);
+static uint8_t IsProtocolPgn(uint32_t pgn);
+static const CAN_J1939_Pgn_TypeDef* FindPgn(uint32_t pgn);
+static uint8_t HasAddress(void);
+static canApi_StatusTypeDef SendFrame(uint32_t pgn, uint8_t priority, uint8_t destination, const uint8_t *data, uint8_t length);
+static canApi_StatusTypeDef SendConnectionManagement(uint8_t destination, uint8_t control, uint8_t byte1, uint8_t byte2,
+	uint8_t byte3, uint8_t byte4, uint32_t pgn);
+static void Dispatch(uint32_t pgn, uint8_t source, uint8_t destination, const uint8_t *data, uint32_t length);
+static void QueueAbort(uint8_t destination, uint8_t reason, uint32_t pgn);
+static void ClaimNextAddress(void);
+static void ReceiveAddressClaimed(uint8_t source, const uint8_t *data);
+static j1939RxSession_TypeDef* FindSession(uint8_t source, uint8_t bam);
+static void ReceiveConnectionManagement(uint8_t source, uint8_t destination, const uint8_t *data);
+static void ReceiveDataTransfer(uint8_t source, uint8_t destination, const uint8_t *data);
+static void OpenWindow(j1939RxSession_TypeDef *session);
+static void ProcessReception(void);
+static void ProcessTransmission(uint32_t budget);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE CONSTANTS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief PGNs the layer receives itself, they get the first filter banks */
+static const uint32_t protocolPgn_array[] =
+{
+	CAN_J1939_PGN_ADDRESS_CLAIMED,
+	CAN_J1939_PGN_REQUEST,
+	CAN_J1939_PGN_TP_CM,
+	CAN_J1939_PGN_TP_DT,
+};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_J1939_LOCAL j1939State_TypeDef j1939;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief PDU1 PGNs are sent to a destination, PDU2 PGNs are broadcast
+ */
+static uint8_t IsPdu1(uint32_t pgn)
+{
+	return (uint8_t)(((pgn >> 8) & 0xFFu) < PDU2_FORMAT_MIN);
+}
+
+/**
+ * @brief Check if the layer handles a PGN itself
+ */
+static uint8_t IsProtocolPgn(uint32_t pgn)
+{
+	uint8_t i;
+
+	for (i = 0; i < PROTOCOL_PGNS; i++)
+	{
+		if (protocolPgn_array[i] == pgn)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Binary search in the PGN table of the configuration
+ * @return entry or 0
+ */
+static const CAN_J1939_Pgn_TypeDef* FindPgn(uint32_t pgn)
+{
+	uint8_t low = 0;
+	uint8_t high = j1939.Config.PgnCount;
+
+	while (low < high)
+	{
+		uint8_t middle = (uint8_t)((low + high) / 2u);
+		const CAN_J1939_Pgn_TypeDef *entry = &j1939.Config.PgnTable[middle];
+
+		if (entry->Pgn == pgn)
+		{
+			return entry;
+		}
+		if (entry->Pgn < pgn)
+		{
+			low = (uint8_t)(middle + 1u);
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Check if messages to the own address are accepted: during and after the claim
+ */
+static uint8_t HasAddress(void)
+{
+	return (uint8_t)(j1939.AddressState == CAN_J1939_BUSY || j1939.AddressState == CAN_J1939_DONE);
+}
+
+/**
+ * @brief Put one frame with the own source address into the transmit buffer
+ * @param pgn: PGN, PS of a PDU1 PGN is replaced by destination
+ * @param length: 0...8, the DLC is the length
+ */
+static canApi_StatusTypeDef SendFrame(uint32_t pgn, uint8_t priority, uint8_t destination, const uint8_t *data, uint8_t length)
+{
+	canApi_MessageTypedef message;
+
+	if (IsPdu1(pgn) != 0u)
+	{
+		pgn = (pgn & PGN_PDU1_MASK) | destination;
+	}
+	message.Identifier = ((uint32_t)(priority & 0x07u) << ID_PRIORITY_SHIFT) | ((pgn & PGN_MASK) << ID_PGN_SHIFT) | j1939.Address;
+	message.IDE = 1;
+	message.RTR = 0;
+	message.DLC = length;
+	message.Priority = 1;
+	memcpy(message.Data, data, length);
+
+	return canApi_SendMessage(&message);
+}
+
+/**
+ * @brief Send a TP.CM frame, the PGN of the transported message is in bytes 5...7
+ */
+static canApi_StatusTypeDef SendConnectionManagement(uint8_t destination, uint8_t control, uint8_t byte1, uint8_t byte2,
+	uint8_t byte3, uint8_t byte4, uint32_t pgn)
+{
+	uint8_t data[8];
+
+	data[0] = control;
+	data[1] = byte1;
+	data[2] = byte2;
+	data[3] = byte3;
+	data[4] = byte4;
+	data[5] = (uint8_t)pgn;
+	data[6] = (uint8_t)(pgn >> 8);
+	data[7] = (uint8_t)(pgn >> 16);
+	return SendFrame(CAN_J1939_PGN_TP_CM, PRIORITY_TRANSPORT, destination, data, 8);
+}
+
+/**
+ * @brief Pass a complete message to the function of its PGN
+ */
+static void Dispatch(uint32_t pgn, uint8_t source, uint8_t destination, const uint8_t *data, uint32_t length)
+{
+	const CAN_J1939_Pgn_TypeDef *entry = FindPgn(pgn);
+
+	if (entry != 0 && entry->ReceiveFunction != 0)
+	{
+		entry->ReceiveFunction(pgn, source, destination, data, length);
+	}
+}
+
+/**
+ * @brief Remember an abort, sent in the next CAN_J1939_Process(). A newer abort replaces an unsent one.
+ */
+static void QueueAbort(uint8_t destination, uint8_t reason, uint32_t pgn)
+{
+	j1939.AbortPending = 1;
+	j1939.AbortDestination = destination;
+	j1939.AbortReason = reason;
+	j1939.AbortPgn = pgn;
+}
+
+/**
+ * @brief The own address was lost: claim the next free address of the arbitrary range
+ * if the NAME allows it, else give up with Cannot Claim
+ */
+static void ClaimNextAddress(void)
+{
+	uint8_t range = ADDRESS_ARBITRARY_LAST - ADDRESS_ARBITRARY_FIRST + 1u;
+	uint8_t start = 0;
+	uint8_t i;
+
+	j1939.ClaimPending = 1;
+	if ((j1939.Config.Name & CAN_J1939_NAME_ARBITRARY_ADDRESS) != 0u)
+	{
+		if (j1939.Address >= ADDRESS_ARBITRARY_FIRST && j1939.Address <= ADDRESS_ARBITRARY_LAST)
+		{
+			start = (uint8_t)(j1939.Address - ADDRESS_ARBITRARY_FIRST + 1u);
+		}
+		for (i = 0; i < range; i++)
+		{
+			uint8_t candidate = (uint8_t)(ADDRESS_ARBITRARY_FIRST + (start + i) % range);
+
+			if ((j1939.Claimed[candidate >> 3] & (1u << (candidate & 7u))) == 0u)
+			{
+				j1939.Address = candidate;
+				j1939.AddressState = CAN_J1939_BUSY;
+				return;
+			}
+		}
+	}
+	j1939.Address = CAN_J1939_ADDRESS_NULL;
+	j1939.AddressState = CAN_J1939_ERROR_NO_ADDRESS;
+	j1939.TxState = (j1939.TxState == CAN_J1939_BUSY) ? CAN_J1939_ERROR_NO_ADDRESS : j1939.TxState;
+}
+
+/**
+ * @brief Address claimed by another node: defend the own address with a lower NAME, else give it up
+ */
+static void ReceiveAddressClaimed(uint8_t source, const uint8_t *data)
+{
+	uint64_t name = 0;
+	uint8_t i;
+
+	if (source >= CAN_J1939_ADDRESS_NULL)
+	{
+		return;
+	}
+	for (i = 0; i < 8u; i++)
+	{
+		name |= (uint64_t)data[i] << (8u * i);
+	}
+	j1939.Claimed[source >> 3] |= (uint8_t)(1u << (source & 7u));
+
+	if (HasAddress() == 0u || source != j1939.Address)
+	{
+		return;
+	}
+	if (j1939.Config.Name < name)
+	{
+		j1939.ClaimPending = 1;
+	}
+	else
+	{
+		ClaimNextAddress();
+	}
+}
+
+/**
+ * @brief Get the receive session of a sender, a BAM and a RTS/CTS session may run side by side
+ * @return session or 0
+ */
+static j1939RxSession_TypeDef* FindSession(uint8_t source, uint8_t bam)
+{
+	uint8_t i;
+
+	for (i = 0; i < CAN_J1939_RX_SESSIONS; i++)
+	{
+		j1939RxSession_TypeDef *session = &j1939.Rx[i];
+
+		if (session->Active != 0u && session->Source == source && session->Bam == bam)
+		{
+			return session;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Allow the next packets of a RTS/CTS reception, sent as CTS in the next CAN_J1939_Process()
+ */
+static void OpenWindow(j1939RxSession_TypeDef *session)
+{
+	uint32_t end = (uint32_t)session->NextPacket + session->MaxPerCts - 1u;
+
+	session->WindowEnd = (uint8_t)((end < session->Packets) ? end : session->Packets);
+	session->PendingCm = CM_CTS;
+	session->Timer = TIMEOUT_T2_MS;
+}
+
+/**
+ * @brief TP.CM: start of a reception, CTS, end of message acknowledge or abort of the own transmission
+ */
+static void ReceiveConnectionManagement(uint8_t source, uint8_t destination, const uint8_t *data)
+{
+	uint32_t pgn = (uint32_t)data[5] | ((uint32_t)data[6] << 8) | ((uint32_t)data[7] << 16);
+	uint16_t length = (uint16_t)(data[1] | (data[2] << 8));
+	j1939RxSession_TypeDef *session;
+	uint8_t bam = (uint8_t)(data[0] == TP_CM_BAM);
+	uint8_t i;
+
+	switch (data[0])
+	{
+		case TP_CM_RTS:
+		case TP_CM_BAM:
+			if (bam != (uint8_t)(destination == CAN_J1939_ADDRESS_GLOBAL))
+			{
+				return; /* BAM to a destination or RTS to the global address */
+			}
+			session = FindSession(source, bam);
+			for (i = 0; i < CAN_J1939_RX_SESSIONS && session == 0; i++)
+			{
+				if (j1939.Rx[i].Active == 0u)
+				{
+					session = &j1939.Rx[i];
+				}
+			}
+			if (session == 0 || length > CAN_J1939_RX_SIZE || length <= 8u
+				|| (uint32_t)data[3] * PACKET_DATA < length || data[3] == 0u)
+			{
+				if (bam == 0u)
+				{
+					QueueAbort(source, (session == 0) ? ABORT_BUSY : ABORT_RESOURCES, pgn);
+				}
+				if (session != 0 && session->Active != 0u)
+				{
+					session->Active = 0;
+				}
+				return;
+			}
+			session->Active = 1;
+			session->Bam = bam;
+			session->Source = source;
+			session->Destination = destination;
+			session->Pgn = pgn;
+			session->Length = length;
+			session->Packets = data[3];
+			session->NextPacket = 1;
+			session->MaxPerCts = (bam != 0u || data[4] == 0u) ? 0xFFu : data[4];
+			session->PendingCm = CM_NONE;
+			session->Timer = TIMEOUT_T1_MS;
+			if (bam == 0u)
+			{
+				OpenWindow(session);
+			}
+			break;
+
+		case TP_CM_CTS:
+			if (j1939.TxState != CAN_J1939_BUSY || j1939.TxPhase != TX_PHASE_WAIT || source != j1939.TxDestination
+				|| pgn != j1939.TxPgn)
+			{
+				return;
+			}
+			if (data[1] == 0u)
+			{
+				j1939.TxTimer = TIMEOUT_T4_MS; /* hold the connection */
+				return;
+			}
+			if (data[2] == 0u || data[2] > j1939.TxPackets)
+			{
+				QueueAbort(source, ABORT_BAD_SEQUENCE, pgn);
+				j1939.TxState = CAN_J1939_ERROR_ABORT;
+				return;
+			}
+			j1939.TxNextPacket = data[2];
+			j1939.TxWindowEnd = (uint8_t)(((uint32_t)data[2] + data[1] - 1u < j1939.TxPackets) ? data[2] + data[1] - 1u : j1939.TxPackets);
+			j1939.TxPhase = TX_PHASE_DATA;
+			break;
+
+		case TP_CM_EOMA:
+			if (j1939.TxState == CAN_J1939_BUSY && j1939.TxPhase == TX_PHASE_WAIT && source == j1939.TxDestination
+				&& pgn == j1939.TxPgn)
+			{
+				j1939.TxState = CAN_J1939_DONE;
+			}
+			break;
+
+		case TP_CM_ABORT:
+			if (j1939.TxState == CAN_J1939_BUSY && source == j1939.TxDestination && pgn == j1939.TxPgn)
+			{
+				j1939.TxState = CAN_J1939_ERROR_ABORT;
+			}
+			session = FindSession(source, 0);
+			if (session != 0 && session->Pgn == pgn)
+			{
+				session->Active = 0;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief TP.DT: one packet of a reception, the complete message is dispatched
+ */
+static void ReceiveDataTransfer(uint8_t source, uint8_t destination, const uint8_t *data)
+{
+	j1939RxSession_TypeDef *session = FindSession(source, (uint8_t)(destination == CAN_J1939_ADDRESS_GLOBAL));
+	uint32_t offset;
+	uint32_t count;
+
+	if (session == 0 || session->PendingCm != CM_NONE)
+	{
+		return;
+	}
+	if (data[0] != session->NextPacket)
+	{
+		if (session->Bam == 0u)
+		{
+			QueueAbort(source, ABORT_BAD_SEQUENCE, session->Pgn);
+		}
+		session->Active = 0;
+		return;
+	}
+
+	offset = (uint32_t)(data[0] - 1u) * PACKET_DATA;
+	count = session->Length - offset;
+	count = (count > PACKET_DATA) ? PACKET_DATA : count;
+	memcpy(&session->Buffer[offset], &data[1], count);
+	session->NextPacket++;
+	session->Timer = TIMEOUT_T1_MS;
+
+	if (data[0] >= session->Packets)
+	{
+		Dispatch(session->Pgn, session->Source, session->Destination, session->Buffer, session->Length);
+		if (session->Bam != 0u)
+		{
+			session->Active = 0;
+		}
+		else
+		{
+			session->PendingCm = CM_EOMA;
+		}
+	}
+	else if (session->Bam == 0u && data[0] >= session->WindowEnd)
+	{
+		OpenWindow(session);
+	}
+	else
+	{
+		/* do nothing */
+	}
+}
+
+/**
+ * @brief Send pending CTS and EOMA frames and run the receive timeouts
+ */
+static void ProcessReception(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < CAN_J1939_RX_SESSIONS; i++)
+	{
+		j1939RxSession_TypeDef *session = &j1939.Rx[i];
+
+		if (session->Active == 0u)
+		{
+			continue;
+		}
+		if (session->PendingCm == CM_CTS)
+		{
+			if (SendConnectionManagement(session->Source, TP_CM_CTS, (uint8_t)(session->WindowEnd - session->NextPacket + 1u),
+				session->NextPacket, PADDING, PADDING, session->Pgn) == CAN_OK)
+			{
+				session->PendingCm = CM_NONE;
+			}
+		}
+		else if (session->PendingCm == CM_EOMA)
+		{
+			if (SendConnectionManagement(session->Source, TP_CM_EOMA, (uint8_t)session->Length, (uint8_t)(session->Length >> 8),
+				session->Packets, PADDING, session->Pgn) == CAN_OK)
+			{
+				session->Active = 0;
+			}
+			continue;
+		}
+		else
+		{
+			/* do nothing */
+		}
+
+		if (session->Timer > 0u)
+		{
+			session->Timer--;
+		}
+		if (session->Timer == 0u)
+		{
+			if (session->Bam == 0u)
+			{
+				QueueAbort(session->Source, ABORT_TIMEOUT, session->Pgn);
+			}
+			session->Active = 0;
+		}
+	}
+}
+
+/**
+ * @brief Send the announcement and the packets of the running transmission
+ * @param budget: maximum number of RTS/CTS packets
+ */
+static void ProcessTransmission(uint32_t budget)
+{
+	uint8_t packet[8];
+
+	if (j1939.TxState != CAN_J1939_BUSY)
+	{
+		return;
+	}
+
+	switch (j1939.TxPhase)
+	{
+		case TX_PHASE_ANNOUNCE:
+			if (j1939.TxDestination == CAN_J1939_ADDRESS_GLOBAL)
+			{
+				if (SendConnectionManagement(CAN_J1939_ADDRESS_GLOBAL, TP_CM_BAM, (uint8_t)j1939.TxLength,
+					(uint8_t)(j1939.TxLength >> 8), j1939.TxPackets, PADDING, j1939.TxPgn) == CAN_OK)
+				{
+					j1939.TxPhase = TX_PHASE_BAM_DATA;
+					j1939.TxTimer = CAN_J1939_BAM_INTERVAL_MS;
+				}
+			}
+			else if (SendConnectionManagement(j1939.TxDestination, TP_CM_RTS, (uint8_t)j1939.TxLength,
+				(uint8_t)(j1939.TxLength >> 8), j1939.TxPackets, 0xFFu, j1939.TxPgn) == CAN_OK)
+			{
+				j1939.TxPhase = TX_PHASE_WAIT;
+				j1939.TxTimer = TIMEOUT_T3_MS;
+			}
+			else
+			{
+				/* try again in the next millisecond */
+			}
+			return;
+
+		case TX_PHASE_BAM_DATA:
+			if (j1939.TxTimer > 1u)
+			{
+				j1939.TxTimer--;
+				return;
+			}
+			budget = 1;
+			break;
+
+		case TX_PHASE_WAIT:
+			j1939.TxTimer--;
+			if (j1939.TxTimer == 0u)
+			{
+				QueueAbort(j1939.TxDestination, ABORT_TIMEOUT, j1939.TxPgn);
+				j1939.TxState = CAN_J1939_ERROR_TIMEOUT;
+			}
+			return;
+
+		default:
+			break;
+	}
+
+	/* TX_PHASE_DATA and the due BAM packet */
+	while (budget > 0u)
+	{
+		uint32_t offset = (uint32_t)(j1939.TxNextPacket - 1u) * PACKET_DATA;
+		uint32_t count = j1939.TxLength - offset;
+
+		count = (count > PACKET_DATA) ? PACKET_DATA : count;
+		packet[0] = j1939.TxNextPacket;
+		memcpy(&packet[1], &j1939.TxData[offset], count);
+		memset(&packet[1u + count], PADDING, PACKET_DATA - count);
+		if (SendFrame(CAN_J1939_PGN_TP_DT, PRIORITY_TRANSPORT, j1939.TxDestination, packet, 8) != CAN_OK)
+		{
+			return;
+		}
+		budget--;
+
+		if (j1939.TxPhase == TX_PHASE_BAM_DATA)
+		{
+			j1939.TxTimer = CAN_J1939_BAM_INTERVAL_MS;
+			if (j1939.TxNextPacket >= j1939.TxPackets)
+			{
+				j1939.TxState = CAN_J1939_DONE;
+				return;
+			}
+		}
+		else if (j1939.TxNextPacket >= j1939.TxWindowEnd)
+		{
+			/* the receiver answers with the next CTS or the end of message acknowledge */
+			j1939.TxPhase = TX_PHASE_WAIT;
+			j1939.TxTimer = TIMEOUT_T3_MS;
+			j1939.TxNextPacket++;
+			return;
+		}
+		else
+		{
+			/* do nothing */
+		}
+		j1939.TxNextPacket++;
+	}
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_J1939_Init(void)
+{
+	memset(&j1939, 0, sizeof(j1939));
+	j1939.Address = CAN_J1939_ADDRESS_NULL;
+}
+
+canApi_StatusTypeDef CAN_J1939_Open(const CAN_J1939_Config_TypeDef *config)
+{
+	uint8_t i;
+
+	if (config == 0 || config->PreferredAddress >= CAN_J1939_ADDRESS_NULL || (config->PgnTable == 0 && config->PgnCount != 0u))
+	{
+		return CAN_INVALID_VALUE;
+	}
+	for (i = 1; i < config->PgnCount; i++)
+	{
+		if (config->PgnTable[i - 1u].Pgn >= config->PgnTable[i].Pgn)
+		{
+			return CAN_INVALID_VALUE; /* not sorted, the binary search would miss entries */
+		}
+	}
+
+	CAN_J1939_Init();
+	j1939.Config = *config;
+	j1939.Open = 1;
+	j1939.Address = config->PreferredAddress;
+	j1939.AddressState = CAN_J1939_BUSY;
+	j1939.ClaimPending = 1;
+	return CAN_OK;
+}
+
+void CAN_J1939_Close(void)
+{
+	if (j1939.Open != 0u)
+	{
+		CAN_J1939_Init();
+	}
+}
+
+uint8_t CAN_J1939_SetupFilters(const CAN_J1939_Pgn_TypeDef *table, uint8_t count, canApi_FilterBank_Type first, canApi_FilterBank_Type last)
+{
+	uint32_t total = PROTOCOL_PGNS + count;
+	uint32_t mergedId = 0;
+	uint32_t mergedMask = 0;
+	uint8_t merged = 0;
+	uint8_t banks;
+	uint8_t used = 0;
+	uint32_t i;
+
+	if (last < first)
+	{
+		return 0;
+	}
+	banks = (uint8_t)(last - first + 1);
+
+	for (i = 0; i < total; i++)
+	{
+		uint32_t pgn = (i < PROTOCOL_PGNS) ? protocolPgn_array[i] : table[i - PROTOCOL_PGNS].Pgn;
+		uint32_t id = (pgn & PGN_MASK) << ID_PGN_SHIFT;
+		uint32_t mask = (IsPdu1(pgn) != 0u) ? FILTER_MASK_PDU1 : FILTER_MASK_PDU2;
+
+		if (i >= PROTOCOL_PGNS && IsProtocolPgn(pgn) != 0u)
+		{
+			continue;
+		}
+		if (used + 1u < banks)
+		{
+			canApi_FilterSetOneExtIdMaskMode((canApi_FilterBank_Type)(first + used), id, 0, mask, 1);
+			used++;
+		}
+		else if (merged == 0u)
+		{
+			mergedId = id;
+			mergedMask = mask;
+			merged = 1;
+		}
+		else
+		{
+			/* keep only the bits all remaining PGNs agree on */
+			mergedMask &= mask & ~(id ^ mergedId);
+		}
+	}
+	if (merged != 0u)
+	{
+		canApi_FilterSetOneExtIdMaskMode((canApi_FilterBank_Type)(first + used), mergedId & mergedMask, 0, mergedMask, 1);
+		used++;
+	}
+	return used;
+}
+
+uint8_t CAN_J1939_Receive(const canApi_MessageTypedef *message)
+{
+	uint32_t pgn;
+	uint8_t source;
+	uint8_t destination = CAN_J1939_ADDRESS_GLOBAL;
+
+	if (j1939.Open == 0u || message->IDE == 0u || message->RTR != 0u)
+	{
+		return 0;
+	}
+	pgn = (message->Identifier >> ID_PGN_SHIFT) & PGN_MASK;
+	source = (uint8_t)message->Identifier;
+	if (IsPdu1(pgn) != 0u)
+	{
+		destination = (uint8_t)pgn;
+		pgn &= PGN_PDU1_MASK;
+	}
+	if (IsProtocolPgn(pgn) == 0u && FindPgn(pgn) == 0)
+	{
+		return 0;
+	}
+	if (destination != CAN_J1939_ADDRESS_GLOBAL && (HasAddress() == 0u || destination != j1939.Address))
+	{
+		return 1; /* for another node */
+	}
+
+	switch (pgn)
+	{
+		case CAN_J1939_PGN_ADDRESS_CLAIMED:
+			if (message->DLC >= 8u)
+			{
+				ReceiveAddressClaimed(source, message->Data);
+			}
+			break;
+
+		case CAN_J1939_PGN_TP_CM:
+			if (message->DLC >= 8u)
+			{
+				ReceiveConnectionManagement(source, destination, message->Data);
+			}
+			break;
+
+		case CAN_J1939_PGN_TP_DT:
+			if (message->DLC >= 8u)
+			{
+				ReceiveDataTransfer(source, destination, message->Data);
+			}
+			break;
+
+		case CAN_J1939_PGN_REQUEST:
+			if (message->DLC >= 3u && message->Data[0] == (uint8_t)CAN_J1939_PGN_ADDRESS_CLAIMED
+				&& message->Data[1] == (uint8_t)(CAN_J1939_PGN_ADDRESS_CLAIMED >> 8) && message->Data[2] == 0u)
+			{
+				/* answered with the own claim, or with Cannot Claim */
+				j1939.ClaimPending = 1;
+			}
+			else
+			{
+				Dispatch(pgn, source, destination, message->Data, message->DLC);
+			}
+			break;
+
+		default:
+			Dispatch(pgn, source, destination, message->Data, message->DLC);
+			break;
+	}
+	return 1;
+}
+
+void CAN_J1939_Process(uint32_t budget)
+{
+	if (j1939.Open == 0u)
+	{
+		return;
+	}
+
+	if (j1939.ClaimPending != 0u)
+	{
+		uint8_t name[8];
+		uint8_t i;
+
+		for (i = 0; i < 8u; i++)
+		{
+			name[i] = (uint8_t)(j1939.Config.Name >> (8u * i));
+		}
+		if (SendFrame(CAN_J1939_PGN_ADDRESS_CLAIMED, PRIORITY_CLAIM, CAN_J1939_ADDRESS_GLOBAL, name, 8) == CAN_OK)
+		{
+			j1939.ClaimPending = 0;
+			if (j1939.AddressState == CAN_J1939_BUSY)
+			{
+				/* only the self-configurable range has to wait for a contention */
+				j1939.ClaimTimer = (j1939.Address >= ADDRESS_ARBITRARY_FIRST && j1939.Address <= ADDRESS_ARBITRARY_LAST) ? CLAIM_WAIT_MS : 1u;
+			}
+		}
+	}
+	else if (j1939.AddressState == CAN_J1939_BUSY)
+	{
+		j1939.ClaimTimer--;
+		if (j1939.ClaimTimer == 0u)
+		{
+			j1939.AddressState = CAN_J1939_DONE;
+		}
+	}
+	else
+	{
+		/* do nothing */
+	}
+
+	if (j1939.AbortPending != 0u && HasAddress() != 0u)
+	{
+		if (SendConnectionManagement(j1939.AbortDestination, TP_CM_ABORT, j1939.AbortReason, PADDING, PADDING, PADDING,
+			j1939.AbortPgn) == CAN_OK)
+		{
+			j1939.AbortPending = 0;
+		}
+	}
+
+	if (j1939.AddressState == CAN_J1939_DONE)
+	{
+		ProcessReception();
+		ProcessTransmission(budget);
+	}
+}
+
+canApi_StatusTypeDef CAN_J1939_Send(uint32_t pgn, uint8_t priority, uint8_t destination, const uint8_t *data, uint32_t length)
+{
+	if (pgn > PGN_MASK || priority > 7u || (data == 0 && length != 0u) || length > CAN_J1939_MAX_LENGTH)
+	{
+		return CAN_INVALID_VALUE;
+	}
+	if (j1939.Open == 0u || j1939.AddressState != CAN_J1939_DONE)
+	{
+		return CAN_ERROR;
+	}
+	if (length <= 8u)
+	{
+		return SendFrame(pgn, priority, destination, data, (uint8_t)length);
+	}
+	if (j1939.TxState == CAN_J1939_BUSY)
+	{
+		return CAN_BUFFER_FULL;
+	}
+
+	j1939.TxData = data;
+	j1939.TxLength = (uint16_t)length;
+	j1939.TxPgn = pgn;
+	j1939.TxDestination = destination;
+	j1939.TxPackets = (uint8_t)((length + PACKET_DATA - 1u) / PACKET_DATA);
+	j1939.TxNextPacket = 1;
+	j1939.TxWindowEnd = j1939.TxPackets;
+	j1939.TxPhase = TX_PHASE_ANNOUNCE;
+	j1939.TxState = CAN_J1939_BUSY;
+	return CAN_OK;
+}
+
+CAN_J1939_State_TypeDef CAN_J1939_GetTxState(void)
+{
+	return j1939.TxState;
+}
+
+CAN_J1939_State_TypeDef CAN_J1939_GetAddressState(uint8_t *address)
+{
+	if (address != 0)
+	{
+		*address = (j1939.AddressState == CAN_J1939_IDLE || j1939.AddressState == CAN_J1939_ERROR_NO_ADDRESS)
+			? CAN_J1939_ADDRESS_NULL : j1939.Address;
+	}
+	return j1939.AddressState;
+}
+
+/** @} */
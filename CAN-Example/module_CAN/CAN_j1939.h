@@ -0,0 +1,213 @@
+/**
+*******************************************************************************
+* @file CAN_j1939.h
+* @brief SAE J1939 network layer: address claiming, PGN dispatch and transport protocol
+* @author FRIWO
+* @date 20.10.2026 - 17:36:50
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Makes the module one controller application on a J1939 network with
+* extended identifiers: priority (3 bit), data page, PDU format (PF), PDU
+* specific (PS) and source address. A PF below 240 is PDU1, PS is then the
+* destination address and not part of the PGN; PDU2 messages are broadcast.
+*
+* - Address claiming (J1939-81): CAN_J1939_Open() claims the preferred
+*   address with the NAME of the configuration. The lower NAME wins a
+*   contention; with the arbitrary address capable bit the module then
+*   claims a free address of 128...247, without it sends Cannot Claim.
+*   Other messages are sent 250ms after the claim, when nobody contested it.
+*   Requests for the address claimed PGN are answered.
+* - Dispatch: a received message, single frame or reassembled, is passed to
+*   the function of its PGN in the table of the configuration, found by
+*   binary search. PDU1 messages for another destination are dropped.
+* - Transport protocol (J1939-21): messages of 9...CAN_J1939_MAX_LENGTH bytes
+*   are sent with BAM to the global address, one data packet every
+*   CAN_J1939_BAM_INTERVAL_MS, or with RTS/CTS to a destination, as fast as
+*   the receiver allows. Both are received in CAN_J1939_RX_SESSIONS sessions
+*   of CAN_J1939_RX_SIZE bytes, a larger RTS is aborted.
+*
+* CAN_custom.c passes every received extended frame to CAN_J1939_Receive()
+* before the exact identifier match of msgManagment_array and calls
+* CAN_J1939_Process() once per canApi_UserPeriodicCallBack() while
+* CAN_C_J1939_Enable is set. CAN_J1939_SetupFilters() sets the extended mask
+* mode filter banks for the protocol PGNs and the PGN table.
+*/
+
+#ifndef CAN_J1939_H_
+#define CAN_J1939_H_
+
+/**
+* @addtogroup CAN_j1939
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of transport protocol receptions at the same time */
+#ifndef CAN_J1939_RX_SESSIONS
+#define CAN_J1939_RX_SESSIONS 2u
+#endif
+
+/** @brief receive buffer of each transport protocol session [byte] */
+#ifndef CAN_J1939_RX_SIZE
+#define CAN_J1939_RX_SIZE 256u
+#endif
+
+/** @brief time between two BAM data packets, J1939-21 allows 50...200ms [ms] */
+#ifndef CAN_J1939_BAM_INTERVAL_MS
+#define CAN_J1939_BAM_INTERVAL_MS 50u
+#endif
+
+/** @brief largest message of the transport protocol, 255 packets of 7 bytes [byte] */
+#define CAN_J1939_MAX_LENGTH 1785u
+
+/** @brief special addresses */
+#define CAN_J1939_ADDRESS_GLOBAL 0xFFu /**< @brief destination of a broadcast */
+#define CAN_J1939_ADDRESS_NULL 0xFEu /**< @brief source address of Cannot Claim, no address claimed */
+
+/** @brief PGNs of the network layer */
+#define CAN_J1939_PGN_ACKNOWLEDGEMENT 0xE800u
+#define CAN_J1939_PGN_REQUEST 0xEA00u
+#define CAN_J1939_PGN_TP_DT 0xEB00u
+#define CAN_J1939_PGN_TP_CM 0xEC00u
+#define CAN_J1939_PGN_ADDRESS_CLAIMED 0xEE00u
+
+/** @brief NAME bit: the controller application may claim any address of 128...247 */
+#define CAN_J1939_NAME_ARBITRARY_ADDRESS 0x8000000000000000ull
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief State of the address or of the transport protocol transmission
+ */
+typedef enum
+{
+	CAN_J1939_IDLE = 0, /**< @brief closed or no transmission */
+	CAN_J1939_BUSY = 1, /**< @brief address claim or transmission running */
+	CAN_J1939_DONE = 2, /**< @brief address claimed or transmission complete */
+	CAN_J1939_ERROR_TIMEOUT = 3, /**< @brief no CTS or end of message acknowledge in time */
+	CAN_J1939_ERROR_ABORT = 4, /**< @brief the receiver aborted the transmission */
+	CAN_J1939_ERROR_NO_ADDRESS = 5 /**< @brief address lost, Cannot Claim sent */
+}CAN_J1939_State_TypeDef;
+
+/**
+ * @brief Called for a received message of a PGN of the table
+ * @param pgn: parameter group number
+ * @param source: source address
+ * @param destination: own address or CAN_J1939_ADDRESS_GLOBAL
+ * @param data: payload, only valid during the call
+ * @param length: payload length [byte]
+ */
+typedef void (*CAN_J1939_FptrOnReceive)(uint32_t pgn, uint8_t source, uint8_t destination, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief One entry of the PGN table
+ */
+typedef struct
+{
+	uint32_t Pgn; /**< @brief parameter group number, PS is 0 for PDU1 */
+	CAN_J1939_FptrOnReceive ReceiveFunction; /**< @brief called for each received message of the PGN */
+}CAN_J1939_Pgn_TypeDef;
+
+/**
+ * @brief Configuration of the controller application
+ */
+typedef struct
+{
+	uint64_t Name; /**< @brief 64 bit NAME, lower value = higher priority in an address contention */
+	uint8_t PreferredAddress; /**< @brief address claimed first, 0...253 */
+	const CAN_J1939_Pgn_TypeDef *PgnTable; /**< @brief received PGNs sorted by ascending PGN, must stay valid */
+	uint8_t PgnCount; /**< @brief number of entries of PgnTable */
+}CAN_J1939_Config_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Close the layer. Called by the CAN module when its state is initialized.
+ */
+void CAN_J1939_Init(void);
+
+/**
+ * @brief Start the address claim, a running claim and all transfers are dropped
+ * @param config: configuration, copied
+ * @return CAN_OK, CAN_INVALID_VALUE on a wrong preferred address or table
+ */
+canApi_StatusTypeDef CAN_J1939_Open(const CAN_J1939_Config_TypeDef *config);
+
+/**
+ * @brief Stop taking part in the network, running transfers are dropped
+ */
+void CAN_J1939_Close(void);
+
+/**
+ * @brief Set extended mask mode filter banks for the network layer PGNs and the PGN table.
+ * Each PGN gets one bank with the PGN bits relevant, priority, source and for PDU1 the
+ * destination are ignored. If there are more PGNs than banks, the last bank takes the
+ * remaining PGNs with a common mask, CAN_J1939_Receive() drops the surplus.
+ * @param table: PGN table
+ * @param count: number of entries of table
+ * @param first: first filter bank to use
+ * @param last: last filter bank to use
+ * @return number of filter banks set
+ */
+uint8_t CAN_J1939_SetupFilters(const CAN_J1939_Pgn_TypeDef *table, uint8_t count, canApi_FilterBank_Type first, canApi_FilterBank_Type last);
+
+/**
+ * @brief Process a received message
+ * @param message: received message
+ * @return 1 if the message has a PGN of the network layer or the table, else 0
+ */
+uint8_t CAN_J1939_Receive(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Run the address claim and the transport protocol sessions, call every 1ms
+ * @param budget: maximum number of RTS/CTS data packets put into the transmit buffer in this call,
+ * connection management frames and BAM packets are always sent
+ */
+void CAN_J1939_Process(uint32_t budget);
+
+/**
+ * @brief Send a message. Up to 8 bytes go into the transmit buffer right away, larger messages
+ * start a transport protocol transmission which reads from the caller's buffer until it ends.
+ * @param pgn: parameter group number, PS of a PDU1 PGN is replaced by the destination
+ * @param priority: 0...7, 0 is the highest
+ * @param destination: address of PDU1 messages and of a transport with RTS/CTS, CAN_J1939_ADDRESS_GLOBAL
+ * for a broadcast or a transport with BAM. A PDU2 message of up to 8 bytes is always a broadcast.
+ * @param data: payload, must stay valid and unchanged while the state of a transport is CAN_J1939_BUSY
+ * @param length: 0...CAN_J1939_MAX_LENGTH [byte]
+ * @return CAN_OK, CAN_ERROR while no address is claimed, CAN_BUFFER_FULL if a transport
+ * is running or the transmit buffer is full, CAN_INVALID_VALUE on wrong arguments
+ */
+canApi_StatusTypeDef CAN_J1939_Send(uint32_t pgn, uint8_t priority, uint8_t destination, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Get the state of the transport protocol transmission
+ * @return state of the last transmission with more than 8 bytes
+ */
+CAN_J1939_State_TypeDef CAN_J1939_GetTxState(void);
+
+/**
+ * @brief Get the state of the address claim
+ * @param address: target pointer for the own address, CAN_J1939_ADDRESS_NULL without one, may be 0
+ * @return CAN_J1939_IDLE while closed, CAN_J1939_BUSY during the claim, CAN_J1939_DONE when claimed,
+ * CAN_J1939_ERROR_NO_ADDRESS when lost
+ */
+CAN_J1939_State_TypeDef CAN_J1939_GetAddressState(uint8_t *address);
+
+/** @} */
+
+#endif /* CAN_J1939_H_ */
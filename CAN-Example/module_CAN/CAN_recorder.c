@@ -0,0 +1,432 @@
+/**
+*******************************************************************************
+* @file CAN_recorder.c
+* @brief Flight recorder of the CAN traffic with a capture frozen around a trigger
+* @author FRIWO
+* @date 21.10.2026 - 08:47:15
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_recorder
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_custom.h"
+#include "CAN_recorder.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+#if (CAN_RECORDER_SIZE & (CAN_RECORDER_SIZE - 1u)) != 0 || CAN_RECORDER_SIZE > 32768u
+#error "CAN_RECORDER_SIZE must be a power of two up to 32768"
+#endif
+
+#if CAN_RECORDER_ID_BITS > 8u
+#error "CAN_RECORDER_ID_BITS must fit the one byte index of a record"
+#endif
+
+#define RING_MASK (CAN_RECORDER_SIZE - 1u)
+
+/** @brief largest record: header, 4 time bytes, 4 identifier bytes and 8 data bytes */
+#define RECORD_MAX_SIZE 17u
+
+/** @brief fields of the first byte of a literal identifier */
+#define LITERAL_EXTENDED 0x80u
+#define LITERAL_RTR 0x40u
+
+/** @brief size of the header fields of the capture image in front of the identifier table */
+#define IMAGE_FIELDS_SIZE 16u
+
+/** @brief identifier table entry without identifier */
+#define ID_UNUSED 0xFFFFFFFFu
+
+/** @brief multiplier of the identifier hash, 2^32 divided by the golden ratio */
+#define ID_HASH 0x9E3779B1u
+
+/** @brief storage of the recorder state, one recorder per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_RECORDER_LOCAL _Thread_local
+#else
+#define CAN_RECORDER_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Complete state of the recorder.
+ * The ring, the table and the time fields are written by the interrupts while recording, the
+ * periodic callback only reads them once the state is CAN_RECORDER_FROZEN or switches the
+ * state to CAN_RECORDER_OFF before it clears them.
+ */
+typedef struct
+{
+	volatile uint8_t State; /**< @brief CAN_Recorder_State_TypeDef */
+	uint8_t Cause; /**< @brief CAN_Recorder_Cause_TypeDef */
+	uint8_t PostShare; /**< @brief share of the ring for the frames after the trigger [%] */
+	uint32_t PostTime; /**< @brief time after the trigger until the capture is frozen [ms] */
+	uint32_t PostTimer; /**< @brief time since the trigger [ms] */
+	volatile uint32_t PostRemaining; /**< @brief bytes still logged after the trigger */
+
+	uint16_t Head; /**< @brief position of the next record */
+	uint16_t Tail; /**< @brief position of the oldest record */
+	uint16_t Used; /**< @brief bytes of the records */
+	uint16_t Records; /**< @brief number of records */
+	uint16_t TriggerHead; /**< @brief Head at the trigger */
+	uint32_t BaseTime; /**< @brief timestamp the time of the oldest record refers to [us] */
+	uint32_t LastTime; /**< @brief timestamp of the newest record [us] */
+	uint32_t TriggerTime; /**< @brief timestamp of the trigger [us] */
+
+	uint32_t Ids[CAN_RECORDER_IDS]; /**< @brief identifier table, bit 31 = IDE */
+	uint8_t Ring[CAN_RECORDER_SIZE]; /**< @brief records */
+}recorderState_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void Clear(void);
+static uint8_t RecordLength(uint16_t position, uint32_t *delta);
+static void DropOldest(void);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE CONSTANTS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief bytes of the time field per size code of the record header */
+static const uint8_t timeSize_array[4] = {0u, 1u, 2u, 4u};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_RECORDER_LOCAL recorderState_TypeDef recorder;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Empty the ring and the identifier table, the state must not be recording
+ */
+static void Clear(void)
+{
+	uint16_t i;
+
+	recorder.Head = 0;
+	recorder.Tail = 0;
+	recorder.Used = 0;
+	recorder.Records = 0;
+	recorder.Cause = CAN_RECORDER_CAUSE_NONE;
+	recorder.BaseTime = CAN_GetTimestampUs();
+	recorder.LastTime = recorder.BaseTime;
+	for (i = 0; i < CAN_RECORDER_IDS; i++)
+	{
+		recorder.Ids[i] = ID_UNUSED;
+	}
+}
+
+/**
+ * @brief Get the length and the time field of a record in the ring
+ * @param position: position of the record header
+ * @param delta: target pointer for the time since the previous record [us]
+ * @return length of the record [byte]
+ */
+static uint8_t RecordLength(uint16_t position, uint32_t *delta)
+{
+	uint8_t header = recorder.Ring[position];
+	uint8_t timeSize = timeSize_array[(header >> CAN_RECORDER_TIME_SHIFT) & 0x03u];
+	uint8_t dataLength = (uint8_t)(header & CAN_RECORDER_DLC_MASK);
+	uint8_t length = (uint8_t)(1u + timeSize);
+	uint8_t i;
+
+	*delta = 0;
+	for (i = 0; i < timeSize; i++)
+	{
+		*delta = (*delta << 8) | recorder.Ring[(position + 1u + i) & RING_MASK];
+	}
+	if ((header & CAN_RECORDER_LITERAL) != 0u)
+	{
+		uint8_t first = recorder.Ring[(position + length) & RING_MASK];
+
+		length = (uint8_t)(length + (((first & LITERAL_EXTENDED) != 0u) ? 4u : 2u));
+		if ((first & LITERAL_RTR) != 0u)
+		{
+			dataLength = 0;
+		}
+	}
+	else
+	{
+		length++;
+	}
+	return (uint8_t)(length + ((dataLength > 8u) ? 8u : dataLength));
+}
+
+/**
+ * @brief Remove the oldest record, the time of the next one then refers to its time
+ */
+static void DropOldest(void)
+{
+	uint32_t delta;
+	uint8_t length = RecordLength(recorder.Tail, &delta);
+
+	recorder.BaseTime += delta;
+	recorder.Tail = (uint16_t)((recorder.Tail + length) & RING_MASK);
+	recorder.Used = (uint16_t)(recorder.Used - length);
+	recorder.Records--;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_Recorder_Init(void)
+{
+	memset(&recorder, 0, sizeof(recorder));
+	recorder.State = CAN_RECORDER_OFF;
+}
+
+void CAN_Recorder_Configure(uint8_t enable, uint8_t postShare, uint32_t postTime)
+{
+	recorder.PostShare = (postShare <= CAN_RECORDER_POST_MAX) ? postShare : (uint8_t)CAN_RECORDER_POST_MAX;
+	recorder.PostTime = postTime;
+	if (enable == 0u)
+	{
+		if (recorder.State != CAN_RECORDER_OFF)
+		{
+			recorder.State = CAN_RECORDER_OFF;
+			Clear();
+		}
+	}
+	else if (recorder.State == CAN_RECORDER_OFF)
+	{
+		Clear();
+		recorder.State = CAN_RECORDER_RECORDING;
+	}
+	else
+	{
+		/* recording or holding a capture */
+	}
+}
+
+void CAN_Recorder_Log(const canApi_MessageTypedef *message, uint8_t transmitted, uint32_t timestamp)
+{
+	uint8_t record[RECORD_MAX_SIZE];
+	uint8_t dlc = (uint8_t)(message->DLC & CAN_RECORDER_DLC_MASK);
+	uint8_t dataLength = (message->RTR != 0u) ? 0u : ((dlc > 8u) ? 8u : dlc);
+	uint8_t length = 1;
+	uint32_t delta;
+	uint32_t key;
+	uint32_t slot;
+	uint8_t i;
+
+	if (recorder.State != CAN_RECORDER_RECORDING && recorder.State != CAN_RECORDER_TRIGGERED)
+	{
+		return;
+	}
+
+	/* a frame stamped before the previous one gets the time of the previous one */
+	delta = timestamp - recorder.LastTime;
+	if ((int32_t)delta < 0)
+	{
+		delta = 0;
+	}
+	recorder.LastTime += delta;
+
+	record[0] = (uint8_t)(dlc | ((transmitted != 0u) ? CAN_RECORDER_TRANSMITTED : 0u));
+	if (delta > 0xFFFFu)
+	{
+		record[0] |= (uint8_t)(3u << CAN_RECORDER_TIME_SHIFT);
+		record[length++] = (uint8_t)(delta >> 24);
+		record[length++] = (uint8_t)(delta >> 16);
+		record[length++] = (uint8_t)(delta >> 8);
+		record[length++] = (uint8_t)delta;
+	}
+	else if (delta > 0xFFu)
+	{
+		record[0] |= (uint8_t)(2u << CAN_RECORDER_TIME_SHIFT);
+		record[length++] = (uint8_t)(delta >> 8);
+		record[length++] = (uint8_t)delta;
+	}
+	else if (delta > 0u)
+	{
+		record[0] |= (uint8_t)(1u << CAN_RECORDER_TIME_SHIFT);
+		record[length++] = (uint8_t)delta;
+	}
+	else
+	{
+		/* same microsecond as the previous record */
+	}
+
+	/* the table slot is the hash of the identifier, a taken slot makes a colliding identifier literal */
+	key = message->Identifier | ((message->IDE != 0u) ? 0x80000000u : 0u);
+	slot = (key * ID_HASH) >> (32u - CAN_RECORDER_ID_BITS);
+	if (recorder.Ids[slot] == ID_UNUSED)
+	{
+		recorder.Ids[slot] = key;
+	}
+	if (message->RTR == 0u && recorder.Ids[slot] == key)
+	{
+		record[length++] = (uint8_t)slot;
+	}
+	else if (message->IDE != 0u)
+	{
+		record[0] |= CAN_RECORDER_LITERAL;
+		record[length++] = (uint8_t)(LITERAL_EXTENDED | ((message->RTR != 0u) ? LITERAL_RTR : 0u) | ((message->Identifier >> 24) & 0x1Fu));
+		record[length++] = (uint8_t)(message->Identifier >> 16);
+		record[length++] = (uint8_t)(message->Identifier >> 8);
+		record[length++] = (uint8_t)message->Identifier;
+	}
+	else
+	{
+		record[0] |= CAN_RECORDER_LITERAL;
+		record[length++] = (uint8_t)(((message->RTR != 0u) ? LITERAL_RTR : 0u) | ((message->Identifier >> 8) & 0x07u));
+		record[length++] = (uint8_t)message->Identifier;
+	}
+	for (i = 0; i < dataLength; i++)
+	{
+		record[length++] = message->Data[i];
+	}
+
+	while ((uint16_t)(CAN_RECORDER_SIZE - recorder.Used) < length)
+	{
+		DropOldest();
+	}
+	for (i = 0; i < length; i++)
+	{
+		recorder.Ring[(recorder.Head + i) & RING_MASK] = record[i];
+	}
+	recorder.Head = (uint16_t)((recorder.Head + length) & RING_MASK);
+	recorder.Used = (uint16_t)(recorder.Used + length);
+	recorder.Records++;
+
+	if (recorder.State == CAN_RECORDER_TRIGGERED)
+	{
+		if (recorder.PostRemaining <= length)
+		{
+			recorder.PostRemaining = 0;
+			recorder.State = CAN_RECORDER_FROZEN;
+		}
+		else
+		{
+			recorder.PostRemaining -= length;
+		}
+	}
+}
+
+void CAN_Recorder_Trigger(CAN_Recorder_Cause_TypeDef cause)
+{
+	if (recorder.State != CAN_RECORDER_RECORDING)
+	{
+		return;
+	}
+	recorder.Cause = (uint8_t)cause;
+	recorder.TriggerTime = CAN_GetTimestampUs();
+	recorder.TriggerHead = recorder.Head;
+	recorder.PostTimer = 0;
+	recorder.PostRemaining = CAN_RECORDER_SIZE * recorder.PostShare / 100u;
+	recorder.State = (recorder.PostRemaining > 0u && recorder.PostTime > 0u) ? CAN_RECORDER_TRIGGERED : CAN_RECORDER_FROZEN;
+}
+
+void CAN_Recorder_Process(void)
+{
+	if (recorder.State == CAN_RECORDER_TRIGGERED)
+	{
+		recorder.PostTimer++;
+		if (recorder.PostTimer >= recorder.PostTime)
+		{
+			recorder.State = CAN_RECORDER_FROZEN;
+		}
+	}
+}
+
+void CAN_Recorder_Rearm(void)
+{
+	if (recorder.State != CAN_RECORDER_OFF)
+	{
+		/* the interrupts stop logging before the ring is cleared */
+		recorder.State = CAN_RECORDER_OFF;
+		Clear();
+		recorder.State = CAN_RECORDER_RECORDING;
+	}
+}
+
+UInt32 CAN_Recorder_GetState(void)
+{
+	return (uint32_t)recorder.State | ((uint32_t)recorder.Cause << 8);
+}
+
+UInt32 CAN_Recorder_GetSize(void)
+{
+	return (recorder.State == CAN_RECORDER_FROZEN) ? CAN_RECORDER_HEADER_SIZE + recorder.Used : 0u;
+}
+
+uint32_t CAN_Recorder_Read(uint32_t offset, uint8_t *target, uint32_t length)
+{
+	uint8_t fields[IMAGE_FIELDS_SIZE];
+	uint32_t size = CAN_Recorder_GetSize();
+	uint16_t triggerOffset;
+	uint32_t i;
+
+	if (offset >= size)
+	{
+		return 0;
+	}
+	if (length > size - offset)
+	{
+		length = size - offset;
+	}
+
+	/* the frames after the trigger end at Head, the tail never passes the trigger */
+	triggerOffset = (uint16_t)(recorder.Used - ((recorder.Head - recorder.TriggerHead) & RING_MASK));
+	fields[0] = CAN_RECORDER_FORMAT;
+	fields[1] = recorder.Cause;
+	fields[2] = (uint8_t)(recorder.Records >> 8);
+	fields[3] = (uint8_t)recorder.Records;
+	fields[4] = (uint8_t)(recorder.BaseTime >> 24);
+	fields[5] = (uint8_t)(recorder.BaseTime >> 16);
+	fields[6] = (uint8_t)(recorder.BaseTime >> 8);
+	fields[7] = (uint8_t)recorder.BaseTime;
+	fields[8] = (uint8_t)(recorder.TriggerTime >> 24);
+	fields[9] = (uint8_t)(recorder.TriggerTime >> 16);
+	fields[10] = (uint8_t)(recorder.TriggerTime >> 8);
+	fields[11] = (uint8_t)recorder.TriggerTime;
+	fields[12] = (uint8_t)(triggerOffset >> 8);
+	fields[13] = (uint8_t)triggerOffset;
+	fields[14] = (uint8_t)(recorder.Used >> 8);
+	fields[15] = (uint8_t)recorder.Used;
+
+	for (i = 0; i < length; i++)
+	{
+		uint32_t position = offset + i;
+
+		if (position < IMAGE_FIELDS_SIZE)
+		{
+			target[i] = fields[position];
+		}
+		else if (position < CAN_RECORDER_HEADER_SIZE)
+		{
+			uint32_t entry = (position - IMAGE_FIELDS_SIZE) / 4u;
+
+			target[i] = (uint8_t)(recorder.Ids[entry] >> (8u * (3u - (position - IMAGE_FIELDS_SIZE) % 4u)));
+		}
+		else
+		{
+			target[i] = recorder.Ring[(recorder.Tail + position - CAN_RECORDER_HEADER_SIZE) & RING_MASK];
+		}
+	}
+	return length;
+}
+
+/** @} */
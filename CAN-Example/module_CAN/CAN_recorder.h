@@ -0,0 +1,188 @@
+/**
+*******************************************************************************
+* @file CAN_recorder.h
+* @brief Flight recorder of the CAN traffic with a capture frozen around a trigger
+* @author FRIWO
+* @date 21.10.2026 - 08:47:15
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Logs every received and transmitted frame into a RAM ring of
+* CAN_RECORDER_SIZE bytes, the oldest frames are overwritten. A trigger, e.g.
+* an error bit or bus-off, keeps the frames before it and freezes the ring
+* once the share for the frames after it is filled or the post-trigger time
+* has passed. The frozen capture stays until CAN_Recorder_Rearm().
+*
+* One record per frame, multi byte values in Motorola byte order:
+* - byte 0: bit 7 transmitted, bit 6 literal identifier, bits 4...5 size of
+*   the time field (0, 1, 2 or 4 bytes), bits 0...3 DLC
+* - time since the previous record [us], no field for 0
+* - identifier: one byte index into the identifier table, or literal 2 bytes
+*   for a standard identifier (bit 15 0, bit 14 RTR) or 4 bytes for an
+*   extended one (bit 31 1, bit 30 RTR). Frames with RTR and identifiers which
+*   do not get an entry in the table are literal.
+* - DLC data bytes, none for RTR
+* A periodic standard frame with 8 data bytes takes 11...12 bytes.
+*
+* The table gets an entry for each new identifier at the position of its hash,
+* an entry stays until the ring is cleared, so the records of the whole ring
+* refer to the same table.
+*
+* Capture image, read with CAN_Recorder_Read():
+* - byte 0: CAN_RECORDER_FORMAT
+* - byte 1: cause, CAN_Recorder_Cause_TypeDef
+* - bytes 2...3: number of records
+* - bytes 4...7: CAN_GetTimestampUs() the time of the first record refers to [us]
+* - bytes 8...11: CAN_GetTimestampUs() of the trigger [us]
+* - bytes 12...13: offset of the first record after the trigger in the record area
+* - bytes 14...15: length of the record area
+* - CAN_RECORDER_IDS identifiers of the table, 4 bytes each with bit 31 = IDE,
+*   0xFFFFFFFF = unused
+* - record area, oldest record first
+*
+* Logging is done in CAN_RxIsrHook() and CAN_TxCompleteHook(), which must be
+* called from interrupts of the same priority, so one never interrupts the
+* other. Triggers and the post-trigger time are handled in
+* canApi_UserPeriodicCallBack(). FD frames are not logged.
+*/
+
+#ifndef CAN_RECORDER_H_
+#define CAN_RECORDER_H_
+
+/**
+* @addtogroup CAN_recorder
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief size of the ring, power of two up to 32768 [byte] */
+#ifndef CAN_RECORDER_SIZE
+#define CAN_RECORDER_SIZE 2048u
+#endif
+
+/** @brief size of the identifier table as power of two, up to 8 */
+#ifndef CAN_RECORDER_ID_BITS
+#define CAN_RECORDER_ID_BITS 5u
+#endif
+
+/** @brief number of entries of the identifier table */
+#define CAN_RECORDER_IDS (1u << CAN_RECORDER_ID_BITS)
+
+/** @brief version of the capture image */
+#define CAN_RECORDER_FORMAT 0x01u
+
+/** @brief size of the capture image in front of the record area [byte] */
+#define CAN_RECORDER_HEADER_SIZE (16u + 4u * CAN_RECORDER_IDS)
+
+/** @brief largest share of the ring for the frames after the trigger [%] */
+#define CAN_RECORDER_POST_MAX 75u
+
+/** @brief fields of byte 0 of a record */
+#define CAN_RECORDER_TRANSMITTED 0x80u
+#define CAN_RECORDER_LITERAL 0x40u
+#define CAN_RECORDER_TIME_SHIFT 4u
+#define CAN_RECORDER_DLC_MASK 0x0Fu
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief State of the recorder
+ */
+typedef enum
+{
+	CAN_RECORDER_OFF = 0, /**< @brief nothing is logged */
+	CAN_RECORDER_RECORDING = 1, /**< @brief logging, waiting for a trigger */
+	CAN_RECORDER_TRIGGERED = 2, /**< @brief logging the frames after the trigger */
+	CAN_RECORDER_FROZEN = 3 /**< @brief capture complete, may be read */
+}CAN_Recorder_State_TypeDef;
+
+/**
+ * @brief Reason of the capture
+ */
+typedef enum
+{
+	CAN_RECORDER_CAUSE_NONE = 0, /**< @brief not triggered */
+	CAN_RECORDER_CAUSE_ERROR = 1, /**< @brief a bit of the error code was set */
+	CAN_RECORDER_CAUSE_BUSOFF = 2, /**< @brief the CAN peripheral went bus-off */
+	CAN_RECORDER_CAUSE_TIMEOUT = 3, /**< @brief a received message timed out */
+	CAN_RECORDER_CAUSE_MANUAL = 4 /**< @brief triggered by the user */
+}CAN_Recorder_Cause_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Switch the recorder off and clear it. Called by the CAN module when its state is initialized.
+ */
+void CAN_Recorder_Init(void);
+
+/**
+ * @brief Set the configuration, cheap enough for every millisecond
+ * @param enable: 0 switches the recorder off and drops the capture, else it records
+ * @param postShare: share of the ring for the frames after the trigger, up to CAN_RECORDER_POST_MAX,
+ * taken at the next trigger [%]
+ * @param postTime: time after the trigger until the capture is frozen, even if its share is not filled [ms]
+ */
+void CAN_Recorder_Configure(uint8_t enable, uint8_t postShare, uint32_t postTime);
+
+/**
+ * @brief Log a frame, call from the receive interrupt and the transmit complete interrupt
+ * @param message: received or transmitted message
+ * @param transmitted: 0 for a received, 1 for a transmitted message
+ * @param timestamp: CAN_GetTimestampUs() of the frame [us]
+ */
+void CAN_Recorder_Log(const canApi_MessageTypedef *message, uint8_t transmitted, uint32_t timestamp);
+
+/**
+ * @brief Trigger the capture, ignored unless recording and waiting for a trigger
+ * @param cause: reason of the capture
+ */
+void CAN_Recorder_Trigger(CAN_Recorder_Cause_TypeDef cause);
+
+/**
+ * @brief Run the post-trigger time, call every 1ms
+ */
+void CAN_Recorder_Process(void);
+
+/**
+ * @brief Drop the capture and record again
+ */
+void CAN_Recorder_Rearm(void);
+
+/**
+ * @brief Get the state of the recorder, a getter for CAN_uds.c
+ * @return CAN_Recorder_State_TypeDef in bits 0...7, CAN_Recorder_Cause_TypeDef in bits 8...15
+ */
+UInt32 CAN_Recorder_GetState(void);
+
+/**
+ * @brief Get the size of the capture image
+ * @return CAN_RECORDER_HEADER_SIZE plus the record area while frozen, else 0 [byte]
+ */
+UInt32 CAN_Recorder_GetSize(void);
+
+/**
+ * @brief Copy a part of the capture image
+ * @param offset: first byte of the image
+ * @param target: target buffer
+ * @param length: number of bytes
+ * @return number of bytes copied, 0 unless frozen
+ */
+uint32_t CAN_Recorder_Read(uint32_t offset, uint8_t *target, uint32_t length);
+
+/** @} */
+
+#endif /* CAN_RECORDER_H_ */
@@ -0,0 +1,188 @@
+/**
+*******************************************************************************
+* @file CAN_signals.c
+* @brief Table of the canApi_Get_* signals, selectable by index
+* @author FRIWO
+* @date 20.10.2026 - 10:05:17
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_signals
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "CAN_signals.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief table rows for the three getter types */
+#define SIGNAL_FLOAT32(name, factor, size) {#name, canApi_Get_##name, 0, 0, factor, size}
+#define SIGNAL_UINT32(name, size) {#name, 0, canApi_Get_##name, 0, 1.0F, size}
+#define SIGNAL_INT16(name) {#name, 0, 0, canApi_Get_##name, 1.0F, 2}
+
+#define SIGNALS_AVAILABLE ((uint8_t)(sizeof(signal_array) / sizeof(CAN_Signal_TypeDef)))
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE CONSTANTS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief all signals which may be configured into a frame, the index is the position in this array.
+ * Production data and immobilizer codes are left out on purpose.
+ */
+static const CAN_Signal_TypeDef signal_array[] =
+{
+	/*{Name, GetFloat32, GetUInt32, GetInt16, Factor, Size}*/
+	SIGNAL_FLOAT32(INFO_Motor_Current_Iq, 0.1F, 2), /* 0 [A] */
+	SIGNAL_FLOAT32(INFO_Motor_Current_Id, 0.1F, 2), /* 1 [A] */
+	SIGNAL_FLOAT32(INFO_DC_Current, 0.1F, 2), /* 2 [A] */
+	SIGNAL_FLOAT32(INFO_Voltage_DC_Link, 0.01F, 2), /* 3 [V] */
+	SIGNAL_FLOAT32(INFO_Rotor_Speed, 1.0F, 2), /* 4 [rpm] */
+	SIGNAL_FLOAT32(INFO_Motor_Current, 0.1F, 2), /* 5 [A] */
+	SIGNAL_FLOAT32(INFO_Vehicle_Speed, 0.1F, 2), /* 6 [km/h] */
+	SIGNAL_FLOAT32(INFO_Remaining_Distance, 0.1F, 2), /* 7 [km] */
+	SIGNAL_FLOAT32(INFO_Consumption_Ave_Trip, 0.1F, 2), /* 8 [Wh/km] */
+	SIGNAL_FLOAT32(INFO_Ah_Pos, 0.01F, 4), /* 9 [Ah] */
+	SIGNAL_FLOAT32(INFO_Ah_Neg, 0.01F, 4), /* 10 [Ah] */
+	SIGNAL_FLOAT32(INFO_Rel_Torque_Setpoint, 0.1F, 2), /* 11 [%] */
+	SIGNAL_FLOAT32(INFO_Rel_Torque_Max, 0.1F, 2), /* 12 [%] */
+	SIGNAL_FLOAT32(INFO_Rel_Torque_Mapping, 0.1F, 2), /* 13 [%] */
+	SIGNAL_FLOAT32(INFO_ODO_Total_Kilometers, 0.1F, 4), /* 14 [km] */
+	SIGNAL_FLOAT32(INFO_ODO_Trip_Kilometers, 0.1F, 4), /* 15 [km] */
+	SIGNAL_FLOAT32(TEMP_FET_Max, 0.1F, 2), /* 16 [degC] */
+	SIGNAL_FLOAT32(TEMP_Motor, 0.1F, 2), /* 17 [degC] */
+	SIGNAL_FLOAT32(TEMP_MCU, 0.1F, 2), /* 18 [degC] */
+	SIGNAL_FLOAT32(TEMP_Combined_Max_Rel, 0.1F, 2), /* 19 [%] */
+	SIGNAL_UINT32(ERR_Errorcode, 4), /* 20 [-] */
+	SIGNAL_UINT32(ERR_MEM_Trace_0_Errorcode, 4), /* 21 [-] */
+	SIGNAL_FLOAT32(SM_OUT_SYS_Trq_Control, 1.0F, 2), /* 22 [-] */
+	SIGNAL_FLOAT32(SM_PE_Mode_Req_Int, 1.0F, 2), /* 23 [-] */
+	SIGNAL_FLOAT32(SM_BMS_Control_State, 1.0F, 2), /* 24 [-] */
+	SIGNAL_FLOAT32(ROC_Result, 1.0F, 2), /* 25 [-] */
+	SIGNAL_FLOAT32(APP_Disp_Ride_Mode, 1.0F, 2), /* 26 [-] */
+	SIGNAL_UINT32(APP_Boost_Info, 4), /* 27 [-] */
+	SIGNAL_FLOAT32(APP_Boost_Avail_Rel, 0.1F, 2), /* 28 [%] */
+	SIGNAL_FLOAT32(APP_Boost_Avail_As, 0.1F, 2), /* 29 [As] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Temp_MCU, 0.1F, 2), /* 30 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Max_Positive_Current, 0.1F, 2), /* 31 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Max_Negative_Current, 0.1F, 2), /* 32 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_DC_Link_Voltage_Max, 0.1F, 2), /* 33 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_DC_Link_Voltage_Min, 0.1F, 2), /* 34 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Rotor_Speed, 0.1F, 2), /* 35 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Temp_FET, 0.1F, 2), /* 36 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Temp_Motor, 0.1F, 2), /* 37 [%] */
+	SIGNAL_FLOAT32(TRQ_LIM_Derating_Active, 1.0F, 2), /* 38 [-] */
+	SIGNAL_FLOAT32(TRQ_DES_Driver_Reverse_Gear, 1.0F, 2), /* 39 [-] */
+	SIGNAL_FLOAT32(SOC_State_of_Charge, 0.1F, 2), /* 40 [%] */
+	SIGNAL_INT16(BSW_IO_F_CAN_BSW_BusOff), /* 41 [-] */
+	SIGNAL_INT16(BSW_IO_F_CAN_BSW_Passive), /* 42 [-] */
+	SIGNAL_INT16(BSW_IO_F_CAN_BSW_Warning), /* 43 [-] */
+};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+uint8_t CAN_Signals_GetCount(void)
+{
+	return SIGNALS_AVAILABLE;
+}
+
+const CAN_Signal_TypeDef* CAN_Signals_Get(uint8_t index)
+{
+	if (index >= SIGNALS_AVAILABLE)
+	{
+		return 0;
+	}
+	return &signal_array[index];
+}
+
+Float32 CAN_Signals_GetValue(uint8_t index)
+{
+	const CAN_Signal_TypeDef *signal = CAN_Signals_Get(index);
+
+	if (signal == 0)
+	{
+		return 0.0F;
+	}
+	if (signal->GetFloat32 != 0)
+	{
+		return signal->GetFloat32();
+	}
+	if (signal->GetUInt32 != 0)
+	{
+		return (Float32)signal->GetUInt32();
+	}
+	return (Float32)signal->GetInt16();
+}
+
+uint8_t CAN_Signals_GetRaw(uint8_t index, uint32_t *raw)
+{
+	const CAN_Signal_TypeDef *signal = CAN_Signals_Get(index);
+
+	if (signal == 0)
+	{
+		return 0;
+	}
+
+	if (signal->GetFloat32 != 0)
+	{
+		Float32 value = signal->GetFloat32() / signal->Factor;
+		Float32 limit = (signal->Size == 2u) ? 32767.0F : 2147483520.0F;
+
+		/* saturate before the conversion, out of range float to int is undefined */
+		if (value > limit)
+		{
+			value = limit;
+		}
+		else if (value < -limit)
+		{
+			value = -limit;
+		}
+		*raw = (uint32_t)(int32_t)((value >= 0.0F) ? (value + 0.5F) : (value - 0.5F));
+	}
+	else if (signal->GetUInt32 != 0)
+	{
+		*raw = signal->GetUInt32();
+		if (signal->Size == 2u && *raw > 0xFFFFu)
+		{
+			*raw = 0xFFFFu;
+		}
+	}
+	else
+	{
+		*raw = (uint32_t)(int32_t)signal->GetInt16();
+	}
+	return signal->Size;
+}
+
+uint8_t CAN_Signals_Encode(uint8_t index, uint8_t *target, uint8_t space)
+{
+	const CAN_Signal_TypeDef *signal = CAN_Signals_Get(index);
+	uint32_t raw;
+	uint8_t i;
+
+	if (signal == 0 || signal->Size > space)
+	{
+		return 0;
+	}
+
+	(void)CAN_Signals_GetRaw(index, &raw);
+	for (i = 0; i < signal->Size; i++)
+	{
+		target[i] = (uint8_t)(raw >> (8u * i));
+	}
+	return signal->Size;
+}
+
+/** @} */
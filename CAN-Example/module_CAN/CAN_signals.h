@@ -0,0 +1,108 @@
+/**
+*******************************************************************************
+* @file CAN_signals.h
+* @brief Table of the canApi_Get_* signals, selectable by index
+* @author FRIWO
+* @date 20.10.2026 - 10:05:17
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Gives the TX signals of the canApi a number, so a frame layout can be
+* configured with NV variables instead of code. Each signal has a raw size of
+* 2 or 4 bytes. Float32 signals have a factor, raw = physical / factor,
+* rounded and saturated to the signed range of the raw size. UInt32 and Int16
+* signals are sent as they are, saturated to the raw size. Raw values are
+* written in Intel byte order like the signals of the fixed messages.
+*
+* The index of a signal is its position in the table and is part of the
+* interface to the EnableTool configuration: new signals are only appended.
+*/
+
+#ifndef CAN_SIGNALS_H_
+#define CAN_SIGNALS_H_
+
+/**
+* @addtogroup CAN_signals
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief index which selects no signal */
+#define CAN_SIGNAL_NONE 0xFFu
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief getters of the canApi, one of them is set per signal */
+typedef Float32 (*CAN_Signal_FptrGetFloat32)(void);
+typedef UInt32 (*CAN_Signal_FptrGetUInt32)(void);
+typedef Int16 (*CAN_Signal_FptrGetInt16)(void);
+
+/**
+ * @brief One signal of the table
+ */
+typedef struct
+{
+	const char *Name; /**< @brief name of the canApi getter without the canApi_Get_ prefix */
+	CAN_Signal_FptrGetFloat32 GetFloat32; /**< @brief getter of a Float32 signal, else 0 */
+	CAN_Signal_FptrGetUInt32 GetUInt32; /**< @brief getter of a UInt32 signal, else 0 */
+	CAN_Signal_FptrGetInt16 GetInt16; /**< @brief getter of an Int16 signal, else 0 */
+	Float32 Factor; /**< @brief physical value of one raw bit, Float32 signals only */
+	uint8_t Size; /**< @brief raw size, 2 or 4 [byte] */
+}CAN_Signal_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Get the number of signals in the table
+ * @return number of signals, valid indices are 0...count-1
+ */
+uint8_t CAN_Signals_GetCount(void);
+
+/**
+ * @brief Get the description of a signal
+ * @param index: signal index
+ * @return table entry, 0 for an unknown index
+ */
+const CAN_Signal_TypeDef* CAN_Signals_Get(uint8_t index);
+
+/**
+ * @brief Read the physical value of a signal from the canApi
+ * @param index: signal index
+ * @return physical value, 0 for an unknown index
+ */
+Float32 CAN_Signals_GetValue(uint8_t index);
+
+/**
+ * @brief Read the raw value of a signal from the canApi
+ * @param index: signal index
+ * @param raw: target pointer, signed signals are sign extended to 32 bit
+ * @return raw size 2 or 4 [byte], 0 for an unknown index
+ */
+uint8_t CAN_Signals_GetRaw(uint8_t index, uint32_t *raw);
+
+/**
+ * @brief Read a signal and write its raw value, Intel byte order
+ * @param index: signal index
+ * @param target: first byte of the raw value
+ * @param space: bytes available at target
+ * @return number of bytes written, 0 for an unknown index or if the raw value does not fit
+ */
+uint8_t CAN_Signals_Encode(uint8_t index, uint8_t *target, uint8_t space);
+
+/** @} */
+
+#endif /* CAN_SIGNALS_H_ */
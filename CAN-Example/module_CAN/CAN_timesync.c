@@ -0,0 +1,430 @@
+/**
+*******************************************************************************
+* @file CAN_timesync.c
+* @brief Time synchronization over CAN with SYNC and FUP messages
+* @author FRIWO
+* @date 20.10.2026 - 19:12:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_timesync
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_custom.h"
+#include "CAN_timesync.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+#define US_PER_SECOND 1000000u
+#define NS_PER_US 1000u
+#define NS_PER_SECOND 1000000000u
+#define PPB 1000000000
+
+/** @brief fields of byte 2 and byte 3 */
+#define DOMAIN_SHIFT 4u
+#define SEQUENCE_MASK 0x0Fu
+#define OVERFLOW_MASK 0x03u
+
+/** @brief master: time to wait for the transmit complete of SYNC [ms] */
+#define CONFIRM_TIMEOUT_MS 5u
+
+/** @brief slave: weight of a new drift measurement, 1/DRIFT_FILTER */
+#define DRIFT_FILTER 4
+
+/** @brief slave: a larger rate difference is a restart of the master, not a drift [ppb] */
+#define DRIFT_LIMIT 1000000
+
+/** @brief storage of the synchronization state, one node per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_TIMESYNC_LOCAL _Thread_local
+#else
+#define CAN_TIMESYNC_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Step of the master
+ */
+typedef enum
+{
+	MASTER_IDLE = 0, /**< @brief waiting for the interval */
+	MASTER_CONFIRM = 1, /**< @brief SYNC queued, waiting for its transmit complete */
+	MASTER_FUP = 2 /**< @brief FUP to send */
+}timeSyncMasterStep_TypeDef;
+
+/**
+ * @brief Complete state of the synchronization
+ */
+typedef struct
+{
+	CAN_TimeSync_Mode_TypeDef Mode; /**< @brief role */
+	uint8_t Domain; /**< @brief time domain */
+	uint32_t Interval; /**< @brief master: time between two SYNC [ms] */
+	uint32_t Timeout; /**< @brief slave: time without synchronization until timeout [ms] */
+	CAN_TimeSync_Status_TypeDef Status; /**< @brief state of the corrected clock */
+
+	uint32_t LocalLast; /**< @brief last local timestamp of CAN_TimeSync_Process() [us] */
+	uint64_t LocalExtended; /**< @brief LocalLast without wrap [us] */
+
+	timeSyncMasterStep_TypeDef Step; /**< @brief master: step of the current cycle */
+	uint32_t IntervalTimer; /**< @brief master: time until the next SYNC [ms] */
+	uint32_t ConfirmTimer; /**< @brief master: time since SYNC was queued [ms] */
+	uint8_t Sequence; /**< @brief sequence counter of the current SYNC and FUP */
+	uint32_t SyncSeconds; /**< @brief master: seconds sent with SYNC, slave: seconds of the received SYNC */
+	uint64_t QueueTime; /**< @brief master: local time when SYNC was queued [us] */
+	volatile uint32_t ConfirmTimestamp; /**< @brief master: CAN_GetTimestampUs() at the transmit complete of SYNC */
+	volatile uint8_t Confirmed; /**< @brief master: 0x01u after the transmit complete of SYNC */
+	volatile uint8_t TxCompleteSeen; /**< @brief master: 0x01u once CAN_TimeSync_TxComplete() was called */
+
+	uint8_t SyncValid; /**< @brief slave: 0x01u after SYNC until its FUP */
+	uint64_t SyncLocal; /**< @brief slave: local time of the received SYNC [us] */
+	uint8_t Synchronized; /**< @brief slave: 0x01u after the first synchronization */
+	uint8_t DriftValid; /**< @brief slave: 0x01u after the second synchronization */
+	uint64_t BaseLocal; /**< @brief slave: local time of the last synchronization [us] */
+	uint64_t BaseTime; /**< @brief slave: time of the master at BaseLocal [us] */
+	int32_t Drift; /**< @brief slave: rate of the master relative to the local oscillator [ppb] */
+	CAN_TimeSync_Stats_TypeDef Stats; /**< @brief slave: statistics */
+}timeSyncState_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static uint64_t ExtendTimestamp(uint32_t timestamp);
+static uint64_t LocalToSyncTime(uint64_t local);
+static void WriteUInt32(uint8_t *target, uint32_t value);
+static uint32_t ReadUInt32(const uint8_t *source);
+static canApi_StatusTypeDef SendFrame(uint8_t type, uint8_t byte3, uint32_t value);
+static void ProcessMaster(void);
+static void Synchronize(uint64_t local, uint64_t time);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_TIMESYNC_LOCAL timeSyncState_TypeDef timeSync;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Local time without wrap, for timestamps up to 35 minutes before or after the last CAN_TimeSync_Process()
+ */
+static uint64_t ExtendTimestamp(uint32_t timestamp)
+{
+	return timeSync.LocalExtended + (uint64_t)(int64_t)(int32_t)(timestamp - timeSync.LocalLast);
+}
+
+/**
+ * @brief Corrected clock at a local time: time of the master at the last synchronization
+ * plus the local time since then, scaled by the drift
+ */
+static uint64_t LocalToSyncTime(uint64_t local)
+{
+	int64_t elapsed;
+
+	if (timeSync.Mode != CAN_TIMESYNC_SLAVE || timeSync.Synchronized == 0u)
+	{
+		return local;
+	}
+	elapsed = (int64_t)(local - timeSync.BaseLocal);
+	return timeSync.BaseTime + (uint64_t)(elapsed + elapsed * timeSync.Drift / PPB);
+}
+
+/**
+ * @brief Motorola byte order
+ */
+static void WriteUInt32(uint8_t *target, uint32_t value)
+{
+	target[0] = (uint8_t)(value >> 24);
+	target[1] = (uint8_t)(value >> 16);
+	target[2] = (uint8_t)(value >> 8);
+	target[3] = (uint8_t)value;
+}
+
+static uint32_t ReadUInt32(const uint8_t *source)
+{
+	return ((uint32_t)source[0] << 24) | ((uint32_t)source[1] << 16) | ((uint32_t)source[2] << 8) | source[3];
+}
+
+/**
+ * @brief Put SYNC or FUP of the current sequence counter into the transmit buffer
+ */
+static canApi_StatusTypeDef SendFrame(uint8_t type, uint8_t byte3, uint32_t value)
+{
+	canApi_MessageTypedef message;
+
+	message.Identifier = CAN_TIMESYNC_ID;
+	message.IDE = 0;
+	message.RTR = 0;
+	message.DLC = 8;
+	message.Priority = 1;
+	message.Data[0] = type;
+	message.Data[1] = 0;
+	message.Data[2] = (uint8_t)((timeSync.Domain << DOMAIN_SHIFT) | timeSync.Sequence);
+	message.Data[3] = byte3;
+	WriteUInt32(&message.Data[4], value);
+	return canApi_SendMessage(&message);
+}
+
+/**
+ * @brief One cycle of the master: SYNC with the seconds at queueing, FUP with the nanoseconds
+ * from those seconds to the transmit complete. Without transmit complete hook the queueing time is used.
+ */
+static void ProcessMaster(void)
+{
+	uint64_t sent;
+	uint32_t nanoseconds;
+	uint8_t overflow;
+
+	if (timeSync.IntervalTimer > 0u)
+	{
+		timeSync.IntervalTimer--;
+	}
+
+	switch (timeSync.Step)
+	{
+		case MASTER_IDLE:
+			if (timeSync.IntervalTimer > 0u)
+			{
+				break;
+			}
+			timeSync.QueueTime = timeSync.LocalExtended;
+			timeSync.SyncSeconds = (uint32_t)(timeSync.QueueTime / US_PER_SECOND);
+			timeSync.Confirmed = 0;
+			if (SendFrame(CAN_TIMESYNC_TYPE_SYNC, 0, timeSync.SyncSeconds) == CAN_OK)
+			{
+				timeSync.IntervalTimer = timeSync.Interval;
+				timeSync.ConfirmTimer = 0;
+				timeSync.Step = MASTER_CONFIRM;
+			}
+			break;
+
+		case MASTER_CONFIRM:
+			if (timeSync.Confirmed == 0u)
+			{
+				timeSync.ConfirmTimer++;
+				if (timeSync.ConfirmTimer < CONFIRM_TIMEOUT_MS)
+				{
+					break;
+				}
+				if (timeSync.TxCompleteSeen != 0u)
+				{
+					/* SYNC lost, a FUP with the queueing time would mislead the slaves */
+					timeSync.Sequence = (uint8_t)((timeSync.Sequence + 1u) & SEQUENCE_MASK);
+					timeSync.Step = MASTER_IDLE;
+					break;
+				}
+				timeSync.ConfirmTimestamp = (uint32_t)timeSync.QueueTime;
+			}
+			timeSync.Step = MASTER_FUP;
+			/* fall through */
+
+		case MASTER_FUP:
+			sent = ExtendTimestamp(timeSync.ConfirmTimestamp) - (uint64_t)timeSync.SyncSeconds * US_PER_SECOND;
+			overflow = (uint8_t)(sent / US_PER_SECOND);
+			nanoseconds = (uint32_t)(sent % US_PER_SECOND) * NS_PER_US;
+			if (SendFrame(CAN_TIMESYNC_TYPE_FUP, (uint8_t)(overflow & OVERFLOW_MASK), nanoseconds) == CAN_OK)
+			{
+				timeSync.Sequence = (uint8_t)((timeSync.Sequence + 1u) & SEQUENCE_MASK);
+				timeSync.Step = MASTER_IDLE;
+			}
+			break;
+
+		default:
+			timeSync.Step = MASTER_IDLE;
+			break;
+	}
+}
+
+/**
+ * @brief Slave: the master had the given time at the given local time
+ * @param local: local time of SYNC [us]
+ * @param time: time of the master at SYNC [us]
+ */
+static void Synchronize(uint64_t local, uint64_t time)
+{
+	int64_t offset = (int64_t)(time - LocalToSyncTime(local));
+
+	if (timeSync.Synchronized != 0u && local > timeSync.BaseLocal)
+	{
+		int64_t elapsed = (int64_t)(local - timeSync.BaseLocal);
+		int64_t measured = ((int64_t)(time - timeSync.BaseTime) - elapsed) * PPB / elapsed;
+
+		if (measured > DRIFT_LIMIT || measured < -DRIFT_LIMIT)
+		{
+			/* the master restarted or jumped, learn the drift again */
+			timeSync.Drift = 0;
+			timeSync.DriftValid = 0;
+		}
+		else if (timeSync.DriftValid == 0u)
+		{
+			timeSync.Drift = (int32_t)measured;
+			timeSync.DriftValid = 1;
+		}
+		else
+		{
+			uint32_t magnitude = (uint32_t)((offset < 0) ? -offset : offset);
+
+			timeSync.Drift += (int32_t)((measured - timeSync.Drift) / DRIFT_FILTER);
+			if (magnitude > timeSync.Stats.MaxOffset)
+			{
+				timeSync.Stats.MaxOffset = magnitude;
+			}
+		}
+	}
+	timeSync.Stats.Offset = (int32_t)((offset > INT32_MAX) ? INT32_MAX : ((offset < INT32_MIN) ? INT32_MIN : offset));
+	timeSync.Stats.Drift = timeSync.Drift;
+	timeSync.Stats.SyncCount++;
+	timeSync.BaseLocal = local;
+	timeSync.BaseTime = time;
+	timeSync.Synchronized = 1;
+	timeSync.Status = CAN_TIMESYNC_SYNCHRONIZED;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_TimeSync_Init(void)
+{
+	memset(&timeSync, 0, sizeof(timeSync));
+	timeSync.LocalLast = CAN_GetTimestampUs();
+	timeSync.LocalExtended = timeSync.LocalLast;
+}
+
+void CAN_TimeSync_Configure(CAN_TimeSync_Mode_TypeDef mode, uint8_t domain, uint32_t interval, uint32_t timeout)
+{
+	domain &= SEQUENCE_MASK;
+	if (mode != timeSync.Mode || domain != timeSync.Domain)
+	{
+		uint32_t localLast = timeSync.LocalLast;
+		uint64_t localExtended = timeSync.LocalExtended;
+
+		/* the local time keeps running, everything learned from the old master is dropped */
+		memset(&timeSync, 0, sizeof(timeSync));
+		timeSync.LocalLast = localLast;
+		timeSync.LocalExtended = localExtended;
+		timeSync.Mode = mode;
+		timeSync.Domain = domain;
+		timeSync.Status = (mode == CAN_TIMESYNC_MASTER) ? CAN_TIMESYNC_SYNCHRONIZED : CAN_TIMESYNC_UNSYNCHRONIZED;
+	}
+	timeSync.Interval = (interval > 0u) ? interval : 1u;
+	timeSync.Timeout = timeout;
+}
+
+uint8_t CAN_TimeSync_Receive(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	uint8_t sequence;
+
+	if (message->Identifier != CAN_TIMESYNC_ID || message->IDE != 0u || message->RTR != 0u || message->DLC != 8u
+		|| (message->Data[0] != CAN_TIMESYNC_TYPE_SYNC && message->Data[0] != CAN_TIMESYNC_TYPE_FUP))
+	{
+		return 0;
+	}
+	if (timeSync.Mode != CAN_TIMESYNC_SLAVE || (message->Data[2] >> DOMAIN_SHIFT) != timeSync.Domain)
+	{
+		return 1;
+	}
+
+	sequence = (uint8_t)(message->Data[2] & SEQUENCE_MASK);
+	if (message->Data[0] == CAN_TIMESYNC_TYPE_SYNC)
+	{
+		timeSync.SyncValid = 1;
+		timeSync.Sequence = sequence;
+		timeSync.SyncSeconds = ReadUInt32(&message->Data[4]);
+		timeSync.SyncLocal = ExtendTimestamp(timestamp);
+	}
+	else if (timeSync.SyncValid != 0u && sequence == timeSync.Sequence)
+	{
+		uint32_t nanoseconds = ReadUInt32(&message->Data[4]);
+
+		timeSync.SyncValid = 0;
+		if (nanoseconds < NS_PER_SECOND)
+		{
+			Synchronize(timeSync.SyncLocal, ((uint64_t)timeSync.SyncSeconds + (message->Data[3] & OVERFLOW_MASK)) * US_PER_SECOND
+				+ nanoseconds / NS_PER_US);
+		}
+		else
+		{
+			timeSync.Stats.ErrorCount++;
+		}
+	}
+	else
+	{
+		timeSync.Stats.ErrorCount++;
+	}
+	return 1;
+}
+
+void CAN_TimeSync_TxComplete(const canApi_MessageTypedef *message, uint32_t timestamp)
+{
+	timeSync.TxCompleteSeen = 1;
+	if (timeSync.Mode == CAN_TIMESYNC_MASTER && timeSync.Step == MASTER_CONFIRM && message->Identifier == CAN_TIMESYNC_ID
+		&& message->IDE == 0u && message->Data[0] == CAN_TIMESYNC_TYPE_SYNC
+		&& (message->Data[2] & SEQUENCE_MASK) == timeSync.Sequence)
+	{
+		timeSync.ConfirmTimestamp = timestamp;
+		timeSync.Confirmed = 1;
+	}
+}
+
+void CAN_TimeSync_Process(void)
+{
+	uint32_t now = CAN_GetTimestampUs();
+
+	timeSync.LocalExtended += now - timeSync.LocalLast;
+	timeSync.LocalLast = now;
+
+	if (timeSync.Mode == CAN_TIMESYNC_MASTER)
+	{
+		ProcessMaster();
+	}
+	else if (timeSync.Mode == CAN_TIMESYNC_SLAVE && timeSync.Synchronized != 0u && timeSync.Timeout > 0u
+		&& timeSync.LocalExtended - timeSync.BaseLocal > (uint64_t)timeSync.Timeout * 1000u)
+	{
+		timeSync.Status = CAN_TIMESYNC_TIMEOUT;
+	}
+	else
+	{
+		/* do nothing */
+	}
+}
+
+uint64_t CAN_TimeSync_GetTimeUs(void)
+{
+	return LocalToSyncTime(ExtendTimestamp(CAN_GetTimestampUs()));
+}
+
+uint64_t CAN_TimeSync_ToSyncTime(uint32_t timestamp)
+{
+	return LocalToSyncTime(ExtendTimestamp(timestamp));
+}
+
+CAN_TimeSync_Status_TypeDef CAN_TimeSync_GetStatus(void)
+{
+	return timeSync.Status;
+}
+
+void CAN_TimeSync_GetStats(CAN_TimeSync_Stats_TypeDef *stats)
+{
+	*stats = timeSync.Stats;
+}
+
+/** @} */
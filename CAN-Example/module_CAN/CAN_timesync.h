@@ -0,0 +1,167 @@
+/**
+*******************************************************************************
+* @file CAN_timesync.h
+* @brief Time synchronization over CAN with SYNC and FUP messages
+* @author FRIWO
+* @date 20.10.2026 - 19:12:40
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Shares one time base between the nodes of the bus in the way of the AUTOSAR
+* CAN time synchronization, without CRC:
+* - the master sends SYNC with the seconds of its time when it queues the
+*   message, then FUP with the nanoseconds which complete it to the time at
+*   the transmit complete of SYNC, see CAN_TimeSync_TxComplete()
+* - a slave stamps SYNC in the receive interrupt and takes the time of FUP
+*   as the time of the master at that stamp
+*
+* Both frames are sent on CAN_TIMESYNC_ID with DLC 8, multi byte values in
+* Motorola byte order:
+* - byte 0: type, CAN_TIMESYNC_TYPE_SYNC or CAN_TIMESYNC_TYPE_FUP
+* - byte 1: 0
+* - byte 2: time domain in bits 4...7, sequence counter in bits 0...3
+* - byte 3: SYNC 0, FUP overflow of the seconds in bits 0...1
+* - bytes 4...7: SYNC seconds, FUP nanoseconds
+*
+* The slave estimates the drift of its oscillator from two consecutive
+* synchronizations and runs its corrected clock at the rate of the master in
+* between. At each synchronization the clock steps by the remaining offset,
+* which is the error of the drift estimate over one interval. Without a
+* synchronization for the timeout the status turns CAN_TIMESYNC_TIMEOUT and
+* the clock continues with the last drift. The master's own clock is the time
+* base, starting at 0 at power-up.
+*
+* Local time is CAN_GetTimestampUs(), precise stamps need CAN_RxIsrHook()
+* and CAN_TxCompleteHook() of the basic software.
+*/
+
+#ifndef CAN_TIMESYNC_H_
+#define CAN_TIMESYNC_H_
+
+/**
+* @addtogroup CAN_timesync
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief standard identifier of SYNC and FUP, above every periodic message in priority */
+#ifndef CAN_TIMESYNC_ID
+#define CAN_TIMESYNC_ID 0x080u
+#endif
+
+/** @brief message types of byte 0 */
+#define CAN_TIMESYNC_TYPE_SYNC 0x10u
+#define CAN_TIMESYNC_TYPE_FUP 0x18u
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Role of the node
+ */
+typedef enum
+{
+	CAN_TIMESYNC_OFF = 0, /**< @brief no time synchronization, the clock is the local time */
+	CAN_TIMESYNC_MASTER = 1, /**< @brief sends SYNC and FUP, the local time is the time base */
+	CAN_TIMESYNC_SLAVE = 2 /**< @brief follows the SYNC and FUP of the master */
+}CAN_TimeSync_Mode_TypeDef;
+
+/**
+ * @brief State of the corrected clock
+ */
+typedef enum
+{
+	CAN_TIMESYNC_UNSYNCHRONIZED = 0, /**< @brief off or no synchronization yet, the clock is the local time */
+	CAN_TIMESYNC_SYNCHRONIZED = 1, /**< @brief master, or slave with a synchronization within the timeout */
+	CAN_TIMESYNC_TIMEOUT = 2 /**< @brief slave without synchronization for the timeout, the clock continues with the last drift */
+}CAN_TimeSync_Status_TypeDef;
+
+/**
+ * @brief Statistics of the slave
+ */
+typedef struct
+{
+	int32_t Offset; /**< @brief time of the master minus the corrected clock at the last synchronization [us] */
+	uint32_t MaxOffset; /**< @brief largest magnitude of Offset since the second synchronization [us] */
+	int32_t Drift; /**< @brief estimated rate of the master relative to the local oscillator [ppb] */
+	uint32_t SyncCount; /**< @brief number of synchronizations */
+	uint32_t ErrorCount; /**< @brief FUP without matching SYNC */
+}CAN_TimeSync_Stats_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Switch the synchronization off. Called by the CAN module when its state is initialized.
+ */
+void CAN_TimeSync_Init(void);
+
+/**
+ * @brief Set the role, cheap enough for every millisecond. A changed role or domain restarts the synchronization.
+ * @param mode: role of the node
+ * @param domain: time domain 0...15, frames of other domains are ignored
+ * @param interval: master: time between two SYNC [ms]
+ * @param timeout: slave: time without synchronization until CAN_TIMESYNC_TIMEOUT [ms]
+ */
+void CAN_TimeSync_Configure(CAN_TimeSync_Mode_TypeDef mode, uint8_t domain, uint32_t interval, uint32_t timeout);
+
+/**
+ * @brief Process a received message
+ * @param message: received message
+ * @param timestamp: CAN_GetTimestampUs() in the receive interrupt [us]
+ * @return 1 if the message is SYNC or FUP, else 0
+ */
+uint8_t CAN_TimeSync_Receive(const canApi_MessageTypedef *message, uint32_t timestamp);
+
+/**
+ * @brief Record the transmit complete of SYNC, may be called from the transmit complete interrupt
+ * @param message: message which was transmitted on the bus
+ * @param timestamp: CAN_GetTimestampUs() at the transmit complete [us]
+ */
+void CAN_TimeSync_TxComplete(const canApi_MessageTypedef *message, uint32_t timestamp);
+
+/**
+ * @brief Send SYNC and FUP as master and run the timeout of the slave, call every 1ms
+ */
+void CAN_TimeSync_Process(void);
+
+/**
+ * @brief Get the corrected clock
+ * @return synchronized time [us]
+ */
+uint64_t CAN_TimeSync_GetTimeUs(void);
+
+/**
+ * @brief Convert a local timestamp of the last 35 minutes into the corrected clock, e.g. for a logged event
+ * @param timestamp: CAN_GetTimestampUs() at the event [us]
+ * @return synchronized time of the event [us]
+ */
+uint64_t CAN_TimeSync_ToSyncTime(uint32_t timestamp);
+
+/**
+ * @brief Get the state of the corrected clock
+ * @return status
+ */
+CAN_TimeSync_Status_TypeDef CAN_TimeSync_GetStatus(void);
+
+/**
+ * @brief Get the statistics of the slave
+ * @param stats: target pointer to store the statistics
+ */
+void CAN_TimeSync_GetStats(CAN_TimeSync_Stats_TypeDef *stats);
+
+/** @} */
+
+#endif /* CAN_TIMESYNC_H_ */
@@ -0,0 +1,854 @@
+/**
+*******************************************************************************
+* @file CAN_uds.c
+* @brief UDS (ISO 14229-1) diagnostic server for on-demand data
+* @author FRIWO
+* @date 20.10.2026 - 14:21:37
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_uds
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_uds.h"
+#include "CAN_isotp.h"
+#include "CAN_signals.h"
+#include "CAN_recorder.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief service identifiers of the requests, a positive response is SID + SID_POSITIVE */
+#define SID_READ_DTC_INFORMATION 0x19u
+#define SID_READ_DATA_BY_IDENTIFIER 0x22u
+#define SID_READ_MEMORY_BY_ADDRESS 0x23u
+#define SID_REQUEST_DOWNLOAD 0x34u
+#define SID_TRANSFER_DATA 0x36u
+#define SID_REQUEST_TRANSFER_EXIT 0x37u
+#define SID_TESTER_PRESENT 0x3Eu
+#define SID_POSITIVE 0x40u
+#define SID_NEGATIVE 0x7Fu
+
+/** @brief negative response codes */
+#define NRC_SERVICE_NOT_SUPPORTED 0x11u
+#define NRC_SUBFUNCTION_NOT_SUPPORTED 0x12u
+#define NRC_INCORRECT_LENGTH 0x13u
+#define NRC_RESPONSE_TOO_LONG 0x14u
+#define NRC_CONDITIONS_NOT_CORRECT 0x22u
+#define NRC_REQUEST_SEQUENCE_ERROR 0x24u
+#define NRC_REQUEST_OUT_OF_RANGE 0x31u
+#define NRC_UPLOAD_DOWNLOAD_NOT_ACCEPTED 0x70u
+#define NRC_TRANSFER_DATA_SUSPENDED 0x71u
+#define NRC_GENERAL_PROGRAMMING_FAILURE 0x72u
+#define NRC_WRONG_BLOCK_SEQUENCE_COUNTER 0x73u
+#define NRC_RESPONSE_PENDING 0x78u
+
+/** @brief sub-functions */
+#define SUPPRESS_POSITIVE_RESPONSE 0x80u
+#define SUBFUNCTION_MASK 0x7Fu
+#define DTC_NUMBER_BY_STATUS_MASK 0x01u
+#define DTC_BY_STATUS_MASK 0x02u
+#define DTC_SUPPORTED 0x0Au
+#define TESTER_PRESENT_ZERO 0x00u
+
+/** @brief DTC status bits */
+#define DTC_STATUS_TEST_FAILED 0x01u
+#define DTC_STATUS_CONFIRMED 0x08u
+#define DTC_STATUS_AVAILABILITY (DTC_STATUS_TEST_FAILED | DTC_STATUS_CONFIRMED)
+
+/** @brief DTCFormatIdentifier ISO_14229-1_DTCFormat */
+#define DTC_FORMAT_ISO14229 0x01u
+
+/** @brief bits of canApi_Get_ERR_Errorcode() with an error number, see message 0x209 */
+#define DTC_COUNT 31u
+
+/** @brief getters per DID of did_array */
+#define DID_MAX_GETTERS 3u
+
+/** @brief TransferData request: SID, blockSequenceCounter, data, CRC-32 */
+#define BLOCK_LENGTH (2u + CAN_UDS_BLOCK_DATA + CRC_SIZE)
+#define CRC_SIZE 4u
+
+/** @brief response size, holds every supported DTC */
+#define RESPONSE_SIZE (3u + 4u * DTC_COUNT)
+
+/** @brief service result: the request waits for the flash and stays in the receive buffer */
+#define RESPONSE_LATER 0xFFFFFFFFu
+
+/** @brief time until the first and between further responsePending of a waiting request [ms] */
+#define RESPONSE_PENDING_FIRST_MS 40u
+#define RESPONSE_PENDING_REPEAT_MS 2000u
+
+/** @brief lengthFormatIdentifier of the RequestDownload response: maxNumberOfBlockLength in 2 bytes */
+#define LENGTH_FORMAT_2_BYTES 0x20u
+
+#if BLOCK_LENGTH > 0xFFFFu
+#error "CAN_UDS_BLOCK_DATA does not fit into maxNumberOfBlockLength"
+#endif
+
+/** @brief fill byte of the ISO-TP frames */
+#define PADDING 0xCCu
+
+/** @brief storage of the server state, one server per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_UDS_LOCAL _Thread_local
+#else
+#define CAN_UDS_LOCAL
+#endif
+
+#define DIDS_AVAILABLE (sizeof(did_array) / sizeof(udsDid_TypeDef))
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief One data identifier, the data record is the 4 byte value of each getter in this order
+ */
+typedef struct
+{
+	uint16_t Identifier; /**< @brief DID */
+	CAN_Signal_FptrGetUInt32 Getter[DID_MAX_GETTERS]; /**< @brief getters of the data record, unused ones are 0 */
+}udsDid_TypeDef;
+
+/**
+ * @brief Phase of a download
+ */
+typedef enum
+{
+	DOWNLOAD_IDLE = 0, /**< @brief no download */
+	DOWNLOAD_ERASE = 1, /**< @brief RequestDownload waits for the erase */
+	DOWNLOAD_TRANSFER = 2 /**< @brief TransferData and RequestTransferExit accepted */
+}udsDownloadPhase_TypeDef;
+
+/**
+ * @brief Complete state of the server
+ */
+typedef struct
+{
+	uint8_t Open; /**< @brief 1 while the ISO-TP channel is open */
+	uint8_t Buffer[2][BLOCK_LENGTH]; /**< @brief receive buffers of the ISO-TP channel, the other one may be programmed */
+	uint8_t RxBuffer; /**< @brief index of the buffer given to the ISO-TP channel */
+	uint8_t Response[RESPONSE_SIZE]; /**< @brief response, read by CAN_isotp.c while it is sent */
+	const uint8_t *TxData; /**< @brief response to send, Response or the block buffer not given to the ISO-TP channel */
+	uint32_t WaitMs; /**< @brief time the current request waits for the flash [ms] */
+	uint8_t Phase; /**< @brief udsDownloadPhase_TypeDef */
+	uint8_t Sequence; /**< @brief expected blockSequenceCounter */
+	uint8_t BlockAccepted; /**< @brief 1 after the first block, a repeated block is then acknowledged again */
+	uint32_t Address; /**< @brief target address of the next block */
+	uint32_t Remaining; /**< @brief bytes still expected */
+	uint32_t ImageCrc; /**< @brief running CRC-32 of the accepted blocks, not inverted */
+}udsState_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void PutUInt32(uint8_t *target, uint32_t value);
+static uint32_t NegativeResponse(uint8_t sid, uint8_t code);
+static uint32_t ReadDid(uint16_t identifier, uint8_t *target, uint32_t space);
+static uint32_t GetUInt32(const uint8_t *source, uint8_t size);
+static uint32_t Crc32Update(uint32_t crc, const uint8_t *data, uint32_t length);
+static void EndDownload(void);
+static uint32_t ReadDataByIdentifier(const uint8_t *request, uint32_t length);
+static uint8_t GetDtcStatus(uint8_t bit, uint32_t errorCode, uint32_t errorMemory);
+static uint32_t ReadDtcInformation(const uint8_t *request, uint32_t length);
+static uint32_t TesterPresent(const uint8_t *request, uint32_t length);
+static uint32_t ReadMemoryByAddress(const uint8_t *request, uint32_t length);
+static uint32_t RequestDownload(const uint8_t *request, uint32_t length);
+static uint32_t TransferData(const uint8_t *request, uint32_t length);
+static uint32_t RequestTransferExit(const uint8_t *request, uint32_t length);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE CONSTANTS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief identity and production data a tester may read, formerly only broadcast in 0x601...0x604
+ */
+static const udsDid_TypeDef did_array[] =
+{
+	/*{Identifier, Getter}*/
+	{CAN_UDS_DID_SERIAL_NUMBER, {canApi_Get_PROD_C_HW_Prod_Info_1, 0, 0}}, /* as MC_Prod_Data_03 */
+	{CAN_UDS_DID_HW_NUMBER, {canApi_Get_PROD_M_HW_ID1, canApi_Get_PROD_M_HW_ID2, 0}}, /* as MC_Prod_Data_04 */
+	{CAN_UDS_DID_SW_VERSION, {canApi_Get_PROD_M_BSW_Ver_Release, canApi_Get_PROD_M_BSW_Ver_Revision, 0}}, /* as MC_Prod_Data_01 */
+	{CAN_UDS_DID_DATASET, {canApi_Get_BSW_C_BSW_ET_Dataset_ID1, canApi_Get_BSW_C_BSW_ET_Dataset_ID2,
+		canApi_Get_BSW_C_BSW_ET_Dataset_ID3}}, /* as MC_Prod_Data_02, dataset ID 3 not divided by 1000 */
+	{CAN_UDS_DID_IMMO_CHALLENGE, {canApi_Get_BSW_Immo_Challenge_Lower, canApi_Get_BSW_Immo_Challenge_Higher, 0}},
+	{CAN_UDS_DID_ERROR_STATE, {canApi_Get_ERR_Errorcode, canApi_Get_ERR_MEM_Trace_0_Errorcode, 0}},
+	{CAN_UDS_DID_RECORDER, {CAN_Recorder_GetState, CAN_Recorder_GetSize, 0}},
+};
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) per nibble, a compromise between
+ * the flash of a byte table and the time of the bitwise calculation
+ */
+static const uint32_t crc32Nibble_array[16] =
+{
+	0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+	0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
+};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_UDS_LOCAL udsState_TypeDef uds;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Write a value in Motorola byte order
+ */
+static void PutUInt32(uint8_t *target, uint32_t value)
+{
+	target[0] = (uint8_t)(value >> 24);
+	target[1] = (uint8_t)(value >> 16);
+	target[2] = (uint8_t)(value >> 8);
+	target[3] = (uint8_t)value;
+}
+
+/**
+ * @brief Read a value of 1...4 bytes in Motorola byte order
+ */
+static uint32_t GetUInt32(const uint8_t *source, uint8_t size)
+{
+	uint32_t value = 0;
+	uint8_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		value = (value << 8) | source[i];
+	}
+	return value;
+}
+
+/**
+ * @brief Continue a CRC-32, start with 0xFFFFFFFF and invert the result
+ */
+static uint32_t Crc32Update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	uint32_t i;
+
+	for (i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		crc = (crc >> 4) ^ crc32Nibble_array[crc & 0x0Fu];
+		crc = (crc >> 4) ^ crc32Nibble_array[crc & 0x0Fu];
+	}
+	return crc;
+}
+
+/**
+ * @brief Forget a download, the next TransferData is answered with requestSequenceError
+ */
+static void EndDownload(void)
+{
+	uds.Phase = DOWNLOAD_IDLE;
+	uds.Remaining = 0;
+}
+
+/**
+ * @brief Build a negative response
+ * @return response length
+ */
+static uint32_t NegativeResponse(uint8_t sid, uint8_t code)
+{
+	uds.Response[0] = SID_NEGATIVE;
+	uds.Response[1] = sid;
+	uds.Response[2] = code;
+	return 3;
+}
+
+/**
+ * @brief Write the DID and its data record
+ * @param identifier: DID
+ * @param target: target buffer
+ * @param space: free bytes in the target buffer
+ * @return number of bytes written, 0 if the DID is not supported, space + 1 if it does not fit
+ */
+static uint32_t ReadDid(uint16_t identifier, uint8_t *target, uint32_t space)
+{
+	uint32_t length = 2;
+	uint32_t i;
+
+	if (identifier >= CAN_UDS_DID_SIGNAL_BASE && identifier - CAN_UDS_DID_SIGNAL_BASE < CAN_Signals_GetCount())
+	{
+		uint32_t raw;
+		uint8_t size;
+
+		if (space < 2u + 4u)
+		{
+			return space + 1u;
+		}
+		size = CAN_Signals_GetRaw((uint8_t)(identifier - CAN_UDS_DID_SIGNAL_BASE), &raw);
+		target[0] = (uint8_t)(identifier >> 8);
+		target[1] = (uint8_t)identifier;
+		for (i = 0; i < size; i++)
+		{
+			target[2u + i] = (uint8_t)(raw >> (8u * (size - 1u - i)));
+		}
+		return 2u + size;
+	}
+
+	for (i = 0; i < DIDS_AVAILABLE; i++)
+	{
+		const udsDid_TypeDef *did = &did_array[i];
+		uint32_t n;
+
+		if (did->Identifier != identifier)
+		{
+			continue;
+		}
+		for (n = 0; n < DID_MAX_GETTERS && did->Getter[n] != 0; n++)
+		{
+			length += 4u;
+		}
+		if (length > space)
+		{
+			return space + 1u;
+		}
+		target[0] = (uint8_t)(identifier >> 8);
+		target[1] = (uint8_t)identifier;
+		for (n = 0; n < DID_MAX_GETTERS && did->Getter[n] != 0; n++)
+		{
+			PutUInt32(&target[2u + 4u * n], did->Getter[n]());
+		}
+		return length;
+	}
+	return 0;
+}
+
+/**
+ * @brief 0x22 ReadDataByIdentifier. Unsupported DIDs are left out of the response,
+ * requestOutOfRange is only sent if none is supported.
+ * @return response length
+ */
+static uint32_t ReadDataByIdentifier(const uint8_t *request, uint32_t length)
+{
+	uint32_t position = 1;
+	uint32_t offset;
+
+	if (length < 3u || (length - 1u) % 2u != 0u)
+	{
+		return NegativeResponse(SID_READ_DATA_BY_IDENTIFIER, NRC_INCORRECT_LENGTH);
+	}
+
+	uds.Response[0] = SID_READ_DATA_BY_IDENTIFIER + SID_POSITIVE;
+	for (offset = 1; offset < length; offset += 2u)
+	{
+		uint16_t identifier = (uint16_t)((request[offset] << 8) | request[offset + 1u]);
+		uint32_t written = ReadDid(identifier, &uds.Response[position], RESPONSE_SIZE - position);
+
+		if (written > RESPONSE_SIZE - position)
+		{
+			return NegativeResponse(SID_READ_DATA_BY_IDENTIFIER, NRC_RESPONSE_TOO_LONG);
+		}
+		position += written;
+	}
+	if (position == 1u)
+	{
+		return NegativeResponse(SID_READ_DATA_BY_IDENTIFIER, NRC_REQUEST_OUT_OF_RANGE);
+	}
+	return position;
+}
+
+/**
+ * @brief Status byte of the DTC of one bit of the error code
+ */
+static uint8_t GetDtcStatus(uint8_t bit, uint32_t errorCode, uint32_t errorMemory)
+{
+	uint8_t status = 0;
+
+	if (((errorCode >> bit) & 1u) != 0u)
+	{
+		status |= DTC_STATUS_TEST_FAILED | DTC_STATUS_CONFIRMED;
+	}
+	if (((errorMemory >> bit) & 1u) != 0u)
+	{
+		status |= DTC_STATUS_CONFIRMED;
+	}
+	return status;
+}
+
+/**
+ * @brief 0x19 ReadDTCInformation
+ * @return response length
+ */
+static uint32_t ReadDtcInformation(const uint8_t *request, uint32_t length)
+{
+	uint8_t subFunction;
+	uint8_t mask = 0xFFu;
+	uint32_t errorCode = canApi_Get_ERR_Errorcode();
+	uint32_t errorMemory = canApi_Get_ERR_MEM_Trace_0_Errorcode();
+	uint32_t position = 3;
+	uint16_t count = 0;
+	uint8_t bit;
+
+	if (length < 2u)
+	{
+		return NegativeResponse(SID_READ_DTC_INFORMATION, NRC_INCORRECT_LENGTH);
+	}
+	subFunction = (uint8_t)(request[1] & SUBFUNCTION_MASK);
+	if (subFunction != DTC_NUMBER_BY_STATUS_MASK && subFunction != DTC_BY_STATUS_MASK && subFunction != DTC_SUPPORTED)
+	{
+		return NegativeResponse(SID_READ_DTC_INFORMATION, NRC_SUBFUNCTION_NOT_SUPPORTED);
+	}
+	if (length != ((subFunction == DTC_SUPPORTED) ? 2u : 3u))
+	{
+		return NegativeResponse(SID_READ_DTC_INFORMATION, NRC_INCORRECT_LENGTH);
+	}
+	if (subFunction != DTC_SUPPORTED)
+	{
+		mask = request[2];
+	}
+
+	uds.Response[0] = SID_READ_DTC_INFORMATION + SID_POSITIVE;
+	uds.Response[1] = subFunction;
+	uds.Response[2] = DTC_STATUS_AVAILABILITY;
+	for (bit = 0; bit < DTC_COUNT; bit++)
+	{
+		uint8_t status = GetDtcStatus(bit, errorCode, errorMemory);
+		uint32_t dtc = CAN_UDS_DTC_BASE + ((uint32_t)(bit + 1u) << 8);
+
+		if (subFunction != DTC_SUPPORTED && (status & mask & DTC_STATUS_AVAILABILITY) == 0u)
+		{
+			continue;
+		}
+		count++;
+		if (subFunction != DTC_NUMBER_BY_STATUS_MASK)
+		{
+			uds.Response[position] = (uint8_t)(dtc >> 16);
+			uds.Response[position + 1u] = (uint8_t)(dtc >> 8);
+			uds.Response[position + 2u] = (uint8_t)dtc;
+			uds.Response[position + 3u] = status;
+			position += 4u;
+		}
+	}
+
+	if (subFunction == DTC_NUMBER_BY_STATUS_MASK)
+	{
+		uds.Response[3] = DTC_FORMAT_ISO14229;
+		uds.Response[4] = (uint8_t)(count >> 8);
+		uds.Response[5] = (uint8_t)count;
+		position = 6;
+	}
+	return position;
+}
+
+/**
+ * @brief 0x3E TesterPresent, only keeps the tester happy, there is no session to keep alive
+ * @return response length, 0 if the positive response is suppressed
+ */
+static uint32_t TesterPresent(const uint8_t *request, uint32_t length)
+{
+	if (length != 2u)
+	{
+		return NegativeResponse(SID_TESTER_PRESENT, NRC_INCORRECT_LENGTH);
+	}
+	if ((request[1] & SUBFUNCTION_MASK) != TESTER_PRESENT_ZERO)
+	{
+		return NegativeResponse(SID_TESTER_PRESENT, NRC_SUBFUNCTION_NOT_SUPPORTED);
+	}
+	if ((request[1] & SUPPRESS_POSITIVE_RESPONSE) != 0u)
+	{
+		return 0;
+	}
+	uds.Response[0] = SID_TESTER_PRESENT + SID_POSITIVE;
+	uds.Response[1] = TESTER_PRESENT_ZERO;
+	return 2;
+}
+
+/**
+ * @brief 0x23 ReadMemoryByAddress, reads the capture image of the flight recorder at CAN_UDS_RECORDER_ADDRESS.
+ * The response is built in the block buffer not given to the ISO-TP channel, which is free without a download.
+ * @return response length
+ */
+static uint32_t ReadMemoryByAddress(const uint8_t *request, uint32_t length)
+{
+	uint8_t sizeLength;
+	uint8_t addressLength;
+	uint32_t address;
+	uint32_t size;
+	uint32_t imageSize;
+	uint8_t *response;
+
+	if (length < 2u)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_INCORRECT_LENGTH);
+	}
+	sizeLength = (uint8_t)(request[1] >> 4);
+	addressLength = (uint8_t)(request[1] & 0x0Fu);
+	if (sizeLength < 1u || sizeLength > 4u || addressLength < 1u || addressLength > 4u)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_REQUEST_OUT_OF_RANGE);
+	}
+	if (length != 2u + addressLength + sizeLength)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_INCORRECT_LENGTH);
+	}
+	if (uds.Phase != DOWNLOAD_IDLE)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_CONDITIONS_NOT_CORRECT);
+	}
+	address = GetUInt32(&request[2], addressLength);
+	size = GetUInt32(&request[2u + addressLength], sizeLength);
+	if (address < CAN_UDS_RECORDER_ADDRESS || size == 0u || size > CAN_UDS_BLOCK_DATA)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_REQUEST_OUT_OF_RANGE);
+	}
+
+	/* the image exists once the capture is frozen */
+	imageSize = CAN_Recorder_GetSize();
+	if (imageSize == 0u)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_CONDITIONS_NOT_CORRECT);
+	}
+	address -= CAN_UDS_RECORDER_ADDRESS;
+	if (address >= imageSize || size > imageSize - address)
+	{
+		return NegativeResponse(SID_READ_MEMORY_BY_ADDRESS, NRC_REQUEST_OUT_OF_RANGE);
+	}
+
+	response = uds.Buffer[1u - uds.RxBuffer];
+	response[0] = SID_READ_MEMORY_BY_ADDRESS + SID_POSITIVE;
+	(void)CAN_Recorder_Read(address, &response[1], size);
+	uds.TxData = response;
+	return 1u + size;
+}
+
+/**
+ * @brief 0x34 RequestDownload, starts the erase and answers when it is done
+ * @return response length, RESPONSE_LATER while the erase runs
+ */
+static uint32_t RequestDownload(const uint8_t *request, uint32_t length)
+{
+	uint8_t sizeLength;
+	uint8_t addressLength;
+	uint32_t address;
+	uint32_t size;
+
+	if (uds.Phase == DOWNLOAD_ERASE)
+	{
+		switch (CAN_Uds_FlashGetState())
+		{
+			case CAN_UDS_FLASH_BUSY:
+				return RESPONSE_LATER;
+
+			case CAN_UDS_FLASH_ERROR:
+				EndDownload();
+				return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_GENERAL_PROGRAMMING_FAILURE);
+
+			default:
+				break;
+		}
+		uds.Phase = DOWNLOAD_TRANSFER;
+		uds.Response[0] = SID_REQUEST_DOWNLOAD + SID_POSITIVE;
+		uds.Response[1] = LENGTH_FORMAT_2_BYTES;
+		uds.Response[2] = (uint8_t)(BLOCK_LENGTH >> 8);
+		uds.Response[3] = (uint8_t)BLOCK_LENGTH;
+		return 4;
+	}
+
+	if (length < 3u)
+	{
+		return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_INCORRECT_LENGTH);
+	}
+	sizeLength = (uint8_t)(request[2] >> 4);
+	addressLength = (uint8_t)(request[2] & 0x0Fu);
+	if (request[1] != 0u || sizeLength < 1u || sizeLength > 4u || addressLength < 1u || addressLength > 4u)
+	{
+		return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_REQUEST_OUT_OF_RANGE);
+	}
+	if (length != 3u + addressLength + sizeLength)
+	{
+		return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_INCORRECT_LENGTH);
+	}
+	if (uds.Phase != DOWNLOAD_IDLE)
+	{
+		return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_CONDITIONS_NOT_CORRECT);
+	}
+	address = GetUInt32(&request[3], addressLength);
+	size = GetUInt32(&request[3u + addressLength], sizeLength);
+	if (size == 0u)
+	{
+		return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_REQUEST_OUT_OF_RANGE);
+	}
+	if (CAN_Uds_FlashErase(address, size) != CAN_OK)
+	{
+		return NegativeResponse(SID_REQUEST_DOWNLOAD, NRC_UPLOAD_DOWNLOAD_NOT_ACCEPTED);
+	}
+
+	uds.Phase = DOWNLOAD_ERASE;
+	uds.Address = address;
+	uds.Remaining = size;
+	uds.Sequence = 1;
+	uds.BlockAccepted = 0;
+	uds.ImageCrc = 0xFFFFFFFFu;
+	return RESPONSE_LATER;
+}
+
+/**
+ * @brief 0x36 TransferData. The block is programmed from the receive buffer while the next
+ * block is received into the other buffer, so the request waits only if the previous
+ * block is still being programmed.
+ * @return response length, RESPONSE_LATER while the previous block is programmed
+ */
+static uint32_t TransferData(const uint8_t *request, uint32_t length)
+{
+	uint32_t dataLength;
+	uint32_t crc;
+
+	if (uds.Phase != DOWNLOAD_TRANSFER)
+	{
+		return NegativeResponse(SID_TRANSFER_DATA, NRC_REQUEST_SEQUENCE_ERROR);
+	}
+	if (length < 2u + 1u + CRC_SIZE)
+	{
+		return NegativeResponse(SID_TRANSFER_DATA, NRC_INCORRECT_LENGTH);
+	}
+	if (uds.BlockAccepted != 0u && request[1] == (uint8_t)(uds.Sequence - 1u))
+	{
+		/* the tester missed our response, the block is already programmed */
+		uds.Response[0] = SID_TRANSFER_DATA + SID_POSITIVE;
+		uds.Response[1] = request[1];
+		return 2;
+	}
+	if (request[1] != uds.Sequence)
+	{
+		return NegativeResponse(SID_TRANSFER_DATA, NRC_WRONG_BLOCK_SEQUENCE_COUNTER);
+	}
+	dataLength = length - 2u - CRC_SIZE;
+	if (dataLength > uds.Remaining)
+	{
+		return NegativeResponse(SID_TRANSFER_DATA, NRC_REQUEST_OUT_OF_RANGE);
+	}
+
+	switch (CAN_Uds_FlashGetState())
+	{
+		case CAN_UDS_FLASH_BUSY:
+			return RESPONSE_LATER;
+
+		case CAN_UDS_FLASH_ERROR:
+			EndDownload();
+			return NegativeResponse(SID_TRANSFER_DATA, NRC_GENERAL_PROGRAMMING_FAILURE);
+
+		default:
+			break;
+	}
+
+	crc = Crc32Update(0xFFFFFFFFu, &request[2], dataLength) ^ 0xFFFFFFFFu;
+	if (crc != GetUInt32(&request[2u + dataLength], CRC_SIZE))
+	{
+		return NegativeResponse(SID_TRANSFER_DATA, NRC_TRANSFER_DATA_SUSPENDED);
+	}
+	if (CAN_Uds_FlashWrite(uds.Address, &request[2], dataLength) != CAN_OK)
+	{
+		EndDownload();
+		return NegativeResponse(SID_TRANSFER_DATA, NRC_GENERAL_PROGRAMMING_FAILURE);
+	}
+	uds.Address += dataLength;
+	uds.Remaining -= dataLength;
+	uds.ImageCrc = Crc32Update(uds.ImageCrc, &request[2], dataLength);
+	uds.Sequence++;
+	uds.BlockAccepted = 1;
+
+	/* the flash reads this buffer now, receive the next block into the other one */
+	uds.RxBuffer ^= 1u;
+	(void)CAN_IsoTp_SetRxBuffer(CAN_UDS_ISOTP_CHANNEL, uds.Buffer[uds.RxBuffer], BLOCK_LENGTH);
+
+	uds.Response[0] = SID_TRANSFER_DATA + SID_POSITIVE;
+	uds.Response[1] = request[1];
+	return 2;
+}
+
+/**
+ * @brief 0x37 RequestTransferExit, optionally with the CRC-32 of the image
+ * @return response length, RESPONSE_LATER while the last block is programmed
+ */
+static uint32_t RequestTransferExit(const uint8_t *request, uint32_t length)
+{
+	uint32_t crc;
+
+	if (uds.Phase != DOWNLOAD_TRANSFER)
+	{
+		return NegativeResponse(SID_REQUEST_TRANSFER_EXIT, NRC_REQUEST_SEQUENCE_ERROR);
+	}
+	if (length != 1u && length != 1u + CRC_SIZE)
+	{
+		return NegativeResponse(SID_REQUEST_TRANSFER_EXIT, NRC_INCORRECT_LENGTH);
+	}
+	if (uds.Remaining != 0u)
+	{
+		return NegativeResponse(SID_REQUEST_TRANSFER_EXIT, NRC_REQUEST_SEQUENCE_ERROR);
+	}
+
+	switch (CAN_Uds_FlashGetState())
+	{
+		case CAN_UDS_FLASH_BUSY:
+			return RESPONSE_LATER;
+
+		case CAN_UDS_FLASH_ERROR:
+			EndDownload();
+			return NegativeResponse(SID_REQUEST_TRANSFER_EXIT, NRC_GENERAL_PROGRAMMING_FAILURE);
+
+		default:
+			break;
+	}
+
+	crc = uds.ImageCrc ^ 0xFFFFFFFFu;
+	EndDownload();
+	if (length == 1u + CRC_SIZE && crc != GetUInt32(&request[1], CRC_SIZE))
+	{
+		return NegativeResponse(SID_REQUEST_TRANSFER_EXIT, NRC_GENERAL_PROGRAMMING_FAILURE);
+	}
+	uds.Response[0] = SID_REQUEST_TRANSFER_EXIT + SID_POSITIVE;
+	PutUInt32(&uds.Response[1], crc);
+	return 5;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_Uds_Init(void)
+{
+	memset(&uds, 0, sizeof(uds));
+}
+
+void CAN_Uds_Process(void)
+{
+	uint32_t length = 0;
+	uint32_t responseLength;
+	const uint8_t *request;
+
+	if (uds.Open == 0u)
+	{
+		CAN_IsoTp_Config_TypeDef config;
+
+		memset(&config, 0, sizeof(config));
+		config.TxIdentifier = CAN_UDS_RESPONSE_ID;
+		config.RxIdentifier = CAN_UDS_REQUEST_ID;
+		config.IDE = 0;
+		config.Padding = PADDING;
+		config.RxBuffer = uds.Buffer[uds.RxBuffer];
+		config.RxBufferSize = BLOCK_LENGTH;
+		if (CAN_IsoTp_Open(CAN_UDS_ISOTP_CHANNEL, &config) != CAN_OK)
+		{
+			return;
+		}
+		uds.Open = 1;
+	}
+
+	/* the response buffer is read until the previous response is sent */
+	if (CAN_IsoTp_GetRxState(CAN_UDS_ISOTP_CHANNEL, &length) != CAN_ISOTP_DONE
+		|| CAN_IsoTp_GetTxState(CAN_UDS_ISOTP_CHANNEL) == CAN_ISOTP_BUSY)
+	{
+		return;
+	}
+
+	request = uds.Buffer[uds.RxBuffer];
+	uds.TxData = uds.Response;
+	switch (request[0])
+	{
+		case SID_READ_DATA_BY_IDENTIFIER:
+			responseLength = ReadDataByIdentifier(request, length);
+			break;
+
+		case SID_READ_DTC_INFORMATION:
+			responseLength = ReadDtcInformation(request, length);
+			break;
+
+		case SID_READ_MEMORY_BY_ADDRESS:
+			responseLength = ReadMemoryByAddress(request, length);
+			break;
+
+		case SID_TESTER_PRESENT:
+			responseLength = TesterPresent(request, length);
+			break;
+
+		case SID_REQUEST_DOWNLOAD:
+			responseLength = RequestDownload(request, length);
+			break;
+
+		case SID_TRANSFER_DATA:
+			responseLength = TransferData(request, length);
+			break;
+
+		case SID_REQUEST_TRANSFER_EXIT:
+			responseLength = RequestTransferExit(request, length);
+			break;
+
+		default:
+			responseLength = NegativeResponse(request[0], NRC_SERVICE_NOT_SUPPORTED);
+			break;
+	}
+
+	/* the request stays in the receive buffer until the flash is ready, the tester is told so */
+	if (responseLength == RESPONSE_LATER)
+	{
+		uds.WaitMs++;
+		if (uds.WaitMs == RESPONSE_PENDING_FIRST_MS
+			|| (uds.WaitMs > RESPONSE_PENDING_FIRST_MS && (uds.WaitMs - RESPONSE_PENDING_FIRST_MS) % RESPONSE_PENDING_REPEAT_MS == 0u))
+		{
+			(void)CAN_IsoTp_Send(CAN_UDS_ISOTP_CHANNEL, uds.Response, NegativeResponse(request[0], NRC_RESPONSE_PENDING));
+		}
+		return;
+	}
+	uds.WaitMs = 0;
+	CAN_IsoTp_Release(CAN_UDS_ISOTP_CHANNEL);
+
+	if (responseLength > 0u)
+	{
+		(void)CAN_IsoTp_Send(CAN_UDS_ISOTP_CHANNEL, uds.TxData, responseLength);
+	}
+}
+
+void CAN_Uds_Close(void)
+{
+	if (uds.Open != 0u)
+	{
+		CAN_IsoTp_Close(CAN_UDS_ISOTP_CHANNEL);
+		uds.Open = 0;
+	}
+	uds.WaitMs = 0;
+	EndDownload();
+}
+
+/**
+ * @brief Default flash backend: no range may be written
+ */
+__attribute__((weak)) canApi_StatusTypeDef CAN_Uds_FlashErase(uint32_t address, uint32_t length)
+{
+	(void)address;
+	(void)length;
+	return CAN_INVALID_VALUE;
+}
+
+__attribute__((weak)) canApi_StatusTypeDef CAN_Uds_FlashWrite(uint32_t address, const uint8_t *data, uint32_t length)
+{
+	(void)address;
+	(void)data;
+	(void)length;
+	return CAN_ERROR;
+}
+
+__attribute__((weak)) CAN_Uds_FlashState_TypeDef CAN_Uds_FlashGetState(void)
+{
+	return CAN_UDS_FLASH_IDLE;
+}
+
+/** @} */
@@ -0,0 +1,179 @@
+/**
+*******************************************************************************
+* @file CAN_uds.h
+* @brief UDS (ISO 14229-1) diagnostic server for on-demand data
+* @author FRIWO
+* @date 20.10.2026 - 14:21:37
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Answers a service tester on one channel of CAN_isotp.c with physical
+* addressing, default session only:
+* - 0x22 ReadDataByIdentifier, one or more DIDs per request, see did_array in
+*   CAN_uds.c for the identity and production data. DID
+*   CAN_UDS_DID_SIGNAL_BASE + n reads signal n of CAN_signals.c as raw value
+* - 0x19 ReadDTCInformation, sub-functions 0x01 reportNumberOfDTCByStatusMask,
+*   0x02 reportDTCByStatusMask and 0x0A reportSupportedDTC
+* - 0x23 ReadMemoryByAddress of the capture image of CAN_recorder.c, mapped to
+*   CAN_UDS_RECORDER_ADDRESS while it is frozen, up to CAN_UDS_BLOCK_DATA
+*   bytes per request. DID CAN_UDS_DID_RECORDER gives its state and size
+* - 0x3E TesterPresent, with suppressPosRspMsgIndicationBit
+* - 0x34 RequestDownload, 0x36 TransferData and 0x37 RequestTransferExit into
+*   the flash backend, see below
+* Every other service is answered with the negative response code
+* serviceNotSupported. Data is sent in Motorola byte order, as usual for UDS.
+*
+* Bit n of canApi_Get_ERR_Errorcode() is the DTC CAN_UDS_DTC_BASE + ((n + 1) << 8),
+* n + 1 is the error number of the message 0x209. Its status has testFailed
+* while the bit is set in the error code and confirmedDTC while it is set in
+* the error code or in canApi_Get_ERR_MEM_Trace_0_Errorcode().
+*
+* Download: RequestDownload takes dataFormatIdentifier 0x00 and any
+* addressAndLengthFormatIdentifier up to 4 + 4 bytes, erases the range with
+* CAN_Uds_FlashErase() and answers with maxNumberOfBlockLength. Every
+* TransferData request carries up to CAN_UDS_BLOCK_DATA bytes followed by the
+* CRC-32 (IEEE 802.3, Motorola byte order) of these bytes. A block with a
+* wrong CRC is answered with transferDataSuspended and may be sent again with
+* the same blockSequenceCounter. The server owns two block buffers: while
+* CAN_Uds_FlashWrite() programs one block from the first buffer, the next
+* block is received into the second, so programming overlaps the bus
+* transfer. A request which has to wait for the flash gets
+* requestCorrectlyReceived-ResponsePending. RequestTransferExit may carry the
+* CRC-32 of the whole image and answers with the CRC-32 the server computed.
+* The flow control of the server asks for all consecutive frames at once
+* without separation time, so the tester may send as fast as the bus allows.
+*
+* There is no programming session and no SecurityAccess: the default flash
+* backend rejects every range, a project which provides one decides which
+* ranges may be written and when, e.g. only a dataset area or the inactive
+* bank of a dual bank flash.
+*
+* CAN_custom.c calls CAN_Uds_Process() once per canApi_UserPeriodicCallBack()
+* before CAN_IsoTp_Process() while CAN_C_Uds_Enable is set, so a single frame
+* response leaves in the same millisecond as the request was decoded. The
+* request identifier must pass a filter bank set in canApi_UserInitCallBack().
+*/
+
+#ifndef CAN_UDS_H_
+#define CAN_UDS_H_
+
+/**
+* @addtogroup CAN_uds
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief identifier of the physical requests from the tester, standard identifier */
+#ifndef CAN_UDS_REQUEST_ID
+#define CAN_UDS_REQUEST_ID 0x7E0u
+#endif
+
+/** @brief identifier of the responses to the tester, standard identifier */
+#ifndef CAN_UDS_RESPONSE_ID
+#define CAN_UDS_RESPONSE_ID 0x7E8u
+#endif
+
+/** @brief channel of CAN_isotp.c used by the server */
+#ifndef CAN_UDS_ISOTP_CHANNEL
+#define CAN_UDS_ISOTP_CHANNEL 0u
+#endif
+
+/** @brief DTC of error number 0, error number n is CAN_UDS_DTC_BASE + (n << 8): P1A01-00...P1A1F-00 */
+#ifndef CAN_UDS_DTC_BASE
+#define CAN_UDS_DTC_BASE 0x1A0000u
+#endif
+
+/** @brief data bytes per TransferData request, the block buffers are CAN_UDS_BLOCK_DATA + 6 bytes each */
+#ifndef CAN_UDS_BLOCK_DATA
+#define CAN_UDS_BLOCK_DATA 1024u
+#endif
+
+/** @brief address of byte 0 of the flight recorder capture image for ReadMemoryByAddress, no real memory */
+#ifndef CAN_UDS_RECORDER_ADDRESS
+#define CAN_UDS_RECORDER_ADDRESS 0xF0000000u
+#endif
+
+/** @brief DID of signal 0 of CAN_signals.c */
+#define CAN_UDS_DID_SIGNAL_BASE 0xFD00u
+
+/** @brief DIDs of did_array */
+#define CAN_UDS_DID_SERIAL_NUMBER 0xF18Cu /**< @brief ECUSerialNumber: hardware production info */
+#define CAN_UDS_DID_HW_NUMBER 0xF191u /**< @brief vehicleManufacturerECUHardwareNumber: hardware ID 1 and 2 */
+#define CAN_UDS_DID_SW_VERSION 0xF195u /**< @brief systemSupplierECUSoftwareVersionNumber: release and revision */
+#define CAN_UDS_DID_DATASET 0xF1A0u /**< @brief dataset ID 1, 2 and 3 of the parameter set */
+#define CAN_UDS_DID_IMMO_CHALLENGE 0xF1A1u /**< @brief immobilizer challenge, lower and higher word */
+#define CAN_UDS_DID_ERROR_STATE 0xF1A2u /**< @brief error code and error memory trace 0 */
+#define CAN_UDS_DID_RECORDER 0xF1A3u /**< @brief flight recorder state as CAN_Recorder_GetState() and capture image size */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief State of the flash backend
+ */
+typedef enum
+{
+	CAN_UDS_FLASH_IDLE = 0, /**< @brief no operation running, the last one succeeded */
+	CAN_UDS_FLASH_BUSY = 1, /**< @brief erase or write running */
+	CAN_UDS_FLASH_ERROR = 2 /**< @brief the last operation failed, cleared by the next CAN_Uds_FlashErase() */
+}CAN_Uds_FlashState_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Forget the channel and a pending request. Called by the CAN module after CAN_IsoTp_Init().
+ */
+void CAN_Uds_Init(void);
+
+/**
+ * @brief Open the ISO-TP channel if needed and answer a complete request, call every 1ms.
+ * A request waits while the response to the previous one is still being sent.
+ */
+void CAN_Uds_Process(void);
+
+/**
+ * @brief Close the ISO-TP channel, e.g. when the server is disabled. A running response and download are dropped.
+ */
+void CAN_Uds_Close(void);
+
+/**
+ * @brief Start to erase a range for a download. Must not block, the server polls CAN_Uds_FlashGetState().
+ * The default implementation is weak and rejects every range.
+ * @param address: memoryAddress of RequestDownload
+ * @param length: memorySize of RequestDownload [byte]
+ * @return CAN_OK if the erase was started, CAN_INVALID_VALUE if the range may not be written
+ */
+canApi_StatusTypeDef CAN_Uds_FlashErase(uint32_t address, uint32_t length);
+
+/**
+ * @brief Start to write one block of a download. Must not block, the server polls CAN_Uds_FlashGetState().
+ * The default implementation is weak and fails.
+ * @param address: target address, the blocks follow each other without gaps
+ * @param data: block data, stays valid and unchanged until the state is no longer CAN_UDS_FLASH_BUSY
+ * @param length: 1...CAN_UDS_BLOCK_DATA [byte]
+ * @return CAN_OK if the write was started
+ */
+canApi_StatusTypeDef CAN_Uds_FlashWrite(uint32_t address, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Get the state of the last erase or write. The default implementation is weak.
+ * @return CAN_Uds_FlashState_TypeDef
+ */
+CAN_Uds_FlashState_TypeDef CAN_Uds_FlashGetState(void);
+
+/** @} */
+
+#endif /* CAN_UDS_H_ */
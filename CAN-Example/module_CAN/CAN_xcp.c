@@ -0,0 +1,980 @@
+/**
+*******************************************************************************
+* @file CAN_xcp.c
+* @brief XCP on CAN slave for synchronous DAQ measurement
+* @author FRIWO
+* @date 20.10.2026 - 09:12:05
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*/
+
+/**
+* @addtogroup CAN_xcp
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "CAN_xcp.h"
+#include "CAN_custom.h"
+#include "CAN_timesync.h"
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief command codes */
+#define CMD_CONNECT 0xFFu
+#define CMD_DISCONNECT 0xFEu
+#define CMD_GET_STATUS 0xFDu
+#define CMD_SYNCH 0xFCu
+#define CMD_GET_COMM_MODE_INFO 0xFBu
+#define CMD_SET_MTA 0xF6u
+#define CMD_UPLOAD 0xF5u
+#define CMD_SHORT_UPLOAD 0xF4u
+#define CMD_CLEAR_DAQ_LIST 0xE3u
+#define CMD_SET_DAQ_PTR 0xE2u
+#define CMD_WRITE_DAQ 0xE1u
+#define CMD_SET_DAQ_LIST_MODE 0xE0u
+#define CMD_GET_DAQ_LIST_MODE 0xDFu
+#define CMD_START_STOP_DAQ_LIST 0xDEu
+#define CMD_START_STOP_SYNCH 0xDDu
+#define CMD_GET_DAQ_CLOCK 0xDCu
+#define CMD_GET_DAQ_PROCESSOR_INFO 0xDAu
+#define CMD_GET_DAQ_RESOLUTION_INFO 0xD9u
+#define CMD_GET_DAQ_EVENT_INFO 0xD7u
+#define CMD_FREE_DAQ 0xD6u
+#define CMD_ALLOC_DAQ 0xD5u
+#define CMD_ALLOC_ODT 0xD4u
+#define CMD_ALLOC_ODT_ENTRY 0xD3u
+
+/** @brief packet identifiers of the responses */
+#define PID_RES 0xFFu
+#define PID_ERR 0xFEu
+
+/** @brief error codes */
+#define ERR_CMD_SYNCH 0x00u
+#define ERR_DAQ_ACTIVE 0x11u
+#define ERR_CMD_UNKNOWN 0x20u
+#define ERR_CMD_SYNTAX 0x21u
+#define ERR_OUT_OF_RANGE 0x22u
+#define ERR_ACCESS_DENIED 0x24u
+#define ERR_MODE_NOT_VALID 0x27u
+#define ERR_SEQUENCE 0x29u
+#define ERR_DAQ_CONFIG 0x2Au
+#define ERR_MEMORY_OVERFLOW 0x30u
+
+/** @brief DAQ list mode bits, as reported by GET_DAQ_LIST_MODE */
+#define MODE_SELECTED 0x01u
+#define MODE_DIRECTION 0x02u
+#define MODE_TIMESTAMP 0x10u
+#define MODE_PID_OFF 0x20u
+#define MODE_RUNNING 0x40u
+
+/** @brief mode bits SET_DAQ_LIST_MODE may change */
+#define MODE_SETTABLE (MODE_TIMESTAMP)
+
+/** @brief size of a CTO and a DTO, classic CAN */
+#define XCP_MAX_CTO 8u
+#define XCP_MAX_DTO 8u
+
+/** @brief size of the DAQ timestamp */
+#define TIMESTAMP_SIZE 4u
+
+/** @brief bit offset of WRITE_DAQ for a whole byte entry */
+#define BIT_OFFSET_NONE 0xFFu
+
+/** @brief storage of the slave state, one slave per thread in multi-instance builds */
+#ifdef CAN_MULTI_INSTANCE
+#define CAN_XCP_LOCAL _Thread_local
+#else
+#define CAN_XCP_LOCAL
+#endif
+
+#if CAN_XCP_MAX_ODT > 0xFCu
+#error "CAN_XCP_MAX_ODT must leave the packet identifiers 0xFC...0xFF for responses"
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Allocation step of the dynamic DAQ configuration, ALLOC_* must follow this order
+ */
+typedef enum
+{
+	ALLOC_STEP_FREE = 0, /**< @brief after FREE_DAQ */
+	ALLOC_STEP_DAQ = 1, /**< @brief after ALLOC_DAQ */
+	ALLOC_STEP_ODT = 2, /**< @brief after ALLOC_ODT */
+	ALLOC_STEP_ODT_ENTRY = 3 /**< @brief after ALLOC_ODT_ENTRY */
+}xcpAllocStep_TypeDef;
+
+/**
+ * @brief One ODT entry, resolved by WRITE_DAQ
+ */
+typedef struct
+{
+	const uint8_t *Source; /**< @brief first byte of the variable, 0 if not written */
+	uint8_t Size; /**< @brief number of bytes */
+}xcpOdtEntry_TypeDef;
+
+/**
+ * @brief One ODT, its entries are contiguous in the entry pool
+ */
+typedef struct
+{
+	uint16_t FirstEntry; /**< @brief index of the first entry in the entry pool */
+	uint8_t EntryCount; /**< @brief number of entries */
+}xcpOdt_TypeDef;
+
+/**
+ * @brief One DAQ list, its ODTs are contiguous in the ODT pool
+ */
+typedef struct
+{
+	uint8_t FirstOdt; /**< @brief index of the first ODT in the ODT pool, also its packet identifier */
+	uint8_t OdtCount; /**< @brief number of ODTs */
+	uint8_t Mode; /**< @brief MODE_* bits */
+	uint16_t Event; /**< @brief event channel */
+	uint8_t Prescaler; /**< @brief sample every n-th event */
+	uint8_t PrescalerCounter; /**< @brief events left until the next sample */
+}xcpDaq_TypeDef;
+
+/**
+ * @brief Complete state of the slave
+ */
+typedef struct
+{
+	uint8_t Connected; /**< @brief 1 between CONNECT and DISCONNECT */
+	uint8_t Response[XCP_MAX_CTO]; /**< @brief response to the last command */
+	uint8_t ResponseLength; /**< @brief length of the pending response, 0 = nothing to send */
+
+	uint32_t MtaAddress; /**< @brief memory transfer address of UPLOAD */
+	uint8_t MtaExtension; /**< @brief its address extension */
+
+	xcpAllocStep_TypeDef AllocStep; /**< @brief last allocation step */
+	xcpDaq_TypeDef Daq[CAN_XCP_MAX_DAQ]; /**< @brief DAQ list pool */
+	uint8_t DaqCount; /**< @brief allocated DAQ lists */
+	xcpOdt_TypeDef Odt[CAN_XCP_MAX_ODT]; /**< @brief ODT pool */
+	uint8_t OdtCount; /**< @brief allocated ODTs */
+	xcpOdtEntry_TypeDef Entry[CAN_XCP_MAX_ODT_ENTRY]; /**< @brief ODT entry pool */
+	uint16_t EntryCount; /**< @brief allocated ODT entries */
+
+	uint16_t PtrDaq; /**< @brief DAQ list of the DAQ pointer */
+	uint8_t PtrOdt; /**< @brief ODT of the DAQ pointer, relative to the DAQ list */
+	uint8_t PtrEntry; /**< @brief entry of the DAQ pointer, relative to the ODT */
+	uint8_t PtrValid; /**< @brief 1 after SET_DAQ_PTR */
+
+	uint8_t Sample[CAN_XCP_MAX_ODT][XCP_MAX_DTO]; /**< @brief DTOs of the DAQ list being sampled */
+	uint8_t SampleLength[CAN_XCP_MAX_ODT]; /**< @brief their lengths */
+	uint32_t OverloadCount; /**< @brief skipped DAQ list samples */
+}xcpState_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static canApi_StatusTypeDef SendFrame(const uint8_t *data, uint8_t length);
+static void Respond(uint8_t length);
+static void RespondError(uint8_t code);
+static uint32_t ReadUInt32(const uint8_t *data);
+static uint16_t ReadUInt16(const uint8_t *data);
+static void WriteUInt32(uint8_t *data, uint32_t value);
+static void FreeDaq(void);
+static uint8_t IsDaqRunning(void);
+static uint8_t CheckDaqList(const xcpDaq_TypeDef *daq);
+static void StartDaqList(xcpDaq_TypeDef *daq);
+static void Upload(uint8_t size);
+static void CommandDaqConfiguration(const uint8_t *cmd, uint8_t length);
+static void CommandDaqControl(const uint8_t *cmd, uint8_t length);
+static void CommandDaqInfo(const uint8_t *cmd, uint8_t length);
+static uint32_t SampleDaqList(xcpDaq_TypeDef *daq, uint32_t timestamp, uint32_t budget);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static CAN_XCP_LOCAL xcpState_TypeDef xcp;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Put one DTO into the transmit buffer, not padded
+ * @param data: packet identifier and payload
+ * @param length: number of bytes, 1...8
+ * @return result of canApi_SendMessage()
+ */
+static canApi_StatusTypeDef SendFrame(const uint8_t *data, uint8_t length)
+{
+	canApi_MessageTypedef message;
+
+	message.Identifier = CAN_XCP_DTO_ID;
+	message.IDE = 0;
+	message.RTR = 0;
+	message.DLC = length;
+	message.Priority = 1;
+	memcpy(message.Data, data, length);
+
+	return canApi_SendMessage(&message);
+}
+
+/**
+ * @brief Mark the positive response in xcp.Response as pending
+ * @param length: length including the packet identifier
+ */
+static void Respond(uint8_t length)
+{
+	xcp.Response[0] = PID_RES;
+	xcp.ResponseLength = length;
+}
+
+static void RespondError(uint8_t code)
+{
+	xcp.Response[0] = PID_ERR;
+	xcp.Response[1] = code;
+	xcp.ResponseLength = 2;
+}
+
+/* Intel byte order helpers */
+
+static uint32_t ReadUInt32(const uint8_t *data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint16_t ReadUInt16(const uint8_t *data)
+{
+	return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static void WriteUInt32(uint8_t *data, uint32_t value)
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+	data[2] = (uint8_t)(value >> 16);
+	data[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Stop and delete all DAQ lists
+ */
+static void FreeDaq(void)
+{
+	xcp.DaqCount = 0;
+	xcp.OdtCount = 0;
+	xcp.EntryCount = 0;
+	xcp.PtrValid = 0;
+	xcp.AllocStep = ALLOC_STEP_FREE;
+}
+
+static uint8_t IsDaqRunning(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < xcp.DaqCount; i++)
+	{
+		if ((xcp.Daq[i].Mode & MODE_RUNNING) != 0u)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Check that every entry of a DAQ list was written and every ODT fits into one DTO
+ * @return 1 if the DAQ list can be started, else 0
+ */
+static uint8_t CheckDaqList(const xcpDaq_TypeDef *daq)
+{
+	uint8_t n;
+
+	if (daq->OdtCount == 0u)
+	{
+		return 0;
+	}
+	for (n = 0; n < daq->OdtCount; n++)
+	{
+		const xcpOdt_TypeDef *odt = &xcp.Odt[daq->FirstOdt + n];
+		uint32_t length = 1u + ((n == 0u && (daq->Mode & MODE_TIMESTAMP) != 0u) ? TIMESTAMP_SIZE : 0u);
+		uint8_t e;
+
+		for (e = 0; e < odt->EntryCount; e++)
+		{
+			const xcpOdtEntry_TypeDef *entry = &xcp.Entry[odt->FirstEntry + e];
+
+			if (entry->Source == 0)
+			{
+				return 0;
+			}
+			length += entry->Size;
+		}
+		if (length > XCP_MAX_DTO)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void StartDaqList(xcpDaq_TypeDef *daq)
+{
+	daq->Mode = (uint8_t)((daq->Mode | MODE_RUNNING) & ~MODE_SELECTED);
+	daq->PrescalerCounter = 1;
+}
+
+/**
+ * @brief Answer UPLOAD and SHORT_UPLOAD from the memory transfer address and advance it
+ * @param size: number of bytes, 1...7
+ */
+static void Upload(uint8_t size)
+{
+	const uint8_t *source;
+
+	if (size == 0u || size > XCP_MAX_CTO - 1u)
+	{
+		RespondError(ERR_OUT_OF_RANGE);
+		return;
+	}
+	source = CAN_Xcp_GetPointer(xcp.MtaAddress, xcp.MtaExtension, size);
+	if (source == 0)
+	{
+		RespondError(ERR_ACCESS_DENIED);
+		return;
+	}
+	memcpy(&xcp.Response[1], source, size);
+	xcp.MtaAddress += size;
+	Respond((uint8_t)(1u + size));
+}
+
+/**
+ * @brief FREE_DAQ, ALLOC_DAQ, ALLOC_ODT, ALLOC_ODT_ENTRY, SET_DAQ_PTR, WRITE_DAQ and CLEAR_DAQ_LIST
+ */
+static void CommandDaqConfiguration(const uint8_t *cmd, uint8_t length)
+{
+	uint16_t daqNumber = ReadUInt16(&cmd[2]);
+	xcpDaq_TypeDef *daq = (daqNumber < xcp.DaqCount) ? &xcp.Daq[daqNumber] : 0;
+
+	switch (cmd[0])
+	{
+		case CMD_FREE_DAQ:
+			FreeDaq();
+			Respond(1);
+			break;
+
+		case CMD_ALLOC_DAQ:
+		{
+			uint16_t count = ReadUInt16(&cmd[2]);
+
+			if (length < 4u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (xcp.AllocStep != ALLOC_STEP_FREE)
+			{
+				RespondError(ERR_SEQUENCE);
+			}
+			else if (count > CAN_XCP_MAX_DAQ)
+			{
+				RespondError(ERR_MEMORY_OVERFLOW);
+			}
+			else
+			{
+				memset(xcp.Daq, 0, sizeof(xcp.Daq));
+				xcp.DaqCount = (uint8_t)count;
+				xcp.AllocStep = ALLOC_STEP_DAQ;
+				Respond(1);
+			}
+			break;
+		}
+
+		case CMD_ALLOC_ODT:
+			if (length < 5u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if ((xcp.AllocStep != ALLOC_STEP_DAQ && xcp.AllocStep != ALLOC_STEP_ODT) || daq == 0)
+			{
+				RespondError((daq == 0 && xcp.AllocStep != ALLOC_STEP_FREE) ? ERR_OUT_OF_RANGE : ERR_SEQUENCE);
+			}
+			else if (daq->OdtCount != 0u)
+			{
+				RespondError(ERR_SEQUENCE);
+			}
+			else if ((uint32_t)xcp.OdtCount + cmd[4] > CAN_XCP_MAX_ODT)
+			{
+				RespondError(ERR_MEMORY_OVERFLOW);
+			}
+			else
+			{
+				daq->FirstOdt = xcp.OdtCount;
+				daq->OdtCount = cmd[4];
+				memset(&xcp.Odt[xcp.OdtCount], 0, cmd[4] * sizeof(xcpOdt_TypeDef));
+				xcp.OdtCount = (uint8_t)(xcp.OdtCount + cmd[4]);
+				xcp.AllocStep = ALLOC_STEP_ODT;
+				Respond(1);
+			}
+			break;
+
+		case CMD_ALLOC_ODT_ENTRY:
+			if (length < 6u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (xcp.AllocStep != ALLOC_STEP_ODT && xcp.AllocStep != ALLOC_STEP_ODT_ENTRY)
+			{
+				RespondError(ERR_SEQUENCE);
+			}
+			else if (daq == 0 || cmd[4] >= daq->OdtCount)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else if (xcp.Odt[daq->FirstOdt + cmd[4]].EntryCount != 0u)
+			{
+				RespondError(ERR_SEQUENCE);
+			}
+			else if ((uint32_t)xcp.EntryCount + cmd[5] > CAN_XCP_MAX_ODT_ENTRY)
+			{
+				RespondError(ERR_MEMORY_OVERFLOW);
+			}
+			else
+			{
+				xcpOdt_TypeDef *odt = &xcp.Odt[daq->FirstOdt + cmd[4]];
+
+				odt->FirstEntry = xcp.EntryCount;
+				odt->EntryCount = cmd[5];
+				memset(&xcp.Entry[xcp.EntryCount], 0, cmd[5] * sizeof(xcpOdtEntry_TypeDef));
+				xcp.EntryCount = (uint16_t)(xcp.EntryCount + cmd[5]);
+				xcp.AllocStep = ALLOC_STEP_ODT_ENTRY;
+				Respond(1);
+			}
+			break;
+
+		case CMD_SET_DAQ_PTR:
+			if (length < 6u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (daq == 0 || cmd[4] >= daq->OdtCount || cmd[5] >= xcp.Odt[daq->FirstOdt + cmd[4]].EntryCount)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else if ((daq->Mode & MODE_RUNNING) != 0u)
+			{
+				RespondError(ERR_DAQ_ACTIVE);
+			}
+			else
+			{
+				xcp.PtrDaq = daqNumber;
+				xcp.PtrOdt = cmd[4];
+				xcp.PtrEntry = cmd[5];
+				xcp.PtrValid = 1;
+				Respond(1);
+			}
+			break;
+
+		case CMD_WRITE_DAQ:
+		{
+			const xcpOdt_TypeDef *odt;
+			const uint8_t *source;
+
+			if (length < 8u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+				break;
+			}
+			if (xcp.PtrValid == 0u)
+			{
+				RespondError(ERR_SEQUENCE);
+				break;
+			}
+			odt = &xcp.Odt[xcp.Daq[xcp.PtrDaq].FirstOdt + xcp.PtrOdt];
+			if (xcp.PtrEntry >= odt->EntryCount)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+				break;
+			}
+			if (cmd[1] != BIT_OFFSET_NONE || cmd[2] == 0u || cmd[2] > XCP_MAX_DTO - 1u)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+				break;
+			}
+			source = CAN_Xcp_GetPointer(ReadUInt32(&cmd[4]), cmd[3], cmd[2]);
+			if (source == 0)
+			{
+				RespondError(ERR_ACCESS_DENIED);
+				break;
+			}
+			xcp.Entry[odt->FirstEntry + xcp.PtrEntry].Source = source;
+			xcp.Entry[odt->FirstEntry + xcp.PtrEntry].Size = cmd[2];
+			xcp.PtrEntry++;
+			Respond(1);
+			break;
+		}
+
+		default: /* CMD_CLEAR_DAQ_LIST */
+			if (daq == 0)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else
+			{
+				uint8_t n;
+
+				daq->Mode = 0;
+				for (n = 0; n < daq->OdtCount; n++)
+				{
+					const xcpOdt_TypeDef *odt = &xcp.Odt[daq->FirstOdt + n];
+
+					memset(&xcp.Entry[odt->FirstEntry], 0, odt->EntryCount * sizeof(xcpOdtEntry_TypeDef));
+				}
+				Respond(1);
+			}
+			break;
+	}
+}
+
+/**
+ * @brief SET_DAQ_LIST_MODE, GET_DAQ_LIST_MODE, START_STOP_DAQ_LIST and START_STOP_SYNCH
+ */
+static void CommandDaqControl(const uint8_t *cmd, uint8_t length)
+{
+	uint16_t daqNumber = ReadUInt16(&cmd[2]);
+	xcpDaq_TypeDef *daq = (daqNumber < xcp.DaqCount) ? &xcp.Daq[daqNumber] : 0;
+	uint8_t i;
+
+	switch (cmd[0])
+	{
+		case CMD_SET_DAQ_LIST_MODE:
+			if (length < 8u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (daq == 0 || ReadUInt16(&cmd[4]) != 0u)
+			{
+				/* event channel 0 is the only one */
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else if ((daq->Mode & MODE_RUNNING) != 0u)
+			{
+				RespondError(ERR_DAQ_ACTIVE);
+			}
+			else if ((cmd[1] & ~MODE_SETTABLE) != 0u)
+			{
+				/* alternating, STIM and PID_OFF are not supported */
+				RespondError(ERR_MODE_NOT_VALID);
+			}
+			else
+			{
+				daq->Mode = (uint8_t)((daq->Mode & ~MODE_SETTABLE) | cmd[1]);
+				daq->Event = 0;
+				daq->Prescaler = (cmd[6] != 0u) ? cmd[6] : 1u;
+				Respond(1);
+			}
+			break;
+
+		case CMD_GET_DAQ_LIST_MODE:
+			if (length < 4u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (daq == 0)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else
+			{
+				xcp.Response[1] = daq->Mode;
+				xcp.Response[2] = 0;
+				xcp.Response[3] = 0;
+				xcp.Response[4] = (uint8_t)daq->Event;
+				xcp.Response[5] = (uint8_t)(daq->Event >> 8);
+				xcp.Response[6] = daq->Prescaler;
+				xcp.Response[7] = 0;
+				Respond(8);
+			}
+			break;
+
+		case CMD_START_STOP_DAQ_LIST:
+			if (length < 4u || cmd[1] > 2u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (daq == 0)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else if (cmd[1] != 0u && CheckDaqList(daq) == 0u)
+			{
+				RespondError(ERR_DAQ_CONFIG);
+			}
+			else
+			{
+				if (cmd[1] == 0u)
+				{
+					daq->Mode = (uint8_t)(daq->Mode & ~(MODE_RUNNING | MODE_SELECTED));
+				}
+				else if (cmd[1] == 1u)
+				{
+					StartDaqList(daq);
+				}
+				else
+				{
+					daq->Mode |= MODE_SELECTED;
+				}
+				xcp.Response[1] = daq->FirstOdt;
+				Respond(2);
+			}
+			break;
+
+		default: /* CMD_START_STOP_SYNCH */
+			if (length < 2u || cmd[1] > 2u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+				break;
+			}
+			for (i = 0; i < xcp.DaqCount; i++)
+			{
+				xcpDaq_TypeDef *entry = &xcp.Daq[i];
+
+				if (cmd[1] == 0u)
+				{
+					entry->Mode = (uint8_t)(entry->Mode & ~(MODE_RUNNING | MODE_SELECTED));
+				}
+				else if ((entry->Mode & MODE_SELECTED) != 0u)
+				{
+					if (cmd[1] == 1u)
+					{
+						StartDaqList(entry);
+					}
+					else
+					{
+						entry->Mode = (uint8_t)(entry->Mode & ~(MODE_RUNNING | MODE_SELECTED));
+					}
+				}
+			}
+			Respond(1);
+			break;
+	}
+}
+
+/**
+ * @brief GET_DAQ_CLOCK, GET_DAQ_PROCESSOR_INFO, GET_DAQ_RESOLUTION_INFO and GET_DAQ_EVENT_INFO
+ */
+static void CommandDaqInfo(const uint8_t *cmd, uint8_t length)
+{
+	switch (cmd[0])
+	{
+		case CMD_GET_DAQ_CLOCK:
+			xcp.Response[1] = 0;
+			xcp.Response[2] = 0;
+			xcp.Response[3] = 0;
+			WriteUInt32(&xcp.Response[4], (uint32_t)CAN_TimeSync_GetTimeUs());
+			Respond(8);
+			break;
+
+		case CMD_GET_DAQ_PROCESSOR_INFO:
+			/* dynamic configuration, prescaler and timestamps supported */
+			xcp.Response[1] = 0x13;
+			xcp.Response[2] = (uint8_t)CAN_XCP_MAX_DAQ;
+			xcp.Response[3] = 0;
+			xcp.Response[4] = 1;
+			xcp.Response[5] = 0;
+			xcp.Response[6] = 0;
+			/* absolute ODT number, address extension free per entry */
+			xcp.Response[7] = 0x00;
+			Respond(8);
+			break;
+
+		case CMD_GET_DAQ_RESOLUTION_INFO:
+			xcp.Response[1] = 1;
+			xcp.Response[2] = (uint8_t)(XCP_MAX_DTO - 1u);
+			xcp.Response[3] = 1;
+			xcp.Response[4] = 0;
+			/* 4 byte timestamp, unit 1us, one tick per unit */
+			xcp.Response[5] = 0x34;
+			xcp.Response[6] = 1;
+			xcp.Response[7] = 0;
+			Respond(8);
+			break;
+
+		default: /* CMD_GET_DAQ_EVENT_INFO */
+			if (length < 4u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+			}
+			else if (ReadUInt16(&cmd[2]) != 0u)
+			{
+				RespondError(ERR_OUT_OF_RANGE);
+			}
+			else
+			{
+				/* DAQ only, any number of DAQ lists, no name, cycle 1ms */
+				xcp.Response[1] = 0x04;
+				xcp.Response[2] = 0xFF;
+				xcp.Response[3] = 0;
+				xcp.Response[4] = 1;
+				xcp.Response[5] = 6;
+				xcp.Response[6] = 0;
+				Respond(7);
+			}
+			break;
+	}
+}
+
+/**
+ * @brief Sample all ODTs of a DAQ list, then send them
+ * @param daq: running DAQ list
+ * @param timestamp: time of the event [us]
+ * @param budget: number of DTOs which may be sent
+ * @return number of DTOs put into the transmit buffer
+ */
+static uint32_t SampleDaqList(xcpDaq_TypeDef *daq, uint32_t timestamp, uint32_t budget)
+{
+	uint32_t sent = 0;
+	uint8_t n;
+
+	if (daq->OdtCount > budget)
+	{
+		xcp.OverloadCount++;
+		return 0;
+	}
+
+	for (n = 0; n < daq->OdtCount; n++)
+	{
+		const xcpOdt_TypeDef *odt = &xcp.Odt[daq->FirstOdt + n];
+		uint8_t *frame = xcp.Sample[n];
+		uint8_t length = 1;
+		uint8_t e;
+
+		frame[0] = (uint8_t)(daq->FirstOdt + n);
+		if (n == 0u && (daq->Mode & MODE_TIMESTAMP) != 0u)
+		{
+			WriteUInt32(&frame[1], timestamp);
+			length = 1u + TIMESTAMP_SIZE;
+		}
+		for (e = 0; e < odt->EntryCount; e++)
+		{
+			const xcpOdtEntry_TypeDef *entry = &xcp.Entry[odt->FirstEntry + e];
+
+			memcpy(&frame[length], entry->Source, entry->Size);
+			length = (uint8_t)(length + entry->Size);
+		}
+		xcp.SampleLength[n] = length;
+	}
+
+	for (n = 0; n < daq->OdtCount; n++)
+	{
+		if (SendFrame(xcp.Sample[n], xcp.SampleLength[n]) != CAN_OK)
+		{
+			/* the master drops the incomplete sample by the missing ODTs */
+			xcp.OverloadCount++;
+			break;
+		}
+		sent++;
+	}
+	return sent;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+void CAN_Xcp_Init(void)
+{
+	memset(&xcp, 0, sizeof(xcp));
+}
+
+uint8_t CAN_Xcp_Receive(const canApi_MessageTypedef *message)
+{
+	const uint8_t *cmd = message->Data;
+	uint8_t length = message->DLC;
+
+	if (message->Identifier != CAN_XCP_CRO_ID || message->IDE != 0 || message->RTR != 0)
+	{
+		return 0;
+	}
+	if (length == 0u)
+	{
+		return 1;
+	}
+	if (cmd[0] == CMD_CONNECT)
+	{
+		xcp.Connected = 1;
+		/* DAQ resource, Intel byte order, byte granularity, GET_COMM_MODE_INFO available */
+		xcp.Response[1] = 0x04;
+		xcp.Response[2] = 0x80;
+		xcp.Response[3] = XCP_MAX_CTO;
+		xcp.Response[4] = XCP_MAX_DTO;
+		xcp.Response[5] = 0;
+		xcp.Response[6] = 1;
+		xcp.Response[7] = 1;
+		Respond(8);
+		return 1;
+	}
+	if (xcp.Connected == 0u)
+	{
+		/* only CONNECT is answered while disconnected */
+		return 1;
+	}
+
+	switch (cmd[0])
+	{
+		case CMD_DISCONNECT:
+			CAN_Xcp_Disconnect();
+			Respond(1);
+			break;
+
+		case CMD_GET_STATUS:
+			xcp.Response[1] = (IsDaqRunning() != 0u) ? 0x40u : 0x00u;
+			xcp.Response[2] = 0;
+			xcp.Response[3] = 0;
+			xcp.Response[4] = 0;
+			xcp.Response[5] = 0;
+			Respond(6);
+			break;
+
+		case CMD_SYNCH:
+			RespondError(ERR_CMD_SYNCH);
+			break;
+
+		case CMD_GET_COMM_MODE_INFO:
+			memset(&xcp.Response[1], 0, XCP_MAX_CTO - 1u);
+			/* driver version 1.0 */
+			xcp.Response[7] = 0x10;
+			Respond(8);
+			break;
+
+		case CMD_SET_MTA:
+			if (length < 8u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+				break;
+			}
+			xcp.MtaExtension = cmd[3];
+			xcp.MtaAddress = ReadUInt32(&cmd[4]);
+			Respond(1);
+			break;
+
+		case CMD_UPLOAD:
+			if (length < 2u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+				break;
+			}
+			Upload(cmd[1]);
+			break;
+
+		case CMD_SHORT_UPLOAD:
+			if (length < 8u)
+			{
+				RespondError(ERR_CMD_SYNTAX);
+				break;
+			}
+			xcp.MtaExtension = cmd[3];
+			xcp.MtaAddress = ReadUInt32(&cmd[4]);
+			Upload(cmd[1]);
+			break;
+
+		case CMD_FREE_DAQ:
+		case CMD_ALLOC_DAQ:
+		case CMD_ALLOC_ODT:
+		case CMD_ALLOC_ODT_ENTRY:
+		case CMD_SET_DAQ_PTR:
+		case CMD_WRITE_DAQ:
+		case CMD_CLEAR_DAQ_LIST:
+			CommandDaqConfiguration(cmd, length);
+			break;
+
+		case CMD_SET_DAQ_LIST_MODE:
+		case CMD_GET_DAQ_LIST_MODE:
+		case CMD_START_STOP_DAQ_LIST:
+		case CMD_START_STOP_SYNCH:
+			CommandDaqControl(cmd, length);
+			break;
+
+		case CMD_GET_DAQ_CLOCK:
+		case CMD_GET_DAQ_PROCESSOR_INFO:
+		case CMD_GET_DAQ_RESOLUTION_INFO:
+		case CMD_GET_DAQ_EVENT_INFO:
+			CommandDaqInfo(cmd, length);
+			break;
+
+		default:
+			RespondError(ERR_CMD_UNKNOWN);
+			break;
+	}
+	return 1;
+}
+
+void CAN_Xcp_Process(uint32_t budget)
+{
+	uint32_t timestamp;
+	uint8_t i;
+
+	if (xcp.ResponseLength != 0u && SendFrame(xcp.Response, xcp.ResponseLength) == CAN_OK)
+	{
+		xcp.ResponseLength = 0;
+	}
+	if (xcp.Connected == 0u)
+	{
+		return;
+	}
+
+	/* event channel 0: one timestamp for all DAQ lists of this millisecond */
+	timestamp = (uint32_t)CAN_TimeSync_GetTimeUs();
+	for (i = 0; i < xcp.DaqCount; i++)
+	{
+		xcpDaq_TypeDef *daq = &xcp.Daq[i];
+
+		if ((daq->Mode & MODE_RUNNING) == 0u)
+		{
+			continue;
+		}
+		daq->PrescalerCounter--;
+		if (daq->PrescalerCounter != 0u)
+		{
+			continue;
+		}
+		daq->PrescalerCounter = daq->Prescaler;
+		budget -= SampleDaqList(daq, timestamp, budget);
+	}
+}
+
+void CAN_Xcp_Disconnect(void)
+{
+	if (xcp.Connected != 0u)
+	{
+		xcp.Connected = 0;
+		FreeDaq();
+	}
+}
+
+uint32_t CAN_Xcp_GetOverloadCount(void)
+{
+	return xcp.OverloadCount;
+}
+
+/**
+ * @brief Default address translation: extension 0 is the memory address of the target
+ */
+__attribute__((weak)) const uint8_t* CAN_Xcp_GetPointer(uint32_t address, uint8_t extension, uint8_t size)
+{
+	(void)size;
+
+	if (extension != 0u || address == 0u)
+	{
+		return 0;
+	}
+	return (const uint8_t*)(uintptr_t)address;
+}
+
+/** @} */
@@ -0,0 +1,120 @@
+/**
+*******************************************************************************
+* @file CAN_xcp.h
+* @brief XCP on CAN slave for synchronous DAQ measurement
+* @author FRIWO
+* @date 20.10.2026 - 09:12:05
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Subset of XCP 1.1 on CAN for measuring variables at the 1ms rate of
+* canApi_UserPeriodicCallBack(), without calibration:
+* - CONNECT, DISCONNECT, GET_STATUS, SYNCH, GET_COMM_MODE_INFO
+* - SET_MTA, UPLOAD, SHORT_UPLOAD
+* - dynamic DAQ configuration: FREE_DAQ, ALLOC_DAQ, ALLOC_ODT, ALLOC_ODT_ENTRY,
+*   SET_DAQ_PTR, WRITE_DAQ, SET_DAQ_LIST_MODE, GET_DAQ_LIST_MODE,
+*   START_STOP_DAQ_LIST, START_STOP_SYNCH
+* - GET_DAQ_CLOCK, GET_DAQ_PROCESSOR_INFO, GET_DAQ_RESOLUTION_INFO, GET_DAQ_EVENT_INFO
+*
+* There is one event channel, number 0, with a cycle of 1ms. All ODTs of a DAQ
+* list are sampled in the same call of CAN_Xcp_Process() before the first one
+* is sent, so a DAQ list is consistent. Each DTO starts with the absolute ODT
+* number, followed by the 4 byte timestamp in the first ODT of a DAQ list with
+* timestamp mode, and the ODT entries without gaps. Byte order is Intel, the
+* timestamp unit 1us from the corrected clock of CAN_TimeSync_GetTimeUs(), so
+* measurements of synchronized nodes share one time base.
+*
+* CAN_custom.c passes received messages which are not in msgManagment_array to
+* CAN_Xcp_Receive() and calls CAN_Xcp_Process() once per
+* canApi_UserPeriodicCallBack() while CAN_C_Xcp_Enable is set.
+*/
+
+#ifndef CAN_XCP_H_
+#define CAN_XCP_H_
+
+/**
+* @addtogroup CAN_xcp
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include "canApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief identifier of the command frames from the master, standard identifier */
+#ifndef CAN_XCP_CRO_ID
+#define CAN_XCP_CRO_ID 0x6F0u
+#endif
+
+/** @brief identifier of the response, event and DAQ frames to the master, standard identifier */
+#ifndef CAN_XCP_DTO_ID
+#define CAN_XCP_DTO_ID 0x6F1u
+#endif
+
+/** @brief size of the DAQ list, ODT and ODT entry pools shared by ALLOC_DAQ, ALLOC_ODT and ALLOC_ODT_ENTRY */
+#ifndef CAN_XCP_MAX_DAQ
+#define CAN_XCP_MAX_DAQ 4u
+#endif
+#ifndef CAN_XCP_MAX_ODT
+#define CAN_XCP_MAX_ODT 32u
+#endif
+#ifndef CAN_XCP_MAX_ODT_ENTRY
+#define CAN_XCP_MAX_ODT_ENTRY 96u
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Disconnect and free all DAQ lists. Called by the CAN module when its state is initialized.
+ */
+void CAN_Xcp_Init(void);
+
+/**
+ * @brief Process a received message
+ * @param message: received message
+ * @return 1 if the message is an XCP command, else 0
+ */
+uint8_t CAN_Xcp_Receive(const canApi_MessageTypedef *message);
+
+/**
+ * @brief Send the pending command response and sample the running DAQ lists, call every 1ms
+ * @param budget: maximum number of DAQ frames put into the transmit buffer in this call. A DAQ list
+ * which does not fit completely is skipped and counted as overload, responses are always sent.
+ */
+void CAN_Xcp_Process(uint32_t budget);
+
+/**
+ * @brief End the session like DISCONNECT, e.g. when XCP is disabled
+ */
+void CAN_Xcp_Disconnect(void);
+
+/**
+ * @brief Get the number of skipped DAQ list samples
+ * @return DAQ list samples which did not fit into the budget or the transmit buffer since CAN_Xcp_Init()
+ */
+uint32_t CAN_Xcp_GetOverloadCount(void);
+
+/**
+ * @brief Translate an XCP address into a pointer for UPLOAD, SHORT_UPLOAD and WRITE_DAQ.
+ * The default implementation is weak: address extension 0 is the memory address of the target,
+ * every other extension is rejected. Provide this function to restrict the readable memory
+ * or to map addresses on a host.
+ * @param address: XCP address
+ * @param extension: XCP address extension
+ * @param size: number of bytes which will be read
+ * @return pointer to the first byte, 0 if the range may not be read
+ */
+const uint8_t* CAN_Xcp_GetPointer(uint32_t address, uint8_t extension, uint8_t size);
+
+/** @} */
+
+#endif /* CAN_XCP_H_ */
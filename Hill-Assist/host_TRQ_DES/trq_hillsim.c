@@ -0,0 +1,656 @@
+/**
+*******************************************************************************
+* @file trq_hillsim.c
+* @brief Host tool: hill starts of a vehicle model in closed loop with the hill-assist
+* @author FRIWO
+* @date 22.10.2026 - 10:12:44
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Runs TRQ_DES_custom() every simulated millisecond against a longitudinal
+* model of the vehicle, for calibrating TRQ_DES_C_ThrottlePriorization_Time
+* and TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed:
+* - throttle and brake lever of the rider script go to AIN1 and AIN2, the
+*   lever also applies the mechanical brake, which holds the vehicle as
+*   static friction at standstill
+* - the motor delivers TRQ_DES_Trq_Req_Rel percent of the torque map at the
+*   actual rotor speed, delayed by a first order lag
+* - grade force, rolling resistance and aero drag along a grade profile over
+*   the position, the grade is positive uphill in driving direction
+* - the rotor speed in revolutions per second goes back to INFO_Rotor_Speed
+*
+* Each hill start places the vehicle at rest at its position and plays the
+* pedal script from time 0. It ends when the vehicle reaches the launch speed
+* or after the timeout. Reported per start: rollback, the largest distance
+* behind the start position; time to launch from the first throttle until the
+* launch speed; time spent in throttle priorization. -T and -S take comma
+* separated lists, every combination is simulated.
+*
+* Scenario file (-f), one command per line, '#' starts a comment. Without -f
+* the built-in scenario is used, -p prints it as a template.
+*   mass kg | wheel radius_m | gear motor_per_wheel_revolutions | crr coefficient
+*   cda m2 | brake N_at_full_lever | lag ms | launch m_per_s | timeout s
+*   slope position_m grade_% ...      grade profile, replaces the previous one
+*   motor speed_1/s torque_Nm ...     maximum motor torque over rotor speed
+*   start position_m name            new hill start, followed by its script
+*   pedal time_s throttle_% brake_%  script point, linear in between
+*
+* Build: gcc -std=c99 -O2 -I../module_TRQ_DES -o trq_hillsim trq_hillsim.c trqdesApi_sim.c ../module_TRQ_DES/TRQ_DES_custom.c -lm
+* Usage: trq_hillsim [-f scenario] [-p] [-T time_ms[,...]] [-S max_rotor_speed[,...]] [-r rollback_limit_mm]
+*
+* The exit code is 0 if every start launched with a rollback within -r mm
+* (default no limit), 1 otherwise and 2 on usage or scenario errors.
+*/
+
+/**
+* @addtogroup trq_hillsim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#define _POSIX_C_SOURCE 200112L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trqdesApi_sim.h"
+#include "TRQ_DES_custom.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief step of the model, one call of TRQ_DES_custom() [s] */
+#define STEP 0.001
+
+/** @brief gravity [m/s^2] */
+#define GRAVITY 9.81
+
+/** @brief density of air [kg/m^3] */
+#define AIR_DENSITY 1.2
+
+/** @brief maximum number of points of a profile, map or script */
+#define MAX_POINTS 16u
+
+/** @brief maximum number of hill starts */
+#define MAX_STARTS 32u
+
+/** @brief maximum number of values of -T and -S */
+#define MAX_SWEEP 16u
+
+/** @brief the hill-assist state of throttle priorization, see TRQ_DES_HillAssist_State */
+#define STATE_PRIO 1u
+
+/** @brief built-in scenario: a hill of 6, 12 and 20 % with three riders on each grade */
+static const char defaultScenario[] =
+	"# scooter of 25 kg with a rider of 80 kg, 10 inch wheel with hub motor\n"
+	"mass 105\n"
+	"wheel 0.127\n"
+	"gear 1\n"
+	"crr 0.012\n"
+	"cda 0.6\n"
+	"brake 500\n"
+	"lag 20\n"
+	"launch 1.0\n"
+	"timeout 15\n"
+	"slope 0 0 10 6 60 6 70 12 120 12 130 20 180 20 190 0\n"
+	"motor 0 40 5 40 9 20 10 0\n"
+	"# throttle while still braking, then release the brake\n"
+	"start 35 overlap-6\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.8 80 100\npedal 1.0 80 100\npedal 1.4 80 0\n"
+	"start 95 overlap-12\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.8 80 100\npedal 1.0 80 100\npedal 1.4 80 0\n"
+	"start 155 overlap-20\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.8 80 100\npedal 1.0 80 100\npedal 1.4 80 0\n"
+	"# release the brake first, then throttle\n"
+	"start 35 release-6\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.8 0 0\npedal 1.0 0 0\npedal 1.3 80 0\n"
+	"start 95 release-12\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.8 0 0\npedal 1.0 0 0\npedal 1.3 80 0\n"
+	"start 155 release-20\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.8 0 0\npedal 1.0 0 0\npedal 1.3 80 0\n"
+	"# light brake which lets the vehicle creep back, throttle, brake held for 2 s\n"
+	"start 35 creep-6\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.6 0 20\npedal 1.5 0 20\npedal 1.8 80 20\npedal 3.5 80 20\npedal 3.8 80 0\n"
+	"start 95 creep-12\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.6 0 20\npedal 1.5 0 20\npedal 1.8 80 20\npedal 3.5 80 20\npedal 3.8 80 0\n"
+	"start 155 creep-20\n"
+	"pedal 0 0 100\npedal 0.5 0 100\npedal 0.6 0 20\npedal 1.5 0 20\npedal 1.8 80 20\npedal 3.5 80 20\npedal 3.8 80 0\n";
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Piecewise linear table, constant beyond its first and last point */
+typedef struct
+{
+	double X[MAX_POINTS];
+	double Y[MAX_POINTS];
+	uint32_t Count;
+}table_TypeDef;
+
+/** @brief One hill start with the pedal script of the rider */
+typedef struct
+{
+	char Name[24];
+	double Position; /**< @brief start position on the grade profile [m] */
+	double Time[MAX_POINTS]; /**< @brief script points [s] */
+	double Throttle[MAX_POINTS]; /**< @brief throttle lever [%] */
+	double Brake[MAX_POINTS]; /**< @brief brake lever [%] */
+	uint32_t Count;
+}start_TypeDef;
+
+/** @brief Parameters of the vehicle and the hill starts */
+typedef struct
+{
+	double Mass; /**< @brief vehicle with rider [kg] */
+	double Wheel; /**< @brief wheel radius [m] */
+	double Gear; /**< @brief motor revolutions per wheel revolution */
+	double Crr; /**< @brief rolling resistance coefficient */
+	double CdA; /**< @brief drag coefficient times frontal area [m^2] */
+	double Brake; /**< @brief force of the mechanical brake at full lever, at the wheel [N] */
+	double Lag; /**< @brief time constant of the motor torque [s] */
+	double Launch; /**< @brief speed which counts as launched [m/s] */
+	double Timeout; /**< @brief end of a start which did not launch [s] */
+	table_TypeDef Slope; /**< @brief grade [%] over position [m] */
+	table_TypeDef Motor; /**< @brief maximum motor torque [Nm] over rotor speed [1/s] */
+	start_TypeDef Start[MAX_STARTS];
+	uint32_t Starts;
+}scenario_TypeDef;
+
+/** @brief Result of one hill start */
+typedef struct
+{
+	double Rollback; /**< @brief largest distance behind the start position [m] */
+	double Launch; /**< @brief first throttle until launch speed, < 0 if not launched [s] */
+	double Prio; /**< @brief time in throttle priorization [s] */
+	double BackSpeed; /**< @brief largest backward speed [m/s] */
+	double Simulated; /**< @brief simulated time [s] */
+}result_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static scenario_TypeDef scenario;
+
+/* EnableTool variables of TRQ_DES_custom.c */
+extern TRQ_DES_LOCAL volatile UInt16 TRQ_DES_C_ThrottlePriorization_Time;
+extern TRQ_DES_LOCAL volatile Float32 TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed;
+extern TRQ_DES_LOCAL volatile UInt8 TRQ_DES_HillAssist_State;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void PrintUsage(void)
+{
+	fprintf(stderr, "usage: trq_hillsim [-f scenario] [-p] [-T time_ms[,...]] [-S max_rotor_speed[,...]] [-r rollback_limit_mm]\n");
+}
+
+static double WallSeconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Interpolate linearly between the points of x and y.
+ * The search starts at the segment of the previous call, which the simulated values rarely leave.
+ * @param segment: index of the point at or below the previous value, updated
+ */
+static double Interpolate(const double *x, const double *y, uint32_t count, double at, uint32_t *segment)
+{
+	uint32_t i = *segment;
+
+	while (i + 1u < count && at >= x[i + 1u])
+	{
+		i++;
+	}
+	while (i > 0u && at < x[i])
+	{
+		i--;
+	}
+	*segment = i;
+	if (at <= x[i] || i + 1u >= count)
+	{
+		return y[i];
+	}
+	return y[i] + (y[i + 1u] - y[i]) * (at - x[i]) / (x[i + 1u] - x[i]);
+}
+
+/**
+ * @brief Read the pairs of a slope or motor command, the x values must rise
+ * @return 0 on success, -1 on a syntax error
+ */
+static int ParseTable(table_TypeDef *table)
+{
+	char *token;
+
+	table->Count = 0u;
+	while ((token = strtok(0, " \t")) != 0)
+	{
+		char *y = strtok(0, " \t");
+
+		if (y == 0 || table->Count >= MAX_POINTS)
+		{
+			return -1;
+		}
+		table->X[table->Count] = strtod(token, 0);
+		table->Y[table->Count] = strtod(y, 0);
+		if (table->Count > 0u && table->X[table->Count] <= table->X[table->Count - 1u])
+		{
+			return -1;
+		}
+		table->Count++;
+	}
+	return (table->Count > 0u) ? 0 : -1;
+}
+
+/**
+ * @brief Interpret one line of the scenario
+ * @return 0 on success, -1 on an error
+ */
+static int ParseLine(char *line)
+{
+	static const char *const names[] = {"mass", "wheel", "gear", "crr", "cda", "brake", "lag", "launch", "timeout"};
+	double *const values[] = {&scenario.Mass, &scenario.Wheel, &scenario.Gear, &scenario.Crr, &scenario.CdA,
+		&scenario.Brake, &scenario.Lag, &scenario.Launch, &scenario.Timeout};
+	char *command;
+	char *argument;
+	uint32_t i;
+
+	line[strcspn(line, "#\r\n")] = '\0';
+	command = strtok(line, " \t");
+	if (command == 0)
+	{
+		return 0;
+	}
+	if (strcmp(command, "slope") == 0)
+	{
+		return ParseTable(&scenario.Slope);
+	}
+	if (strcmp(command, "motor") == 0)
+	{
+		return ParseTable(&scenario.Motor);
+	}
+	argument = strtok(0, " \t");
+	if (argument == 0)
+	{
+		return -1;
+	}
+	for (i = 0u; i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		if (strcmp(command, names[i]) == 0)
+		{
+			*values[i] = strtod(argument, 0);
+			return 0;
+		}
+	}
+	if (strcmp(command, "start") == 0)
+	{
+		char *name = strtok(0, " \t");
+		start_TypeDef *start = &scenario.Start[scenario.Starts];
+
+		if (scenario.Starts >= MAX_STARTS)
+		{
+			return -1;
+		}
+		scenario.Starts++;
+		start->Position = strtod(argument, 0);
+		snprintf(start->Name, sizeof(start->Name), "%s", (name != 0) ? name : "-");
+		start->Count = 0u;
+		return 0;
+	}
+	if (strcmp(command, "pedal") == 0)
+	{
+		char *throttle = strtok(0, " \t");
+		char *brake = strtok(0, " \t");
+		start_TypeDef *start;
+
+		if (scenario.Starts == 0u || throttle == 0 || brake == 0)
+		{
+			return -1;
+		}
+		start = &scenario.Start[scenario.Starts - 1u];
+		if (start->Count >= MAX_POINTS)
+		{
+			return -1;
+		}
+		start->Time[start->Count] = strtod(argument, 0);
+		start->Throttle[start->Count] = strtod(throttle, 0);
+		start->Brake[start->Count] = strtod(brake, 0);
+		if (start->Count > 0u && start->Time[start->Count] <= start->Time[start->Count - 1u])
+		{
+			return -1;
+		}
+		start->Count++;
+		return 0;
+	}
+	return -1;
+}
+
+/**
+ * @brief Read the scenario from a file, or the built-in one for 0, and check it
+ * @return 0 on success, -1 on an error, reported on stderr
+ */
+static int LoadScenario(const char *path)
+{
+	char line[256];
+	uint32_t number = 0u;
+	uint32_t i;
+
+	memset(&scenario, 0, sizeof(scenario));
+	if (path == 0)
+	{
+		const char *next = defaultScenario;
+
+		while (*next != '\0')
+		{
+			size_t length = strcspn(next, "\n");
+
+			memcpy(line, next, length);
+			line[length] = '\0';
+			next += length + ((next[length] != '\0') ? 1u : 0u);
+			number++;
+			if (ParseLine(line) != 0)
+			{
+				break;
+			}
+		}
+		if (*next != '\0')
+		{
+			fprintf(stderr, "built-in scenario: error in line %u\n", (unsigned)number);
+			return -1;
+		}
+	}
+	else
+	{
+		FILE *file = fopen(path, "r");
+
+		if (file == 0)
+		{
+			fprintf(stderr, "%s: cannot open\n", path);
+			return -1;
+		}
+		while (fgets(line, sizeof(line), file) != 0)
+		{
+			number++;
+			if (ParseLine(line) != 0)
+			{
+				fprintf(stderr, "%s:%u: error\n", path, (unsigned)number);
+				fclose(file);
+				return -1;
+			}
+		}
+		fclose(file);
+	}
+	if (scenario.Mass <= 0.0 || scenario.Wheel <= 0.0 || scenario.Gear <= 0.0 || scenario.Crr < 0.0
+		|| scenario.CdA < 0.0 || scenario.Brake < 0.0 || scenario.Lag < 0.0 || scenario.Launch <= 0.0
+		|| scenario.Timeout <= 0.0 || scenario.Slope.Count == 0u || scenario.Motor.Count == 0u || scenario.Starts == 0u)
+	{
+		fprintf(stderr, "scenario: mass, wheel, gear, launch, timeout, slope, motor and a start are required\n");
+		return -1;
+	}
+	for (i = 0u; i < scenario.Starts; i++)
+	{
+		if (scenario.Start[i].Count == 0u)
+		{
+			fprintf(stderr, "scenario: start %s has no pedal points\n", scenario.Start[i].Name);
+			return -1;
+		}
+	}
+	scenario.Lag *= 0.001;
+	return 0;
+}
+
+/**
+ * @brief Simulate one hill start in closed loop with TRQ_DES_custom()
+ */
+static result_TypeDef RunStart(const start_TypeDef *start)
+{
+	result_TypeDef result = {0.0, -1.0, 0.0, 0.0, 0.0};
+	/* constants of the model, kept local as TRQ_DES_custom() might change the global scenario for all the compiler knows */
+	const double rotorPerSpeed = scenario.Gear / (2.0 * 3.14159265358979 * scenario.Wheel); /* [1/m] */
+	const double forcePerTorque = scenario.Gear / scenario.Wheel; /* [1/m] */
+	const double lagFactor = STEP / (scenario.Lag + STEP);
+	const double weight = scenario.Mass * GRAVITY; /* [N] */
+	const double rolling = scenario.Crr * weight; /* [N] */
+	const double brakePerLever = 0.01 * scenario.Brake; /* [N/%] */
+	const double aero = 0.5 * AIR_DENSITY * scenario.CdA; /* [kg/m] */
+	const double stepPerMass = STEP / scenario.Mass; /* [s/kg] */
+	const double launch = scenario.Launch; /* [m/s] */
+	const uint32_t steps = (uint32_t)(scenario.Timeout / STEP);
+	uint32_t step;
+	double position = start->Position;
+	double speed = 0.0;
+	double torque = 0.0;
+	double throttleTime = -1.0;
+	uint32_t pedalSegment[2] = {0u, 0u};
+	uint32_t slopeSegment = 0u;
+	uint32_t motorSegment = 0u;
+
+	/* one tick without torque control puts the state machine back to its initial state */
+	trqdesApiSim_SM_OUT_SYS_Trq_Control = 0.F;
+	trqdesApiSim_AIN1_Throttle = 0.F;
+	trqdesApiSim_AIN2_Throttle = 0.F;
+	trqdesApiSim_INFO_Rotor_Speed = 0.F;
+	trqdesApiSim_Tick(1u);
+	trqdesApiSim_SM_OUT_SYS_Trq_Control = 1.F;
+
+	for (step = 1u; step <= steps; step++)
+	{
+		double t = (double)(step - 1u) * STEP;
+		double throttle = Interpolate(start->Time, start->Throttle, start->Count, t, &pedalSegment[0]);
+		double brake = Interpolate(start->Time, start->Brake, start->Count, t, &pedalSegment[1]);
+		double rotorSpeed = speed * rotorPerSpeed;
+		double grade = 0.01 * Interpolate(scenario.Slope.X, scenario.Slope.Y, scenario.Slope.Count, position, &slopeSegment);
+		double cosine = 1.0 / sqrt(1.0 + grade * grade);
+		double demand;
+		double drive;
+		double hold;
+
+		trqdesApiSim_AIN1_Throttle = (Float32)throttle;
+		trqdesApiSim_AIN2_Throttle = (Float32)brake;
+		trqdesApiSim_INFO_Rotor_Speed = (Float32)rotorSpeed;
+		trqdesApiSim_Tick(1u);
+		if (TRQ_DES_HillAssist_State == STATE_PRIO)
+		{
+			result.Prio += STEP;
+		}
+
+		/* motor torque follows the request with a first order lag */
+		demand = 0.01 * (double)trqdesApiSim_TRQ_DES_Trq_Req_Rel
+			* Interpolate(scenario.Motor.X, scenario.Motor.Y, scenario.Motor.Count, fabs(rotorSpeed), &motorSegment);
+		torque += (demand - torque) * lagFactor;
+
+		/* motor and grade drive, brake and rolling resistance hold as friction */
+		drive = torque * forcePerTorque - weight * grade * cosine;
+		hold = brake * brakePerLever + rolling * cosine;
+		if (speed == 0.0)
+		{
+			if (fabs(drive) > hold)
+			{
+				speed = (drive - copysign(hold, drive)) * stepPerMass;
+			}
+		}
+		else
+		{
+			double next = speed + (drive - copysign(hold, speed) - aero * speed * fabs(speed)) * stepPerMass;
+
+			/* friction stops the vehicle, it does not reverse it */
+			speed = (next * speed < 0.0) ? 0.0 : next;
+		}
+		position += speed * STEP;
+
+		if (throttleTime < 0.0 && throttle > 0.0)
+		{
+			throttleTime = t;
+		}
+		if (start->Position - position > result.Rollback)
+		{
+			result.Rollback = start->Position - position;
+		}
+		if (-speed > result.BackSpeed)
+		{
+			result.BackSpeed = -speed;
+		}
+		if (throttleTime >= 0.0 && speed >= launch)
+		{
+			result.Launch = t + STEP - throttleTime;
+			break;
+		}
+	}
+	result.Simulated = (double)step * STEP;
+	return result;
+}
+
+/**
+ * @brief Read a comma separated list of values
+ * @return number of values, 0 on a syntax error
+ */
+static uint32_t ParseList(const char *text, double *values)
+{
+	uint32_t count = 0u;
+
+	while (count < MAX_SWEEP)
+	{
+		char *end;
+
+		values[count++] = strtod(text, &end);
+		if (end == text)
+		{
+			return 0u;
+		}
+		if (*end == '\0')
+		{
+			return count;
+		}
+		if (*end != ',')
+		{
+			return 0u;
+		}
+		text = end + 1;
+	}
+	return 0u;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int main(int argc, char *argv[])
+{
+	const char *path = 0;
+	double times[MAX_SWEEP];
+	double speeds[MAX_SWEEP];
+	uint32_t timeCount = 1u;
+	uint32_t speedCount = 1u;
+	double limit = -1.0;
+	double simulated = 0.0;
+	double wall = 0.0;
+	int failed = 0;
+	uint32_t t;
+	uint32_t s;
+	uint32_t i;
+
+	times[0] = (double)TRQ_DES_C_ThrottlePriorization_Time;
+	speeds[0] = (double)TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed;
+	for (i = 1u; i < (uint32_t)argc; i++)
+	{
+		if (strcmp(argv[i], "-p") == 0)
+		{
+			fputs(defaultScenario, stdout);
+			return 0;
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-f") == 0)
+		{
+			path = argv[++i];
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-T") == 0)
+		{
+			timeCount = ParseList(argv[++i], times);
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-S") == 0)
+		{
+			speedCount = ParseList(argv[++i], speeds);
+		}
+		else if (i + 1u < (uint32_t)argc && strcmp(argv[i], "-r") == 0)
+		{
+			limit = 0.001 * strtod(argv[++i], 0);
+		}
+		else
+		{
+			timeCount = 0u;
+		}
+	}
+	for (i = 0u; i < timeCount; i++)
+	{
+		if (times[i] < 0.0 || times[i] > 65535.0)
+		{
+			timeCount = 0u;
+		}
+	}
+	if (timeCount == 0u || speedCount == 0u)
+	{
+		PrintUsage();
+		return 2;
+	}
+	if (LoadScenario(path) != 0)
+	{
+		return 2;
+	}
+
+	trqdesApiSim_Reset();
+	printf("mass %.0f kg, wheel %.3f m, gear %.2f, brake %.0f N, torque lag %.0f ms, launch at %.2f m/s\n",
+		scenario.Mass, scenario.Wheel, scenario.Gear, scenario.Brake, scenario.Lag * 1000.0, scenario.Launch);
+	for (t = 0u; t < timeCount; t++)
+	{
+		for (s = 0u; s < speedCount; s++)
+		{
+			TRQ_DES_C_ThrottlePriorization_Time = (UInt16)times[t];
+			TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed = (Float32)speeds[s];
+			printf("\nThrottlePriorization_Time %u ms, MaxRotorSpeed %.2f 1/s\n", (unsigned)TRQ_DES_C_ThrottlePriorization_Time,
+				(double)TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed);
+			printf("start         grade[%%]  rollback[mm]  back[m/s]  prio[ms]  launch[ms]\n");
+			for (i = 0u; i < scenario.Starts; i++)
+			{
+				const start_TypeDef *start = &scenario.Start[i];
+				uint32_t segment = 0u;
+				double begin = WallSeconds();
+				result_TypeDef result = RunStart(start);
+
+				wall += WallSeconds() - begin;
+				simulated += result.Simulated;
+				printf("%-12s  %8.1f  %12.0f  %9.3f  %8.0f  ", start->Name,
+					Interpolate(scenario.Slope.X, scenario.Slope.Y, scenario.Slope.Count, start->Position, &segment),
+					result.Rollback * 1000.0, result.BackSpeed, result.Prio * 1000.0);
+				if (result.Launch < 0.0)
+				{
+					printf("%10s\n", "none");
+					failed = 1;
+				}
+				else
+				{
+					printf("%10.0f\n", result.Launch * 1000.0);
+				}
+				if (limit >= 0.0 && result.Rollback > limit)
+				{
+					failed = 1;
+				}
+			}
+		}
+	}
+	printf("\nsimulated %.1f s in %.3f s wall time, %.0f x real time\n", simulated, wall,
+		(wall > 0.0) ? simulated / wall : 0.0);
+	return failed;
+}
+
+/** @} */
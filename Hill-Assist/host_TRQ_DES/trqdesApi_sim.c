@@ -0,0 +1,172 @@
+/**
+*******************************************************************************
+* @file trqdesApi_sim.c
+* @brief Host stand-in for the trqdesApi of the basic firmware
+* @author FRIWO
+* @date 19.10.2026 - 15:21:07
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* See trqdesApi_sim.h for the simulated behaviour and the build command.
+*/
+
+/**
+* @addtogroup trqdesApi_sim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <string.h>
+#include "trqdesApi_sim.h"
+#include "TRQ_DES_custom.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief number of trqdesApi signals */
+#define SIGNALS_AVAILABLE ((uint32_t)(sizeof(signal_array) / sizeof(trqdesApiSim_SignalTypeDef)))
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Index of every signal in signal_array */
+typedef enum
+{
+#define TRQDESAPI_SIM_INDEX(name) SIGNAL_INDEX_##name,
+	TRQDESAPI_SIM_SIGNALS(TRQDESAPI_SIM_INDEX, TRQDESAPI_SIM_INDEX)
+#undef TRQDESAPI_SIM_INDEX
+	SIGNAL_INDEX_COUNT
+}simSignalIndex_TypeDef;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* signal storage */
+#define TRQDESAPI_SIM_STORAGE(name) TRQDESAPI_SIM_LOCAL Float32 trqdesApiSim_##name = 0.F;
+TRQDESAPI_SIM_SIGNALS(TRQDESAPI_SIM_STORAGE, TRQDESAPI_SIM_STORAGE)
+#undef TRQDESAPI_SIM_STORAGE
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief signal descriptions for generic access, in the order of trqdesApi.h.
+ * The value pointers are set in trqdesApiSim_Reset(), the address of a thread-local signal is not a constant.
+ */
+static TRQDESAPI_SIM_LOCAL trqdesApiSim_SignalTypeDef signal_array[] =
+{
+#define TRQDESAPI_SIM_DESC_GET(name) {#name, 0, 0},
+#define TRQDESAPI_SIM_DESC_SET(name) {#name, 1, 0},
+	TRQDESAPI_SIM_SIGNALS(TRQDESAPI_SIM_DESC_GET, TRQDESAPI_SIM_DESC_SET)
+#undef TRQDESAPI_SIM_DESC_GET
+#undef TRQDESAPI_SIM_DESC_SET
+};
+
+static TRQDESAPI_SIM_LOCAL uint32_t simTimeUs = 0;
+static TRQDESAPI_SIM_LOCAL trqdesApiSim_FptrOnSet signalObserver = 0;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+static void NotifySet(simSignalIndex_TypeDef index);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PRIVATE FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Call the signal observer for a trqdesApi_Set_ call
+ * @param index: index of the written signal
+ */
+static void NotifySet(simSignalIndex_TypeDef index)
+{
+	if (signalObserver != 0)
+	{
+		signalObserver(&signal_array[index], *signal_array[index].Value, simTimeUs);
+	}
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTIONS */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* trqdesApi signal functions */
+#define TRQDESAPI_SIM_GETTER(name) Float32 trqdesApi_Get_##name(void) { return trqdesApiSim_##name; }
+#define TRQDESAPI_SIM_SETTER(name) void trqdesApi_Set_##name(Float32 value) { trqdesApiSim_##name = value; NotifySet(SIGNAL_INDEX_##name); }
+TRQDESAPI_SIM_SIGNALS(TRQDESAPI_SIM_GETTER, TRQDESAPI_SIM_SETTER)
+#undef TRQDESAPI_SIM_GETTER
+#undef TRQDESAPI_SIM_SETTER
+
+void trqdesApiSim_Reset(void)
+{
+	uint32_t i;
+
+#define TRQDESAPI_SIM_ADDRESS(name) signal_array[SIGNAL_INDEX_##name].Value = &trqdesApiSim_##name;
+	TRQDESAPI_SIM_SIGNALS(TRQDESAPI_SIM_ADDRESS, TRQDESAPI_SIM_ADDRESS)
+#undef TRQDESAPI_SIM_ADDRESS
+	for (i = 0; i < SIGNALS_AVAILABLE; i++)
+	{
+		*signal_array[i].Value = 0.F;
+	}
+	simTimeUs = 0;
+	signalObserver = 0;
+}
+
+void trqdesApiSim_Tick(uint32_t count)
+{
+	while (count > 0)
+	{
+		simTimeUs += 1000u;
+		TRQ_DES_custom();
+		count--;
+	}
+}
+
+uint32_t trqdesApiSim_GetTimeUs(void)
+{
+	return simTimeUs;
+}
+
+void trqdesApiSim_SetSignalObserver(trqdesApiSim_FptrOnSet observer)
+{
+	signalObserver = observer;
+}
+
+uint32_t trqdesApiSim_GetSignalCount(void)
+{
+	return SIGNALS_AVAILABLE;
+}
+
+const trqdesApiSim_SignalTypeDef* trqdesApiSim_GetSignalByIndex(uint32_t index)
+{
+	if (index >= SIGNALS_AVAILABLE)
+	{
+		return 0;
+	}
+	return &signal_array[index];
+}
+
+const trqdesApiSim_SignalTypeDef* trqdesApiSim_FindSignal(const char *name)
+{
+	uint32_t i;
+
+	for (i = 0; i < SIGNALS_AVAILABLE; i++)
+	{
+		if (strcmp(signal_array[i].Name, name) == 0)
+		{
+			return &signal_array[i];
+		}
+	}
+	return 0;
+}
+
+/** @} */
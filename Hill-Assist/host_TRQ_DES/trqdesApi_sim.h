@@ -0,0 +1,148 @@
+/**
+*******************************************************************************
+* @file trqdesApi_sim.h
+* @brief Host stand-in for the trqdesApi of the basic firmware
+* @author FRIWO
+* @date 19.10.2026 - 15:21:07
+* <hr>
+*******************************************************************************
+* COPYRIGHT &copy; 2026 FRIWO GmbH
+*******************************************************************************
+*
+* Implements every function of trqdesApi.h on a Linux host so that
+* TRQ_DES_custom.c runs unchanged outside the target. Each trqdesApi_Get_ and
+* trqdesApi_Set_ signal is an ordinary variable trqdesApiSim_<name>; the tick
+* driver calls TRQ_DES_custom() once per simulated millisecond. Built with
+* -DTRQ_DES_MULTI_INSTANCE all simulation state is thread-local, so each thread
+* simulates its own controller, see TRQ_DES_SelectContext().
+*
+* Build together with the module and a driver, e.g.
+* gcc -std=c99 -O2 -I../module_TRQ_DES -o trq_host driver.c trqdesApi_sim.c ../module_TRQ_DES/TRQ_DES_custom.c -lm
+*/
+
+#ifndef TRQDESAPI_SIM_H_
+#define TRQDESAPI_SIM_H_
+
+/**
+* @addtogroup trqdesApi_sim
+* @{
+*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* INCLUDES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <stdint.h>
+#include "trqdesApi.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC DEFINES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief X-macro list of all signals of trqdesApi.h.
+ * GET(name) is read by the module through trqdesApi_Get_<name>(), SET(name) written through trqdesApi_Set_<name>().
+ * All signals are Float32.
+ */
+#define TRQDESAPI_SIM_SIGNALS(GET, SET) \
+	GET(APP_Brake_Signal_Channel) \
+	GET(APP_Reverse_Gear_Signal_Channel) \
+	GET(APP_Throttle_Signal_Channel) \
+	GET(AIN1_Throttle) \
+	GET(AIN2_Throttle) \
+	GET(CAN_EXT_Reverse_Gear) \
+	GET(CAN_EXT_Torque_Request) \
+	GET(DIN_DIN1_Signal) \
+	GET(DIN_DIN2_Signal) \
+	GET(PWMI_Throttle) \
+	GET(INFO_Rotor_Speed) \
+	GET(APP_Disp_Ride_Mode) \
+	GET(SM_OUT_SYS_Trq_Control) \
+	GET(IHS_Vibration_Detected) \
+	SET(TRQ_DES_Driver_Throttle) \
+	SET(TRQ_DES_Driver_Brake) \
+	SET(TRQ_DES_Driver_Reverse_Gear) \
+	SET(TRQ_DES_Trq_Req_Rel)
+
+/** @brief storage of the simulation state, one simulated controller per thread in multi-instance builds */
+#ifdef TRQ_DES_MULTI_INSTANCE
+#define TRQDESAPI_SIM_LOCAL _Thread_local
+#else
+#define TRQDESAPI_SIM_LOCAL
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC TYPEDEF */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/** @brief Description of one trqdesApi signal for generic access by name */
+typedef struct
+{
+	const char *Name; /**< @brief signal name without trqdesApi_Get_/trqdesApi_Set_ prefix */
+	uint8_t Direction; /**< @brief 0 = read by the module (Get), 1 = written by the module (Set) */
+	Float32 *Value; /**< @brief pointer to the variable trqdesApiSim_<name> */
+}trqdesApiSim_SignalTypeDef;
+
+/** @brief Called for every trqdesApi_Set_ call of the module */
+typedef void (*trqdesApiSim_FptrOnSet)(const trqdesApiSim_SignalTypeDef *signal, Float32 value, uint32_t timestamp);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC VARIABLES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* one variable trqdesApiSim_<name> per signal */
+#define TRQDESAPI_SIM_EXTERN(name) extern TRQDESAPI_SIM_LOCAL Float32 trqdesApiSim_##name;
+TRQDESAPI_SIM_SIGNALS(TRQDESAPI_SIM_EXTERN, TRQDESAPI_SIM_EXTERN)
+#undef TRQDESAPI_SIM_EXTERN
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* PUBLIC FUNCTION PROTOTYPES */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/**
+ * @brief Clear all signals, the observer and the simulated clock
+ */
+void trqdesApiSim_Reset(void);
+
+/**
+ * @brief Run the module for a number of 1ms ticks as fast as possible.
+ * Each tick advances the clock by 1000us and calls TRQ_DES_custom().
+ * @param count: number of ticks
+ */
+void trqdesApiSim_Tick(uint32_t count);
+
+/**
+ * @brief Get the simulated clock
+ * @return time since trqdesApiSim_Reset() [us]
+ */
+uint32_t trqdesApiSim_GetTimeUs(void);
+
+/**
+ * @brief Register a function called for every trqdesApi_Set_ call, 0 to remove
+ * @param observer: function pointer
+ */
+void trqdesApiSim_SetSignalObserver(trqdesApiSim_FptrOnSet observer);
+
+/**
+ * @brief Get the number of trqdesApi signals
+ * @return number of entries for trqdesApiSim_GetSignalByIndex()
+ */
+uint32_t trqdesApiSim_GetSignalCount(void);
+
+/**
+ * @brief Get a trqdesApi signal by index, in the order of trqdesApi.h.
+ * The value pointer is valid after trqdesApiSim_Reset() in the calling thread.
+ * @param index: 0...trqdesApiSim_GetSignalCount()-1
+ * @return signal description, 0 if index is out of range
+ */
+const trqdesApiSim_SignalTypeDef* trqdesApiSim_GetSignalByIndex(uint32_t index);
+
+/**
+ * @brief Find a trqdesApi signal by name
+ * @param name: signal name without trqdesApi_Get_/trqdesApi_Set_ prefix
+ * @return signal description, 0 if unknown
+ */
+const trqdesApiSim_SignalTypeDef* trqdesApiSim_FindSignal(const char *name);
+
+/** @} */
+
+#endif /* TRQDESAPI_SIM_H_ */
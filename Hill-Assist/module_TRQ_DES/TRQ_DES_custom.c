@@ -51,6 +51,15 @@ typedef enum
 	zero and rotor speed is below threshold. */
 }hillAssistState_TypeDef;
 
+/** 
+ * @brief State of the hill-assist state machine which is kept from one call of TRQ_DES_custom() to the next.
+ */
+struct TRQ_DES_ContextTag
+{
+	hillAssistState_TypeDef StateHillAssist; /**< @brief current state of the hill-assist state machine */
+	UInt16 CtrHillAssist; /**< @brief remaining time of throttle priorization [ms] */
+};
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PRIVATE CONSTANTS */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -65,40 +74,40 @@ typedef enum
  * All data types which can be chosen:  Int8, Int16, Int32, UInt8, UInt16, UInt32, Bool and Float32.
  */
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile Float32 TRQ_DES_Throttle_Input; /*
+TRQ_DES_LOCAL volatile Float32 TRQ_DES_Throttle_Input; /*
 	Description: Throttle signal value after selection of input channel [%] */
 	
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile Float32 TRQ_DES_Brake_Input; /*
+TRQ_DES_LOCAL volatile Float32 TRQ_DES_Brake_Input; /*
 	Description: Brake signal value after selection of input channel [%] */
    
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile Float32 TRQ_DES_ReverseGear_Input; /*
+TRQ_DES_LOCAL volatile Float32 TRQ_DES_ReverseGear_Input; /*
 	Description: Shows if reverse gear is selected after selection of input 
 	channel;  0 = forward gear selected; 1 = reverse gear selected */
 	
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile Float32 TRQ_DES_TorqueRequest; /*
+TRQ_DES_LOCAL volatile Float32 TRQ_DES_TorqueRequest; /*
 	Description: Shows the desired torque request returned to trqdesApi [%]; */
    
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile UInt8 TRQ_DES_TorqueRequest_UpperLim; /*
+TRQ_DES_LOCAL volatile UInt8 TRQ_DES_TorqueRequest_UpperLim; /*
 	Description: Shows if desired torque has reached the upper bound of 
 	allowed operational range */
    
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile UInt8 TRQ_DES_TorqueRequest_LowerLim; /*
+TRQ_DES_LOCAL volatile UInt8 TRQ_DES_TorqueRequest_LowerLim; /*
 	Description: Shows if desired torque has reached the lower bound of 
 	allowed operational range */
 
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile UInt8 TRQ_DES_HillAssist_State; /*
+TRQ_DES_LOCAL volatile UInt8 TRQ_DES_HillAssist_State; /*
 	Description: Shows the actual state of hill-assist algorithm; 
 	0 = Initial state; 1 = Throttle priorization; 
 	2 = Accelerate without priorization; */
 
 __attribute__((section("EMERGE_DISP_RAM")))
-volatile UInt16 TRQ_DES_HillAssist_ValCounter; /*
+TRQ_DES_LOCAL volatile UInt16 TRQ_DES_HillAssist_ValCounter; /*
 	Description: Shows the actual value of hill-assist counter to priorize 
 	throttle */
 
@@ -109,16 +118,16 @@ volatile UInt16 TRQ_DES_HillAssist_ValCounter; /*
  * All data types which can be chosen:  Int8, Int16, Int32, UInt8, UInt16, UInt32, Bool and Float32.
  */
  __attribute__((section("EMERGE_NV_RAM_PAGE1")))
-volatile UInt8 TRQ_DES_C_ReverseGear_TestInput = 0u; /* 
+TRQ_DES_LOCAL volatile UInt8 TRQ_DES_C_ReverseGear_TestInput = 0u; /* 
 	Description: Test parameter for manual input of reverse gear signal [-]; Limits: 0...1 */
 	
 __attribute__((section("EMERGE_NV_RAM_PAGE1")))
-volatile UInt16 TRQ_DES_C_ThrottlePriorization_Time = 10000u; /* 
+TRQ_DES_LOCAL volatile UInt16 TRQ_DES_C_ThrottlePriorization_Time = 10000u; /* 
 	Description: Parameter for time during which throttle will be priorized when both brake and throttle
 	pedal are used in parallel [ms]; Limits: 0...65535 */
    
 __attribute__((section("EMERGE_NV_RAM_PAGE1")))
-volatile Float32 TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed = 2.F; /* 
+TRQ_DES_LOCAL volatile Float32 TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed = 2.F; /* 
 	Description: Parameter for maximum rotor speed to priorize throttle when both brake and throttle
 	pedal are used in parallel [1/s]; Limits: -1...2000 */
 
@@ -133,6 +142,17 @@ Float32 sigSaturation(Float32, Float32, Float32);
 /* PRIVATE VARIABLES */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+/** @brief context of the hill-assist, the only one on the target */
+static TRQ_DES_Context_TypeDef trqdesDefaultContext = {STATE_INITIAL, 0u};
+
+#ifdef TRQ_DES_MULTI_INSTANCE
+/** @brief context used by TRQ_DES_custom(), selected per thread with TRQ_DES_SelectContext() */
+static _Thread_local TRQ_DES_Context_TypeDef *trqdesContext = &trqdesDefaultContext;
+#else
+/** @brief context used by TRQ_DES_custom(), constant so that the compiler resolves every access statically */
+static TRQ_DES_Context_TypeDef * const trqdesContext = &trqdesDefaultContext;
+#endif
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PRIVATE FUNCTIONS */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -183,9 +203,8 @@ void TRQ_DES_custom(void){
 	Float32 Motor_RotorSpeed = trqdesApi_Get_INFO_Rotor_Speed();
 	Float32 TorqueControl_Status = trqdesApi_Get_SM_OUT_SYS_Trq_Control();
 
-	/* Define state and counter variables which show the current state of hill-assist state machine. */
-	static hillAssistState_TypeDef stateHillAssist = STATE_INITIAL;
-	static UInt16 ctrHillAssist = 0u;
+	/* State and counter variables which show the current state of hill-assist state machine. */
+	TRQ_DES_Context_TypeDef *context = trqdesContext;
 	
 	/* Saturate the input signals to the desired range */
 	TRQ_DES_Throttle_Input = sigSaturation(0.F, 100.F, AnalogInput1_Signal);
@@ -199,46 +218,46 @@ void TRQ_DES_custom(void){
 	if(TorqueControl_Status == 1.F) {
 		/* Implement the state-machine for the hill-assist using the three states STATE_INITIAL, 
 		STATE_THROTTLE_PRIO and STATE_NORMAL_ACCELERATION */
-		switch(stateHillAssist) {
+		switch(context->StateHillAssist) {
 			case STATE_INITIAL: {
 				/* When accelerating while brake is pulled and rotor speed is below threshold, reload 
 				hill-assist counter and jump to STATE_THROTTLE_PRIO */
 				if (TRQ_DES_Throttle_Input > 0.F && TRQ_DES_Brake_Input > 0.F && 
 					abs(Motor_RotorSpeed) <= TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed) {
 					TRQ_DES_TorqueRequest = TRQ_DES_Throttle_Input;
-					stateHillAssist = STATE_THROTTLE_PRIO;
-					TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
-					ctrHillAssist = TRQ_DES_C_ThrottlePriorization_Time;
+					context->StateHillAssist = STATE_THROTTLE_PRIO;
+					TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
+					context->CtrHillAssist = TRQ_DES_C_ThrottlePriorization_Time;
 				}
 				/* When accelerating without holding brake there is no priorization of throttle input and 
 				jump to STATE_NORMAL_ACCELERATION */
 				else if (TRQ_DES_Throttle_Input > 0.F && TRQ_DES_Brake_Input <= 0.F) {
 					TRQ_DES_TorqueRequest = TRQ_DES_Throttle_Input - TRQ_DES_Brake_Input;
-					stateHillAssist = STATE_NORMAL_ACCELERATION;
-					TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
+					context->StateHillAssist = STATE_NORMAL_ACCELERATION;
+					TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
 				}
 				/* When there is no acceleration stay in STATE_INITIAL */
 				else {
 					TRQ_DES_TorqueRequest = TRQ_DES_Throttle_Input - TRQ_DES_Brake_Input;
-					TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
+					TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
 				}
 				break;
 			}
 			case STATE_THROTTLE_PRIO: {
-				ctrHillAssist--;
+				context->CtrHillAssist--;
 				/* If still accelerating when counter reaches zero jump to STATE_NORMAL_ACCELERATION  */
-				if (TRQ_DES_Throttle_Input > 0.F && ctrHillAssist == 0u) {
+				if (TRQ_DES_Throttle_Input > 0.F && context->CtrHillAssist == 0u) {
 					TRQ_DES_TorqueRequest = TRQ_DES_Throttle_Input - TRQ_DES_Brake_Input;
-					stateHillAssist = STATE_NORMAL_ACCELERATION;
-					TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
+					context->StateHillAssist = STATE_NORMAL_ACCELERATION;
+					TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
 				}
 				/* If throttle is released while counter still running reset counter and jump back to 
 				STATE_INITIAL */
-				else if (TRQ_DES_Throttle_Input <= 0.F && ctrHillAssist != 0u) {
-					ctrHillAssist = 0u;
+				else if (TRQ_DES_Throttle_Input <= 0.F && context->CtrHillAssist != 0u) {
+					context->CtrHillAssist = 0u;
 					TRQ_DES_TorqueRequest = TRQ_DES_Throttle_Input - TRQ_DES_Brake_Input;
-					stateHillAssist = STATE_INITIAL;
-					TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
+					context->StateHillAssist = STATE_INITIAL;
+					TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
 				}
 				/* As long as counter has not reached zero priorize throttle over brake input */
 				else {
@@ -252,8 +271,8 @@ void TRQ_DES_custom(void){
 				if (TRQ_DES_Throttle_Input <= 0.F && TRQ_DES_Brake_Input <= 0.F && 
 					abs(Motor_RotorSpeed) <= TRQ_DES_C_ThrottlePriorization_MaxRotorSpeed) {
 					TRQ_DES_TorqueRequest = TRQ_DES_Throttle_Input - TRQ_DES_Brake_Input;
-					stateHillAssist = STATE_INITIAL;
-					TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
+					context->StateHillAssist = STATE_INITIAL;
+					TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
 				}
 				/* Normal acceleration without priorization after hill-assist counter has reached zero */
 				else {
@@ -264,14 +283,14 @@ void TRQ_DES_custom(void){
 		}
 	}
 	else {
-		stateHillAssist = STATE_INITIAL;
-		ctrHillAssist = 0u;
+		context->StateHillAssist = STATE_INITIAL;
+		context->CtrHillAssist = 0u;
 		TRQ_DES_TorqueRequest = 0.F;
 	}
 	
 	/* Show current state and counter value of hill-assist state machine */
-	TRQ_DES_HillAssist_ValCounter = ctrHillAssist;
-	TRQ_DES_HillAssist_State = (UInt8)stateHillAssist;
+	TRQ_DES_HillAssist_ValCounter = context->CtrHillAssist;
+	TRQ_DES_HillAssist_State = (UInt8)context->StateHillAssist;
 
 	/**
 	 * Saturation of relative torque request depending on rotor speed and driving direction. 
@@ -322,6 +341,33 @@ void TRQ_DES_custom(void){
 	
 }
 
+#ifdef TRQ_DES_MULTI_INSTANCE
+/** 
+ * @brief Get the memory needed for one module context
+ * @return size of TRQ_DES_Context_TypeDef [byte]
+ */
+UInt32 TRQ_DES_GetContextSize(void){
+	return (UInt32)sizeof(TRQ_DES_Context_TypeDef);
+}
+
+/** 
+ * @brief Set a context to the power-up state of the hill-assist
+ * @param context: context to initialize, TRQ_DES_GetContextSize() bytes
+ */
+void TRQ_DES_InitContext(TRQ_DES_Context_TypeDef *context){
+	context->StateHillAssist = STATE_INITIAL;
+	context->CtrHillAssist = 0u;
+}
+
+/** 
+ * @brief Select the context used by TRQ_DES_custom() in the calling thread
+ * @param context: initialized context, 0 for the default context
+ */
+void TRQ_DES_SelectContext(TRQ_DES_Context_TypeDef *context){
+	trqdesContext = (context != 0) ? context : &trqdesDefaultContext;
+}
+#endif
+
 /** @} */
 
 #endif /* TRQ_DES_CUSTOM_C_ */
@@ -27,6 +27,13 @@
 /* PUBLIC DEFINES */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+/* storage class of the EnableTool variables, thread-local in a host simulation with one controller instance per thread */
+#ifdef TRQ_DES_MULTI_INSTANCE
+#define TRQ_DES_LOCAL _Thread_local
+#else
+#define TRQ_DES_LOCAL
+#endif
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PUBLIC TYPEDEF */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -40,6 +47,11 @@ typedef unsigned short int UInt16; /* 16 bit unsigned integer basetype */
 typedef unsigned long int UInt32; /* 32 bit unsigned integer basetype */
 typedef unsigned char UInt8; /* 8 bit unsigned integer basetype */
 
+/**
+ * @brief Runtime state of one hill-assist instance, only used through a pointer outside TRQ_DES_custom.c
+ */
+typedef struct TRQ_DES_ContextTag TRQ_DES_Context_TypeDef;
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /* PUBLIC CONSTANTS */
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -59,6 +71,32 @@ typedef unsigned char UInt8; /* 8 bit unsigned integer basetype */
  */
 void TRQ_DES_custom(void);
 
+#ifdef TRQ_DES_MULTI_INSTANCE
+/*
+ * Multi-instance build for host simulations, compile all files with -DTRQ_DES_MULTI_INSTANCE.
+ * Each thread selects its own context before it calls TRQ_DES_custom(). The EnableTool
+ * variables are thread-local and shared by all contexts a thread runs.
+ */
+
+/**
+ * @brief Get the memory needed for one module context
+ * @return size of TRQ_DES_Context_TypeDef [byte]
+ */
+UInt32 TRQ_DES_GetContextSize(void);
+
+/**
+ * @brief Set a context to the power-up state of the hill-assist
+ * @param context: context to initialize, TRQ_DES_GetContextSize() bytes
+ */
+void TRQ_DES_InitContext(TRQ_DES_Context_TypeDef *context);
+
+/**
+ * @brief Select the context used by TRQ_DES_custom() in the calling thread
+ * @param context: initialized context, 0 for the default context
+ */
+void TRQ_DES_SelectContext(TRQ_DES_Context_TypeDef *context);
+#endif
+
 
 /** @} */ 
 